@@ -0,0 +1,70 @@
+#include "agenda.h"
+
+#include <algorithm>
+#include <utility>
+
+// Ordem do heap: o prazo que vence antes fica no topo
+bool Agenda::depois(const Prazo& a, const Prazo& b)
+{
+    if (a.instante != b.instante) {
+        return a.instante > b.instante;
+    }
+    return a.sequencia > b.sequencia;
+}
+
+int Agenda::agendar(Instante prazo, Acao acao)
+{
+    int id = proximo_id++;
+    acoes.emplace(id, std::move(acao));
+    heap.push_back(Prazo{prazo, proxima_sequencia++, id});
+    std::push_heap(heap.begin(), heap.end(), depois);
+    return id;
+}
+
+bool Agenda::cancelar(int id)
+{
+    if (acoes.erase(id) == 0) {
+        return false;
+    }
+    // Sem prazos pendentes, descarta de uma vez as marcas de cancelamento
+    if (acoes.empty()) {
+        heap.clear();
+    }
+    return true;
+}
+
+// Retira do topo os prazos cancelados
+void Agenda::descartar_cancelados()
+{
+    while (!heap.empty() && acoes.count(heap.front().id) == 0) {
+        std::pop_heap(heap.begin(), heap.end(), depois);
+        heap.pop_back();
+    }
+}
+
+Agenda::Instante Agenda::proximo_prazo()
+{
+    descartar_cancelados();
+    return heap.empty() ? Instante::max() : heap.front().instante;
+}
+
+std::size_t Agenda::executar_vencidos(Instante agora)
+{
+    std::size_t executadas = 0;
+    while (true) {
+        descartar_cancelados();
+        if (heap.empty() || heap.front().instante > agora) {
+            return executadas;
+        }
+        Prazo prazo = heap.front();
+        std::pop_heap(heap.begin(), heap.end(), depois);
+        heap.pop_back();
+
+        // A ação sai da agenda antes de executar, para que possa reagendar a si mesma
+        auto encontrada = acoes.find(prazo.id);
+        Acao acao = std::move(encontrada->second);
+        acoes.erase(encontrada);
+        acao(prazo.instante);
+        executadas++;
+    }
+}
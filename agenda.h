@@ -0,0 +1,82 @@
+#ifndef AGENDA_H
+#define AGENDA_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Agenda de prazos: executa ações no instante em que vencem.
+ *
+ * Os prazos ficam em um heap de mínimo, de modo que quem usa a agenda só
+ * precisa acordar em proximo_prazo() (um único temporizador do laço de eventos,
+ * por exemplo) em vez de verificar periodicamente se há algo a fazer. Prazos
+ * iguais são executados na ordem em que foram agendados. O cancelamento apenas
+ * marca o prazo, que é descartado quando chega ao topo do heap.
+ *
+ * A agenda não consulta o relógio: o instante atual é sempre informado por quem
+ * chama, o que permite usá-la também com um relógio virtual.
+ */
+class Agenda
+{
+public:
+    using Relogio = std::chrono::steady_clock;
+    using Instante = Relogio::time_point;
+    using Acao = std::function<void(Instante prazo)>; // Recebe o prazo agendado (não o instante atual)
+
+    /**
+     * @brief Agenda uma ação.
+     * A ação pode agendar e cancelar outras ações, inclusive reagendar a si mesma.
+     * @param prazo Instante a partir do qual a ação deve ser executada.
+     * @param acao Ação a executar.
+     * @return Identificador do prazo, para cancelar().
+     */
+    int agendar(Instante prazo, Acao acao);
+
+    /**
+     * @brief Cancela um prazo ainda não executado.
+     * @return true se o prazo estava pendente.
+     */
+    bool cancelar(int id);
+
+    /**
+     * @brief Verifica se um prazo ainda está pendente.
+     */
+    bool pendente(int id) const { return acoes.count(id) != 0; }
+
+    bool vazia() const { return acoes.empty(); }
+
+    /**
+     * @brief Instante do prazo pendente mais próximo.
+     * @return Prazo mais próximo, ou Instante::max() se a agenda estiver vazia.
+     */
+    Instante proximo_prazo();
+
+    /**
+     * @brief Executa, em ordem, as ações com prazo até o instante informado.
+     * Ações agendadas durante a execução com prazo vencido também são executadas.
+     * @param agora Instante atual.
+     * @return Quantidade de ações executadas.
+     */
+    std::size_t executar_vencidos(Instante agora);
+
+private:
+    struct Prazo {
+        Instante instante;
+        std::uint64_t sequencia; // Desempate entre prazos iguais: ordem de agendamento
+        int id;
+    };
+
+    static bool depois(const Prazo& a, const Prazo& b);
+    void descartar_cancelados();
+
+    std::vector<Prazo> heap;                   // Heap de mínimo pelo instante (inclui prazos cancelados)
+    std::unordered_map<int, Acao> acoes;       // Ações dos prazos pendentes
+    std::uint64_t proxima_sequencia = 0;       // Contador de agendamentos
+    int proximo_id = 0;                        // Próximo identificador de prazo
+};
+
+#endif // AGENDA_H
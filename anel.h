@@ -0,0 +1,116 @@
+#ifndef ANEL_H
+#define ANEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Fila circular limitada, sem travas, com vários produtores e um consumidor.
+ *
+ * Cada posição do anel tem um número de sequência que diz de quem é a vez: do
+ * produtor que vai escrever nela (sequência == posição) ou do consumidor que
+ * vai lê-la (sequência == posição + 1). Os produtores disputam a próxima
+ * posição livre com uma única comparação e troca e depois escrevem sem
+ * concorrência; o consumidor lê em ordem sem instruções atômicas de
+ * leitura-modificação-escrita. Nenhuma operação aloca ou espera: enviar()
+ * retorna false se o anel estiver cheio e receber(), se estiver vazio.
+ *
+ * Os itens de um mesmo produtor são recebidos na ordem em que foram enviados.
+ */
+template <typename T>
+class AnelMpsc
+{
+public:
+    /**
+     * @param capacidade Quantidade máxima de itens, arredondada para uma potência de dois.
+     */
+    explicit AnelMpsc(std::size_t capacidade)
+    {
+        std::size_t tamanho = 2;
+        while (tamanho < capacidade) {
+            tamanho *= 2;
+        }
+        mascara = tamanho - 1;
+        posicoes.reset(new Posicao[tamanho]);
+        for (std::size_t i = 0; i < tamanho; ++i) {
+            posicoes[i].sequencia.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    AnelMpsc(const AnelMpsc&) = delete;
+    AnelMpsc& operator=(const AnelMpsc&) = delete;
+
+    /**
+     * @brief Acrescenta um item; pode ser chamado de qualquer thread.
+     * @return false se o anel estiver cheio (o item não é consumido).
+     */
+    bool enviar(T&& item)
+    {
+        std::size_t posicao = cauda.load(std::memory_order_relaxed);
+        while (true) {
+            Posicao& destino = posicoes[posicao & mascara];
+            std::size_t sequencia = destino.sequencia.load(std::memory_order_acquire);
+            if (sequencia == posicao) {
+                // A posição está livre: tenta reservá-la antes de outro produtor
+                if (cauda.compare_exchange_weak(posicao, posicao + 1, std::memory_order_relaxed)) {
+                    destino.item = std::move(item);
+                    destino.sequencia.store(posicao + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequencia < posicao) {
+                return false; // O consumidor ainda não liberou a posição de uma volta atrás
+            } else {
+                posicao = cauda.load(std::memory_order_relaxed); // Outro produtor já a reservou
+            }
+        }
+    }
+
+    /**
+     * @brief Retira o item mais antigo; apenas o thread consumidor.
+     * @return false se o anel estiver vazio.
+     */
+    bool receber(T& item)
+    {
+        Posicao& origem = posicoes[cabeca & mascara];
+        if (origem.sequencia.load(std::memory_order_acquire) != cabeca + 1) {
+            return false;
+        }
+        item = std::move(origem.item);
+        origem.sequencia.store(cabeca + mascara + 1, std::memory_order_release); // Livre para a próxima volta
+        cabeca++;
+        return true;
+    }
+
+    /**
+     * @brief Verifica se há item para receber; apenas o thread consumidor.
+     */
+    bool vazio() const
+    {
+        return posicoes[cabeca & mascara].sequencia.load(std::memory_order_acquire) != cabeca + 1;
+    }
+
+    /**
+     * @brief Quantidade de posições já reservadas por produtores desde o início.
+     * Todo item enviado antes da chamada está entre as reservadas(); o
+     * consumidor o terá recebido depois de receber essa quantidade de itens.
+     */
+    std::size_t reservados() const { return cauda.load(std::memory_order_acquire); }
+
+    std::size_t capacidade() const { return mascara + 1; }
+
+private:
+    // Posição do anel; alinhada para que produtores vizinhos não disputem a mesma linha de cache
+    struct alignas(64) Posicao {
+        std::atomic<std::size_t> sequencia;
+        T item;
+    };
+
+    std::unique_ptr<Posicao[]> posicoes;
+    std::size_t mascara;
+    alignas(64) std::atomic<std::size_t> cauda{0}; // Próxima posição a reservar pelos produtores
+    alignas(64) std::size_t cabeca = 0;            // Próxima posição a ler pelo consumidor
+};
+
+#endif // ANEL_H
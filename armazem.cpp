@@ -0,0 +1,120 @@
+#include "armazem.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "binario.h"
+#include "cpf.h"
+
+int ArmazemPacientes::adicionar(std::uint64_t cpf, std::string_view nome, std::string_view email,
+                                long long nascimento, unsigned sintomas)
+{
+    sintomas_por_id.push_back(static_cast<std::uint8_t>(sintomas));
+    cpfs.push_back(cpf);
+    nascimentos.push_back(static_cast<std::int32_t>(nascimento));
+    nomes.push_back(textos_nomes.internar(nome));
+    emails.push_back(textos_emails.guardar(email));
+    return static_cast<int>(sintomas_por_id.size()) - 1;
+}
+
+void ArmazemPacientes::reservar(std::size_t total)
+{
+    sintomas_por_id.reserve(total);
+    cpfs.reserve(total);
+    nascimentos.reserve(total);
+    nomes.reserve(total);
+    emails.reserve(total);
+}
+
+void ArmazemPacientes::atualizar(int id, std::string_view nome, std::string_view email,
+                                 long long nascimento, unsigned sintomas)
+{
+    sintomas_por_id[id] = static_cast<std::uint8_t>(sintomas);
+    nascimentos[id] = static_cast<std::int32_t>(nascimento);
+    if (this->nome(id) != nome) {
+        nomes[id] = textos_nomes.internar(nome);
+    }
+    if (this->email(id) != email) {
+        emails[id] = textos_emails.guardar(email);
+    }
+}
+
+void ArmazemPacientes::descartar_textos(int ate)
+{
+    const std::size_t fim = std::min(static_cast<std::size_t>(std::max(ate, 0)), tamanho());
+    if (fim <= descartados) {
+        return;
+    }
+
+    // Arenas novas só com os textos dos pacientes seguintes; os descartados apontam para o texto vazio
+    TabelaTexto novos_nomes, novos_emails;
+    const std::uint32_t nome_vazio = novos_nomes.internar({});
+    const std::uint32_t email_vazio = novos_emails.guardar({});
+    for (std::size_t id = 0; id < fim; ++id) {
+        nomes[id] = nome_vazio;
+        emails[id] = email_vazio;
+    }
+    for (std::size_t id = fim; id < tamanho(); ++id) {
+        nomes[id] = novos_nomes.internar(textos_nomes.texto(nomes[id]));
+        emails[id] = novos_emails.guardar(textos_emails.texto(emails[id]));
+    }
+    textos_nomes = std::move(novos_nomes);
+    textos_emails = std::move(novos_emails);
+    descartados = fim;
+}
+
+Patient ArmazemPacientes::paciente(int id) const
+{
+    return Patient(id, std::string(nome(id)), chave_para_cpf(cpfs[id]), std::string(email(id)),
+                   nascimentos[id], sintomas_por_id[id]);
+}
+
+std::size_t ArmazemPacientes::bytes() const
+{
+    return sintomas_por_id.capacity() * sizeof(std::uint8_t) +
+           cpfs.capacity() * sizeof(std::uint64_t) +
+           nascimentos.capacity() * sizeof(std::int32_t) +
+           nomes.capacity() * sizeof(std::uint32_t) +
+           emails.capacity() * sizeof(std::uint32_t) +
+           textos_nomes.bytes() + textos_emails.bytes();
+}
+
+void ArmazemPacientes::salvar(Escritor& saida) const
+{
+    // Os vetores paralelos são gravados inteiros, sem conversão
+    saida.vetor(sintomas_por_id);
+    saida.vetor(cpfs);
+    saida.vetor(nascimentos);
+    saida.vetor(nomes);
+    saida.vetor(emails);
+    textos_nomes.salvar(saida, true);
+    textos_emails.salvar(saida, false);
+    saida.u64(descartados);
+}
+
+bool ArmazemPacientes::carregar(Leitor& entrada)
+{
+    std::uint64_t sem_textos_gravados = 0;
+    if (!entrada.vetor(sintomas_por_id) || !entrada.vetor(cpfs) || !entrada.vetor(nascimentos) ||
+        !entrada.vetor(nomes) || !entrada.vetor(emails) ||
+        !textos_nomes.carregar(entrada, true) || !textos_emails.carregar(entrada, false) ||
+        !entrada.u64(sem_textos_gravados)) {
+        return false;
+    }
+
+    // Confere se todos os vetores têm um elemento por paciente e se os textos existem
+    const std::size_t n = sintomas_por_id.size();
+    if (cpfs.size() != n || nascimentos.size() != n || nomes.size() != n || emails.size() != n ||
+        sem_textos_gravados > n) {
+        return false;
+    }
+    for (std::size_t id = 0; id < n; ++id) {
+        if (nomes[id] >= textos_nomes.tamanho() || emails[id] >= textos_emails.tamanho()) {
+            return false;
+        }
+    }
+    // Os textos desses pacientes só existem no histórico, que precisa cobri-los (ver Historico::conferir)
+    descartados = static_cast<std::size_t>(sem_textos_gravados);
+    return true;
+}
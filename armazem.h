@@ -0,0 +1,113 @@
+#ifndef ARMAZEM_H
+#define ARMAZEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "paciente.h"
+#include "tabelatexto.h"
+
+/**
+ * @brief Armazenamento compacto de todos os pacientes admitidos.
+ *
+ * Cada paciente é guardado uma única vez, identificado pelo seu ID, que é a
+ * sua posição no armazenamento e também a sua ordem de chegada. Os campos
+ * ficam em vetores paralelos: os campos quentes, lidos pela fila e pelo
+ * tratamento, ficam separados dos campos frios, lidos apenas para exibição.
+ * O CPF é guardado como chave inteira (ver cpf.h), a data de nascimento como
+ * dia juliano (ver data.h) e os textos em arenas (ver TabelaTexto), com os
+ * nomes deduplicados. A idade não é guardada: é calculada na data da exibição (ver calcular_idade).
+ * Os nomes e emails dos pacientes selados no histórico em disco podem ser
+ * descartados (ver descartar_textos); os demais campos ficam, porque os
+ * índices da triagem os usam.
+ */
+class ArmazemPacientes
+{
+public:
+    /**
+     * @brief Adiciona um paciente.
+     * @param cpf Chave do CPF.
+     * @param nome Nome em UTF-8.
+     * @param email Email.
+     * @param nascimento Data de nascimento (dia juliano).
+     * @param sintomas Sintomas representados por flags binárias.
+     * @return ID do paciente.
+     */
+    int adicionar(std::uint64_t cpf, std::string_view nome, std::string_view email,
+                  long long nascimento, unsigned sintomas);
+
+    /**
+     * @brief Reserva espaço para a quantidade informada de pacientes, evitando realocações durante um lote.
+     * @param total Quantidade total de pacientes esperada.
+     */
+    void reservar(std::size_t total);
+
+    /**
+     * @brief Atualiza os dados de um paciente; o CPF não muda.
+     * Os textos anteriores continuam ocupando espaço nas arenas.
+     */
+    void atualizar(int id, std::string_view nome, std::string_view email,
+                   long long nascimento, unsigned sintomas);
+
+    /**
+     * @brief Descarta os nomes e emails dos pacientes com ID menor que ate, compactando as arenas em O(n).
+     * Usado quando esses pacientes já estão selados no histórico (ver Historico), que passa a ser a
+     * fonte dos textos deles; nome() e email() desses pacientes ficam vazios.
+     */
+    void descartar_textos(int ate);
+
+    /**
+     * @brief Pacientes sem nome e email na memória: os IDs de 0 a sem_textos() - 1.
+     */
+    std::size_t sem_textos() const { return descartados; }
+
+    // Campos quentes
+    unsigned sintomas(int id) const { return sintomas_por_id[id]; }
+
+    // Campos frios
+    std::uint64_t cpf(int id) const { return cpfs[id]; }
+    std::string_view nome(int id) const { return textos_nomes.texto(nomes[id]); }
+    std::string_view email(int id) const { return textos_emails.texto(emails[id]); }
+    long long nascimento(int id) const { return nascimentos[id]; }
+
+    /**
+     * @brief Monta o registro completo de um paciente.
+     */
+    Patient paciente(int id) const;
+
+    std::size_t tamanho() const { return sintomas_por_id.size(); }
+
+    /**
+     * @brief Memória reservada pelo armazenamento, em bytes.
+     */
+    std::size_t bytes() const;
+
+    /**
+     * @brief Grava todos os pacientes e quantos deles estão sem textos (ver binario.h e sem_textos).
+     */
+    void salvar(Escritor& saida) const;
+
+    /**
+     * @brief Substitui o conteúdo pelos pacientes gravados por salvar().
+     * Os pacientes gravados sem textos continuam sem textos: só o histórico os tem.
+     * @return false se os dados estiverem incompletos ou inconsistentes.
+     */
+    bool carregar(Leitor& entrada);
+
+private:
+    // Campos quentes
+    std::vector<std::uint8_t> sintomas_por_id; // Sintomas (prioridade) de cada paciente
+
+    // Campos frios
+    std::vector<std::uint64_t> cpfs;       // Chave do CPF
+    std::vector<std::int32_t> nascimentos; // Data de nascimento (dia juliano)
+    std::vector<std::uint32_t> nomes;      // Nome em textos_nomes
+    std::vector<std::uint32_t> emails;     // Email em textos_emails
+    TabelaTexto textos_nomes;              // Nomes, deduplicados
+    TabelaTexto textos_emails;             // Emails
+    std::size_t descartados = 0;           // Pacientes do início sem nome e email (ver descartar_textos)
+};
+
+#endif // ARMAZEM_H
@@ -0,0 +1,58 @@
+#include "arquivomapeado.h"
+
+#ifdef _WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ArquivoMapeado::ArquivoMapeado(const std::string& caminho)
+{
+#ifdef _WIN32
+    std::FILE* f = std::fopen(caminho.c_str(), "rb");
+    if (f == nullptr) {
+        return;
+    }
+    char bloco[1 << 16];
+    std::size_t lidos;
+    while ((lidos = std::fread(bloco, 1, sizeof(bloco), f)) > 0) {
+        copia.insert(copia.end(), bloco, bloco + lidos);
+    }
+    std::fclose(f);
+    inicio = copia.data();
+    tamanho_arquivo = copia.size();
+    aberto = true;
+#else
+    int f = open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+    if (f == -1) {
+        return;
+    }
+    struct stat info;
+    if (fstat(f, &info) == 0) {
+        tamanho_arquivo = static_cast<std::size_t>(info.st_size);
+        aberto = true;
+        if (tamanho_arquivo > 0) {
+            void* p = mmap(nullptr, tamanho_arquivo, PROT_READ, MAP_PRIVATE, f, 0);
+            if (p == MAP_FAILED) {
+                aberto = false;
+            } else {
+                inicio = static_cast<const char*>(p);
+                madvise(p, tamanho_arquivo, MADV_SEQUENTIAL);
+            }
+        }
+    }
+    close(f);
+#endif
+}
+
+ArquivoMapeado::~ArquivoMapeado()
+{
+#ifndef _WIN32
+    if (inicio != nullptr) {
+        munmap(const_cast<char*>(inicio), tamanho_arquivo);
+    }
+#endif
+}
@@ -0,0 +1,38 @@
+#ifndef ARQUIVOMAPEADO_H
+#define ARQUIVOMAPEADO_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Arquivo inteiro disponível em memória para leitura.
+ * Usa mmap quando disponível, sem copiar o conteúdo; no Windows lê o arquivo.
+ */
+class ArquivoMapeado
+{
+public:
+    /**
+     * @brief Mapeia o arquivo informado.
+     * @param caminho Caminho do arquivo; se ele não puder ser aberto, existe() retorna false.
+     */
+    explicit ArquivoMapeado(const std::string& caminho);
+    ~ArquivoMapeado();
+
+    ArquivoMapeado(const ArquivoMapeado&) = delete;
+    ArquivoMapeado& operator=(const ArquivoMapeado&) = delete;
+
+    bool existe() const { return aberto; }
+    const char* dados() const { return inicio; }
+    std::size_t tamanho() const { return tamanho_arquivo; }
+
+private:
+    const char* inicio = nullptr;
+    std::size_t tamanho_arquivo = 0;
+    bool aberto = false;
+#ifdef _WIN32
+    std::vector<char> copia;
+#endif
+};
+
+#endif // ARQUIVOMAPEADO_H
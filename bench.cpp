@@ -0,0 +1,1078 @@
+// Benchmark das operações de ordenação, busca e fila da triagem.
+//
+// Compara os algoritmos originais da interface (ordenação por seleção, busca
+// binária sobre cópia ordenada e varreduras sequenciais), reproduzidos aqui no
+// namespace legado, com o motor atual (Triagem) e seus componentes, sobre
+// conjuntos sintéticos de pacientes. Para cada operação são medidos o tempo
+// por operação, as alocações por operação, a vazão e, quando o sistema permite
+// ler os contadores de hardware, as falhas de cache por operação. Também é
+// medida a memória ocupada por paciente em cada organização dos dados, a vazão
+// da admissão concorrente por vários guichês (ver Recepcao) com o tratamento
+// avançando e consultas lendo os retratos ao mesmo tempo e, em
+// uma simulação com as estações quase sempre ocupadas, os percentis da espera
+// com e sem o envelhecimento da prioridade (ver Escalonador::envelhecer). Por
+// fim, compara as consultas e contagens de sintomas pelo índice em mapas de
+// bits (ver IndiceSintomas) com a varredura dos pacientes, sobre dez vezes o
+// maior conjunto, e mede o selamento do histórico em segmentos e as consultas
+// que descartam segmentos pelo cabeçalho (ver Historico) e a formatação dos
+// pacientes em texto, CSV e JSON (ver Formatador) contra a montagem original
+// do texto, e as contagens por faixa de idade pelo índice de nascimentos (ver
+// IndiceNascimento) contra a varredura da fila. Os resultados são gravados em
+// JSON para acompanhar regressões.
+//
+// Uso: b1_bench [--max N] [--max-quadratico N] [--saida arquivo.json]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "cpf.h"
+#include "data.h"
+#include "filaprioridade.h"
+#include "formatador.h"
+#include "historico.h"
+#include "histograma.h"
+#include "importacao.h"
+#include "indicesintomas.h"
+#include "paciente.h"
+#include "recepcao.h"
+#include "simulacao.h"
+#include "telemetria.h"
+#include "texto.h"
+#include "triagem.h"
+
+// Contadores globais de alocações e de bytes alocados e ainda não liberados
+static std::atomic<std::size_t> alocacoes{0};
+static std::atomic<std::size_t> bytes_vivos{0};
+
+// Cada bloco guarda o seu tamanho em um cabeçalho, para que a liberação
+// desconte os bytes correspondentes
+static const std::size_t CABECALHO = 16;
+
+void* operator new(std::size_t tamanho)
+{
+    alocacoes.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(tamanho + CABECALHO)) {
+        *static_cast<std::size_t*>(p) = tamanho;
+        bytes_vivos.fetch_add(tamanho, std::memory_order_relaxed);
+        return static_cast<char*>(p) + CABECALHO;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p == nullptr) {
+        return;
+    }
+    char* bloco = static_cast<char*>(p) - CABECALHO;
+    bytes_vivos.fetch_sub(*reinterpret_cast<std::size_t*>(bloco), std::memory_order_relaxed);
+    std::free(bloco);
+}
+
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+
+namespace {
+
+// Gerador pseudoaleatório determinístico (xorshift64*)
+class Gerador
+{
+public:
+    explicit Gerador(std::uint64_t semente) : estado(semente ? semente : 1) {}
+
+    std::uint64_t proximo()
+    {
+        estado ^= estado >> 12;
+        estado ^= estado << 25;
+        estado ^= estado >> 27;
+        return estado * 0x2545F4914F6CDD1DULL;
+    }
+
+    // Número uniforme em [0, n)
+    std::size_t abaixo(std::size_t n) { return static_cast<std::size_t>(proximo() % n); }
+
+private:
+    std::uint64_t estado;
+};
+
+const char* const NOMES[] = {
+    "Ana", "Bruno", "Carla", "Daniel", "Eduarda", "Felipe", "Gabriela", "Henrique", "Isabela", "João",
+    "Júlia", "Lucas", "Mariana", "Matheus", "Natália", "Otávio", "Paula", "Rafael", "Sofia", "Thiago",
+    "Vitória", "William", "Yasmin", "Álvaro", "Beatriz", "Caio", "Débora", "Enzo", "Fernanda", "Gustavo",
+};
+
+const char* const SOBRENOMES[] = {
+    "Silva", "Santos", "Oliveira", "Souza", "Rodrigues", "Ferreira", "Alves", "Pereira", "Lima", "Gomes",
+    "Costa", "Ribeiro", "Martins", "Carvalho", "Almeida", "Lopes", "Soares", "Fernandes", "Vieira", "Barbosa",
+    "Rocha", "Dias", "Nascimento", "Andrade", "Moreira", "Nunes", "Marques", "Machado", "Mendes", "Freitas",
+    "Araújo", "Cardoso", "Teixeira", "Correia", "Cavalcanti", "Monteiro", "Moura", "Pinto", "Batista", "Conceição",
+};
+
+const std::size_t QTD_NOMES = sizeof(NOMES) / sizeof(NOMES[0]);
+const std::size_t QTD_SOBRENOMES = sizeof(SOBRENOMES) / sizeof(SOBRENOMES[0]);
+
+// Dados de um paciente sintético, antes da admissão
+struct Registro {
+    std::string name;
+    std::string cpf;
+    std::string email;
+    long long bday;
+    unsigned sintomas;
+};
+
+/**
+ * @brief Gera um CPF único e com dígitos verificadores válidos para o índice i.
+ * A base de 9 dígitos é i multiplicado por um número primo com 10^9, o que
+ * espalha os CPFs sem repetições.
+ */
+std::string gerar_cpf(std::size_t i)
+{
+    return chave_para_cpf(completar_cpf(static_cast<std::uint32_t>((static_cast<std::uint64_t>(i) * 7919 + 12345) %
+                                                                   1000000000ULL)));
+}
+
+std::vector<Registro> gerar_registros(std::size_t n, std::uint64_t semente)
+{
+    Gerador gerador(semente);
+    std::vector<Registro> registros;
+    registros.reserve(n);
+    const long long inicio = dia_juliano(1930, 1, 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        Registro r;
+        r.name = std::string(NOMES[gerador.abaixo(QTD_NOMES)]) + " " +
+                 SOBRENOMES[gerador.abaixo(QTD_SOBRENOMES)] + " " +
+                 SOBRENOMES[gerador.abaixo(QTD_SOBRENOMES)];
+        r.cpf = gerar_cpf(i);
+        r.email = "paciente" + std::to_string(i) + "@exemplo.com";
+        r.bday = inicio + static_cast<long long>(gerador.abaixo(90 * 365));
+        r.sintomas = static_cast<unsigned>(1 + gerador.abaixo(255));
+        registros.push_back(std::move(r));
+    }
+    return registros;
+}
+
+// Introduz um erro de digitação (troca de uma letra) em uma palavra do nome
+std::string com_erro(const std::string& nome, Gerador& gerador)
+{
+    std::string resultado = nome;
+    std::size_t espaco = resultado.find(' ');
+    std::size_t fim = espaco == std::string::npos ? resultado.size() : espaco;
+    if (fim > 2) {
+        std::size_t i = 1 + gerador.abaixo(fim - 2);
+        if (static_cast<unsigned char>(resultado[i]) < 0x80) {
+            resultado[i] = resultado[i] == 'x' ? 'z' : 'x';
+        }
+    }
+    return resultado;
+}
+
+/**
+ * @brief Contador de falhas de cache do processo, lido pelo perf_event do Linux.
+ * Em outros sistemas, ou quando o kernel não permite o acesso, disponivel()
+ * retorna false e as medições registram -1.
+ */
+class ContadorCache
+{
+public:
+    ContadorCache()
+    {
+#ifdef __linux__
+        perf_event_attr atributos;
+        std::memset(&atributos, 0, sizeof(atributos));
+        atributos.type = PERF_TYPE_HARDWARE;
+        atributos.size = sizeof(atributos);
+        atributos.config = PERF_COUNT_HW_CACHE_MISSES;
+        atributos.exclude_kernel = 1;
+        atributos.exclude_hv = 1;
+        descritor = static_cast<int>(syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0));
+#endif
+    }
+
+    ~ContadorCache()
+    {
+#ifdef __linux__
+        if (descritor != -1) {
+            close(descritor);
+        }
+#endif
+    }
+
+    bool disponivel() const { return descritor != -1; }
+
+    // Falhas de cache acumuladas desde a criação do contador
+    long long ler() const
+    {
+        long long valor = -1;
+#ifdef __linux__
+        if (descritor == -1 || read(descritor, &valor, sizeof(valor)) != sizeof(valor)) {
+            return -1;
+        }
+#endif
+        return valor;
+    }
+
+private:
+    int descritor = -1;
+};
+
+ContadorCache falhas_cache;
+
+// Algoritmos originais da interface, antes do motor de triagem
+namespace legado {
+
+// Equivalente a QString::compare(..., Qt::CaseInsensitive) para os nomes gerados
+int comparar_sem_caixa(const std::string& a, const std::string& b)
+{
+    std::size_t n = std::min(a.size(), b.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        unsigned char x = static_cast<unsigned char>(a[i]);
+        unsigned char y = static_cast<unsigned char>(b[i]);
+        if (x >= 'A' && x <= 'Z') x += 'a' - 'A';
+        if (y >= 'A' && y <= 'Z') y += 'a' - 'A';
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+void ordenar_paciente_sintoma(std::vector<Patient>& fila)
+{
+    int n = static_cast<int>(fila.size());
+    for (int i = 0; i < n - 1; ++i) {
+        int max_idx = i;
+        unsigned max_priority = fila[i].sintomas;
+        for (int j = i + 1; j < n; ++j) {
+            if (fila[j].sintomas > max_priority) {
+                max_idx = j;
+                max_priority = fila[j].sintomas;
+            }
+        }
+        if (max_idx != i) {
+            std::swap(fila[i], fila[max_idx]);
+        }
+    }
+}
+
+void ordenar_paciente_nome(const std::vector<Patient>& fila, std::vector<Patient>& sorted_name_fila)
+{
+    sorted_name_fila = fila;
+    int n = static_cast<int>(sorted_name_fila.size());
+    for (int i = 0; i < n - 1; ++i) {
+        int min_idx = i;
+        for (int j = i + 1; j < n; ++j) {
+            if (comparar_sem_caixa(sorted_name_fila[j].name, sorted_name_fila[min_idx].name) < 0) {
+                min_idx = j;
+            }
+        }
+        if (min_idx != i) {
+            std::swap(sorted_name_fila[i], sorted_name_fila[min_idx]);
+        }
+    }
+}
+
+int binary_search(const std::vector<Patient>& sorted_name_fila, const std::string& name)
+{
+    int left = 0;
+    int right = static_cast<int>(sorted_name_fila.size()) - 1;
+    while (left <= right) {
+        int mid = left + (right - left) / 2;
+        int cmp = comparar_sem_caixa(sorted_name_fila[mid].name, name);
+        if (cmp == 0) {
+            return mid;
+        }
+        else if (cmp < 0) {
+            left = mid + 1;
+        }
+        else {
+            right = mid - 1;
+        }
+    }
+    return -1;
+}
+
+// Busca sequencial da consulta: CPF exato ou nome convertido para minúsculas
+const Patient* buscar(const std::vector<Patient>& fila, const std::string& cpf, const std::string& name)
+{
+    for (const Patient& patient : fila) {
+        if ((!cpf.empty() && patient.cpf.compare(cpf) == 0) ||
+            (!name.empty() && minusculas(patient.name).compare(minusculas(name)) == 0)) {
+            return &patient;
+        }
+    }
+    return nullptr;
+}
+
+bool remover(std::vector<Patient>& fila, const std::string& cpf)
+{
+    for (std::size_t i = 0; i < fila.size(); ++i) {
+        if (fila[i].cpf.compare(cpf) == 0) {
+            fila.erase(fila.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Bloco de texto de um paciente como on_consultarPatient_clicked montava, com std::string no lugar de QString
+std::string formatar_paciente(const Patient& patient)
+{
+    int ano, mes, dia;
+    data_do_dia_juliano(patient.bday, ano, mes, dia);
+    char data[16];
+    std::snprintf(data, sizeof(data), "%02d/%02d/%04d", dia, mes, ano);
+    std::string info;
+    info += "ID: " + std::to_string(patient.id) + "\n";
+    info += "Nome: " + patient.name + "\n";
+    info += "CPF: " + patient.cpf + "\n";
+    info += "Email: " + patient.email + "\n";
+    info += "Data de Nascimento: " + std::string(data) + "\n";
+    info += "Idade: " + std::to_string(calcular_idade(patient.bday, dia_juliano_hoje())) + "\n";
+    info += "Sintomas: ";
+    if (patient.sintomas & TOSSE)       info += "TOSSE ";
+    if (patient.sintomas & NAUSEA)      info += "NÁUSEA ";
+    if (patient.sintomas & FEBRE)       info += "FEBRE ";
+    if (patient.sintomas & DISENTERIA)  info += "DISENTERIA ";
+    if (patient.sintomas & INFECCAO)    info += "INFECÇÃO ";
+    if (patient.sintomas & COVID)       info += "COVID ";
+    if (patient.sintomas & AVC)         info += "AVC ";
+    if (patient.sintomas & ACIDENTE)    info += "ACIDENTE ";
+    info += "\n-----------------------------\n";
+    return info;
+}
+
+} // namespace legado
+
+// Resultado de uma medição
+struct Medida {
+    std::string operacao;
+    std::string implementacao;
+    std::size_t n;
+    std::size_t ops;
+    double ns_por_op;
+    double alocacoes_por_op;
+    double falhas_cache_por_op; // -1 se o contador não estiver disponível
+};
+
+// Memória ocupada por paciente em uma organização dos dados
+struct Memoria {
+    std::string implementacao;
+    std::size_t n;
+    double bytes_por_paciente;
+};
+
+// Percentis da espera, em passos, com uma política de envelhecimento
+struct Espera {
+    std::string politica;
+    std::int64_t passos_por_nivel;
+    std::size_t chegadas;
+    std::int64_t p50;
+    std::int64_t p99;
+    std::int64_t maximo;
+    std::int64_t pior_classe_p99; // p99 da classe de sintomas que mais espera
+};
+
+std::vector<Medida> medidas;
+std::vector<Memoria> memorias;
+std::vector<Espera> esperas;
+
+void registrar_memoria(const char* implementacao, std::size_t n, std::size_t bytes)
+{
+    Memoria m{implementacao, n, static_cast<double>(bytes) / n};
+    std::printf("%-28s %-12s %10zu %25.1f bytes/paciente\n", "memoria", implementacao, n, m.bytes_por_paciente);
+    memorias.push_back(std::move(m));
+}
+
+/**
+ * @brief Executa f uma vez, contando ops operações, e registra a medição.
+ * O valor retornado por f é acumulado para que o compilador não descarte o trabalho.
+ */
+template <typename F>
+void medir(const char* operacao, const char* implementacao, std::size_t n, std::size_t ops, F&& f)
+{
+    static volatile std::size_t sumidouro = 0;
+    std::size_t alocacoes_antes = alocacoes.load(std::memory_order_relaxed);
+    long long falhas_antes = falhas_cache.ler();
+    auto inicio = std::chrono::steady_clock::now();
+    sumidouro = sumidouro + f();
+    auto fim = std::chrono::steady_clock::now();
+    long long falhas_depois = falhas_cache.ler();
+    std::size_t alocadas = alocacoes.load(std::memory_order_relaxed) - alocacoes_antes;
+
+    double ns = std::chrono::duration<double, std::nano>(fim - inicio).count();
+    double falhas = falhas_antes < 0 || falhas_depois < 0
+                        ? -1.0
+                        : static_cast<double>(falhas_depois - falhas_antes) / ops;
+    Medida m{operacao, implementacao, n, ops, ns / ops, static_cast<double>(alocadas) / ops, falhas};
+    char texto_falhas[32] = "n/d";
+    if (falhas >= 0) {
+        std::snprintf(texto_falhas, sizeof(texto_falhas), "%.2f", falhas);
+    }
+    std::printf("%-28s %-12s %10zu %10zu %14.1f %10.2f %14.0f %12s\n", m.operacao.c_str(), m.implementacao.c_str(),
+                m.n, m.ops, m.ns_por_op, m.alocacoes_por_op, 1e9 / m.ns_por_op, texto_falhas);
+    std::fflush(stdout);
+    medidas.push_back(std::move(m));
+}
+
+// Mede o motor atual e seus componentes com n pacientes
+void medir_triagem(const std::vector<Registro>& registros, std::size_t consultas, std::size_t sequenciais)
+{
+    const std::size_t n = registros.size();
+    Gerador gerador(n * 31 + 7);
+    Triagem triagem;
+
+    std::size_t bytes_antes = bytes_vivos.load(std::memory_order_relaxed);
+    medir("admitir", "triagem", n, n, [&] {
+        std::size_t admitidos = 0;
+        for (const Registro& r : registros) {
+            admitidos += triagem.admitir(r.name, r.cpf, r.email, r.bday, r.sintomas) == Triagem::ADMITIDO;
+        }
+        return admitidos;
+    });
+    registrar_memoria("triagem", n, bytes_vivos.load(std::memory_order_relaxed) - bytes_antes);
+
+    // Importação em lote dos mesmos pacientes a partir de um CSV em memória
+    std::string csv = "nome,cpf,email,nascimento,sintomas\n";
+    for (const Registro& r : registros) {
+        int ano, mes, dia;
+        char data[16];
+        data_do_dia_juliano(r.bday, ano, mes, dia);
+        std::snprintf(data, sizeof(data), "%02d/%02d/%04d", dia, mes, ano);
+        csv += r.name + "," + r.cpf + "," + r.email + "," + data + "," + std::to_string(r.sintomas) + "\n";
+    }
+    medir("importar_csv", "triagem", n, n, [&] {
+        Triagem importada;
+        return importar(importada, csv).admitidos;
+    });
+
+    // Validação dos CPFs um a um e em lote, com o mesmo resultado
+    std::vector<std::string_view> cpfs;
+    cpfs.reserve(n);
+    for (const Registro& r : registros) {
+        cpfs.push_back(r.cpf);
+    }
+    std::vector<std::uint64_t> chaves(n);
+    medir("validar_cpf", "cpf", n, n, [&] {
+        std::size_t validos = 0;
+        for (std::string_view cpf : cpfs) {
+            validos += cpf_para_chave(cpf.data(), cpf.size()) != CPF_INVALIDO;
+        }
+        return validos;
+    });
+    medir("validar_cpf_lote", "cpf", n, n, [&] { return cpfs_para_chaves(cpfs.data(), cpfs.size(), chaves.data()); });
+
+    medir("buscar_cpf", "triagem", n, consultas, [&] {
+        std::size_t achados = 0;
+        for (std::size_t q = 0; q < consultas; ++q) {
+            achados += triagem.buscar_cpf(registros[gerador.abaixo(n)].cpf) != -1;
+        }
+        return achados;
+    });
+
+    medir("buscar_nome", "triagem", n, consultas, [&] {
+        std::size_t achados = 0;
+        for (std::size_t q = 0; q < consultas; ++q) {
+            achados += triagem.buscar_nome(registros[gerador.abaixo(n)].name).size();
+        }
+        return achados;
+    });
+
+    medir("buscar_nome_sequencial", "triagem", n, sequenciais, [&] {
+        std::size_t achados = 0;
+        for (std::size_t q = 0; q < sequenciais; ++q) {
+            achados += triagem.buscar_nome_sequencial(registros[gerador.abaixo(n)].name) != -1;
+        }
+        return achados;
+    });
+
+    const std::size_t aproximadas = std::min<std::size_t>(consultas, 1000);
+    medir("buscar_aproximado", "triagem", n, aproximadas, [&] {
+        std::size_t achados = 0;
+        for (std::size_t q = 0; q < aproximadas; ++q) {
+            achados += triagem.buscar_aproximado(com_erro(registros[gerador.abaixo(n)].name, gerador), 20).size();
+        }
+        return achados;
+    });
+
+    medir("primeiros(5)", "triagem", n, consultas, [&] {
+        std::size_t total = 0;
+        for (std::size_t q = 0; q < consultas; ++q) {
+            total += triagem.primeiros(5).size();
+        }
+        return total;
+    });
+
+    medir("listar", "triagem", n, 1, [&] { return triagem.listar().size(); });
+
+    // Remove pacientes distintos, escolhidos por um passo primo com n
+    const std::size_t remocoes = std::min(consultas, n);
+    medir("remover", "triagem", n, remocoes, [&] {
+        std::size_t removidos = 0;
+        for (std::size_t q = 0; q < remocoes; ++q) {
+            removidos += triagem.remover(registros[(q * 7919) % n].cpf);
+        }
+        return removidos;
+    });
+
+    // Inserção e retirada do topo diretamente na fila de prioridade
+    FilaPrioridade fila;
+    medir("inserir", "filaprioridade", n, n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            fila.inserir(static_cast<int>(i), registros[i].sintomas, static_cast<int>(i));
+        }
+        return fila.tamanho();
+    });
+    medir("remover_topo", "filaprioridade", n, n, [&] {
+        std::size_t soma = 0;
+        while (!fila.vazia()) {
+            soma += static_cast<std::size_t>(fila.remover_topo());
+        }
+        return soma;
+    });
+
+    // Custo da telemetria nos caminhos de admissão e tratamento
+    Histograma histograma;
+    medir("registrar", "histograma", n, n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            histograma.registrar(static_cast<std::int64_t>(registros[i].bday) * 1000003);
+        }
+        return static_cast<std::size_t>(histograma.quantidade());
+    });
+    Telemetria telemetria;
+    Triagem medida;
+    medida.medir_em(&telemetria);
+    medir("admitir_medido", "triagem", n, n, [&] {
+        std::size_t admitidos = 0;
+        for (const Registro& r : registros) {
+            admitidos += medida.admitir(r.name, r.cpf, r.email, r.bday, r.sintomas) == Triagem::ADMITIDO;
+        }
+        return admitidos;
+    });
+    medir("chamado", "telemetria", n, n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            telemetria.chamado(static_cast<int>(i), registros[i].sintomas);
+        }
+        return static_cast<std::size_t>(telemetria.espera_total().quantidade());
+    });
+}
+
+/**
+ * @brief Mede a admissão concorrente de n pacientes por 1, 2, 4 e 8 guichês.
+ * O dono da triagem avança o tratamento a cada milissegundo e um thread de
+ * consulta lê os retratos sem parar, para mostrar que nenhum dos dois segura
+ * os guichês. Termina quando o último retrato contém todas as admissões.
+ */
+void medir_recepcao(const std::vector<Registro>& registros)
+{
+    const std::size_t n = registros.size();
+    for (unsigned guiches = 1; guiches <= 8; guiches *= 2) {
+        Triagem triagem;
+        Recepcao recepcao(triagem);
+        recepcao.iniciar(std::chrono::milliseconds(1));
+        std::atomic<bool> fim{false};
+        std::size_t leituras = 0;
+        std::thread consulta([&] {
+            while (!fim.load(std::memory_order_relaxed)) {
+                std::shared_ptr<const Retrato> retrato = recepcao.retrato();
+                leituras += retrato->fila.empty() ? 1 : retrato->buscar_cpf(retrato->fila.back().cpf) >= 0;
+            }
+        });
+
+        std::string implementacao = "recepcao_" + std::to_string(guiches);
+        std::size_t admitidos = 0;
+        medir("admitir_concorrente", implementacao.c_str(), n, n, [&] {
+            std::vector<std::thread> produtores;
+            for (unsigned g = 0; g < guiches; ++g) {
+                produtores.emplace_back([&, g] {
+                    for (std::size_t i = g; i < n; i += guiches) {
+                        const Registro& r = registros[i];
+                        while (recepcao.admitir(r.name, r.cpf, r.email, r.bday, r.sintomas) == Recepcao::CHEIA) {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+            for (std::thread& produtor : produtores) {
+                produtor.join();
+            }
+            recepcao.sincronizar();
+            admitidos = recepcao.retrato()->admitidos;
+            return admitidos;
+        });
+        fim.store(true);
+        consulta.join();
+        recepcao.parar();
+        if (admitidos != n) {
+            std::printf("recepcao_%u: %zu de %zu pacientes admitidos\n", guiches, admitidos, n);
+        }
+        std::printf("%-28s %-12s %10zu %10zu retratos lidos durante a admissão\n", "consultas",
+                    implementacao.c_str(), n, leituras);
+    }
+}
+
+/**
+ * @brief Mede as consultas e contagens de sintomas sobre n pacientes, pelo índice (mapas de bits
+ * e contagens por combinação) e pela varredura dos sintomas de cada paciente, conferindo que os
+ * resultados coincidem.
+ * Cada sintoma aparece em cerca de 15% dos pacientes e os últimos 10% estão na fila.
+ */
+void medir_sintomas(std::size_t n)
+{
+    Gerador gerador(7);
+    std::vector<std::uint8_t> sintomas(n);
+    IndiceSintomas indice;
+    indice.reservar(n);
+    for (std::size_t id = 0; id < n; ++id) {
+        std::uint64_t sorteio = gerador.proximo();
+        unsigned s = 0;
+        for (int bit = 0; bit < 8; ++bit) {
+            s |= ((sorteio >> (8 * bit)) & 0xFF) < 38 ? 1u << bit : 0;
+        }
+        sintomas[id] = static_cast<std::uint8_t>(s);
+        indice.adicionar(static_cast<int>(id), s, id >= n - n / 10);
+    }
+    registrar_memoria("indice_sintomas", n, indice.bytes());
+
+    // "COVID e FEBRE, sem AVC" entre todos os pacientes
+    IndiceSintomas::Consulta consulta;
+    consulta.todos = COVID | FEBRE;
+    consulta.nenhum = AVC;
+    consulta.escopo = IndiceSintomas::TODOS;
+    std::size_t por_indice = 0, por_varredura = 0;
+    medir("contar_sintomas", "bitmap", n, 1, [&] { return por_indice = indice.contar(consulta); });
+    medir("contar_sintomas", "varredura", n, 1, [&] {
+        por_varredura = 0;
+        for (std::uint8_t s : sintomas) {
+            por_varredura += (s & (COVID | FEBRE)) == (COVID | FEBRE) && !(s & AVC);
+        }
+        return por_varredura;
+    });
+
+    // Coocorrência dos sintomas entre os pacientes que já saíram da fila
+    IndiceSintomas::Matriz matriz{}, matriz_varredura{};
+    medir("coocorrencia", "combinacoes", n, 1, [&] {
+        matriz = indice.coocorrencia(IndiceSintomas::HISTORICO);
+        return static_cast<std::size_t>(matriz[0][0]);
+    });
+    medir("coocorrencia", "varredura", n, 1, [&] {
+        // Conta as combinações de sintomas e depois os pares de cada combinação
+        std::uint64_t combinacoes[256] = {};
+        for (std::size_t id = 0; id < n - n / 10; ++id) {
+            combinacoes[sintomas[id]]++;
+        }
+        matriz_varredura = IndiceSintomas::Matriz{};
+        for (unsigned s = 0; s < 256; ++s) {
+            for (int i = 0; i < 8; ++i) {
+                for (int j = 0; j < 8; ++j) {
+                    if ((s >> i & 1) && (s >> j & 1)) {
+                        matriz_varredura[i][j] += combinacoes[s];
+                    }
+                }
+            }
+        }
+        return static_cast<std::size_t>(matriz_varredura[0][0]);
+    });
+
+    if (por_indice != por_varredura || matriz != matriz_varredura) {
+        std::printf("%-28s %-12s %10zu   divergência entre o índice e a varredura\n", "sintomas", "bitmap", n);
+    }
+}
+
+/**
+ * @brief Mede o selamento do histórico de n pacientes que já saíram da fila e as consultas
+ * sobre ele: uma faixa de 1% dos IDs, que descarta os demais segmentos pelo cabeçalho, e um
+ * filtro de sintomas sobre todos os segmentos, comparados com a varredura do armazenamento.
+ * Os segmentos têm n/64 pacientes, para que qualquer n sele vários segmentos; a memória do
+ * armazenamento é registrada antes e depois do selamento, que descarta os textos selados.
+ */
+void medir_historico(const std::vector<Registro>& registros)
+{
+    const std::size_t n = registros.size();
+    const std::string diretorio = (std::filesystem::temp_directory_path() / "b1_bench_historico").string();
+    std::error_code erro;
+    std::filesystem::remove_all(diretorio, erro);
+
+    Triagem triagem;
+    for (const Registro& r : registros) {
+        triagem.admitir(r.name, r.cpf, r.email, r.bday, r.sintomas);
+    }
+    for (const Registro& r : registros) {
+        triagem.remover(r.cpf);
+    }
+    Historico historico(diretorio, std::max<std::size_t>(n / 64, 1));
+    if (!historico.abrir()) {
+        std::printf("%-28s %-12s %10zu   não foi possível abrir %s\n", "historico", "segmentos", n, diretorio.c_str());
+        return;
+    }
+    registrar_memoria("armazem", n, triagem.pacientes().bytes());
+    medir("selar_historico", "segmentos", n, n, [&] {
+        return triagem.arquivar_em(&historico) ? historico.selados() : 0;
+    });
+    registrar_memoria("armazem_selado", n, triagem.pacientes().bytes());
+    registrar_memoria("historico_disco", n, historico.bytes_em_disco());
+
+    const ArmazemPacientes& pacientes = triagem.pacientes();
+    auto varrer = [&](const Historico::Consulta& consulta) {
+        std::size_t encontrados = 0;
+        for (std::size_t i = 0; i < triagem.admitidos(); ++i) {
+            int id = static_cast<int>(i);
+            unsigned s = pacientes.sintomas(id);
+            encontrados += id >= consulta.primeiro_id && id <= consulta.ultimo_id &&
+                           (s & consulta.todos) == consulta.todos && (s & consulta.nenhum) == 0 &&
+                           pacientes.cpf(id) != 0;
+        }
+        return encontrados;
+    };
+
+    Historico::Consulta faixa;
+    faixa.primeiro_id = static_cast<int>(n / 2);
+    faixa.ultimo_id = static_cast<int>(n / 2 + n / 100);
+    Historico::Consulta sintomas;
+    sintomas.todos = COVID | FEBRE;
+    sintomas.nenhum = AVC;
+    const struct {
+        const char* operacao;
+        const Historico::Consulta& consulta;
+    } consultas[] = {{"historico_faixa_1pc", faixa}, {"historico_sintomas", sintomas}};
+    for (const auto& c : consultas) {
+        std::size_t por_segmentos = 0, por_varredura = 0;
+        Historico::Resultado resultado;
+        medir(c.operacao, "segmentos", n, 1, [&] {
+            resultado = historico.consultar(triagem, c.consulta, [&](const Historico::Registro& r) {
+                por_segmentos += r.cpf != 0;
+            });
+            return resultado.registros;
+        });
+        medir(c.operacao, "varredura", n, 1, [&] { return por_varredura = varrer(c.consulta); });
+        std::printf("%-28s %-12s %10zu   %zu segmentos lidos, %zu pulados%s\n", c.operacao, "segmentos", n,
+                    resultado.segmentos_lidos, resultado.segmentos_pulados,
+                    por_segmentos == por_varredura ? "" : ", divergência com a varredura");
+    }
+    std::filesystem::remove_all(diretorio, erro);
+}
+
+/**
+ * @brief Compara as contagens e listagens por faixa de idade pelo índice de nascimentos com a
+ * varredura da fila calculando a idade de cada paciente. Metade dos pacientes sai da fila antes.
+ */
+void medir_nascimentos(const std::vector<Registro>& registros)
+{
+    const std::size_t n = registros.size();
+    Triagem triagem;
+    for (const Registro& r : registros) {
+        triagem.admitir(r.name, r.cpf, r.email, r.bday, r.sintomas);
+    }
+    for (std::size_t i = 0; i < n; i += 2) {
+        triagem.remover(registros[i].cpf);
+    }
+    const ArmazemPacientes& pacientes = triagem.pacientes();
+    const IndiceNascimento& indice = triagem.nascimentos();
+    const long long hoje = dia_juliano_hoje();
+    const std::size_t consultas = 1000;
+
+    // "Esperando com 60 anos ou mais" e a faixa estreita de 30 a 31 anos
+    const struct {
+        const char* operacao;
+        int idade_minima;
+        int idade_maxima;
+    } faixas[] = {{"idade_60_mais", 60, 200}, {"idade_30_31", 30, 31}};
+    for (const auto& f : faixas) {
+        std::size_t por_indice = 0, listados = 0, por_varredura = 0;
+        medir((std::string("contar_") + f.operacao).c_str(), "fenwick", n, consultas, [&] {
+            for (std::size_t c = 0; c < consultas; ++c) {
+                por_indice = indice.contar_idade(f.idade_minima, f.idade_maxima, hoje, IndiceSintomas::FILA);
+            }
+            return por_indice;
+        });
+        // A primeira listagem paga as falhas de página do vetor de resultados; mede as seguintes
+        indice.buscar_idade(f.idade_minima, f.idade_maxima, hoje, IndiceSintomas::FILA);
+        medir((std::string("listar_") + f.operacao).c_str(), "ordenado", n, 10, [&] {
+            for (int r = 0; r < 10; ++r) {
+                listados = indice.buscar_idade(f.idade_minima, f.idade_maxima, hoje, IndiceSintomas::FILA).size();
+            }
+            return listados;
+        });
+        medir((std::string("contar_") + f.operacao).c_str(), "varredura", n, 1, [&] {
+            por_varredura = 0;
+            for (int id : triagem.listar()) {
+                int idade = calcular_idade(pacientes.nascimento(id), hoje);
+                por_varredura += idade >= f.idade_minima && idade <= f.idade_maxima;
+            }
+            return por_varredura;
+        });
+        if (por_indice != por_varredura || listados != por_varredura) {
+            std::printf("%-28s %-12s %10zu   divergência entre o índice e a varredura\n", f.operacao, "fenwick", n);
+        }
+    }
+}
+
+/**
+ * @brief Compara a formatação dos pacientes pelo Formatador, nos três formatos, com a montagem
+ * original do texto. O Formatador é esvaziado a cada 64 KB, como em uma exportação para arquivo.
+ */
+void medir_formatacao(const std::vector<Registro>& registros)
+{
+    const std::size_t n = registros.size();
+    Triagem triagem;
+    for (const Registro& r : registros) {
+        triagem.admitir(r.name, r.cpf, r.email, r.bday, r.sintomas);
+    }
+    const ArmazemPacientes& pacientes = triagem.pacientes();
+
+    medir("formatar", "legado", n, n, [&] {
+        std::size_t bytes = 0;
+        for (std::size_t id = 0; id < n; ++id) {
+            bytes += legado::formatar_paciente(triagem.paciente(static_cast<int>(id))).size();
+        }
+        return bytes;
+    });
+    const struct {
+        const char* nome;
+        Formatador::Formato formato;
+    } formatos[] = {{"texto", Formatador::TEXTO}, {"csv", Formatador::CSV}, {"json", Formatador::JSON}};
+    for (const auto& f : formatos) {
+        Formatador formatador(f.formato, dia_juliano_hoje());
+        medir("formatar", f.nome, n, n, [&] {
+            std::size_t bytes = 0;
+            formatador.comecar();
+            for (std::size_t id = 0; id < n; ++id) {
+                formatador.escrever(pacientes, static_cast<int>(id));
+                if (formatador.texto().size() >= 64 * 1024) {
+                    bytes += formatador.texto().size();
+                    formatador.limpar();
+                }
+            }
+            formatador.terminar();
+            bytes += formatador.texto().size();
+            formatador.limpar();
+            return bytes;
+        });
+    }
+}
+
+/**
+ * @brief Simula as estações da interface sob carga alta, com e sem envelhecimento.
+ * Mede o custo da simulação por chegada e registra os percentis da espera: sem
+ * envelhecimento, os pacientes com sintomas leves esperam quase indefinidamente.
+ */
+void medir_esperas(std::size_t quantidade)
+{
+    ModeloChegadas modelo;
+    modelo.taxa = 0.105; // Cerca de 93% da capacidade das três estações
+    modelo.sintomas.fill(0.1);
+    std::vector<Chegada> chegadas = gerar_chegadas(modelo, quantidade, 42);
+
+    const struct {
+        const char* politica;
+        std::int64_t passos_por_nivel;
+    } politicas[] = {{"sem_envelh", 0}, {"envelh_600", 600}, {"envelh_60", 60}, {"envelh_30", 30}};
+    for (const auto& politica : politicas) {
+        Cenario cenario{"interface", {0, 0, AVC | ACIDENTE}, politica.passos_por_nivel};
+        ResultadoSimulacao resultado;
+        medir("simular", politica.politica, quantidade, quantidade, [&] {
+            resultado = simular(cenario, chegadas);
+            return static_cast<std::size_t>(resultado.atendidos);
+        });
+        Espera e{politica.politica, politica.passos_por_nivel, quantidade, resultado.espera.percentil(50),
+                 resultado.espera.percentil(99), resultado.espera.maximo(), resultado.pior_classe(99)};
+        std::printf("%-28s %-12s %10zu   espera p50 %lld, p99 %lld, max %lld, pior classe p99 %lld passos\n",
+                    "espera", e.politica.c_str(), e.chegadas, static_cast<long long>(e.p50),
+                    static_cast<long long>(e.p99), static_cast<long long>(e.maximo),
+                    static_cast<long long>(e.pior_classe_p99));
+        esperas.push_back(std::move(e));
+    }
+}
+
+// Mede os algoritmos originais com n pacientes
+void medir_legado(const std::vector<Registro>& registros, std::size_t consultas, std::size_t sequenciais,
+                  std::size_t max_quadratico)
+{
+    const std::size_t n = registros.size();
+    Gerador gerador(n * 31 + 7);
+
+    // A fila original era um vetor de pacientes em ordem de chegada, reordenado
+    // a cada inserção, e cada paciente também era copiado para o relatório
+    std::size_t bytes_antes = bytes_vivos.load(std::memory_order_relaxed);
+    std::vector<Patient> fila;
+    std::vector<Patient> relatorio;
+    for (std::size_t i = 0; i < n; ++i) {
+        const Registro& r = registros[i];
+        fila.push_back(Patient(static_cast<int>(i), r.name, r.cpf, r.email, r.bday, r.sintomas));
+        relatorio.push_back(fila.back());
+    }
+    registrar_memoria("legado", n, bytes_vivos.load(std::memory_order_relaxed) - bytes_antes);
+    relatorio.clear();
+    relatorio.shrink_to_fit();
+
+    medir("buscar_cpf", "legado", n, sequenciais, [&] {
+        std::size_t achados = 0;
+        for (std::size_t q = 0; q < sequenciais; ++q) {
+            achados += legado::buscar(fila, registros[gerador.abaixo(n)].cpf, "") != nullptr;
+        }
+        return achados;
+    });
+
+    medir("buscar_nome_sequencial", "legado", n, sequenciais, [&] {
+        std::size_t achados = 0;
+        for (std::size_t q = 0; q < sequenciais; ++q) {
+            achados += legado::buscar(fila, "", registros[gerador.abaixo(n)].name) != nullptr;
+        }
+        return achados;
+    });
+
+    // A busca binária original exigia a cópia ordenada por nome; aqui ela é
+    // preparada uma única vez, fora da medição
+    std::vector<Patient> sorted_name_fila = fila;
+    std::sort(sorted_name_fila.begin(), sorted_name_fila.end(), [](const Patient& a, const Patient& b) {
+        return legado::comparar_sem_caixa(a.name, b.name) < 0;
+    });
+    medir("binary_search", "legado", n, consultas, [&] {
+        std::size_t achados = 0;
+        for (std::size_t q = 0; q < consultas; ++q) {
+            achados += legado::binary_search(sorted_name_fila, registros[gerador.abaixo(n)].name) != -1;
+        }
+        return achados;
+    });
+    sorted_name_fila.clear();
+    sorted_name_fila.shrink_to_fit();
+
+    // As ordenações por seleção são quadráticas e só rodam nos tamanhos menores
+    if (n <= max_quadratico) {
+        medir("ordenar_paciente_nome", "legado", n, 1, [&] {
+            legado::ordenar_paciente_nome(fila, sorted_name_fila);
+            return sorted_name_fila.size();
+        });
+        medir("ordenar_paciente_sintoma", "legado", n, 1, [&] {
+            legado::ordenar_paciente_sintoma(fila);
+            return fila.size();
+        });
+
+        // Cada admissão original inseria no fim e reordenava a fila inteira
+        const std::size_t insercoes = 3;
+        medir("admitir", "legado", n, insercoes, [&] {
+            for (std::size_t q = 0; q < insercoes; ++q) {
+                const Registro& r = registros[q];
+                fila.push_back(Patient(static_cast<int>(n + q), r.name, r.cpf, r.email, r.bday, r.sintomas));
+                legado::ordenar_paciente_sintoma(fila);
+            }
+            return fila.size();
+        });
+        fila.erase(fila.begin() + n, fila.end());
+    }
+
+    const std::size_t remocoes = std::min(sequenciais, n);
+    medir("remover", "legado", n, remocoes, [&] {
+        std::size_t removidos = 0;
+        for (std::size_t q = 0; q < remocoes; ++q) {
+            removidos += legado::remover(fila, registros[(q * 7919) % n].cpf);
+        }
+        return removidos;
+    });
+
+    // Ao fim de cada tratamento o primeiro paciente era apagado do início do vetor
+    const std::size_t retiradas = std::min(sequenciais, fila.size());
+    medir("remover_topo", "legado", n, retiradas, [&] {
+        for (std::size_t q = 0; q < retiradas; ++q) {
+            fila.erase(fila.begin());
+        }
+        return fila.size();
+    });
+}
+
+bool gravar_json(const char* caminho)
+{
+    std::FILE* arquivo = std::fopen(caminho, "w");
+    if (arquivo == nullptr) {
+        return false;
+    }
+    std::fprintf(arquivo, "{\n  \"resultados\": [\n");
+    for (std::size_t i = 0; i < medidas.size(); ++i) {
+        const Medida& m = medidas[i];
+        std::fprintf(arquivo,
+                     "    {\"operacao\": \"%s\", \"implementacao\": \"%s\", \"n\": %zu, \"ops\": %zu, "
+                     "\"ns_por_op\": %.1f, \"alocacoes_por_op\": %.3f, \"ops_por_segundo\": %.0f, "
+                     "\"falhas_cache_por_op\": %.2f}%s\n",
+                     m.operacao.c_str(), m.implementacao.c_str(), m.n, m.ops, m.ns_por_op, m.alocacoes_por_op,
+                     1e9 / m.ns_por_op, m.falhas_cache_por_op, i + 1 < medidas.size() ? "," : "");
+    }
+    std::fprintf(arquivo, "  ],\n  \"memoria\": [\n");
+    for (std::size_t i = 0; i < memorias.size(); ++i) {
+        const Memoria& m = memorias[i];
+        std::fprintf(arquivo, "    {\"implementacao\": \"%s\", \"n\": %zu, \"bytes_por_paciente\": %.1f}%s\n",
+                     m.implementacao.c_str(), m.n, m.bytes_por_paciente, i + 1 < memorias.size() ? "," : "");
+    }
+    std::fprintf(arquivo, "  ],\n  \"esperas\": [\n");
+    for (std::size_t i = 0; i < esperas.size(); ++i) {
+        const Espera& e = esperas[i];
+        std::fprintf(arquivo,
+                     "    {\"politica\": \"%s\", \"passos_por_nivel\": %lld, \"chegadas\": %zu, \"p50_passos\": %lld, "
+                     "\"p99_passos\": %lld, \"max_passos\": %lld, \"pior_classe_p99_passos\": %lld}%s\n",
+                     e.politica.c_str(), static_cast<long long>(e.passos_por_nivel), e.chegadas,
+                     static_cast<long long>(e.p50), static_cast<long long>(e.p99), static_cast<long long>(e.maximo),
+                     static_cast<long long>(e.pior_classe_p99), i + 1 < esperas.size() ? "," : "");
+    }
+    std::fprintf(arquivo, "  ]\n}\n");
+    return std::fclose(arquivo) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t maximo = 1000000;        // Maior conjunto de pacientes
+    std::size_t max_quadratico = 20000;  // Maior conjunto para as ordenações quadráticas
+    const char* saida = "b1_bench.json"; // Arquivo com os resultados
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+            maximo = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--max-quadratico") == 0 && i + 1 < argc) {
+            max_quadratico = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--saida") == 0 && i + 1 < argc) {
+            saida = argv[++i];
+        } else {
+            std::fprintf(stderr, "uso: %s [--max N] [--max-quadratico N] [--saida arquivo.json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("%-28s %-12s %10s %10s %14s %10s %14s %12s\n",
+                "operacao", "impl", "n", "ops", "ns/op", "aloc/op", "ops/s", "falhas/op");
+    for (std::size_t n = 1000; n <= maximo; n *= 10) {
+        std::vector<Registro> registros = gerar_registros(n, 42);
+        const std::size_t consultas = std::min<std::size_t>(n, 10000);
+        // Varreduras lineares: limita o trabalho total a cerca de 10^8 comparações
+        const std::size_t sequenciais = std::max<std::size_t>(1, std::min<std::size_t>(1000, 100000000 / n));
+
+        medir_triagem(registros, consultas, sequenciais);
+        medir_legado(registros, consultas, sequenciais, max_quadratico);
+        medir_recepcao(registros);
+    }
+    medir_esperas(maximo);
+    medir_sintomas(10 * maximo);
+    medir_historico(gerar_registros(maximo, 42));
+    medir_formatacao(gerar_registros(maximo, 42));
+    medir_nascimentos(gerar_registros(maximo, 42));
+
+    if (!gravar_json(saida)) {
+        std::fprintf(stderr, "não foi possível gravar %s\n", saida);
+        return 1;
+    }
+    std::printf("resultados gravados em %s\n", saida);
+    return 0;
+}
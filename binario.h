@@ -0,0 +1,110 @@
+#ifndef BINARIO_H
+#define BINARIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Codifica valores em um buffer binário, na ordem de bytes da máquina.
+ * Usado pelo diário e pelos instantâneos (ver diario.h).
+ */
+class Escritor
+{
+public:
+    explicit Escritor(std::vector<char>& destino) : destino(destino) {}
+
+    void bytes(const void* dados, std::size_t tamanho)
+    {
+        if (tamanho == 0) {
+            return;
+        }
+        std::size_t inicio = destino.size();
+        destino.resize(inicio + tamanho);
+        std::memcpy(destino.data() + inicio, dados, tamanho);
+    }
+
+    void u8(std::uint8_t valor) { bytes(&valor, sizeof(valor)); }
+    void u32(std::uint32_t valor) { bytes(&valor, sizeof(valor)); }
+    void u64(std::uint64_t valor) { bytes(&valor, sizeof(valor)); }
+    void i32(std::int32_t valor) { bytes(&valor, sizeof(valor)); }
+
+    // Texto precedido do seu tamanho
+    void texto(std::string_view valor)
+    {
+        u32(static_cast<std::uint32_t>(valor.size()));
+        bytes(valor.data(), valor.size());
+    }
+
+    // Vetor de valores triviais precedido da quantidade de elementos
+    template <typename T>
+    void vetor(const std::vector<T>& valores)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "vetor() exige elementos triviais");
+        u64(valores.size());
+        bytes(valores.data(), valores.size() * sizeof(T));
+    }
+
+private:
+    std::vector<char>& destino;
+};
+
+/**
+ * @brief Decodifica valores gravados por Escritor, verificando os limites do buffer.
+ * Todas as leituras retornam false se os dados acabarem antes do esperado.
+ */
+class Leitor
+{
+public:
+    Leitor(const char* dados, std::size_t tamanho) : atual(dados), fim(dados + tamanho) {}
+
+    bool bytes(void* destino, std::size_t tamanho)
+    {
+        if (static_cast<std::size_t>(fim - atual) < tamanho) {
+            return false;
+        }
+        std::memcpy(destino, atual, tamanho);
+        atual += tamanho;
+        return true;
+    }
+
+    bool u8(std::uint8_t& valor) { return bytes(&valor, sizeof(valor)); }
+    bool u32(std::uint32_t& valor) { return bytes(&valor, sizeof(valor)); }
+    bool u64(std::uint64_t& valor) { return bytes(&valor, sizeof(valor)); }
+    bool i32(std::int32_t& valor) { return bytes(&valor, sizeof(valor)); }
+
+    // O texto aponta para o próprio buffer lido
+    bool texto(std::string_view& valor)
+    {
+        std::uint32_t tamanho;
+        if (!u32(tamanho) || static_cast<std::size_t>(fim - atual) < tamanho) {
+            return false;
+        }
+        valor = std::string_view(atual, tamanho);
+        atual += tamanho;
+        return true;
+    }
+
+    template <typename T>
+    bool vetor(std::vector<T>& valores)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "vetor() exige elementos triviais");
+        std::uint64_t quantidade;
+        if (!u64(quantidade) || quantidade > static_cast<std::size_t>(fim - atual) / sizeof(T)) {
+            return false;
+        }
+        valores.resize(quantidade);
+        return bytes(valores.data(), quantidade * sizeof(T));
+    }
+
+    std::size_t restante() const { return static_cast<std::size_t>(fim - atual); }
+
+private:
+    const char* atual;
+    const char* fim;
+};
+
+#endif // BINARIO_H
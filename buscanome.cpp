@@ -0,0 +1,465 @@
+#include "buscanome.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "binario.h"
+#include "texto.h"
+
+// Caractere que marca o início de uma palavra nos gramas (não aparece em texto normalizado)
+static const unsigned char INICIO = 0x01;
+
+// Grama de 2 caracteres com o marcador de início, usado para palavras de 1 letra
+static std::uint32_t grama_inicial(char c)
+{
+    return (2u << 24) | (INICIO << 8) | static_cast<unsigned char>(c);
+}
+
+// Trigrama formado pelos caracteres a, b e c
+static std::uint32_t trigrama(unsigned char a, unsigned char b, unsigned char c)
+{
+    return (std::uint32_t(a) << 16) | (std::uint32_t(b) << 8) | c;
+}
+
+// Trigramas distintos da palavra precedida pelo marcador de início
+static std::vector<std::uint32_t> trigramas(const std::string& palavra)
+{
+    std::vector<std::uint32_t> gramas;
+    std::string texto = static_cast<char>(INICIO) + palavra;
+    for (std::size_t i = 0; i + 2 < texto.size(); ++i) {
+        gramas.push_back(trigrama(texto[i], texto[i + 1], texto[i + 2]));
+    }
+    std::sort(gramas.begin(), gramas.end());
+    gramas.erase(std::unique(gramas.begin(), gramas.end()), gramas.end());
+    return gramas;
+}
+
+// FNV-1a de 64 bits; ao contrário de std::hash, o valor não muda entre compilações e pode ser gravado
+static std::uint64_t hash_texto(const std::string& texto)
+{
+    std::uint64_t h = 0xCBF29CE484222325ULL;
+    for (char c : texto) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// Chama f(palavra) para cada palavra de um texto normalizado, reaproveitando o mesmo texto
+template <typename F>
+static void para_cada_palavra(const std::string& texto, F f)
+{
+    std::string palavra;
+    std::size_t inicio = 0;
+    while (inicio < texto.size()) {
+        std::size_t fim = texto.find(' ', inicio);
+        if (fim == std::string::npos) {
+            fim = texto.size();
+        }
+        palavra.assign(texto, inicio, fim - inicio);
+        f(palavra);
+        inicio = fim + 1;
+    }
+}
+
+// Separa um texto normalizado em palavras
+static std::vector<std::string> palavras(const std::string& texto)
+{
+    std::vector<std::string> resultado;
+    para_cada_palavra(texto, [&](const std::string& palavra) { resultado.push_back(palavra); });
+    return resultado;
+}
+
+// Quantidade de edições toleradas para uma palavra da consulta
+static int edicoes_toleradas(std::size_t tamanho)
+{
+    if (tamanho <= 3) return 0;
+    if (tamanho <= 6) return 1;
+    return 2;
+}
+
+/**
+ * @brief Distância de edição entre a consulta e o prefixo mais próximo da palavra.
+ * @param consulta Palavra da consulta.
+ * @param palavra Início da palavra do nome.
+ * @param n Tamanho da palavra do nome.
+ * @param limite Distância máxima de interesse.
+ * @param anterior Vetor auxiliar reaproveitado entre chamadas.
+ * @param atual Vetor auxiliar reaproveitado entre chamadas.
+ * @return Distância encontrada, ou limite + 1 se ela for maior que o limite.
+ */
+static int distancia_prefixo(const std::string& consulta, const char* palavra, std::size_t n, int limite,
+                             std::vector<int>& anterior, std::vector<int>& atual)
+{
+    anterior.resize(n + 1);
+    atual.resize(n + 1);
+    for (std::size_t j = 0; j <= n; ++j) {
+        anterior[j] = static_cast<int>(j);
+    }
+
+    for (std::size_t i = 1; i <= consulta.size(); ++i) {
+        atual[0] = static_cast<int>(i);
+        int menor_da_linha = atual[0];
+        for (std::size_t j = 1; j <= n; ++j) {
+            int custo = consulta[i - 1] == palavra[j - 1] ? 0 : 1;
+            atual[j] = std::min({anterior[j] + 1, atual[j - 1] + 1, anterior[j - 1] + custo});
+            menor_da_linha = std::min(menor_da_linha, atual[j]);
+        }
+        if (menor_da_linha > limite) {
+            return limite + 1; // Nenhum prefixo pode ficar dentro do limite
+        }
+        anterior.swap(atual);
+    }
+
+    // Qualquer prefixo da palavra serve: pega a menor distância da última linha
+    int distancia = *std::min_element(anterior.begin(), anterior.end());
+    return std::min(distancia, limite + 1);
+}
+
+std::uint32_t BuscaNome::palavra_do_vocabulario(const std::string& texto)
+{
+    auto it = palavra_por_texto.find(texto);
+    if (it != palavra_por_texto.end()) {
+        return it->second;
+    }
+
+    // Palavra nova: entra no vocabulário e nas listas dos seus gramas
+    std::uint32_t palavra = static_cast<std::uint32_t>(vocabulario.size());
+    vocabulario.push_back(Palavra{texto, {}});
+    palavra_por_texto.emplace(texto, palavra);
+    listas[grama_inicial(texto[0])].push_back(palavra);
+    for (std::uint32_t grama : trigramas(texto)) {
+        listas[grama].push_back(palavra); // Palavras entram em ordem crescente, mantendo as listas ordenadas
+    }
+    return palavra;
+}
+
+void BuscaNome::indexar(int id, const std::string& nome)
+{
+    remover(id); // Desativa o documento anterior do mesmo ID, se houver
+
+    std::string normalizado = normalizar(nome);
+    std::uint32_t doc = static_cast<std::uint32_t>(doc_id.size());
+    doc_id.push_back(id);
+    doc_tamanho.push_back(static_cast<std::uint32_t>(normalizado.size()));
+    doc_hash.push_back(hash_texto(normalizado));
+    doc_inicio.push_back(static_cast<std::uint32_t>(doc_palavras.size()));
+    doc_ativo.push_back(true);
+    if (static_cast<std::size_t>(id) >= documento_por_id.size()) {
+        documento_por_id.resize(static_cast<std::size_t>(id) + 1, SEM_DOCUMENTO);
+    }
+    documento_por_id[id] = doc;
+    ativos++;
+
+    // Associa o documento a cada palavra do nome
+    para_cada_palavra(normalizado, [&](const std::string& texto) {
+        std::uint32_t palavra = palavra_do_vocabulario(texto);
+        std::vector<std::uint32_t>& lista = vocabulario[palavra].documentos;
+        if (lista.empty() || lista.back() != doc) {
+            lista.push_back(doc); // Documentos entram em ordem crescente, mantendo a lista ordenada
+            doc_palavras.push_back(palavra);
+        }
+    });
+}
+
+void BuscaNome::remover(int id)
+{
+    if (id >= 0 && static_cast<std::size_t>(id) < documento_por_id.size() && documento_por_id[id] != SEM_DOCUMENTO) {
+        doc_ativo[documento_por_id[id]] = false; // As listas de documentos ignoram documentos inativos
+        documento_por_id[id] = SEM_DOCUMENTO;
+        ativos--;
+    }
+}
+
+/**
+ * @brief Palavras do vocabulário que têm um prefixo próximo do termo.
+ * Uma palavra precisa compartilhar pelo menos (gramas - 3 * edições) trigramas
+ * com o termo, e portanto aparece em pelo menos uma das (gramas - mínimo + 1)
+ * listas mais curtas; as demais listas servem só para contar as ocorrências.
+ * @param termo Palavra da consulta.
+ * @param edicoes Edições toleradas.
+ * @return Palavras compatíveis, ordenadas pela posição no vocabulário.
+ */
+std::vector<BuscaNome::Compativel> BuscaNome::compativeis(const std::string& termo, int edicoes) const
+{
+    static const std::vector<std::uint32_t> vazia;
+
+    std::vector<std::uint32_t> gramas;
+    int minimo = 1;
+    if (termo.size() == 1) {
+        gramas.push_back(grama_inicial(termo[0])); // Termo de 1 letra: apenas o início da palavra
+    }
+    else {
+        gramas = trigramas(termo);
+        minimo = std::max(1, static_cast<int>(gramas.size()) - 3 * edicoes);
+    }
+
+    // Listas de palavras de cada grama, da mais curta para a mais longa
+    std::vector<const std::vector<std::uint32_t>*> selecionadas;
+    for (std::uint32_t grama : gramas) {
+        auto it = listas.find(grama);
+        selecionadas.push_back(it != listas.end() ? &it->second : &vazia);
+    }
+    std::sort(selecionadas.begin(), selecionadas.end(),
+              [](const std::vector<std::uint32_t>* a, const std::vector<std::uint32_t>* b) {
+                  return a->size() < b->size();
+              });
+
+    std::vector<std::uint32_t> candidatas;
+    std::size_t sementes = selecionadas.size() - minimo + 1;
+    for (std::size_t i = 0; i < sementes; ++i) {
+        candidatas.insert(candidatas.end(), selecionadas[i]->begin(), selecionadas[i]->end());
+    }
+    if (sementes > 1) {
+        std::sort(candidatas.begin(), candidatas.end());
+        candidatas.erase(std::unique(candidatas.begin(), candidatas.end()), candidatas.end());
+    }
+
+    std::vector<Compativel> resultado;
+    std::vector<int> anterior, atual;
+    for (std::uint32_t palavra : candidatas) {
+        // Conta em quantas listas a palavra aparece, parando assim que o mínimo for atingido
+        if (minimo > 1) {
+            int presentes = 0;
+            int restantes = static_cast<int>(selecionadas.size());
+            for (const std::vector<std::uint32_t>* lista : selecionadas) {
+                if (presentes >= minimo || presentes + restantes < minimo) {
+                    break;
+                }
+                if (std::binary_search(lista->begin(), lista->end(), palavra)) {
+                    presentes++;
+                }
+                restantes--;
+            }
+            if (presentes < minimo) {
+                continue;
+            }
+        }
+
+        const std::string& texto = vocabulario[palavra].texto;
+        int distancia = distancia_prefixo(termo, texto.data(), texto.size(), edicoes, anterior, atual);
+        if (distancia <= edicoes) {
+            resultado.push_back(Compativel{palavra, distancia, texto == termo});
+        }
+    }
+    return resultado;
+}
+
+/**
+ * @brief Executa uma passada da busca.
+ * @param termos Palavras da consulta normalizada.
+ * @param normalizada Consulta normalizada.
+ * @param aproximada false para exigir prefixos exatos, true para tolerar edições.
+ * @param limite Quantidade máxima de resultados.
+ * @return Resultados ordenados por relevância.
+ */
+std::vector<BuscaNome::Resultado> BuscaNome::buscar_termos(const std::vector<std::string>& termos, const std::string& normalizada,
+                                                           bool aproximada, std::size_t limite) const
+{
+    struct Candidato {
+        Resultado resultado;
+        int completas;         // Palavras da consulta iguais a uma palavra inteira do nome
+        std::size_t tamanho;   // Tamanho do nome normalizado
+    };
+
+    // Palavras do vocabulário compatíveis com cada termo e quantos documentos elas alcançam
+    std::vector<std::vector<Compativel>> por_termo;
+    std::size_t seletivo = 0;
+    std::size_t menor_alcance = 0;
+    for (std::size_t i = 0; i < termos.size(); ++i) {
+        int edicoes = aproximada ? edicoes_toleradas(termos[i].size()) : 0;
+        por_termo.push_back(compativeis(termos[i], edicoes));
+        if (por_termo.back().empty()) {
+            return {}; // Algum termo não casa com nenhuma palavra
+        }
+
+        std::size_t alcance = 0;
+        for (const Compativel& c : por_termo.back()) {
+            alcance += vocabulario[c.palavra].documentos.size();
+        }
+        if (i == 0 || alcance < menor_alcance) {
+            menor_alcance = alcance;
+            seletivo = i;
+        }
+    }
+
+    // Os candidatos são os documentos das palavras compatíveis com o termo mais seletivo
+    std::vector<std::uint32_t> candidatos;
+    candidatos.reserve(menor_alcance);
+    for (const Compativel& c : por_termo[seletivo]) {
+        const std::vector<std::uint32_t>& lista = vocabulario[c.palavra].documentos;
+        candidatos.insert(candidatos.end(), lista.begin(), lista.end());
+    }
+    if (por_termo[seletivo].size() > 1) {
+        std::sort(candidatos.begin(), candidatos.end());
+        candidatos.erase(std::unique(candidatos.begin(), candidatos.end()), candidatos.end());
+    }
+
+    // Um nome é exato se tiver as mesmas palavras da consulta; o hash evita comparar textos
+    const std::uint64_t hash_consulta = hash_texto(normalizada);
+
+    std::vector<Candidato> encontrados;
+    for (std::uint32_t doc : candidatos) {
+        if (!doc_ativo[doc]) {
+            continue;
+        }
+        const std::uint32_t* inicio = doc_palavras.data() + doc_inicio[doc];
+        const std::uint32_t* fim = doc_palavras.data() +
+            (doc + 1 < doc_inicio.size() ? doc_inicio[doc + 1] : doc_palavras.size());
+
+        // Cada termo precisa casar com alguma palavra do nome
+        int distancia = 0;
+        int completas = 0;
+        bool casou = true;
+        for (const std::vector<Compativel>& compativeis_termo : por_termo) {
+            int melhor = -1;
+            bool completa = false;
+            for (const std::uint32_t* p = inicio; p != fim; ++p) {
+                std::uint32_t palavra = *p;
+                auto it = std::lower_bound(compativeis_termo.begin(), compativeis_termo.end(), palavra,
+                                           [](const Compativel& c, std::uint32_t p) { return c.palavra < p; });
+                if (it != compativeis_termo.end() && it->palavra == palavra &&
+                    (melhor == -1 || it->distancia < melhor || (it->distancia == melhor && it->completa))) {
+                    melhor = it->distancia;
+                    completa = it->completa;
+                }
+            }
+            if (melhor == -1) {
+                casou = false;
+                break;
+            }
+            distancia += melhor;
+            completas += completa ? 1 : 0;
+        }
+
+        if (casou) {
+            bool exato = doc_hash[doc] == hash_consulta && doc_tamanho[doc] == normalizada.size() &&
+                         completas == static_cast<int>(termos.size()) &&
+                         static_cast<std::size_t>(fim - inicio) == termos.size();
+            Resultado resultado{doc_id[doc], distancia, exato};
+            encontrados.push_back(Candidato{resultado, completas, doc_tamanho[doc]});
+        }
+    }
+
+    // Ordena por relevância: nome exato, menos edições, mais palavras completas, nome mais curto, chegada
+    auto mais_relevante = [](const Candidato& a, const Candidato& b) {
+        if (a.resultado.exato != b.resultado.exato) return a.resultado.exato;
+        if (a.resultado.distancia != b.resultado.distancia) return a.resultado.distancia < b.resultado.distancia;
+        if (a.completas != b.completas) return a.completas > b.completas;
+        if (a.tamanho != b.tamanho) return a.tamanho < b.tamanho;
+        return a.resultado.id < b.resultado.id;
+    };
+    std::size_t quantidade = std::min(limite, encontrados.size());
+    std::partial_sort(encontrados.begin(), encontrados.begin() + quantidade, encontrados.end(), mais_relevante);
+
+    std::vector<Resultado> resultados;
+    resultados.reserve(quantidade);
+    for (std::size_t i = 0; i < quantidade; ++i) {
+        resultados.push_back(encontrados[i].resultado);
+    }
+    return resultados;
+}
+
+std::vector<BuscaNome::Resultado> BuscaNome::buscar(const std::string& consulta, std::size_t limite) const
+{
+    std::string normalizada = normalizar(consulta);
+    std::vector<std::string> termos = palavras(normalizada);
+    if (termos.empty() || limite == 0) {
+        return {};
+    }
+
+    // Primeiro procura prefixos exatos, que alcançam bem menos documentos. Resultados
+    // aproximados têm pelo menos uma edição e ficariam depois de todos eles, então a
+    // busca aproximada só é necessária se os prefixos exatos não preencherem o limite.
+    std::vector<Resultado> resultados = buscar_termos(termos, normalizada, false, limite);
+    if (resultados.size() < limite) {
+        resultados = buscar_termos(termos, normalizada, true, limite);
+    }
+    return resultados;
+}
+
+void BuscaNome::salvar(Escritor& saida) const
+{
+    saida.vetor(doc_id);
+    saida.vetor(doc_tamanho);
+    saida.vetor(doc_hash);
+    saida.vetor(doc_inicio);
+    saida.vetor(doc_palavras);
+    saida.vetor(std::vector<std::uint8_t>(doc_ativo.begin(), doc_ativo.end()));
+
+    saida.u64(vocabulario.size());
+    for (const Palavra& palavra : vocabulario) {
+        saida.texto(palavra.texto);
+        saida.vetor(palavra.documentos);
+    }
+}
+
+bool BuscaNome::carregar(Leitor& entrada)
+{
+    BuscaNome nova;
+    std::vector<std::uint8_t> ativos_gravados;
+    std::uint64_t palavras_vocabulario;
+    if (!entrada.vetor(nova.doc_id) || !entrada.vetor(nova.doc_tamanho) || !entrada.vetor(nova.doc_hash) ||
+        !entrada.vetor(nova.doc_inicio) || !entrada.vetor(nova.doc_palavras) || !entrada.vetor(ativos_gravados) ||
+        !entrada.u64(palavras_vocabulario)) {
+        return false;
+    }
+
+    const std::size_t documentos = nova.doc_id.size();
+    if (nova.doc_tamanho.size() != documentos || nova.doc_hash.size() != documentos ||
+        nova.doc_inicio.size() != documentos || ativos_gravados.size() != documentos) {
+        return false;
+    }
+
+    // O vocabulário é relido na ordem original, o que mantém as listas de gramas ordenadas
+    for (std::uint64_t p = 0; p < palavras_vocabulario; ++p) {
+        std::string_view texto;
+        std::vector<std::uint32_t> lista;
+        if (!entrada.texto(texto) || texto.empty() || !entrada.vetor(lista)) {
+            return false;
+        }
+        for (std::uint32_t doc : lista) {
+            if (doc >= documentos) {
+                return false;
+            }
+        }
+        std::uint32_t palavra = nova.palavra_do_vocabulario(std::string(texto));
+        if (palavra != p) {
+            return false; // Palavra repetida no vocabulário
+        }
+        nova.vocabulario[palavra].documentos = std::move(lista);
+    }
+    for (std::uint32_t palavra : nova.doc_palavras) {
+        if (palavra >= palavras_vocabulario) {
+            return false;
+        }
+    }
+    std::uint32_t anterior = 0;
+    for (std::size_t doc = 0; doc < documentos; ++doc) {
+        if (nova.doc_inicio[doc] < anterior || nova.doc_inicio[doc] > nova.doc_palavras.size()) {
+            return false;
+        }
+        anterior = nova.doc_inicio[doc];
+    }
+
+    nova.doc_ativo.assign(ativos_gravados.begin(), ativos_gravados.end());
+    for (std::size_t doc = 0; doc < documentos; ++doc) {
+        if (!nova.doc_ativo[doc]) {
+            continue;
+        }
+        if (nova.doc_id[doc] < 0) {
+            return false;
+        }
+        std::size_t id = static_cast<std::size_t>(nova.doc_id[doc]);
+        if (id >= nova.documento_por_id.size()) {
+            nova.documento_por_id.resize(id + 1, SEM_DOCUMENTO);
+        }
+        if (nova.documento_por_id[id] != SEM_DOCUMENTO) {
+            return false; // Dois documentos ativos para o mesmo ID
+        }
+        nova.documento_por_id[id] = static_cast<std::uint32_t>(doc);
+        nova.ativos++;
+    }
+    *this = std::move(nova);
+    return true;
+}
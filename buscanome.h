@@ -0,0 +1,115 @@
+#ifndef BUSCANOME_H
+#define BUSCANOME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Escritor;
+class Leitor;
+
+/**
+ * @brief Busca de pacientes por prefixo e com tolerância a erros de digitação.
+ *
+ * Os nomes são normalizados (minúsculas, sem acentos, ver texto.h) e
+ * separados em palavras. Cada palavra distinta entra uma única vez no
+ * vocabulário, indexada pelos seus trigramas com um marcador de início de
+ * palavra, e guarda a lista de documentos que a contêm.
+ *
+ * Uma consulta procura, para cada palavra digitada, as palavras do
+ * vocabulário que têm um prefixo a poucas edições de distância: o filtro de
+ * contagem de trigramas (cada edição destrói no máximo 3 trigramas) elimina
+ * a maior parte do vocabulário e a distância de edição limitada confirma o
+ * restante. Os documentos candidatos saem da palavra mais seletiva e precisam
+ * conter palavras compatíveis com todas as outras. Assim "jose sil"
+ * encontra "José da Silva" e "joaquin" encontra "Joaquim".
+ *
+ * Os documentos são identificados pelo ID do paciente e só saem do índice
+ * quando removidos explicitamente, o que permite buscar na fila e no
+ * histórico ao mesmo tempo.
+ */
+class BuscaNome
+{
+public:
+    // Resultado de uma busca, do mais para o menos relevante
+    struct Resultado {
+        int id;         // ID do paciente
+        int distancia;  // Total de edições necessárias (0 se todas as palavras casam como prefixo)
+        bool exato;     // Nome normalizado idêntico à consulta
+    };
+
+    /**
+     * @brief Indexa o nome de um paciente, substituindo o nome anterior do mesmo ID.
+     * @param id ID do paciente (não negativo; os IDs são densos, atribuídos em ordem de chegada).
+     * @param nome Nome em UTF-8.
+     */
+    void indexar(int id, const std::string& nome);
+
+    /**
+     * @brief Remove um paciente do índice.
+     * @param id ID do paciente.
+     */
+    void remover(int id);
+
+    /**
+     * @brief Busca os pacientes cujo nome casa com a consulta.
+     * Cada palavra da consulta precisa casar com o início de alguma palavra do
+     * nome. Palavras de até 3 letras precisam casar exatamente; até 6 letras
+     * toleram 1 edição e palavras maiores toleram 2.
+     * @param consulta Nome completo ou parcial, em UTF-8.
+     * @param limite Quantidade máxima de resultados.
+     * @return Resultados ordenados por relevância.
+     */
+    std::vector<Resultado> buscar(const std::string& consulta, std::size_t limite) const;
+
+    std::size_t tamanho() const { return ativos; }
+
+    /**
+     * @brief Grava o índice (ver binario.h); os mapas auxiliares são reconstruídos ao carregar.
+     */
+    void salvar(Escritor& saida) const;
+
+    /**
+     * @brief Substitui o índice pelo gravado por salvar().
+     * @return false se os dados estiverem incompletos ou inconsistentes; nesse caso o índice não muda.
+     */
+    bool carregar(Leitor& entrada);
+
+private:
+    static constexpr std::uint32_t SEM_DOCUMENTO = ~std::uint32_t(0);
+
+    struct Palavra {
+        std::string texto;                     // Palavra normalizada
+        std::vector<std::uint32_t> documentos; // Documentos que contêm a palavra (ordenados)
+    };
+
+    // Palavra do vocabulário compatível com uma palavra da consulta
+    struct Compativel {
+        std::uint32_t palavra; // Índice no vocabulário
+        int distancia;         // Edições até um prefixo da palavra
+        bool completa;         // A palavra do vocabulário é igual à da consulta
+    };
+
+    std::uint32_t palavra_do_vocabulario(const std::string& texto);
+    std::vector<Compativel> compativeis(const std::string& termo, int edicoes) const;
+    std::vector<Resultado> buscar_termos(const std::vector<std::string>& termos, const std::string& normalizada,
+                                         bool aproximada, std::size_t limite) const;
+
+    // Documentos na ordem de indexação, em vetores paralelos para que a verificação
+    // dos candidatos leia apenas dados contíguos
+    std::vector<int> doc_id;                     // ID do paciente de cada documento
+    std::vector<std::uint32_t> doc_tamanho;      // Tamanho do nome normalizado
+    std::vector<std::uint64_t> doc_hash;         // Hash do nome normalizado, para detectar nomes exatos
+    std::vector<std::uint32_t> doc_inicio;       // Início das palavras de cada documento em doc_palavras
+    std::vector<std::uint32_t> doc_palavras;     // Palavras de todos os documentos, em sequência
+    std::vector<bool> doc_ativo;                 // false se o documento foi substituído ou removido
+    std::vector<std::uint32_t> documento_por_id; // Documento ativo de cada ID (SEM_DOCUMENTO se nenhum)
+    std::size_t ativos = 0;                      // Quantidade de IDs com documento ativo
+    std::vector<Palavra> vocabulario;                           // Palavras distintas
+    std::unordered_map<std::string, std::uint32_t> palavra_por_texto; // Posição de cada palavra no vocabulário
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> listas; // Palavras que contêm cada grama (ordenadas)
+};
+
+#endif // BUSCANOME_H
@@ -0,0 +1,362 @@
+#include "carga.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "arquivomapeado.h"
+#include "binario.h"
+#include "cpf.h"
+#include "paciente.h"
+#include "protocolo.h"
+
+namespace {
+
+const char ASSINATURA_RASTRO[8] = {'B', '1', 'C', 'A', 'R', 'G', 'A', '1'};
+
+// Xorshift64*, como na simulação: rápido e reprodutível em qualquer plataforma
+class Gerador
+{
+public:
+    explicit Gerador(std::uint64_t semente) : estado(semente ? semente : 1) {}
+
+    std::uint64_t proximo()
+    {
+        estado ^= estado >> 12;
+        estado ^= estado << 25;
+        estado ^= estado >> 27;
+        return estado * 0x2545F4914F6CDD1DULL;
+    }
+
+    // Número uniforme em [0, 1)
+    double uniforme() { return static_cast<double>(proximo() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // Inteiro uniforme em [0, n)
+    std::size_t abaixo(std::size_t n) { return static_cast<std::size_t>(uniforme() * static_cast<double>(n)); }
+
+private:
+    std::uint64_t estado;
+};
+
+// Nomes e sobrenomes mais frequentes no Brasil, do mais comum para o menos comum
+const char* const NOMES[] = {
+    "Maria", "José", "Ana", "João", "Antônio", "Francisco", "Carlos", "Paulo", "Pedro", "Lucas",
+    "Luiz", "Marcos", "Luis", "Gabriel", "Rafael", "Francisca", "Daniel", "Marcelo", "Bruno", "Eduardo",
+    "Juliana", "Adriana", "Márcia", "Fernanda", "Patrícia", "Aline", "Sandra", "Camila", "Amanda", "Bruna",
+    "Jéssica", "Letícia", "Júlia", "Luciana", "Vanessa", "Felipe", "Raimundo", "Rodrigo", "Manoel", "Mateus",
+};
+
+const char* const SOBRENOMES[] = {
+    "Silva", "Santos", "Oliveira", "Souza", "Rodrigues", "Ferreira", "Alves", "Pereira", "Lima", "Gomes",
+    "Costa", "Ribeiro", "Martins", "Carvalho", "Almeida", "Lopes", "Soares", "Fernandes", "Vieira", "Barbosa",
+    "Rocha", "Dias", "Nascimento", "Andrade", "Moreira", "Nunes", "Marques", "Machado", "Mendes", "Freitas",
+    "Cardoso", "Ramos", "Gonçalves", "Santana", "Teixeira", "Araújo", "Castro", "Pinto", "Correia", "Cavalcanti",
+};
+
+const char* const DOMINIOS[] = {"gmail.com", "hotmail.com", "outlook.com", "yahoo.com.br", "uol.com.br"};
+
+/**
+ * @brief Classe de gravidade: um sintoma principal sorteado entre os principais e
+ * cada sintoma associado com probabilidade PROBABILIDADE_ASSOCIADO.
+ */
+struct Gravidade {
+    double peso;
+    unsigned principais;
+    unsigned associados;
+};
+
+const Gravidade GRAVIDADES[] = {
+    {0.55, TOSSE | NAUSEA | FEBRE, TOSSE | NAUSEA | FEBRE},          // Leve
+    {0.30, DISENTERIA | INFECCAO | COVID, TOSSE | NAUSEA | FEBRE},   // Moderada
+    {0.15, AVC | ACIDENTE, FEBRE | INFECCAO},                        // Grave
+};
+const Gravidade ACIDENTADO = {1, ACIDENTE, AVC | INFECCAO};
+
+const double PROBABILIDADE_ASSOCIADO = 0.3;
+
+// Faixas de idade dos pacientes, em anos: crianças, adultos e idosos
+struct FaixaIdade {
+    double peso;
+    int minima;
+    int maxima;
+};
+
+const FaixaIdade FAIXAS_IDADE[] = {{0.18, 0, 14}, {0.57, 15, 64}, {0.25, 65, 99}};
+
+/**
+ * @brief Sorteia posições com probabilidade proporcional a 1/(posição+1) (lei de Zipf),
+ * como a frequência dos nomes: poucos nomes muito comuns e muitos raros.
+ */
+class Zipf
+{
+public:
+    explicit Zipf(std::size_t n)
+    {
+        double soma = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            soma += 1.0 / static_cast<double>(i + 1);
+            acumulado.push_back(soma);
+        }
+    }
+
+    std::size_t sortear(Gerador& gerador) const
+    {
+        double alvo = gerador.uniforme() * acumulado.back();
+        auto posicao = std::upper_bound(acumulado.begin(), acumulado.end(), alvo);
+        return std::min<std::size_t>(static_cast<std::size_t>(posicao - acumulado.begin()), acumulado.size() - 1);
+    }
+
+private:
+    std::vector<double> acumulado;
+};
+
+template <typename T, std::size_t N>
+const T& sortear_peso(const T (&opcoes)[N], Gerador& gerador)
+{
+    double alvo = gerador.uniforme();
+    for (std::size_t i = 0; i + 1 < N; ++i) {
+        if (alvo < opcoes[i].peso) {
+            return opcoes[i];
+        }
+        alvo -= opcoes[i].peso;
+    }
+    return opcoes[N - 1];
+}
+
+// Um bit sorteado entre os bits da máscara
+unsigned sortear_bit(unsigned mascara, Gerador& gerador)
+{
+    std::size_t escolhido = gerador.abaixo(std::bitset<8>(mascara).count());
+    for (unsigned bit = 1; bit <= mascara; bit <<= 1) {
+        if ((mascara & bit) && escolhido-- == 0) {
+            return bit;
+        }
+    }
+    return 0;
+}
+
+unsigned sortear_sintomas(const Gravidade& gravidade, Gerador& gerador)
+{
+    unsigned sintomas = sortear_bit(gravidade.principais, gerador);
+    for (unsigned bit = 1; bit <= gravidade.associados; bit <<= 1) {
+        if ((gravidade.associados & bit) && gerador.uniforme() < PROBABILIDADE_ASSOCIADO) {
+            sintomas |= bit;
+        }
+    }
+    return sintomas;
+}
+
+/**
+ * @brief Acrescenta o texto em minúsculas ASCII, trocando as letras acentuadas de
+ * dois bytes em UTF-8 (U+00C0 a U+00FF) pela letra sem acento.
+ */
+void acrescentar_ascii(std::string& destino, const char* texto)
+{
+    static const char SEM_ACENTO[] = "aaaaaaaceeeeiiiidnooooo_ouuuuy_s";
+    for (const unsigned char* c = reinterpret_cast<const unsigned char*>(texto); *c != '\0'; ++c) {
+        if (*c == 0xC3 && c[1] != '\0') {
+            destino += SEM_ACENTO[*++c & 0x1F];
+        } else if (*c < 0x80) {
+            destino += static_cast<char>(*c >= 'A' && *c <= 'Z' ? *c - 'A' + 'a' : *c);
+        }
+    }
+}
+
+// Cadastros dos pacientes gerados
+class Cadastros
+{
+public:
+    Cadastros(RastroCarga& rastro, long long hoje, std::uint64_t semente)
+        : rastro(rastro)
+        , hoje(hoje)
+        , deslocamento(static_cast<std::uint32_t>(semente % 1000000000ULL))
+        , nomes(sizeof(NOMES) / sizeof(NOMES[0]))
+        , sobrenomes(sizeof(SOBRENOMES) / sizeof(SOBRENOMES[0]))
+        , dominios(sizeof(DOMINIOS) / sizeof(DOMINIOS[0]))
+    {
+        vazio = rastro.textos.internar("");
+    }
+
+    // Cadastra o próximo paciente; o CPF é diferente para cada um dos primeiros 10^9 pacientes
+    std::uint32_t novo(Gerador& gerador, bool completo)
+    {
+        const std::uint64_t indice = rastro.pacientes.size();
+        // 3^18 é primo com 10^9: a multiplicação embaralha os CPFs sem repeti-los
+        std::uint32_t base = static_cast<std::uint32_t>((indice * 387420489ULL + deslocamento) % 1000000000ULL);
+        PacienteCarga paciente{completar_cpf(base), vazio, vazio, 0, 0};
+        if (completo) {
+            const char* nome = NOMES[nomes.sortear(gerador)];
+            const char* sobrenome = SOBRENOMES[sobrenomes.sortear(gerador)];
+            texto.assign(nome).append(" ");
+            if (gerador.uniforme() < 0.6) {
+                texto.append(SOBRENOMES[sobrenomes.sortear(gerador)]).append(" ");
+            }
+            texto.append(sobrenome);
+            paciente.nome = rastro.textos.internar(texto);
+
+            texto.clear();
+            acrescentar_ascii(texto, nome);
+            texto += '.';
+            acrescentar_ascii(texto, sobrenome);
+            texto.append(std::to_string(1 + gerador.abaixo(999))).append("@");
+            texto.append(DOMINIOS[dominios.sortear(gerador)]);
+            paciente.email = rastro.textos.guardar(texto);
+
+            const FaixaIdade& faixa = sortear_peso(FAIXAS_IDADE, gerador);
+            double idade = faixa.minima + gerador.uniforme() * (faixa.maxima - faixa.minima + 1);
+            paciente.nascimento = static_cast<std::int32_t>(hoje - static_cast<long long>(idade * 365.2425));
+        }
+        rastro.pacientes.push_back(paciente);
+        return static_cast<std::uint32_t>(indice);
+    }
+
+private:
+    RastroCarga& rastro;
+    long long hoje;
+    std::uint32_t deslocamento;
+    Zipf nomes, sobrenomes, dominios;
+    std::uint32_t vazio;    // Texto vazio, para os pacientes que só são consultados
+    std::string texto;
+};
+
+} // namespace
+
+RastroCarga gerar_carga(const ModeloCarga& modelo, std::size_t quantidade, std::uint64_t semente)
+{
+    RastroCarga rastro;
+    if (modelo.taxa <= 0) {
+        return rastro;
+    }
+    rastro.operacoes.reserve(quantidade);
+    Gerador gerador(semente);
+    Cadastros cadastros(rastro, modelo.hoje, semente);
+
+    std::array<double, 4> mistura;
+    double soma = 0;
+    for (std::size_t i = 0; i < mistura.size(); ++i) {
+        soma += std::max(modelo.mistura[i], 0.0);
+        mistura[i] = soma;
+    }
+
+    // Pacientes admitidos e ainda não removidos pelo rastro, com os sintomas atuais
+    std::vector<std::uint32_t> admitidos;
+    std::vector<std::uint8_t> sintomas_atuais;
+
+    auto emitir = [&](double instante, std::uint32_t paciente, std::uint8_t operacao, unsigned sintomas) {
+        rastro.operacoes.push_back(OperacaoCarga{static_cast<std::uint64_t>(instante * 1e9), paciente, operacao,
+                                                 static_cast<std::uint8_t>(sintomas), 0});
+    };
+    auto admitir = [&](double instante, const Gravidade& gravidade) {
+        std::uint32_t paciente = cadastros.novo(gerador, true);
+        unsigned sintomas = sortear_sintomas(gravidade, gerador);
+        admitidos.push_back(paciente);
+        sintomas_atuais.resize(rastro.pacientes.size());
+        sintomas_atuais[paciente] = static_cast<std::uint8_t>(sintomas);
+        emitir(instante, paciente, Protocolo::ADMITIR, sintomas);
+    };
+
+    // Instantes em segundos; as rajadas são um segundo processo de Poisson
+    double tempo = 0;
+    double proxima_rajada = modelo.rajadas > 0 ? -std::log(1.0 - gerador.uniforme()) / modelo.rajadas : std::numeric_limits<double>::infinity();
+    while (rastro.operacoes.size() < quantidade) {
+        tempo -= std::log(1.0 - gerador.uniforme()) / modelo.taxa;
+        while (proxima_rajada <= tempo && rastro.operacoes.size() < quantidade) {
+            // Tamanho geométrico com a média informada
+            double continuar = 1.0 - 1.0 / std::max(modelo.tamanho_rajada, 1.0);
+            do {
+                admitir(proxima_rajada, ACIDENTADO);
+            } while (rastro.operacoes.size() < quantidade && gerador.uniforme() < continuar);
+            proxima_rajada -= std::log(1.0 - gerador.uniforme()) / modelo.rajadas;
+        }
+        if (rastro.operacoes.size() >= quantidade) {
+            break;
+        }
+
+        double sorteio = gerador.uniforme() * soma;
+        std::size_t tipo = std::upper_bound(mistura.begin(), mistura.end(), sorteio) - mistura.begin();
+        if (soma <= 0 || tipo == 0 || tipo >= mistura.size() || admitidos.empty()) {
+            admitir(tempo, sortear_peso(GRAVIDADES, gerador));
+            continue;
+        }
+        std::size_t escolhido = gerador.abaixo(admitidos.size());
+        std::uint32_t paciente = admitidos[escolhido];
+        switch (tipo) {
+        case 1: {
+            // O paciente piorou: ganha um sintoma, que pode ser de uma classe mais grave
+            unsigned sintomas = sintomas_atuais[paciente] | (1u << gerador.abaixo(8));
+            sintomas_atuais[paciente] = static_cast<std::uint8_t>(sintomas);
+            emitir(tempo, paciente, Protocolo::ATUALIZAR, sintomas);
+            break;
+        }
+        case 2:
+            admitidos[escolhido] = admitidos.back();
+            admitidos.pop_back();
+            emitir(tempo, paciente, Protocolo::REMOVER, 0);
+            break;
+        default:
+            if (gerador.uniforme() < modelo.ausentes) {
+                paciente = cadastros.novo(gerador, false);
+            }
+            emitir(tempo, paciente, Protocolo::CONSULTAR, 0);
+            break;
+        }
+    }
+    return rastro;
+}
+
+bool gravar_rastro(const std::string& caminho, const RastroCarga& rastro)
+{
+    std::vector<char> dados;
+    Escritor escritor(dados);
+    escritor.bytes(ASSINATURA_RASTRO, sizeof(ASSINATURA_RASTRO));
+    rastro.textos.salvar(escritor, false);
+    escritor.vetor(rastro.pacientes);
+    escritor.vetor(rastro.operacoes);
+
+    std::FILE* arquivo = std::fopen(caminho.c_str(), "wb");
+    if (arquivo == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(dados.data(), 1, dados.size(), arquivo) == dados.size();
+    return std::fclose(arquivo) == 0 && ok;
+}
+
+const char* ler_rastro(const std::string& caminho, RastroCarga& rastro)
+{
+    ArquivoMapeado arquivo(caminho);
+    if (!arquivo.existe()) {
+        return "não foi possível abrir o arquivo";
+    }
+    Leitor leitor(arquivo.dados(), arquivo.tamanho());
+    char assinatura[sizeof(ASSINATURA_RASTRO)];
+    if (!leitor.bytes(assinatura, sizeof(assinatura)) ||
+        std::memcmp(assinatura, ASSINATURA_RASTRO, sizeof(assinatura)) != 0) {
+        return "o arquivo não é um rastro de carga";
+    }
+    if (!rastro.textos.carregar(leitor, false) || !leitor.vetor(rastro.pacientes) ||
+        !leitor.vetor(rastro.operacoes) || leitor.restante() != 0) {
+        return "rastro incompleto";
+    }
+
+    const std::size_t textos = rastro.textos.tamanho();
+    char cpf[TAMANHO_CPF_FORMATADO];
+    for (const PacienteCarga& paciente : rastro.pacientes) {
+        escrever_cpf(paciente.cpf, cpf);
+        if (paciente.nome >= textos || paciente.email >= textos ||
+            cpf_para_chave(cpf, sizeof(cpf)) != paciente.cpf) {
+            return "paciente inválido no rastro";
+        }
+    }
+    std::uint64_t anterior = 0;
+    for (const OperacaoCarga& operacao : rastro.operacoes) {
+        if (operacao.paciente >= rastro.pacientes.size() || operacao.operacao < Protocolo::ADMITIR ||
+            operacao.operacao > Protocolo::CONSULTAR || operacao.instante < anterior) {
+            return "operação inválida no rastro";
+        }
+        anterior = operacao.instante;
+    }
+    return nullptr;
+}
@@ -0,0 +1,90 @@
+#ifndef CARGA_H
+#define CARGA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tabelatexto.h"
+
+/**
+ * Carga sintética da triagem e rastros de operações, para medir a triagem e o
+ * serviço sob uma carga que o formulário da interface não consegue produzir
+ * (ver loadgen.cpp).
+ *
+ * Um rastro é uma sequência de operações da interface (admitir, atualizar,
+ * remover e consultar, com os códigos de Protocolo::Operacao), cada uma com o
+ * instante em que deve ser feita, sobre pacientes cadastrados no próprio
+ * rastro. Os pacientes têm CPFs válidos, nomes sorteados com a frequência
+ * desigual dos nomes reais e sintomas sorteados por gravidade; as operações
+ * chegam em um processo de Poisson, com rajadas de acidentados opcionais.
+ *
+ * O arquivo do rastro guarda os textos uma única vez (os nomes repetidos são
+ * deduplicados), cada paciente em 24 bytes e cada operação em 16 bytes, de
+ * modo que um rastro com milhões de operações é lido de uma vez e repetido sem
+ * decodificação.
+ */
+
+// Paciente de um rastro
+struct PacienteCarga {
+    std::uint64_t cpf;          // Chave do CPF (ver cpf.h)
+    std::uint32_t nome;         // Identificador do nome em RastroCarga::textos
+    std::uint32_t email;        // Identificador do email em RastroCarga::textos
+    std::int32_t nascimento;    // Dia juliano
+    std::uint32_t reservado;    // Sempre 0 (completa o registro gravado)
+};
+
+// Operação de um rastro
+struct OperacaoCarga {
+    std::uint64_t instante;     // Nanossegundos desde o início do rastro
+    std::uint32_t paciente;     // Índice do paciente em RastroCarga::pacientes
+    std::uint8_t operacao;      // Protocolo::ADMITIR, ATUALIZAR, REMOVER ou CONSULTAR
+    std::uint8_t sintomas;      // Sintomas enviados ao admitir ou atualizar
+    std::uint16_t reservado;    // Sempre 0 (completa o registro gravado)
+};
+
+// Operações e pacientes de um rastro, gerado por gerar_carga() ou lido por ler_rastro()
+struct RastroCarga {
+    std::vector<PacienteCarga> pacientes;
+    std::vector<OperacaoCarga> operacoes; // Em ordem de instante
+    TabelaTexto textos;                   // Nomes e emails dos pacientes
+};
+
+// Modelo da carga gerada por gerar_carga()
+struct ModeloCarga {
+    double taxa = 100000;                              // Operações por segundo, em média (processo de Poisson)
+    std::array<double, 4> mistura{0.55, 0.1, 0.1, 0.25}; // Pesos de admitir, atualizar, remover e consultar
+    double ausentes = 0.1;                             // Fração das consultas com CPFs que nunca foram admitidos
+    double rajadas = 0;                                // Rajadas de acidentados por segundo, em média
+    double tamanho_rajada = 20;                        // Admissões por rajada, em média
+    long long hoje = 0;                                // Dia juliano de referência para as idades
+};
+
+/**
+ * @brief Gera um rastro com a quantidade informada de operações.
+ * Admitir cadastra um paciente novo; atualizar, remover e consultar escolhem
+ * um paciente admitido e ainda não removido pelo rastro (admitir, se não
+ * houver nenhum). A atualização acrescenta um sintoma (o paciente piorou) e as
+ * rajadas admitem, no mesmo instante, pacientes graves com ACIDENTE.
+ * A mesma semente gera sempre o mesmo rastro.
+ * @param modelo Taxa, mistura de operações e rajadas.
+ * @param quantidade Quantidade de operações, incluindo as das rajadas.
+ * @param semente Semente do gerador pseudoaleatório.
+ */
+RastroCarga gerar_carga(const ModeloCarga& modelo, std::size_t quantidade, std::uint64_t semente);
+
+/**
+ * @brief Grava o rastro em um arquivo binário (ver a descrição do formato acima).
+ * @return false se a gravação falhou.
+ */
+bool gravar_rastro(const std::string& caminho, const RastroCarga& rastro);
+
+/**
+ * @brief Lê um rastro gravado por gravar_rastro(), conferindo as referências entre as partes.
+ * @return Mensagem de erro ou nullptr.
+ */
+const char* ler_rastro(const std::string& caminho, RastroCarga& rastro);
+
+#endif // CARGA_H
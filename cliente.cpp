@@ -0,0 +1,308 @@
+#include "cliente.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+Cliente::~Cliente()
+{
+    fechar();
+}
+
+bool Cliente::conectar(const std::string& caminho)
+{
+    fechar();
+    sockaddr_un endereco{};
+    endereco.sun_family = AF_UNIX;
+    if (caminho.empty() || caminho.size() >= sizeof(endereco.sun_path)) {
+        errno = EINVAL;
+        return false;
+    }
+    std::memcpy(endereco.sun_path, caminho.c_str(), caminho.size() + 1);
+
+    int novo = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (novo == -1) {
+        return false;
+    }
+    if (connect(novo, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) == -1) {
+        int erro = errno;
+        close(novo);
+        errno = erro;
+        return false;
+    }
+    fd = novo;
+    return true;
+}
+
+void Cliente::fechar()
+{
+    if (fd != -1) {
+        close(fd);
+        fd = -1;
+    }
+    saida.clear();
+    entrada.clear();
+    lidos = 0;
+    notificacoes.clear();
+}
+
+Escritor Cliente::iniciar_pedido(std::uint8_t operacao)
+{
+    if (proximo_id == Protocolo::NOTIFICACAO_ID) {
+        proximo_id++;
+    }
+    inicio_pedido = Protocolo::iniciar_quadro(saida);
+    Escritor pedido(saida);
+    pedido.u32(proximo_id);
+    pedido.u8(operacao);
+    return pedido;
+}
+
+std::uint32_t Cliente::pedir_admissao(std::string_view nome, std::string_view cpf, std::string_view email,
+                                      std::int32_t nascimento, unsigned sintomas, bool atualizar)
+{
+    Escritor pedido = iniciar_pedido(atualizar ? Protocolo::ATUALIZAR : Protocolo::ADMITIR);
+    pedido.texto(nome);
+    pedido.texto(cpf);
+    pedido.texto(email);
+    pedido.i32(nascimento);
+    pedido.u8(static_cast<std::uint8_t>(sintomas));
+    concluir_pedido();
+    return proximo_id++;
+}
+
+std::uint32_t Cliente::pedir_remocao(std::string_view cpf)
+{
+    iniciar_pedido(Protocolo::REMOVER).texto(cpf);
+    concluir_pedido();
+    return proximo_id++;
+}
+
+std::uint32_t Cliente::pedir_consulta(std::string_view cpf)
+{
+    iniciar_pedido(Protocolo::CONSULTAR).texto(cpf);
+    concluir_pedido();
+    return proximo_id++;
+}
+
+std::uint32_t Cliente::pedir_lista(std::uint32_t limite)
+{
+    iniciar_pedido(Protocolo::LISTAR).u32(limite);
+    concluir_pedido();
+    return proximo_id++;
+}
+
+std::uint32_t Cliente::pedir_proximo()
+{
+    iniciar_pedido(Protocolo::PROXIMO);
+    concluir_pedido();
+    return proximo_id++;
+}
+
+std::uint32_t Cliente::pedir_assinatura()
+{
+    iniciar_pedido(Protocolo::ASSINAR);
+    concluir_pedido();
+    return proximo_id++;
+}
+
+bool Cliente::descarregar()
+{
+    std::size_t enviados = 0;
+    while (fd != -1 && enviados < saida.size()) {
+        ssize_t enviado = send(fd, saida.data() + enviados, saida.size() - enviados, MSG_NOSIGNAL);
+        if (enviado < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fechar();
+            return false;
+        }
+        enviados += static_cast<std::size_t>(enviado);
+    }
+    saida.clear();
+    return fd != -1;
+}
+
+// Lê o próximo quadro do socket, seja resposta ou notificação
+bool Cliente::ler_quadro(Resposta& resposta)
+{
+    while (fd != -1) {
+        long long quadro = Protocolo::quadro_completo(entrada.data() + lidos, entrada.size() - lidos);
+        if (quadro > 0) {
+            Leitor leitor(entrada.data() + lidos + sizeof(std::uint32_t), quadro - sizeof(std::uint32_t));
+            std::uint8_t status;
+            if (!leitor.u32(resposta.id) || !leitor.u8(status)) {
+                break;
+            }
+            resposta.status = static_cast<Protocolo::Status>(status);
+            std::size_t inicio_resultado = lidos + sizeof(std::uint32_t) * 2 + 1;
+            resposta.resultado.assign(entrada.begin() + inicio_resultado, entrada.begin() + lidos + quadro);
+            lidos += static_cast<std::size_t>(quadro);
+            return true;
+        }
+        if (quadro < 0) {
+            break;
+        }
+
+        // Quadro incompleto: descarta o que já foi lido e recebe mais
+        entrada.erase(entrada.begin(), entrada.begin() + lidos);
+        lidos = 0;
+        std::size_t tamanho = entrada.size();
+        entrada.resize(tamanho + 65536);
+        ssize_t lido = recv(fd, entrada.data() + tamanho, 65536, 0);
+        entrada.resize(tamanho + (lido > 0 ? lido : 0));
+        if (lido == 0 || (lido < 0 && errno != EINTR)) {
+            break;
+        }
+    }
+    fechar();
+    resposta.status = Protocolo::SEM_CONEXAO;
+    return false;
+}
+
+bool Cliente::receber(Resposta& resposta)
+{
+    while (ler_quadro(resposta)) {
+        if (resposta.id != Protocolo::NOTIFICACAO_ID) {
+            return true;
+        }
+        Protocolo::Notificacao notificacao;
+        Leitor leitor = resposta.leitor();
+        if (!Protocolo::ler_notificacao(leitor, notificacao)) {
+            fechar();
+            return false;
+        }
+        notificacoes.push_back(std::move(notificacao));
+    }
+    return false;
+}
+
+bool Cliente::notificacao(Protocolo::Notificacao& notificacao)
+{
+    while (notificacoes.empty()) {
+        if (!ler_quadro(resposta)) {
+            return false;
+        }
+        if (resposta.id != Protocolo::NOTIFICACAO_ID) {
+            continue; // Resposta de um pedido em lote, que não é esperada aqui
+        }
+        Leitor leitor = resposta.leitor();
+        if (!Protocolo::ler_notificacao(leitor, notificacao)) {
+            fechar();
+            return false;
+        }
+        return true;
+    }
+    notificacao = std::move(notificacoes.front());
+    notificacoes.pop_front();
+    return true;
+}
+
+// Envia os pedidos acumulados e aguarda a resposta do pedido id
+Protocolo::Status Cliente::esperar(std::uint32_t id)
+{
+    if (!descarregar()) {
+        return Protocolo::SEM_CONEXAO;
+    }
+    while (receber(resposta)) {
+        if (resposta.id == id) {
+            return resposta.status;
+        }
+    }
+    return Protocolo::SEM_CONEXAO;
+}
+
+Protocolo::Status Cliente::admitir(std::string_view nome, std::string_view cpf, std::string_view email,
+                                   std::int32_t nascimento, unsigned sintomas, int& id, bool& novo)
+{
+    Protocolo::Status status = esperar(pedir_admissao(nome, cpf, email, nascimento, sintomas));
+    if (status != Protocolo::OK) {
+        return status;
+    }
+    Leitor leitor = resposta.leitor();
+    std::uint8_t admitido;
+    std::int32_t id_lido;
+    if (!leitor.u8(admitido) || !leitor.i32(id_lido)) {
+        return Protocolo::PEDIDO_INVALIDO;
+    }
+    id = id_lido;
+    novo = admitido != 0;
+    return status;
+}
+
+Protocolo::Status Cliente::atualizar(std::string_view nome, std::string_view cpf, std::string_view email,
+                                     std::int32_t nascimento, unsigned sintomas, int& id)
+{
+    Protocolo::Status status = esperar(pedir_admissao(nome, cpf, email, nascimento, sintomas, true));
+    if (status != Protocolo::OK) {
+        return status;
+    }
+    Leitor leitor = resposta.leitor();
+    std::uint8_t admitido;
+    std::int32_t id_lido;
+    if (!leitor.u8(admitido) || !leitor.i32(id_lido)) {
+        return Protocolo::PEDIDO_INVALIDO;
+    }
+    id = id_lido;
+    return status;
+}
+
+Protocolo::Status Cliente::remover(std::string_view cpf)
+{
+    return esperar(pedir_remocao(cpf));
+}
+
+Protocolo::Status Cliente::consultar(std::string_view cpf, Protocolo::Paciente& paciente)
+{
+    Protocolo::Status status = esperar(pedir_consulta(cpf));
+    Leitor leitor = resposta.leitor();
+    if (status == Protocolo::OK && !Protocolo::ler_paciente(leitor, paciente)) {
+        return Protocolo::PEDIDO_INVALIDO;
+    }
+    return status;
+}
+
+Protocolo::Status Cliente::listar(std::uint32_t limite, std::vector<Protocolo::Paciente>& pacientes)
+{
+    Protocolo::Status status = esperar(pedir_lista(limite));
+    if (status != Protocolo::OK) {
+        return status;
+    }
+    Leitor leitor = resposta.leitor();
+    std::uint32_t quantidade;
+    if (!leitor.u32(quantidade)) {
+        return Protocolo::PEDIDO_INVALIDO;
+    }
+    pacientes.clear();
+    for (std::uint32_t i = 0; i < quantidade; ++i) {
+        Protocolo::Paciente paciente;
+        if (!Protocolo::ler_paciente(leitor, paciente)) {
+            return Protocolo::PEDIDO_INVALIDO;
+        }
+        pacientes.push_back(std::move(paciente));
+    }
+    return status;
+}
+
+Protocolo::Status Cliente::proximo(Protocolo::Paciente& paciente)
+{
+    Protocolo::Status status = esperar(pedir_proximo());
+    Leitor leitor = resposta.leitor();
+    if (status == Protocolo::OK && !Protocolo::ler_paciente(leitor, paciente)) {
+        return Protocolo::PEDIDO_INVALIDO;
+    }
+    return status;
+}
+
+Protocolo::Status Cliente::assinar()
+{
+    return esperar(pedir_assinatura());
+}
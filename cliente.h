@@ -0,0 +1,131 @@
+#ifndef CLIENTE_H
+#define CLIENTE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "binario.h"
+#include "protocolo.h"
+
+/**
+ * @brief Cliente do serviço da triagem (b1d) pelo socket Unix (apenas POSIX).
+ *
+ * Há duas formas de uso, que não devem ser misturadas enquanto houver
+ * respostas pendentes:
+ * - As operações síncronas (admitir(), consultar(), ...) enviam um pedido e
+ *   esperam a resposta dele.
+ * - Os métodos pedir_*() apenas acumulam pedidos, que descarregar() envia em
+ *   uma só escrita; receber() retorna as respostas na ordem dos pedidos. Com
+ *   vários pedidos em trânsito (pipelining), a latência do socket é paga uma
+ *   vez por lote.
+ *
+ * As notificações que chegam entre as respostas (depois de assinar()) são
+ * guardadas e retornadas por notificacao().
+ */
+class Cliente
+{
+public:
+    // Resposta a um pedido
+    struct Resposta {
+        std::uint32_t id = 0;                          // Id do pedido (ver pedir_*())
+        Protocolo::Status status = Protocolo::SEM_CONEXAO;
+        std::vector<char> resultado;                   // Resultado codificado (ver protocolo.h)
+
+        Leitor leitor() const { return Leitor(resultado.data(), resultado.size()); }
+    };
+
+    Cliente() = default;
+    ~Cliente();
+
+    Cliente(const Cliente&) = delete;
+    Cliente& operator=(const Cliente&) = delete;
+
+    /**
+     * @brief Conecta ao serviço.
+     * @return false se não houver serviço no caminho (errno indica o motivo).
+     */
+    bool conectar(const std::string& caminho);
+
+    void fechar();
+    bool conectado() const { return fd != -1; }
+
+    // Pedidos em lote; cada um retorna o id que aparecerá na resposta
+
+    std::uint32_t pedir_admissao(std::string_view nome, std::string_view cpf, std::string_view email,
+                                 std::int32_t nascimento, unsigned sintomas, bool atualizar = false);
+    std::uint32_t pedir_remocao(std::string_view cpf);
+    std::uint32_t pedir_consulta(std::string_view cpf);
+    std::uint32_t pedir_lista(std::uint32_t limite);
+    std::uint32_t pedir_proximo();
+    std::uint32_t pedir_assinatura();
+
+    /**
+     * @brief Quantidade de bytes de pedidos ainda não enviados.
+     */
+    std::size_t pendentes() const { return saida.size(); }
+
+    /**
+     * @brief Envia todos os pedidos acumulados.
+     * @return false se a conexão falhou.
+     */
+    bool descarregar();
+
+    /**
+     * @brief Aguarda a próxima resposta, guardando as notificações que chegarem antes dela.
+     * @return false se a conexão falhou ou se o serviço enviou dados inválidos.
+     */
+    bool receber(Resposta& resposta);
+
+    // Operações síncronas; SEM_CONEXAO se a conexão falhou
+
+    /**
+     * @brief Admite um paciente ou atualiza o paciente com o mesmo CPF (ver Triagem::admitir).
+     * @param id Recebe o ID do paciente.
+     * @param novo Recebe true se o paciente foi admitido, false se foi atualizado.
+     */
+    Protocolo::Status admitir(std::string_view nome, std::string_view cpf, std::string_view email,
+                              std::int32_t nascimento, unsigned sintomas, int& id, bool& novo);
+
+    /**
+     * @brief Atualiza o paciente com o CPF informado; NAO_ENCONTRADO se ele não estiver na fila.
+     */
+    Protocolo::Status atualizar(std::string_view nome, std::string_view cpf, std::string_view email,
+                                std::int32_t nascimento, unsigned sintomas, int& id);
+
+    Protocolo::Status remover(std::string_view cpf);
+    Protocolo::Status consultar(std::string_view cpf, Protocolo::Paciente& paciente);
+    Protocolo::Status listar(std::uint32_t limite, std::vector<Protocolo::Paciente>& pacientes);
+    Protocolo::Status proximo(Protocolo::Paciente& paciente);
+
+    /**
+     * @brief Passa a receber as notificações de mudança (ver notificacao()).
+     */
+    Protocolo::Status assinar();
+
+    /**
+     * @brief Aguarda a próxima notificação (a primeira traz o estado no momento da assinatura).
+     * @return false se a conexão falhou.
+     */
+    bool notificacao(Protocolo::Notificacao& notificacao);
+
+private:
+    Escritor iniciar_pedido(std::uint8_t operacao);
+    void concluir_pedido() { Protocolo::concluir_quadro(saida, inicio_pedido); }
+    bool ler_quadro(Resposta& resposta);
+    Protocolo::Status esperar(std::uint32_t id);
+
+    int fd = -1;
+    std::uint32_t proximo_id = 1;           // Próximo id de pedido (NOTIFICACAO_ID é pulado)
+    std::vector<char> saida;                // Pedidos ainda não enviados
+    std::size_t inicio_pedido = 0;          // Posição do quadro do pedido em construção
+    std::vector<char> entrada;              // Dados recebidos, a partir de lidos
+    std::size_t lidos = 0;
+    std::deque<Protocolo::Notificacao> notificacoes; // Notificações recebidas e ainda não retornadas
+    Resposta resposta;                      // Resposta das operações síncronas
+};
+
+#endif // CLIENTE_H
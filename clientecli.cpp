@@ -0,0 +1,268 @@
+// Cliente de linha de comando do serviço da triagem (b1d).
+//
+// Executa uma operação no serviço e imprime o resultado, acompanha as
+// notificações de mudança como uma tela de chamada (assinar) ou mede o
+// serviço (bench): N admissões, N consultas e N remoções de pacientes
+// sintéticos, com até J pedidos em trânsito na conexão, informando a vazão e
+// os percentis da latência de cada fase. O bench remove os pacientes que
+// admitiu; os CPFs sintéticos podem coincidir com os de pacientes reais, então
+// ele deve ser usado apenas em um serviço de teste.
+//
+// Uso: b1_cliente [--socket caminho] comando
+//   admitir nome cpf email dd/mm/aaaa sintomas
+//   atualizar nome cpf email dd/mm/aaaa sintomas
+//   remover cpf | consultar cpf | listar [limite [texto|csv|json]] | proximo | assinar
+//   bench [N] [J]
+//
+// Com um formato, listar exporta a fila no formato do Formatador (ver formatador.h).
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "cliente.h"
+#include "cpf.h"
+#include "data.h"
+#include "escalonador.h"
+#include "formatador.h"
+#include "histograma.h"
+#include "protocolo.h"
+
+static const char* descrever(Protocolo::Status status)
+{
+    switch (status) {
+    case Protocolo::OK:
+        return "ok";
+    case Protocolo::NAO_ENCONTRADO:
+        return "paciente não encontrado";
+    case Protocolo::CPF_MAL_FORMADO:
+        return "CPF mal formado";
+    case Protocolo::PEDIDO_INVALIDO:
+        return "pedido inválido";
+    default:
+        return "sem conexão com o serviço";
+    }
+}
+
+static bool ler_data(const char* texto, long long& dia)
+{
+    int d, m, a;
+    if (std::sscanf(texto, "%d/%d/%d", &d, &m, &a) != 3 || m < 1 || m > 12 || d < 1 || d > 31) {
+        return false;
+    }
+    dia = dia_juliano(a, m, d);
+    return true;
+}
+
+static void imprimir(const Protocolo::Paciente& paciente)
+{
+    int ano, mes, dia;
+    data_do_dia_juliano(paciente.nascimento, ano, mes, dia);
+    std::printf("%6d  %s  %02d/%02d/%04d  %3u  %-8s  %s <%s>\n", paciente.id, chave_para_cpf(paciente.cpf).c_str(),
+                dia, mes, ano, paciente.sintomas,
+                paciente.estacao == -1 ? "espera" : ("estação " + std::to_string(paciente.estacao)).c_str(),
+                paciente.nome.c_str(), paciente.email.c_str());
+}
+
+/**
+ * @brief Exporta os pacientes no formato informado (texto, csv ou json).
+ * @return false se o formato for desconhecido.
+ */
+static bool exportar(const std::vector<Protocolo::Paciente>& pacientes, const std::string& nome_formato)
+{
+    Formatador::Formato formato;
+    if (nome_formato == "texto") {
+        formato = Formatador::TEXTO;
+    } else if (nome_formato == "csv") {
+        formato = Formatador::CSV;
+    } else if (nome_formato == "json") {
+        formato = Formatador::JSON;
+    } else {
+        return false;
+    }
+
+    // Descarrega a cada poucos KB para que o buffer não cresça com a lista
+    Formatador formatador(formato, dia_juliano_hoje());
+    formatador.comecar();
+    for (const Protocolo::Paciente& p : pacientes) {
+        formatador.escrever(Formatador::Campos{p.id, p.cpf, p.nome, p.email, p.nascimento, p.sintomas});
+        if (formatador.texto().size() >= 64 * 1024) {
+            formatador.descarregar(stdout);
+        }
+    }
+    formatador.terminar();
+    formatador.descarregar(stdout);
+    return true;
+}
+
+/**
+ * @brief Executa n pedidos com até janela deles em trânsito e imprime a vazão e a latência.
+ * Os pedidos que o serviço não atende (status diferente de OK) são contados como falhas.
+ * @param pedir Acumula o pedido i no cliente.
+ * @return false se a conexão falhou.
+ */
+template <typename Pedir>
+static bool medir_fase(Cliente& cliente, const char* fase, std::size_t n, std::size_t janela, Pedir pedir)
+{
+    using Relogio = std::chrono::steady_clock;
+    std::vector<Relogio::time_point> envio(n);
+    Histograma latencia;
+    Cliente::Resposta resposta;
+    std::size_t enviados = 0, recebidos = 0, falhas = 0;
+
+    Relogio::time_point inicio = Relogio::now();
+    while (recebidos < n) {
+        // Completa a janela e envia os novos pedidos em uma só escrita
+        Relogio::time_point agora = Relogio::now();
+        while (enviados < n && enviados - recebidos < janela) {
+            pedir(enviados);
+            envio[enviados++] = agora;
+        }
+        if (!cliente.descarregar() || !cliente.receber(resposta)) {
+            std::fprintf(stderr, "%s: conexão perdida\n", fase);
+            return false;
+        }
+        latencia.registrar(std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now() -
+                                                                                 envio[recebidos]).count());
+        falhas += resposta.status != Protocolo::OK;
+        recebidos++;
+    }
+    double segundos = std::chrono::duration<double>(Relogio::now() - inicio).count();
+
+    std::printf("%-10s %9zu %12.0f %9.1f %9.1f %9.1f %9.1f %7zu\n", fase, n, n / segundos,
+                latencia.percentil(50) / 1e3, latencia.percentil(99) / 1e3, latencia.percentil(99.9) / 1e3,
+                latencia.maximo() / 1e3, falhas);
+    return true;
+}
+
+static int bench(Cliente& cliente, std::size_t n, std::size_t janela)
+{
+    std::vector<std::string> cpfs(n), nomes(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        cpfs[i] = chave_para_cpf(completar_cpf(static_cast<std::uint32_t>((i * 7919 + 424242) % 1000000000ULL)));
+        nomes[i] = "Paciente Bench " + std::to_string(i);
+    }
+    const std::int32_t nascimento = static_cast<std::int32_t>(dia_juliano(1980, 1, 1));
+
+    std::printf("%zu pedidos por fase, janela de %zu pedidos\n", n, janela);
+    std::printf("%-10s %9s %12s %9s %9s %9s %9s %7s\n", "fase", "pedidos", "pedidos/s", "p50_us", "p99_us",
+                "p999_us", "max_us", "falhas");
+    // Consultas e remoções falham para os pacientes cujo tratamento o serviço já concluiu
+    bool ok = medir_fase(cliente, "admitir", n, janela, [&](std::size_t i) {
+        cliente.pedir_admissao(nomes[i], cpfs[i], "bench@b1", nascimento, static_cast<unsigned>(i % 255 + 1));
+    }) && medir_fase(cliente, "consultar", n, janela, [&](std::size_t i) { cliente.pedir_consulta(cpfs[i]); }) &&
+              medir_fase(cliente, "remover", n, janela, [&](std::size_t i) { cliente.pedir_remocao(cpfs[i]); });
+    return ok ? 0 : 1;
+}
+
+static int uso(const char* programa)
+{
+    std::fprintf(stderr,
+                 "uso: %s [--socket caminho] comando\n"
+                 "  admitir nome cpf email dd/mm/aaaa sintomas\n"
+                 "  atualizar nome cpf email dd/mm/aaaa sintomas\n"
+                 "  remover cpf | consultar cpf | listar [limite [texto|csv|json]] | proximo | assinar\n"
+                 "  bench [N] [J]\n",
+                 programa);
+    return 2;
+}
+
+int main(int argc, char** argv)
+{
+    std::string caminho = Protocolo::caminho_padrao();
+    int i = 1;
+    if (i + 1 < argc && std::strcmp(argv[i], "--socket") == 0) {
+        caminho = argv[i + 1];
+        i += 2;
+    }
+    if (i >= argc) {
+        return uso(argv[0]);
+    }
+    const std::string comando = argv[i++];
+    const int argumentos = argc - i;
+    char** arg = argv + i;
+
+    Cliente cliente;
+    if (!cliente.conectar(caminho)) {
+        std::fprintf(stderr, "%s: %s\n", caminho.c_str(), std::strerror(errno));
+        return 1;
+    }
+
+    Protocolo::Status status;
+    if ((comando == "admitir" || comando == "atualizar") && argumentos == 5) {
+        long long nascimento;
+        if (!ler_data(arg[3], nascimento)) {
+            return uso(argv[0]);
+        }
+        unsigned sintomas = static_cast<unsigned>(std::strtoul(arg[4], nullptr, 10));
+        int id = -1;
+        bool novo = false;
+        status = comando == "admitir"
+                     ? cliente.admitir(arg[0], arg[1], arg[2], static_cast<std::int32_t>(nascimento), sintomas, id, novo)
+                     : cliente.atualizar(arg[0], arg[1], arg[2], static_cast<std::int32_t>(nascimento), sintomas, id);
+        if (status == Protocolo::OK) {
+            std::printf("%s: ID %d\n", novo ? "admitido" : "atualizado", id);
+        }
+    } else if (comando == "remover" && argumentos == 1) {
+        status = cliente.remover(arg[0]);
+    } else if (comando == "consultar" && argumentos == 1) {
+        Protocolo::Paciente paciente;
+        status = cliente.consultar(arg[0], paciente);
+        if (status == Protocolo::OK) {
+            imprimir(paciente);
+        }
+    } else if (comando == "listar" && argumentos <= 2) {
+        std::vector<Protocolo::Paciente> pacientes;
+        status = cliente.listar(argumentos >= 1 ? static_cast<std::uint32_t>(std::strtoul(arg[0], nullptr, 10)) : 20,
+                                pacientes);
+        if (argumentos == 2) {
+            if (!exportar(pacientes, arg[1])) {
+                return uso(argv[0]);
+            }
+        } else {
+            for (const Protocolo::Paciente& paciente : pacientes) {
+                imprimir(paciente);
+            }
+        }
+    } else if (comando == "proximo" && argumentos == 0) {
+        Protocolo::Paciente paciente;
+        status = cliente.proximo(paciente);
+        if (status == Protocolo::OK) {
+            imprimir(paciente);
+        }
+    } else if (comando == "assinar" && argumentos == 0) {
+        status = cliente.assinar();
+        Protocolo::Notificacao notificacao;
+        while (status == Protocolo::OK && cliente.notificacao(notificacao)) {
+            std::printf("versão %llu: %u na fila\n", static_cast<unsigned long long>(notificacao.versao),
+                        notificacao.tamanho);
+            for (std::size_t e = 0; e < notificacao.estacoes.size(); ++e) {
+                const Protocolo::Estacao& estacao = notificacao.estacoes[e];
+                if (estacao.paciente == -1) {
+                    std::printf("  estação %zu: livre\n", e);
+                } else {
+                    std::printf("  estação %zu: %d %s%s\n", e, estacao.paciente, estacao.nome.c_str(),
+                                estacao.evento == Escalonador::CHAMADO ? " (chamado)" : "");
+                }
+            }
+            std::fflush(stdout);
+        }
+        status = Protocolo::SEM_CONEXAO;
+    } else if (comando == "bench" && argumentos <= 2) {
+        std::size_t n = argumentos >= 1 ? std::strtoull(arg[0], nullptr, 10) : 100000;
+        std::size_t janela = argumentos >= 2 ? std::strtoull(arg[1], nullptr, 10) : 64;
+        return bench(cliente, n, janela > 0 ? janela : 1);
+    } else {
+        return uso(argv[0]);
+    }
+
+    if (status != Protocolo::OK) {
+        std::fprintf(stderr, "%s\n", descrever(status));
+        return 1;
+    }
+    return 0;
+}
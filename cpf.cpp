@@ -0,0 +1,309 @@
+#include "cpf.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CPF_SSE2
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CPF_AVX2
+#endif
+
+// Disposição dos 11 dígitos em um dos formatos aceitos, em blocos de 16 bytes para a conferência vetorial
+struct FormatoCpf {
+    std::size_t tamanho;                 // Quantidade de caracteres do formato
+    std::uint8_t posicao[11];            // Posição de cada dígito no texto
+    alignas(16) char modelo[16];         // Separadores esperados; 0 nas posições de dígitos e depois do fim
+    alignas(16) std::uint8_t digito[16]; // 0xFF nas posições de dígitos
+    alignas(16) std::int16_t peso1[16];  // Peso de cada posição no primeiro dígito verificador
+    alignas(16) std::int16_t peso2[16];  // Peso de cada posição no segundo dígito verificador
+};
+
+static constexpr FormatoCpf montar_formato(bool com_separadores)
+{
+    FormatoCpf f{};
+    std::size_t p = 0;
+    for (int k = 0; k < 11; ++k) {
+        if (com_separadores && (p == 3 || p == 7)) {
+            f.modelo[p++] = '.';
+        }
+        if (com_separadores && p == 11) {
+            f.modelo[p++] = '-';
+        }
+        f.posicao[k] = static_cast<std::uint8_t>(p);
+        f.digito[p] = 0xFF;
+        f.peso1[p] = static_cast<std::int16_t>(k < 9 ? 10 - k : 0);  // Pesos 10 a 2 sobre os 9 primeiros dígitos
+        f.peso2[p] = static_cast<std::int16_t>(k < 10 ? 11 - k : 0); // Pesos 11 a 2 sobre os 10 primeiros dígitos
+        p++;
+    }
+    f.tamanho = p;
+    return f;
+}
+
+static constexpr FormatoCpf FORMATADO = montar_formato(true);        // XXX.XXX.XXX-XX
+static constexpr FormatoCpf SEM_SEPARADORES = montar_formato(false); // XXXXXXXXXXX
+
+static const FormatoCpf* formato_de(std::size_t tamanho)
+{
+    if (tamanho == FORMATADO.tamanho) {
+        return &FORMATADO;
+    }
+    if (tamanho == SEM_SEPARADORES.tamanho) {
+        return &SEM_SEPARADORES;
+    }
+    return nullptr;
+}
+
+// Copia o texto para o início de um bloco zerado, com tamanho constante para cada formato
+static void copiar_texto(char* bloco, const char* texto, const FormatoCpf& f)
+{
+    if (f.tamanho == FORMATADO.tamanho) {
+        std::memcpy(bloco, texto, FORMATADO.tamanho);
+    } else {
+        std::memcpy(bloco, texto, SEM_SEPARADORES.tamanho);
+    }
+}
+
+// Dígito verificador correspondente a uma soma ponderada (módulo 11)
+static int verificador(int soma)
+{
+    int resto = soma % 11;
+    return resto < 2 ? 0 : 11 - resto;
+}
+
+/**
+ * @brief Confere os dígitos verificadores e monta a chave a partir dos dígitos já extraídos.
+ * @param digitos Valor de cada caractere menos '0', nas posições do formato.
+ * @param f Formato do texto.
+ * @param soma1 Soma ponderada do primeiro dígito verificador.
+ * @param soma2 Soma ponderada do segundo dígito verificador.
+ */
+static std::uint64_t concluir(const std::uint8_t* digitos, const FormatoCpf& f, int soma1, int soma2)
+{
+    if (digitos[f.posicao[9]] != verificador(soma1) || digitos[f.posicao[10]] != verificador(soma2)) {
+        return CPF_INVALIDO;
+    }
+
+    // Grupos de 3, 3, 3 e 2 dígitos calculados independentemente
+    std::uint32_t grupos[4] = {};
+    bool iguais = true;
+    for (int k = 0; k < 11; ++k) {
+        grupos[k / 3] = grupos[k / 3] * 10 + digitos[f.posicao[k]];
+        iguais = iguais && digitos[f.posicao[k]] == digitos[f.posicao[0]];
+    }
+    if (iguais) {
+        return CPF_INVALIDO; // 000.000.000-00, 111.111.111-11 etc. passam no módulo 11, mas não existem
+    }
+    return ((std::uint64_t(grupos[0]) * 1000 + grupos[1]) * 1000 + grupos[2]) * 100 + grupos[3];
+}
+
+// Versão escalar, usada fora do x86
+[[maybe_unused]] static std::uint64_t chave_escalar(const char* texto, const FormatoCpf& f)
+{
+    std::uint8_t digitos[16] = {};
+    int soma1 = 0;
+    int soma2 = 0;
+    for (std::size_t p = 0; p < f.tamanho; ++p) {
+        if (!f.digito[p]) {
+            if (texto[p] != f.modelo[p]) {
+                return CPF_INVALIDO;
+            }
+            continue;
+        }
+        if (texto[p] < '0' || texto[p] > '9') {
+            return CPF_INVALIDO;
+        }
+        digitos[p] = static_cast<std::uint8_t>(texto[p] - '0');
+        soma1 += digitos[p] * f.peso1[p];
+        soma2 += digitos[p] * f.peso2[p];
+    }
+    return concluir(digitos, f, soma1, soma2);
+}
+
+#ifdef CPF_SSE2
+// Soma as 4 parcelas de 32 bits de um registro
+static int somar_parcelas(__m128i s)
+{
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+/**
+ * @brief Confere um CPF com SSE2.
+ * Os 16 bytes do texto (completados com zeros) são conferidos de uma vez: as
+ * posições de dígitos precisam estar entre '0' e '9' e as demais iguais ao
+ * modelo. As duas somas ponderadas saem de multiplicações de 16 bits com os
+ * pesos do formato, que são zero nos separadores.
+ */
+static std::uint64_t chave_sse2(const char* texto, const FormatoCpf& f)
+{
+    alignas(16) char bloco[16] = {};
+    copiar_texto(bloco, texto, f);
+    const __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(bloco));
+    const __m128i mascara_digitos = _mm_load_si128(reinterpret_cast<const __m128i*>(f.digito));
+    const __m128i nove = _mm_set1_epi8(9);
+
+    // Dígitos: c - '0' entre 0 e 9, comparado sem sinal; demais posições: iguais ao modelo
+    const __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i eh_digito = _mm_cmpeq_epi8(_mm_max_epu8(d, nove), nove);
+    const __m128i igual_modelo = _mm_cmpeq_epi8(c, _mm_load_si128(reinterpret_cast<const __m128i*>(f.modelo)));
+    const __m128i corretos = _mm_or_si128(_mm_and_si128(eh_digito, mascara_digitos),
+                                          _mm_andnot_si128(mascara_digitos, igual_modelo));
+    if (_mm_movemask_epi8(corretos) != 0xFFFF) {
+        return CPF_INVALIDO;
+    }
+
+    // Somas ponderadas com os dígitos estendidos para 16 bits
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i baixo = _mm_unpacklo_epi8(d, zero);
+    const __m128i alto = _mm_unpackhi_epi8(d, zero);
+    const __m128i* peso1 = reinterpret_cast<const __m128i*>(f.peso1);
+    const __m128i* peso2 = reinterpret_cast<const __m128i*>(f.peso2);
+    int soma1 = somar_parcelas(_mm_add_epi32(_mm_madd_epi16(baixo, _mm_load_si128(peso1)),
+                                             _mm_madd_epi16(alto, _mm_load_si128(peso1 + 1))));
+    int soma2 = somar_parcelas(_mm_add_epi32(_mm_madd_epi16(baixo, _mm_load_si128(peso2)),
+                                             _mm_madd_epi16(alto, _mm_load_si128(peso2 + 1))));
+
+    alignas(16) std::uint8_t digitos[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(digitos), d);
+    return concluir(digitos, f, soma1, soma2);
+}
+#endif
+
+#ifdef CPF_AVX2
+// Junta os mesmos dados de dois formatos em um registro de 256 bits
+static __m256i par(const void* a, const void* b)
+{
+    return _mm256_set_m128i(_mm_load_si128(static_cast<const __m128i*>(b)),
+                            _mm_load_si128(static_cast<const __m128i*>(a)));
+}
+
+// Soma as parcelas de cada metade de 128 bits
+static void somar_parcelas(__m256i s, int& a, int& b)
+{
+    s = _mm256_add_epi32(s, _mm256_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm256_add_epi32(s, _mm256_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    a = _mm_cvtsi128_si32(_mm256_castsi256_si128(s));
+    b = _mm_cvtsi128_si32(_mm256_extracti128_si256(s, 1));
+}
+
+// Confere dois CPFs de uma vez com AVX2, um em cada metade do registro (mesmo método de chave_sse2)
+static void chaves_avx2(const char* texto_a, const FormatoCpf& fa, const char* texto_b, const FormatoCpf& fb,
+                        std::uint64_t& chave_a, std::uint64_t& chave_b)
+{
+    alignas(32) char bloco[32] = {};
+    copiar_texto(bloco, texto_a, fa);
+    copiar_texto(bloco + 16, texto_b, fb);
+    const __m256i c = _mm256_load_si256(reinterpret_cast<const __m256i*>(bloco));
+    const __m256i mascara_digitos = par(fa.digito, fb.digito);
+    const __m256i nove = _mm256_set1_epi8(9);
+
+    const __m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    const __m256i eh_digito = _mm256_cmpeq_epi8(_mm256_max_epu8(d, nove), nove);
+    const __m256i igual_modelo = _mm256_cmpeq_epi8(c, par(fa.modelo, fb.modelo));
+    const __m256i corretos = _mm256_or_si256(_mm256_and_si256(eh_digito, mascara_digitos),
+                                             _mm256_andnot_si256(mascara_digitos, igual_modelo));
+    const unsigned mascara = static_cast<unsigned>(_mm256_movemask_epi8(corretos));
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i baixo = _mm256_unpacklo_epi8(d, zero); // Bytes 0 a 7 de cada metade
+    const __m256i alto = _mm256_unpackhi_epi8(d, zero);  // Bytes 8 a 15 de cada metade
+    int soma1_a, soma1_b, soma2_a, soma2_b;
+    somar_parcelas(_mm256_add_epi32(_mm256_madd_epi16(baixo, par(fa.peso1, fb.peso1)),
+                                    _mm256_madd_epi16(alto, par(fa.peso1 + 8, fb.peso1 + 8))), soma1_a, soma1_b);
+    somar_parcelas(_mm256_add_epi32(_mm256_madd_epi16(baixo, par(fa.peso2, fb.peso2)),
+                                    _mm256_madd_epi16(alto, par(fa.peso2 + 8, fb.peso2 + 8))), soma2_a, soma2_b);
+
+    alignas(32) std::uint8_t digitos[32];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(digitos), d);
+    chave_a = (mascara & 0xFFFFu) == 0xFFFFu ? concluir(digitos, fa, soma1_a, soma2_a) : CPF_INVALIDO;
+    chave_b = (mascara >> 16) == 0xFFFFu ? concluir(digitos + 16, fb, soma1_b, soma2_b) : CPF_INVALIDO;
+}
+#endif
+
+// Confere um CPF com o formato já identificado
+static std::uint64_t chave_de(const char* texto, const FormatoCpf& f)
+{
+#ifdef CPF_SSE2
+    return chave_sse2(texto, f);
+#else
+    return chave_escalar(texto, f);
+#endif
+}
+
+std::uint64_t cpf_para_chave(const char* texto, std::size_t tamanho)
+{
+    const FormatoCpf* f = formato_de(tamanho);
+    return f != nullptr ? chave_de(texto, *f) : CPF_INVALIDO;
+}
+
+std::size_t cpfs_para_chaves(const std::string_view* cpfs, std::size_t n, std::uint64_t* chaves)
+{
+    std::size_t validos = 0;
+    std::size_t i = 0;
+#ifdef CPF_AVX2
+    for (; i + 1 < n; i += 2) {
+        const FormatoCpf* fa = formato_de(cpfs[i].size());
+        const FormatoCpf* fb = formato_de(cpfs[i + 1].size());
+        if (fa != nullptr && fb != nullptr) {
+            chaves_avx2(cpfs[i].data(), *fa, cpfs[i + 1].data(), *fb, chaves[i], chaves[i + 1]);
+        } else {
+            chaves[i] = fa != nullptr ? chave_de(cpfs[i].data(), *fa) : CPF_INVALIDO;
+            chaves[i + 1] = fb != nullptr ? chave_de(cpfs[i + 1].data(), *fb) : CPF_INVALIDO;
+        }
+        validos += (chaves[i] != CPF_INVALIDO) + (chaves[i + 1] != CPF_INVALIDO);
+    }
+#endif
+    for (; i < n; ++i) {
+        chaves[i] = cpf_para_chave(cpfs[i].data(), cpfs[i].size());
+        validos += chaves[i] != CPF_INVALIDO;
+    }
+    return validos;
+}
+
+std::string chave_para_cpf(std::uint64_t chave)
+{
+    std::string cpf(TAMANHO_CPF_FORMATADO, '0');
+    escrever_cpf(chave, &cpf[0]);
+    return cpf;
+}
+
+void escrever_cpf(std::uint64_t chave, char* destino)
+{
+    // Preenche os dígitos da direita para a esquerda, com os separadores nas posições fixas
+    for (int i = static_cast<int>(TAMANHO_CPF_FORMATADO) - 1; i >= 0; --i) {
+        if (i == 3 || i == 7) {
+            destino[i] = '.';
+        } else if (i == 11) {
+            destino[i] = '-';
+        } else {
+            destino[i] = static_cast<char>('0' + chave % 10);
+            chave /= 10;
+        }
+    }
+}
+
+std::uint64_t completar_cpf(std::uint32_t base)
+{
+    int d[11];
+    for (int k = 8; k >= 0; --k) {
+        d[k] = static_cast<int>(base % 10);
+        base /= 10;
+    }
+    for (int v = 9; v <= 10; ++v) {
+        int soma = 0;
+        for (int k = 0; k < v; ++k) {
+            soma += d[k] * (v + 1 - k);
+        }
+        int resto = soma % 11;
+        d[v] = resto < 2 ? 0 : 11 - resto;
+    }
+    std::uint64_t chave = 0;
+    for (int k = 0; k < 11; ++k) {
+        chave = chave * 10 + d[k];
+    }
+    return chave;
+}
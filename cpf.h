@@ -0,0 +1,84 @@
+#ifndef CPF_H
+#define CPF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Valor retornado quando o texto não contém um CPF válido
+const std::uint64_t CPF_INVALIDO = ~std::uint64_t(0);
+
+/**
+ * @brief Valida um CPF e o converte em uma chave inteira compacta.
+ * Aceita o formato XXX.XXX.XXX-XX ou os 11 dígitos sem separadores, confere
+ * os dois dígitos verificadores (módulo 11) e rejeita CPFs com todos os
+ * dígitos iguais. Os 11 dígitos são lidos como um número decimal (menor que
+ * 2^37), de forma que "123.456.789-09" e "12345678909" geram a mesma chave.
+ * Em x86 a conferência usa SSE2 (ou AVX2 no lote, se habilitado na compilação);
+ * nas demais arquiteturas, uma versão escalar equivalente.
+ * @param texto Caracteres do CPF.
+ * @param tamanho Quantidade de caracteres.
+ * @return Chave do CPF ou CPF_INVALIDO.
+ */
+std::uint64_t cpf_para_chave(const char* texto, std::size_t tamanho);
+
+inline std::uint64_t cpf_para_chave(const std::string& cpf)
+{
+    return cpf_para_chave(cpf.data(), cpf.size());
+}
+
+/**
+ * @brief Verifica se o texto é um CPF válido (ver cpf_para_chave).
+ */
+inline bool cpf_valido(const std::string& cpf)
+{
+    return cpf_para_chave(cpf) != CPF_INVALIDO;
+}
+
+/**
+ * @brief Valida e converte uma coluna inteira de CPFs.
+ * Equivale a chamar cpf_para_chave para cada texto, processando vários CPFs
+ * por iteração quando o processador permite.
+ * @param cpfs Textos dos CPFs.
+ * @param n Quantidade de CPFs.
+ * @param chaves Recebe a chave de cada CPF, ou CPF_INVALIDO (n posições).
+ * @return Quantidade de CPFs válidos.
+ */
+std::size_t cpfs_para_chaves(const std::string_view* cpfs, std::size_t n, std::uint64_t* chaves);
+
+inline std::vector<std::uint64_t> cpfs_para_chaves(const std::vector<std::string_view>& cpfs)
+{
+    std::vector<std::uint64_t> chaves(cpfs.size());
+    cpfs_para_chaves(cpfs.data(), cpfs.size(), chaves.data());
+    return chaves;
+}
+
+/**
+ * @brief Converte a chave compacta de volta para o CPF no formato XXX.XXX.XXX-XX.
+ * @param chave Chave gerada por cpf_para_chave.
+ * @return CPF formatado.
+ */
+std::string chave_para_cpf(std::uint64_t chave);
+
+// Tamanho do CPF formatado por escrever_cpf
+const std::size_t TAMANHO_CPF_FORMATADO = 14;
+
+/**
+ * @brief Escreve o CPF no formato XXX.XXX.XXX-XX sem alocar memória.
+ * @param chave Chave gerada por cpf_para_chave.
+ * @param destino Recebe os TAMANHO_CPF_FORMATADO caracteres, sem terminador.
+ */
+void escrever_cpf(std::uint64_t chave, char* destino);
+
+/**
+ * @brief Completa os 9 primeiros dígitos de um CPF com os dígitos verificadores.
+ * Usado para gerar CPFs de teste; bases com todos os dígitos iguais geram CPFs
+ * que cpf_para_chave rejeita.
+ * @param base Nove primeiros dígitos, lidos como um número decimal (menor que 10^9).
+ * @return Chave do CPF completo (ver cpf_para_chave).
+ */
+std::uint64_t completar_cpf(std::uint32_t base);
+
+#endif // CPF_H
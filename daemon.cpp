@@ -0,0 +1,143 @@
+// Serviço da triagem sem interface gráfica (b1d).
+//
+// Mantém a fila em um único processo e a serve pelo protocolo de protocolo.h
+// em um socket Unix: vários guichês, telas de chamada (que assinam as
+// notificações de mudança) e ferramentas de carga usam a mesma fila ao mesmo
+// tempo. O tratamento avança um passo a cada --passo milissegundos, com as
+// mesmas estações e o mesmo envelhecimento da interface se nada for informado.
+// Com --dados, a fila é recuperada e persistida no diretório (ver diario.h),
+// no mesmo formato da interface, e os pacientes que saem da fila são selados
+// no histórico em disco (ver historico.h), que passa a guardar os nomes e emails
+// deles no lugar da memória; sem ele, tudo existe apenas em memória.
+// Encerra com SIGINT ou SIGTERM, gravando o diário pendente.
+//
+// Uso: b1d [--socket caminho] [--dados diretorio] [--passo ms] [--estacoes afinidade,afinidade,...]
+//          [--envelhecimento P]
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "diario.h"
+#include "historico.h"
+#include "paciente.h"
+#include "protocolo.h"
+#include "servidor.h"
+#include "triagem.h"
+
+static std::atomic<bool> encerrar{false};
+
+static void pedir_encerramento(int)
+{
+    encerrar.store(true);
+}
+
+// Lê as afinidades separadas por vírgula (máscaras de sintomas; 0 atende qualquer paciente)
+static bool ler_estacoes(const char* texto, std::vector<unsigned>& afinidades)
+{
+    afinidades.clear();
+    const char* p = texto;
+    while (true) {
+        char* fim;
+        unsigned long afinidade = std::strtoul(p, &fim, 10);
+        if (fim == p || afinidade > 255) {
+            return false;
+        }
+        afinidades.push_back(static_cast<unsigned>(afinidade));
+        if (*fim == '\0') {
+            return true;
+        }
+        if (*fim != ',') {
+            return false;
+        }
+        p = fim + 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string caminho = Protocolo::caminho_padrao();
+    const char* dados = nullptr;                                 // Diretório do diário (nullptr: só em memória)
+    long long passo_ms = 1000;                                   // Um passo por segundo, como na interface
+    std::vector<unsigned> afinidades = {0, 0, AVC | ACIDENTE};   // Estações da interface
+    std::int64_t passos_por_nivel = 30;                          // Envelhecimento da interface
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            caminho = argv[++i];
+        } else if (std::strcmp(argv[i], "--dados") == 0 && i + 1 < argc) {
+            dados = argv[++i];
+        } else if (std::strcmp(argv[i], "--passo") == 0 && i + 1 < argc) {
+            passo_ms = std::strtoll(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--estacoes") == 0 && i + 1 < argc && ler_estacoes(argv[i + 1], afinidades)) {
+            i++;
+        } else if (std::strcmp(argv[i], "--envelhecimento") == 0 && i + 1 < argc) {
+            passos_por_nivel = std::strtoll(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr,
+                         "uso: %s [--socket caminho] [--dados diretorio] [--passo ms]\n"
+                         "       [--estacoes afinidade,afinidade,...] [--envelhecimento P]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    // Sem SA_RESTART: o sinal interrompe o poll() do servidor, que encerra logo em seguida
+    struct sigaction acao{};
+    acao.sa_handler = pedir_encerramento;
+    sigemptyset(&acao.sa_mask);
+    sigaction(SIGINT, &acao, nullptr);
+    sigaction(SIGTERM, &acao, nullptr);
+    std::signal(SIGPIPE, SIG_IGN); // Um cliente que fecha a conexão não derruba o serviço
+
+    Triagem triagem;
+    std::unique_ptr<Diario> diario;
+    std::unique_ptr<Historico> historico;
+    if (dados != nullptr) {
+        diario.reset(new Diario(dados));
+        if (!diario->abrir(triagem)) {
+            std::fprintf(stderr, "%s: não foi possível recuperar os dados gravados\n", dados);
+            return 1;
+        }
+        historico.reset(new Historico(std::string(dados) + "/historico"));
+        if (!historico->abrir()) {
+            std::fprintf(stderr, "%s/historico: histórico inconsistente\n", dados);
+            return 1;
+        }
+        if (!triagem.arquivar_em(historico.get())) {
+            std::fprintf(stderr, "%s/historico: histórico sem os pacientes já selados\n", dados);
+            return 1;
+        }
+    }
+    triagem.configurar_estacoes(afinidades);
+    triagem.configurar_envelhecimento(passos_por_nivel);
+
+    Servidor servidor(triagem);
+    if (!servidor.abrir(caminho)) {
+        std::fprintf(stderr, "%s: %s\n", caminho.c_str(), std::strerror(errno));
+        return 1;
+    }
+    std::printf("b1d: %zu pacientes na fila, %zu estações, atendendo em %s\n", triagem.tamanho(),
+                triagem.estacoes().size(), caminho.c_str());
+    std::fflush(stdout);
+
+    servidor.executar(std::chrono::milliseconds(passo_ms > 0 ? passo_ms : 0), encerrar);
+
+    std::printf("b1d: %llu pedidos atendidos, %zu pacientes na fila\n",
+                static_cast<unsigned long long>(servidor.pedidos_atendidos()), triagem.tamanho());
+    if (diario) {
+        diario->sincronizar();
+        if (diario->falhou() || historico->falhou()) {
+            std::fprintf(stderr, "%s: falha ao gravar os dados\n", dados);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "data.h"
+
+#include <ctime>
+
+// Algoritmo de Fliegel e Van Flandern para o calendário gregoriano proléptico
+long long dia_juliano(int ano, int mes, int dia)
+{
+    long long a = (14 - mes) / 12;
+    long long y = ano + 4800 - a;
+    long long m = mes + 12 * a - 3;
+    return dia + (153 * m + 2) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 32045;
+}
+
+void data_do_dia_juliano(long long jd, int& ano, int& mes, int& dia)
+{
+    long long a = jd + 32044;
+    long long b = (4 * a + 3) / 146097;
+    long long c = a - 146097 * b / 4;
+    long long d = (4 * c + 3) / 1461;
+    long long e = c - 1461 * d / 4;
+    long long m = (5 * e + 2) / 153;
+    dia = static_cast<int>(e - (153 * m + 2) / 5 + 1);
+    mes = static_cast<int>(m + 3 - 12 * (m / 10));
+    ano = static_cast<int>(100 * b + d - 4800 + m / 10);
+}
+
+long long dia_juliano_hoje()
+{
+    std::time_t agora = std::time(nullptr);
+    std::tm local;
+#ifdef _WIN32
+    localtime_s(&local, &agora);
+#else
+    localtime_r(&agora, &local);
+#endif
+    return dia_juliano(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+int calcular_idade(long long nascimento, long long hoje)
+{
+    int ano_nasc, mes_nasc, dia_nasc;
+    int ano, mes, dia;
+    data_do_dia_juliano(nascimento, ano_nasc, mes_nasc, dia_nasc);
+    data_do_dia_juliano(hoje, ano, mes, dia);
+
+    int idade = ano - ano_nasc; // Calcula a idade básica
+
+    // Ajusta a idade se o aniversário ainda não ocorreu no ano atual
+    if (mes < mes_nasc || (mes == mes_nasc && dia < dia_nasc)) {
+        idade--;
+    }
+    return idade;
+}
+
+// Último dia de nascimento de quem já completou a idade informada
+static long long ultimo_nascimento_com_idade(int idade, long long hoje)
+{
+    int ano, mes, dia;
+    data_do_dia_juliano(hoje, ano, mes, dia);
+
+    // O aniversário no ano de nascimento; 29 de fevereiro em ano comum cai em 1º de março
+    long long candidato = dia_juliano(ano - idade, mes, dia);
+    while (calcular_idade(candidato, hoje) < idade) {
+        candidato--;
+    }
+    while (calcular_idade(candidato + 1, hoje) >= idade) {
+        candidato++;
+    }
+    return candidato;
+}
+
+void faixa_de_nascimento(int idade_minima, int idade_maxima, long long hoje, long long& primeiro, long long& ultimo)
+{
+    ultimo = ultimo_nascimento_com_idade(idade_minima, hoje);
+    primeiro = ultimo_nascimento_com_idade(idade_maxima + 1, hoje) + 1;
+}
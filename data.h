@@ -0,0 +1,48 @@
+#ifndef DATA_H
+#define DATA_H
+
+/**
+ * @brief Converte uma data do calendário gregoriano em dia juliano.
+ * O valor é o mesmo de QDate::toJulianDay, o que permite trocar datas com a
+ * interface Qt sem conversões de texto.
+ * @param ano Ano (positivo).
+ * @param mes Mês (1 a 12).
+ * @param dia Dia do mês.
+ * @return Número do dia juliano.
+ */
+long long dia_juliano(int ano, int mes, int dia);
+
+/**
+ * @brief Converte um dia juliano em data do calendário gregoriano.
+ * @param jd Número do dia juliano.
+ * @param ano Recebe o ano.
+ * @param mes Recebe o mês.
+ * @param dia Recebe o dia do mês.
+ */
+void data_do_dia_juliano(long long jd, int& ano, int& mes, int& dia);
+
+/**
+ * @brief Retorna o dia juliano da data local atual.
+ */
+long long dia_juliano_hoje();
+
+/**
+ * @brief Calcula a idade em anos completos.
+ * @param nascimento Dia juliano do nascimento.
+ * @param hoje Dia juliano da data de referência.
+ * @return Idade em anos.
+ */
+int calcular_idade(long long nascimento, long long hoje);
+
+/**
+ * @brief Calcula as datas de nascimento de quem tem entre idade_minima e idade_maxima anos completos.
+ * Usa as mesmas regras de calcular_idade, inclusive para quem nasceu em 29 de fevereiro.
+ * @param idade_minima Menor idade, em anos.
+ * @param idade_maxima Maior idade, em anos.
+ * @param hoje Dia juliano da data de referência.
+ * @param primeiro Recebe o primeiro dia juliano de nascimento da faixa.
+ * @param ultimo Recebe o último dia juliano de nascimento da faixa (menor que primeiro se a faixa for vazia).
+ */
+void faixa_de_nascimento(int idade_minima, int idade_maxima, long long hoje, long long& primeiro, long long& ultimo);
+
+#endif // DATA_H
@@ -0,0 +1,483 @@
+#include "diario.h"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "arquivomapeado.h"
+#include "binario.h"
+#include "triagem.h"
+
+namespace {
+
+// Tipos de registro do diário
+enum TipoRegistro : std::uint8_t {
+    REGISTRO_ADMISSAO = 1,
+    REGISTRO_REMOCAO = 2,
+    REGISTRO_AVANCO = 3,
+    REGISTRO_ESTACOES = 4,
+    REGISTRO_ENVELHECIMENTO = 5
+};
+
+const char ASSINATURA_INSTANTANEO[8] = {'B', '1', 'I', 'N', 'S', 'T', '0', '5'};
+const std::size_t CABECALHO_REGISTRO = 8;        // Tamanho (u32) e CRC-32 (u32) do conteúdo
+const std::size_t LIMITE_PENDENTES = 1 << 20;    // Bytes pendentes que antecipam a gravação
+
+// CRC-32 (polinômio 0xEDB88320), com as tabelas montadas na primeira chamada. Processa 8 bytes por
+// iteração (slicing-by-8): tabela[k][b] é o CRC do byte b seguido de k bytes zero
+std::uint32_t crc32(const char* dados, std::size_t tamanho)
+{
+    static const auto tabela = [] {
+        std::vector<std::array<std::uint32_t, 256>> t(8);
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[0][i] = c;
+        }
+        for (std::size_t k = 1; k < t.size(); ++k) {
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                t[k][i] = t[0][t[k - 1][i] & 0xFF] ^ (t[k - 1][i] >> 8);
+            }
+        }
+        return t;
+    }();
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(dados);
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (; tamanho >= 8; tamanho -= 8, p += 8) {
+        std::uint32_t baixo = crc ^ (p[0] | p[1] << 8 | p[2] << 16 | static_cast<std::uint32_t>(p[3]) << 24);
+        std::uint32_t alto = p[4] | p[5] << 8 | p[6] << 16 | static_cast<std::uint32_t>(p[7]) << 24;
+        crc = tabela[7][baixo & 0xFF] ^ tabela[6][(baixo >> 8) & 0xFF] ^ tabela[5][(baixo >> 16) & 0xFF] ^
+              tabela[4][baixo >> 24] ^ tabela[3][alto & 0xFF] ^ tabela[2][(alto >> 8) & 0xFF] ^
+              tabela[1][(alto >> 16) & 0xFF] ^ tabela[0][alto >> 24];
+    }
+    for (; tamanho > 0; --tamanho, ++p) {
+        crc = tabela[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Funções de arquivo de baixo nível, sem buffer da biblioteca padrão
+#ifdef _WIN32
+int abrir_arquivo(const std::string& caminho, bool truncar)
+{
+    int modo = _O_WRONLY | _O_CREAT | _O_BINARY | (truncar ? _O_TRUNC : _O_APPEND);
+    return _open(caminho.c_str(), modo, _S_IREAD | _S_IWRITE);
+}
+bool escrever_tudo(int arquivo, const char* dados, std::size_t tamanho)
+{
+    while (tamanho > 0) {
+        int escritos = _write(arquivo, dados, static_cast<unsigned>(tamanho));
+        if (escritos <= 0) {
+            return false;
+        }
+        dados += escritos;
+        tamanho -= static_cast<std::size_t>(escritos);
+    }
+    return true;
+}
+bool sincronizar_arquivo(int arquivo) { return _commit(arquivo) == 0; }
+bool truncar_arquivo(int arquivo, std::uint64_t tamanho) { return _chsize_s(arquivo, static_cast<long long>(tamanho)) == 0; }
+void fechar_arquivo(int arquivo) { _close(arquivo); }
+void sincronizar_diretorio(const std::string&) {}
+#else
+int abrir_arquivo(const std::string& caminho, bool truncar)
+{
+    int modo = O_WRONLY | O_CREAT | O_CLOEXEC | (truncar ? O_TRUNC : O_APPEND);
+    return open(caminho.c_str(), modo, 0644);
+}
+bool escrever_tudo(int arquivo, const char* dados, std::size_t tamanho)
+{
+    while (tamanho > 0) {
+        ssize_t escritos = write(arquivo, dados, tamanho);
+        if (escritos <= 0) {
+            return false;
+        }
+        dados += escritos;
+        tamanho -= static_cast<std::size_t>(escritos);
+    }
+    return true;
+}
+bool sincronizar_arquivo(int arquivo) { return fdatasync(arquivo) == 0; }
+bool truncar_arquivo(int arquivo, std::uint64_t tamanho) { return ftruncate(arquivo, static_cast<off_t>(tamanho)) == 0; }
+void fechar_arquivo(int arquivo) { close(arquivo); }
+
+// Garante que a renomeação do instantâneo também chegue ao disco
+void sincronizar_diretorio(const std::string& diretorio)
+{
+    int d = open(diretorio.c_str(), O_RDONLY | O_CLOEXEC);
+    if (d != -1) {
+        fsync(d);
+        close(d);
+    }
+}
+#endif
+
+} // namespace
+
+Diario::Diario(std::string diretorio, std::size_t eventos_por_instantaneo, std::chrono::milliseconds intervalo)
+    : diretorio(std::move(diretorio))
+    , eventos_por_instantaneo(eventos_por_instantaneo)
+    , intervalo(intervalo)
+{
+    caminho_diario = (std::filesystem::path(this->diretorio) / "diario.log").string();
+    caminho_instantaneo = (std::filesystem::path(this->diretorio) / "instantaneo.bin").string();
+}
+
+Diario::~Diario()
+{
+    if (escritor.joinable()) {
+        {
+            std::lock_guard<std::mutex> guarda(trava);
+            parar = true;
+        }
+        acordar.notify_one();
+        escritor.join();
+    }
+    if (arquivo != -1) {
+        fechar_arquivo(arquivo);
+    }
+}
+
+bool Diario::abrir(Triagem& triagem)
+{
+    std::error_code erro_diretorio;
+    std::filesystem::create_directories(diretorio, erro_diretorio);
+    if (erro_diretorio) {
+        return false;
+    }
+    triagem.registrar_em(nullptr); // A reaplicação não pode gerar novos registros
+
+    // Carrega o último instantâneo
+    std::uint64_t numero_instantaneo = 0;
+    {
+        ArquivoMapeado instantaneo(caminho_instantaneo);
+        if (instantaneo.existe()) {
+            Leitor leitor(instantaneo.dados(), instantaneo.tamanho());
+            char assinatura[sizeof(ASSINATURA_INSTANTANEO)];
+            std::uint64_t tamanho;
+            std::uint32_t crc;
+            if (!leitor.bytes(assinatura, sizeof(assinatura)) ||
+                std::memcmp(assinatura, ASSINATURA_INSTANTANEO, sizeof(assinatura)) != 0 ||
+                !leitor.u64(numero_instantaneo) || !leitor.u64(tamanho) || !leitor.u32(crc) ||
+                leitor.restante() != tamanho) {
+                return false;
+            }
+            const char* estado = instantaneo.dados() + (instantaneo.tamanho() - tamanho);
+            Leitor leitor_estado(estado, tamanho);
+            if (crc32(estado, tamanho) != crc || !triagem.carregar(leitor_estado)) {
+                return false;
+            }
+        }
+    }
+
+    // Reaplica os registros posteriores ao instantâneo, até o primeiro registro inválido
+    std::uint64_t ultimo = numero_instantaneo;
+    std::uint64_t fim_valido = 0;
+    {
+        ArquivoMapeado diario(caminho_diario);
+        const char* dados = diario.dados();
+        std::size_t tamanho = diario.existe() ? diario.tamanho() : 0;
+        while (tamanho - fim_valido >= CABECALHO_REGISTRO) {
+            Leitor cabecalho(dados + fim_valido, CABECALHO_REGISTRO);
+            std::uint32_t tamanho_registro, crc;
+            cabecalho.u32(tamanho_registro);
+            cabecalho.u32(crc);
+            const char* conteudo = dados + fim_valido + CABECALHO_REGISTRO;
+            if (tamanho_registro > tamanho - fim_valido - CABECALHO_REGISTRO ||
+                crc32(conteudo, tamanho_registro) != crc) {
+                break; // Registro incompleto: a gravação foi interrompida
+            }
+
+            Leitor leitor(conteudo, tamanho_registro);
+            std::uint64_t numero;
+            std::uint8_t tipo;
+            if (!leitor.u64(numero) || !leitor.u8(tipo)) {
+                break;
+            }
+            if (numero > numero_instantaneo) {
+                if (tipo == REGISTRO_ADMISSAO) {
+                    std::uint64_t cpf;
+                    std::int32_t nascimento;
+                    std::uint8_t sintomas;
+                    std::string_view nome, email;
+                    if (!leitor.u64(cpf) || !leitor.i32(nascimento) || !leitor.u8(sintomas) ||
+                        !leitor.texto(nome) || !leitor.texto(email)) {
+                        break;
+                    }
+                    triagem.admitir_chave(cpf, nome, email, nascimento, sintomas);
+                } else if (tipo == REGISTRO_REMOCAO) {
+                    std::uint64_t cpf;
+                    if (!leitor.u64(cpf)) {
+                        break;
+                    }
+                    triagem.remover_chave(cpf);
+                } else if (tipo == REGISTRO_AVANCO) {
+                    triagem.avancar();
+                } else if (tipo == REGISTRO_ESTACOES) {
+                    std::uint32_t quantidade;
+                    if (!leitor.u32(quantidade) || quantidade > leitor.restante() / sizeof(std::uint32_t)) {
+                        break;
+                    }
+                    // O tamanho já foi conferido: as leituras não falham e valor é sempre lido
+                    std::vector<unsigned> afinidades(quantidade);
+                    for (unsigned& afinidade : afinidades) {
+                        std::uint32_t valor = 0;
+                        leitor.u32(valor);
+                        afinidade = valor;
+                    }
+                    triagem.configurar_estacoes(afinidades);
+                } else if (tipo == REGISTRO_ENVELHECIMENTO) {
+                    std::uint64_t passos_por_nivel;
+                    if (!leitor.u64(passos_por_nivel)) {
+                        break;
+                    }
+                    triagem.configurar_envelhecimento(static_cast<std::int64_t>(passos_por_nivel));
+                } else {
+                    break;
+                }
+                ultimo = numero;
+                eventos_desde_instantaneo++;
+            }
+            fim_valido += CABECALHO_REGISTRO + tamanho_registro;
+        }
+    }
+    proximo_numero = ultimo + 1;
+
+    // Abre o diário para anexação, descartando um registro final incompleto; o que foi
+    // reaplicado é sincronizado, para que conte como durável (ver numero_duravel)
+    arquivo = abrir_arquivo(caminho_diario, false);
+    if (arquivo == -1 || !truncar_arquivo(arquivo, fim_valido) || !sincronizar_arquivo(arquivo)) {
+        return false;
+    }
+    ultimo_agendado = duravel = ultimo;
+
+    escritor = std::thread(&Diario::gravar, this);
+    triagem.registrar_em(this);
+    return true;
+}
+
+void Diario::iniciar_registro(std::uint8_t tipo)
+{
+    registro.clear();
+    Escritor escritor_registro(registro);
+    escritor_registro.u64(proximo_numero++);
+    escritor_registro.u8(tipo);
+}
+
+// Acrescenta o cabeçalho e entrega o registro montado à thread de gravação
+void Diario::concluir_registro()
+{
+    std::uint32_t tamanho = static_cast<std::uint32_t>(registro.size());
+    std::uint32_t crc = crc32(registro.data(), registro.size());
+
+    bool acordar_escritor;
+    {
+        std::lock_guard<std::mutex> guarda(trava);
+        Escritor escritor_pendentes(pendentes);
+        escritor_pendentes.u32(tamanho);
+        escritor_pendentes.u32(crc);
+        escritor_pendentes.bytes(registro.data(), registro.size());
+        agendados++;
+        ultimo_agendado = proximo_numero - 1;
+        acordar_escritor = pendentes.size() >= LIMITE_PENDENTES && !urgente;
+        if (acordar_escritor) {
+            urgente = true;
+        }
+    }
+    eventos_desde_instantaneo++;
+    if (acordar_escritor) {
+        acordar.notify_one();
+    }
+}
+
+void Diario::registrar_admissao(std::uint64_t cpf, std::string_view nome, std::string_view email,
+                                long long nascimento, unsigned sintomas)
+{
+    iniciar_registro(REGISTRO_ADMISSAO);
+    Escritor escritor_registro(registro);
+    escritor_registro.u64(cpf);
+    escritor_registro.i32(static_cast<std::int32_t>(nascimento));
+    escritor_registro.u8(static_cast<std::uint8_t>(sintomas));
+    escritor_registro.texto(nome);
+    escritor_registro.texto(email);
+    concluir_registro();
+}
+
+void Diario::registrar_remocao(std::uint64_t cpf)
+{
+    iniciar_registro(REGISTRO_REMOCAO);
+    Escritor escritor_registro(registro);
+    escritor_registro.u64(cpf);
+    concluir_registro();
+}
+
+void Diario::registrar_avanco()
+{
+    iniciar_registro(REGISTRO_AVANCO);
+    concluir_registro();
+}
+
+void Diario::registrar_estacoes(const std::vector<unsigned>& afinidades)
+{
+    iniciar_registro(REGISTRO_ESTACOES);
+    Escritor escritor_registro(registro);
+    escritor_registro.u32(static_cast<std::uint32_t>(afinidades.size()));
+    for (unsigned afinidade : afinidades) {
+        escritor_registro.u32(afinidade);
+    }
+    concluir_registro();
+}
+
+void Diario::registrar_envelhecimento(std::int64_t passos_por_nivel)
+{
+    iniciar_registro(REGISTRO_ENVELHECIMENTO);
+    Escritor escritor_registro(registro);
+    escritor_registro.u64(static_cast<std::uint64_t>(passos_por_nivel));
+    concluir_registro();
+}
+
+void Diario::instantaneo(const Triagem& triagem)
+{
+    Tarefa tarefa;
+    Escritor escritor_estado(tarefa.estado);
+    triagem.salvar(escritor_estado);
+    tarefa.numero = proximo_numero - 1;
+
+    {
+        // Os registros pendentes vão junto com a tarefa para serem gravados antes dela
+        std::lock_guard<std::mutex> guarda(trava);
+        tarefa.registros_anteriores.swap(pendentes);
+        tarefas.push_back(std::move(tarefa));
+        agendados++;
+        urgente = true;
+    }
+    eventos_desde_instantaneo = 0;
+    acordar.notify_one();
+}
+
+void Diario::sincronizar()
+{
+    std::unique_lock<std::mutex> guarda(trava);
+    if (!escritor.joinable()) {
+        return;
+    }
+    std::uint64_t alvo = agendados;
+    urgente = true;
+    acordar.notify_one();
+    gravado.wait(guarda, [&] { return concluidos >= alvo; });
+}
+
+std::uint64_t Diario::numero_duravel() const
+{
+    std::lock_guard<std::mutex> guarda(trava);
+    return duravel;
+}
+
+bool Diario::falhou() const
+{
+    std::lock_guard<std::mutex> guarda(trava);
+    return erro;
+}
+
+bool Diario::gravar_diario(const std::vector<char>& dados)
+{
+    return dados.empty() || escrever_tudo(arquivo, dados.data(), dados.size());
+}
+
+// Grava o instantâneo em um arquivo temporário e o renomeia sobre o anterior
+bool Diario::gravar_instantaneo(const Tarefa& tarefa)
+{
+    std::string temporario = caminho_instantaneo + ".tmp";
+    int f = abrir_arquivo(temporario, true);
+    if (f == -1) {
+        return false;
+    }
+
+    std::vector<char> cabecalho;
+    Escritor escritor_cabecalho(cabecalho);
+    escritor_cabecalho.bytes(ASSINATURA_INSTANTANEO, sizeof(ASSINATURA_INSTANTANEO));
+    escritor_cabecalho.u64(tarefa.numero);
+    escritor_cabecalho.u64(tarefa.estado.size());
+    escritor_cabecalho.u32(crc32(tarefa.estado.data(), tarefa.estado.size()));
+
+    bool ok = escrever_tudo(f, cabecalho.data(), cabecalho.size()) &&
+              escrever_tudo(f, tarefa.estado.data(), tarefa.estado.size()) &&
+              sincronizar_arquivo(f);
+    fechar_arquivo(f);
+    if (!ok) {
+        return false;
+    }
+
+    std::error_code erro_renomear;
+    std::filesystem::rename(temporario, caminho_instantaneo, erro_renomear);
+    if (erro_renomear) {
+        return false;
+    }
+    sincronizar_diretorio(diretorio);
+    return true;
+}
+
+// Laço da thread de gravação: grava os registros acumulados a cada intervalo
+void Diario::gravar()
+{
+    std::vector<char> lote;
+    std::vector<Tarefa> lote_tarefas;
+    std::unique_lock<std::mutex> guarda(trava);
+    while (true) {
+        acordar.wait_for(guarda, intervalo, [this] { return urgente || parar; });
+        bool encerrar = parar;
+        if (pendentes.empty() && tarefas.empty()) {
+            urgente = false;
+            gravado.notify_all();
+            if (encerrar) {
+                break;
+            }
+            continue;
+        }
+
+        lote.swap(pendentes);
+        lote_tarefas.swap(tarefas);
+        std::uint64_t alvo = agendados;
+        std::uint64_t numero_alvo = ultimo_agendado;
+        urgente = false;
+        guarda.unlock();
+
+        bool ok = true;
+        for (const Tarefa& tarefa : lote_tarefas) {
+            // Registros anteriores ao instantâneo, depois o instantâneo; como ele
+            // contém esses registros, o diário pode ser truncado em seguida
+            ok = gravar_diario(tarefa.registros_anteriores) && ok;
+            if (gravar_instantaneo(tarefa)) {
+                ok = truncar_arquivo(arquivo, 0) && ok;
+            } else {
+                ok = false;
+            }
+        }
+        ok = gravar_diario(lote) && sincronizar_arquivo(arquivo) && ok;
+        lote.clear();
+        lote_tarefas.clear();
+
+        guarda.lock();
+        concluidos = alvo;
+        erro = erro || !ok;
+        if (!erro) {
+            duravel = numero_alvo;
+        }
+        gravado.notify_all();
+    }
+}
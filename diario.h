@@ -0,0 +1,143 @@
+#ifndef DIARIO_H
+#define DIARIO_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class Triagem;
+
+/**
+ * @brief Diário de operações (write-ahead log) e instantâneos da triagem.
+ *
+ * Cada admissão, atualização, remoção, passo de tratamento e mudança das
+ * estações de tratamento ou do envelhecimento da prioridade é anexado a um
+ * arquivo binário de registros com tamanho, CRC-32 e número de sequência. Os
+ * registros são apenas copiados para um buffer em memória por quem chama; uma
+ * thread de gravação junta os registros acumulados e os grava com um único
+ * write + fdatasync a cada intervalo (group commit), de modo que o custo do
+ * disco não aparece na interface. Um registro só é considerado durável depois
+ * desse intervalo, ou depois de sincronizar().
+ *
+ * A cada eventos_por_instantaneo registros, o estado completo é serializado
+ * e gravado pela mesma thread em um arquivo temporário, renomeado de forma
+ * atômica sobre o instantâneo anterior; em seguida o diário é truncado. Na
+ * recuperação o instantâneo é mapeado em memória e apenas os registros
+ * posteriores a ele são reaplicados. Um registro incompleto ou corrompido no
+ * fim do diário (queda durante a gravação) encerra a reaplicação e é descartado.
+ */
+class Diario
+{
+public:
+    /**
+     * @brief Cria o diário sem abrir arquivos.
+     * @param diretorio Diretório onde ficam diario.log e instantaneo.bin.
+     * @param eventos_por_instantaneo Quantidade de registros entre dois instantâneos.
+     * @param intervalo Intervalo máximo entre duas gravações em disco.
+     */
+    explicit Diario(std::string diretorio, std::size_t eventos_por_instantaneo = 100000,
+                    std::chrono::milliseconds intervalo = std::chrono::milliseconds(5));
+
+    // Grava os registros pendentes e encerra a thread de gravação
+    ~Diario();
+
+    Diario(const Diario&) = delete;
+    Diario& operator=(const Diario&) = delete;
+
+    /**
+     * @brief Recupera o estado gravado na triagem e passa a registrar as suas operações.
+     * Carrega o último instantâneo, reaplica o diário posterior a ele, descarta
+     * um registro final incompleto e inicia a thread de gravação. A triagem
+     * deve estar vazia e passa a apontar para este diário (ver Triagem::registrar_em).
+     * @param triagem Triagem a ser recuperada.
+     * @return false se o diretório não puder ser usado ou se o instantâneo estiver corrompido.
+     */
+    bool abrir(Triagem& triagem);
+
+    // Registro das operações da triagem (chamados pela própria Triagem)
+    void registrar_admissao(std::uint64_t cpf, std::string_view nome, std::string_view email,
+                            long long nascimento, unsigned sintomas);
+    void registrar_remocao(std::uint64_t cpf);
+    void registrar_avanco();
+    void registrar_estacoes(const std::vector<unsigned>& afinidades);
+    void registrar_envelhecimento(std::int64_t passos_por_nivel);
+
+    /**
+     * @brief Verifica se já foram registrados eventos suficientes para um novo instantâneo.
+     */
+    bool precisa_instantaneo() const { return eventos_desde_instantaneo >= eventos_por_instantaneo; }
+
+    /**
+     * @brief Serializa o estado atual e agenda a gravação do instantâneo.
+     * A serialização ocorre na thread que chama; a gravação, na thread de gravação.
+     */
+    void instantaneo(const Triagem& triagem);
+
+    /**
+     * @brief Aguarda até que todos os registros e instantâneos agendados estejam em disco.
+     */
+    void sincronizar();
+
+    /**
+     * @brief Verifica se alguma gravação em disco falhou.
+     */
+    bool falhou() const;
+
+    /**
+     * @brief Número de sequência do último registro anexado.
+     */
+    std::uint64_t ultimo_numero() const { return proximo_numero - 1; }
+
+    /**
+     * @brief Número de sequência do último registro já sincronizado com o disco.
+     * Os registros até ele sobrevivem a uma queda; os posteriores podem se perder.
+     */
+    std::uint64_t numero_duravel() const;
+
+private:
+    // Instantâneo aguardando gravação, com os registros anteriores a ele
+    struct Tarefa {
+        std::vector<char> registros_anteriores;
+        std::vector<char> estado;
+        std::uint64_t numero; // Último registro incluído no estado
+    };
+
+    void iniciar_registro(std::uint8_t tipo);
+    void concluir_registro();
+    void gravar();
+    bool gravar_instantaneo(const Tarefa& tarefa);
+    bool gravar_diario(const std::vector<char>& dados);
+
+    std::string diretorio;
+    std::string caminho_diario;
+    std::string caminho_instantaneo;
+    std::size_t eventos_por_instantaneo;
+    std::chrono::milliseconds intervalo;
+
+    int arquivo = -1;                          // Descritor do diário aberto para anexação
+    std::uint64_t proximo_numero = 1;          // Número de sequência do próximo registro
+    std::size_t eventos_desde_instantaneo = 0; // Registros anexados desde o último instantâneo
+
+    mutable std::mutex trava;
+    std::condition_variable acordar;           // Acorda a thread de gravação
+    std::condition_variable gravado;           // Avisa quem espera em sincronizar()
+    std::vector<char> registro;                // Registro sendo montado pela thread da triagem
+    std::vector<char> pendentes;               // Registros ainda não entregues à thread de gravação
+    std::vector<Tarefa> tarefas;               // Instantâneos agendados
+    std::uint64_t agendados = 0;               // Registros e instantâneos entregues para gravação
+    std::uint64_t concluidos = 0;              // Registros e instantâneos já gravados
+    std::uint64_t ultimo_agendado = 0;         // Número do último registro entregue para gravação
+    std::uint64_t duravel = 0;                 // Número do último registro sincronizado com o disco
+    bool urgente = false;                      // Gravar sem esperar o intervalo
+    bool parar = false;                        // Encerrar a thread de gravação
+    bool erro = false;                         // Alguma gravação falhou
+    std::thread escritor;
+};
+
+#endif // DIARIO_H
@@ -0,0 +1,328 @@
+#include "escalonador.h"
+
+#include <algorithm>
+#include <utility>
+
+// Soma quantidade aos contadores de espera de cada flag presente na prioridade
+void Escalonador::contar_espera(unsigned prioridade, int quantidade)
+{
+    for (std::size_t bit = 0; bit < espera_por_sintoma.size(); ++bit) {
+        if (prioridade & (1u << bit)) {
+            espera_por_sintoma[bit] += quantidade;
+        }
+    }
+}
+
+// Chave da fila: a prioridade vezes passos_nivel menos o passo de chegada, ou só a prioridade sem envelhecimento
+std::int64_t Escalonador::chave(unsigned prioridade, std::int64_t chegada) const
+{
+    if (passos_nivel == 0) {
+        return prioridade;
+    }
+    return static_cast<std::int64_t>(prioridade) * passos_nivel - chegada;
+}
+
+// Situação do handle, aumentando o vetor se necessário
+Escalonador::Situacao& Escalonador::situacao(int handle)
+{
+    if (static_cast<std::size_t>(handle) >= situacoes.size()) {
+        situacoes.resize(handle + 1);
+    }
+    return situacoes[handle];
+}
+
+// Coloca o paciente na espera com a chegada informada
+void Escalonador::esperar(int handle, unsigned prioridade, int ordem, std::int64_t chegada)
+{
+    Situacao& dados = situacao(handle);
+    dados.prioridade = prioridade;
+    dados.chegada = chegada;
+    fila.inserir(handle, chave(prioridade, chegada), ordem);
+    contar_espera(prioridade, 1);
+}
+
+bool Escalonador::configurar(const std::vector<unsigned>& afinidades)
+{
+    std::size_t quantidade = std::max<std::size_t>(afinidades.size(), 1);
+    bool iguais = quantidade == estacoes_tratamento.size();
+    for (std::size_t e = 0; iguais && e < quantidade; ++e) {
+        iguais = estacoes_tratamento[e].afinidade == (e < afinidades.size() ? afinidades[e] : 0);
+    }
+    if (iguais) {
+        return false;
+    }
+
+    // Os pacientes das estações retiradas voltam a esperar, com a chegada original
+    for (std::size_t e = quantidade; e < estacoes_tratamento.size(); ++e) {
+        const Estacao& estacao = estacoes_tratamento[e];
+        if (estacao.paciente != -1) {
+            int handle = estacao.paciente;
+            unsigned prioridade = estacao.prioridade;
+            int ordem = estacao.ordem;
+            liberar(e);
+            esperar(handle, prioridade, ordem, situacoes[handle].chegada);
+        }
+    }
+    estacoes_tratamento.resize(quantidade);
+    for (std::size_t e = 0; e < quantidade; ++e) {
+        estacoes_tratamento[e].afinidade = e < afinidades.size() ? afinidades[e] : 0;
+        estacoes_tratamento[e].evento = NENHUM;
+    }
+    return true;
+}
+
+bool Escalonador::envelhecer(std::int64_t passos_por_nivel)
+{
+    passos_por_nivel = std::min(std::max<std::int64_t>(passos_por_nivel, 0), MAXIMO_PASSOS_POR_NIVEL);
+    if (passos_por_nivel == passos_nivel) {
+        return false;
+    }
+    passos_nivel = passos_por_nivel;
+
+    // Recalcula as chaves de quem espera; a ordem de chegada continua a mesma
+    std::vector<FilaPrioridade::Entrada> entradas = fila.entradas();
+    for (FilaPrioridade::Entrada& entrada : entradas) {
+        const Situacao& dados = situacoes[entrada.handle];
+        entrada.prioridade = chave(dados.prioridade, dados.chegada);
+    }
+    fila.construir(std::move(entradas));
+    return true;
+}
+
+void Escalonador::inserir(int handle, unsigned prioridade, int ordem)
+{
+    esperar(handle, prioridade, ordem, passo_atual);
+}
+
+void Escalonador::alterar_prioridade(int handle, unsigned prioridade)
+{
+    int e = estacao_de(handle);
+    if (e != -1) {
+        estacoes_tratamento[e].prioridade = prioridade;
+        situacoes[handle].prioridade = prioridade;
+        return;
+    }
+    if (fila.contem(handle)) {
+        Situacao& dados = situacoes[handle];
+        contar_espera(dados.prioridade, -1);
+        contar_espera(prioridade, 1);
+        dados.prioridade = prioridade;
+        fila.alterar_prioridade(handle, chave(prioridade, dados.chegada));
+    }
+}
+
+bool Escalonador::remover(int handle)
+{
+    int e = estacao_de(handle);
+    if (e != -1) {
+        liberar(e);
+        return true;
+    }
+    if (!fila.contem(handle)) {
+        return false;
+    }
+    contar_espera(situacoes[handle].prioridade, -1);
+    fila.remover(handle);
+    return true;
+}
+
+void Escalonador::construir(const std::vector<Paciente>& pacientes, std::vector<Estacao> estacoes,
+                            std::int64_t passo)
+{
+    estacoes_tratamento = std::move(estacoes);
+    situacoes.clear();
+    passo_atual = passo;
+    ocupadas = 0;
+    for (std::size_t e = 0; e < estacoes_tratamento.size(); ++e) {
+        if (estacoes_tratamento[e].paciente != -1) {
+            situacao(estacoes_tratamento[e].paciente).estacao = static_cast<int>(e);
+            ocupadas++;
+        }
+    }
+
+    // Quem está em tratamento fica na estação, com a prioridade e a ordem informadas
+    espera_por_sintoma.fill(0);
+    std::vector<FilaPrioridade::Entrada> entradas;
+    entradas.reserve(pacientes.size() - ocupadas);
+    for (const Paciente& paciente : pacientes) {
+        Situacao& dados = situacao(paciente.handle);
+        dados.prioridade = paciente.prioridade;
+        dados.chegada = paciente.chegada;
+        if (dados.estacao != -1) {
+            estacoes_tratamento[dados.estacao].prioridade = paciente.prioridade;
+            estacoes_tratamento[dados.estacao].ordem = paciente.ordem;
+            continue;
+        }
+        contar_espera(paciente.prioridade, 1);
+        entradas.push_back(FilaPrioridade::Entrada{chave(paciente.prioridade, paciente.chegada), paciente.ordem,
+                                                   paciente.handle});
+    }
+    fila.construir(std::move(entradas));
+}
+
+// Encerra o tratamento da estação e a deixa livre
+void Escalonador::liberar(std::size_t e)
+{
+    Estacao& estacao = estacoes_tratamento[e];
+    situacoes[estacao.paciente].estacao = -1;
+    estacao.paciente = -1;
+    estacao.prioridade = 0;
+    estacao.ordem = -1;
+    estacao.tempo = -1;
+    estacao.duracao = 0;
+    estacao.progresso = 0;
+    ocupadas--;
+}
+
+/**
+ * @brief Escolhe o próximo paciente que espera.
+ * @param afinidade Sintomas exigidos (o paciente precisa ter pelo menos um), ou 0 para qualquer paciente.
+ * @return Handle do paciente ou -1 se nenhum servir.
+ */
+int Escalonador::proximo_da_espera(unsigned afinidade) const
+{
+    if (afinidade == 0) {
+        return fila.topo();
+    }
+
+    // Os contadores evitam percorrer a fila inteira quando ninguém tem os sintomas da afinidade
+    bool alguem = false;
+    for (std::size_t bit = 0; bit < espera_por_sintoma.size(); ++bit) {
+        alguem = alguem || ((afinidade & (1u << bit)) && espera_por_sintoma[bit] > 0);
+    }
+    if (!alguem) {
+        return -1;
+    }
+    return fila.primeiro_aceito([this, afinidade](const FilaPrioridade::Entrada& entrada) {
+        return (situacoes[entrada.handle].prioridade & afinidade) != 0;
+    });
+}
+
+// Tira o paciente da espera e inicia o seu tratamento na estação livre e
+void Escalonador::chamar(std::size_t e, int handle)
+{
+    Situacao& dados = situacoes[handle];
+    int ordem = fila.entrada(handle).ordem;
+    contar_espera(dados.prioridade, -1);
+    fila.remover(handle);
+
+    Estacao& estacao = estacoes_tratamento[e];
+    estacao.paciente = handle;
+    estacao.prioridade = dados.prioridade;
+    estacao.ordem = ordem;
+    estacao.duracao = static_cast<int>(dados.prioridade) + 1; // Define o tempo de tratamento baseado nos sintomas
+    estacao.tempo = estacao.duracao;
+    estacao.progresso = 0;
+    estacao.evento = CHAMADO;
+    dados.estacao = static_cast<int>(e);
+    ocupadas++;
+}
+
+std::int64_t Escalonador::passos_ate_evento() const
+{
+    if (ocupadas < estacoes_tratamento.size() && !fila.vazia()) {
+        return 1;
+    }
+    std::int64_t menor = -1;
+    for (const Estacao& estacao : estacoes_tratamento) {
+        if (estacao.paciente != -1 && (menor == -1 || estacao.tempo < menor)) {
+            menor = estacao.tempo;
+        }
+    }
+    return menor;
+}
+
+bool Escalonador::avancar(std::int64_t passos)
+{
+    concluidos_no_passo.clear();
+    std::int64_t limite = passos_ate_evento();
+    passos = limite > 0 ? std::min(std::max<std::int64_t>(passos, 1), limite) : 1;
+    if (!vazio()) {
+        passo_atual += passos; // Sem pacientes, o tempo não conta para o envelhecimento
+    }
+    bool houve_evento = false;
+
+    // Os tratamentos em andamento avançam; as estações liberadas só chamam no próximo passo
+    for (std::size_t e = 0; e < estacoes_tratamento.size(); ++e) {
+        Estacao& estacao = estacoes_tratamento[e];
+        estacao.evento = NENHUM;
+        if (estacao.paciente == -1) {
+            continue;
+        }
+        estacao.tempo -= static_cast<int>(passos);
+        int sintomas = estacao.duracao - 1;
+        estacao.progresso = sintomas > 0 ? (sintomas - estacao.tempo) * 100 / sintomas : 100; // Calcula a porcentagem de conclusão
+        estacao.evento = PROGRESSO;
+        if (estacao.tempo == 0) {
+            concluidos_no_passo.push_back(estacao.paciente);
+            liberar(e);
+            estacao.evento = CONCLUIDO;
+        }
+        houve_evento = true;
+    }
+
+    // As estações livres com afinidade chamam primeiro; depois, as demais estações livres
+    for (int rodada = 0; rodada < 2 && !fila.vazia(); ++rodada) {
+        for (std::size_t e = 0; e < estacoes_tratamento.size(); ++e) {
+            const Estacao& estacao = estacoes_tratamento[e];
+            if (estacao.paciente != -1 || estacao.evento != NENHUM || (rodada == 0 && estacao.afinidade == 0)) {
+                continue;
+            }
+            int handle = proximo_da_espera(rodada == 0 ? estacao.afinidade : 0);
+            if (handle != -1) {
+                chamar(e, handle);
+                houve_evento = true;
+            }
+        }
+    }
+    return houve_evento;
+}
+
+// Entradas dos pacientes em tratamento, com a mesma chave da fila, na ordem de atendimento
+std::vector<FilaPrioridade::Entrada> Escalonador::em_tratamento() const
+{
+    std::vector<FilaPrioridade::Entrada> entradas;
+    for (const Estacao& estacao : estacoes_tratamento) {
+        if (estacao.paciente != -1) {
+            entradas.push_back(FilaPrioridade::Entrada{
+                chave(estacao.prioridade, situacoes[estacao.paciente].chegada), estacao.ordem, estacao.paciente});
+        }
+    }
+    std::sort(entradas.begin(), entradas.end(), FilaPrioridade::precede);
+    return entradas;
+}
+
+// Intercala os pacientes em tratamento com os handles da espera, já em ordem de atendimento
+static std::vector<int> intercalar(const FilaPrioridade& fila, const std::vector<int>& esperando,
+                                   const std::vector<FilaPrioridade::Entrada>& tratados, std::size_t k)
+{
+    std::vector<int> resultado;
+    resultado.reserve(std::min(k, esperando.size() + tratados.size()));
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (resultado.size() < k && (i < esperando.size() || j < tratados.size())) {
+        if (j == tratados.size() ||
+            (i < esperando.size() && FilaPrioridade::precede(fila.entrada(esperando[i]), tratados[j]))) {
+            resultado.push_back(esperando[i++]);
+        } else {
+            resultado.push_back(tratados[j++].handle);
+        }
+    }
+    return resultado;
+}
+
+std::vector<int> Escalonador::primeiros(std::size_t k) const
+{
+    if (ocupadas == 0) {
+        return fila.primeiros(k);
+    }
+    return intercalar(fila, fila.primeiros(k), em_tratamento(), k);
+}
+
+std::vector<int> Escalonador::ordenados() const
+{
+    if (ocupadas == 0) {
+        return fila.ordenados();
+    }
+    return intercalar(fila, fila.ordenados(), em_tratamento(), tamanho());
+}
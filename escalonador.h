@@ -0,0 +1,225 @@
+#ifndef ESCALONADOR_H
+#define ESCALONADOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "filaprioridade.h"
+
+/**
+ * @brief Regras de espera e tratamento: fila de prioridade e estações de tratamento.
+ *
+ * Os pacientes são identificados por handles inteiros e têm uma prioridade
+ * (as flags de sintomas) e uma ordem de chegada. Quem espera fica em uma fila
+ * de prioridade (ver FilaPrioridade); quem está em tratamento fica na estação
+ * que o chamou até o tratamento terminar. O tempo de um tratamento é a
+ * prioridade do paciente mais um passo.
+ *
+ * A cada passo, as estações ocupadas avançam e as que já estavam livres chamam
+ * o próximo paciente que espera: as estações com afinidade chamam primeiro o
+ * paciente mais prioritário com algum dos seus sintomas e, se não houver, o
+ * mais prioritário de todos, como as demais.
+ *
+ * Para que os pacientes de baixa prioridade não esperem indefinidamente
+ * enquanto chegam pacientes mais graves, a prioridade pode envelhecer (ver
+ * envelhecer()): a cada passos_por_nivel passos de espera, o paciente sobe um
+ * nível. Como todos envelhecem à mesma taxa, a ordem entre dois pacientes não
+ * muda com o tempo e a prioridade efetiva p + (agora - chegada) / passos_por_nivel
+ * equivale à chave fixa p * passos_por_nivel - chegada, calculada uma única vez
+ * na entrada; a fila nunca precisa ser reordenada. O relógio do escalonador
+ * (ver passo()) só anda enquanto há pacientes, de modo que reaplicar os mesmos
+ * passos (do diário, por exemplo) reproduz as mesmas chaves.
+ *
+ * O escalonador não depende do cadastro dos pacientes, de modo que a mesma
+ * regra serve à Triagem e à simulação (ver simulacao.h).
+ */
+class Escalonador
+{
+public:
+    // O que aconteceu em uma estação de tratamento em um passo de avancar()
+    enum EventoTratamento {
+        NENHUM,     // Estação livre e nenhum paciente esperando, nada a fazer
+        CHAMADO,    // Um paciente foi chamado para tratamento
+        PROGRESSO,  // O tratamento em andamento avançou
+        CONCLUIDO   // O tratamento terminou e o paciente saiu do escalonador
+    };
+
+    // Paciente informado a construir() e a percorrer()
+    struct Paciente {
+        int handle;           // Handle do paciente
+        unsigned prioridade;  // Prioridade do paciente (flags de sintomas)
+        int ordem;            // Ordem de chegada usada como critério de desempate
+        std::int64_t chegada; // Passo do escalonador em que o paciente entrou (ver passo())
+    };
+
+    // Estação de tratamento: atende um paciente por vez
+    struct Estacao {
+        unsigned afinidade = 0;           // Sintomas atendidos com preferência (0 para qualquer paciente)
+        int paciente = -1;                // Handle do paciente em tratamento (-1 se a estação está livre)
+        unsigned prioridade = 0;          // Prioridade do paciente em tratamento
+        int ordem = -1;                   // Ordem de chegada do paciente em tratamento
+        int tempo = -1;                   // Tempo restante do tratamento (-1 se a estação está livre)
+        int duracao = 0;                  // Duração total do tratamento em andamento
+        int progresso = 0;                // Porcentagem de conclusão do tratamento em andamento
+        EventoTratamento evento = NENHUM; // O que aconteceu na estação no último avancar()
+    };
+
+    /**
+     * @brief Define as estações de tratamento.
+     * As estações que continuam existindo mantêm o tratamento em andamento; os
+     * pacientes das estações retiradas voltam a esperar. O escalonador começa
+     * com uma única estação sem afinidade.
+     * @param afinidades Afinidade de cada estação (ver Estacao::afinidade); vazio equivale a {0}.
+     * @return false se as estações já eram essas (nada mudou).
+     */
+    bool configurar(const std::vector<unsigned>& afinidades);
+
+    /**
+     * @brief Define o envelhecimento da prioridade dos pacientes que esperam.
+     * As chaves dos pacientes que já esperam são recalculadas (O(n)), cada um
+     * com o passo em que entrou. O escalonador começa sem envelhecimento.
+     * @param passos_por_nivel Passos de espera para subir um nível de prioridade,
+     *        entre 1 e MAXIMO_PASSOS_POR_NIVEL, ou 0 para não envelhecer.
+     * @return false se o envelhecimento já era esse (nada mudou).
+     */
+    bool envelhecer(std::int64_t passos_por_nivel);
+
+    static constexpr std::int64_t MAXIMO_PASSOS_POR_NIVEL = std::int64_t(1) << 32;
+
+    std::int64_t passos_por_nivel() const { return passos_nivel; }
+
+    /**
+     * @brief Passos avançados desde o início, contando apenas os passos com pacientes.
+     */
+    std::int64_t passo() const { return passo_atual; }
+
+    /**
+     * @brief Coloca um paciente na espera, com chegada no passo atual.
+     * @param handle Handle do paciente (não negativo e ainda não presente).
+     * @param prioridade Prioridade do paciente (flags de sintomas).
+     * @param ordem Ordem de chegada usada como critério de desempate.
+     */
+    void inserir(int handle, unsigned prioridade, int ordem);
+
+    /**
+     * @brief Altera a prioridade de um paciente que espera ou está em tratamento.
+     * O paciente mantém a chegada e o envelhecimento já acumulado; um
+     * tratamento em andamento mantém a duração com que começou.
+     */
+    void alterar_prioridade(int handle, unsigned prioridade);
+
+    /**
+     * @brief Retira um paciente que espera ou está em tratamento, liberando a estação.
+     * @return true se o paciente estava no escalonador.
+     */
+    bool remover(int handle);
+
+    /**
+     * @brief Substitui os pacientes e as estações de uma só vez.
+     * Os pacientes que aparecem em alguma estação ficam em tratamento nela; os
+     * demais passam a esperar, com o heap construído em O(n).
+     * @param pacientes Todos os pacientes, com handles distintos e não negativos.
+     * @param estacoes Estações, com pacientes distintos presentes em pacientes (pelo menos uma).
+     * @param passo Relógio do escalonador (ver passo()), não menor que as chegadas.
+     */
+    void construir(const std::vector<Paciente>& pacientes, std::vector<Estacao> estacoes, std::int64_t passo);
+
+    /**
+     * @brief Avança o tratamento em todas as estações.
+     * Com passos > 1, equivale a chamar avancar() essa quantidade de vezes, desde
+     * que nada além do progresso aconteça antes do último passo: passos é
+     * limitado a passos_ate_evento().
+     * @return true se algo aconteceu em alguma estação (ver Estacao::evento).
+     */
+    bool avancar(std::int64_t passos = 1);
+
+    /**
+     * @brief Quantidade de passos até o próximo chamado ou conclusão de tratamento.
+     * @return 1 se há estação livre e paciente esperando, o menor tempo restante
+     *         entre as estações ocupadas, ou -1 se não há nada em andamento.
+     */
+    std::int64_t passos_ate_evento() const;
+
+    /**
+     * @brief Pacientes que concluíram o tratamento no último avancar().
+     */
+    const std::vector<int>& concluidos() const { return concluidos_no_passo; }
+
+    /**
+     * @brief Estação onde o paciente está sendo tratado, ou -1 se ele não está em tratamento.
+     */
+    int estacao_de(int handle) const
+    {
+        return handle >= 0 && static_cast<std::size_t>(handle) < situacoes.size() ? situacoes[handle].estacao : -1;
+    }
+
+    const std::vector<Estacao>& estacoes() const { return estacoes_tratamento; }
+
+    /**
+     * @brief Pacientes que esperam, sem os que estão em tratamento, com a prioridade já envelhecida como chave.
+     */
+    const FilaPrioridade& espera() const { return fila; }
+
+    /**
+     * @brief Retorna os k primeiros pacientes na ordem de atendimento, incluindo os que estão em tratamento.
+     */
+    std::vector<int> primeiros(std::size_t k) const;
+
+    /**
+     * @brief Retorna todos os pacientes na ordem de atendimento, incluindo os que estão em tratamento.
+     */
+    std::vector<int> ordenados() const;
+
+    /**
+     * @brief Executa f(paciente) para cada paciente, esperando ou em tratamento, sem ordem definida.
+     */
+    template <typename F>
+    void percorrer(F f) const
+    {
+        for (const FilaPrioridade::Entrada& entrada : fila.entradas()) {
+            const Situacao& situacao = situacoes[entrada.handle];
+            f(Paciente{entrada.handle, situacao.prioridade, entrada.ordem, situacao.chegada});
+        }
+        for (const Estacao& estacao : estacoes_tratamento) {
+            if (estacao.paciente != -1) {
+                f(Paciente{estacao.paciente, estacao.prioridade, estacao.ordem, situacoes[estacao.paciente].chegada});
+            }
+        }
+    }
+
+    bool contem(int handle) const { return fila.contem(handle) || estacao_de(handle) != -1; }
+    std::size_t tamanho() const { return fila.tamanho() + ocupadas; }
+    bool vazio() const { return fila.vazia() && ocupadas == 0; }
+    std::size_t esperando() const { return fila.tamanho(); }
+    std::size_t estacoes_ocupadas() const { return ocupadas; }
+
+private:
+    // Situação de um handle no escalonador
+    struct Situacao {
+        unsigned prioridade = 0;  // Prioridade (flags de sintomas) do paciente que espera
+        int estacao = -1;         // Estação onde o paciente está em tratamento (-1 se não está)
+        std::int64_t chegada = 0; // Passo em que o paciente entrou
+    };
+
+    std::int64_t chave(unsigned prioridade, std::int64_t chegada) const;
+    Situacao& situacao(int handle);
+    void esperar(int handle, unsigned prioridade, int ordem, std::int64_t chegada);
+    int proximo_da_espera(unsigned afinidade) const;
+    void chamar(std::size_t e, int handle);
+    void liberar(std::size_t e);
+    void contar_espera(unsigned prioridade, int quantidade);
+    std::vector<FilaPrioridade::Entrada> em_tratamento() const;
+
+    FilaPrioridade fila;                                                // Pacientes que esperam, pela chave envelhecida
+    std::vector<Estacao> estacoes_tratamento = std::vector<Estacao>(1); // Estações de tratamento (pelo menos uma)
+    std::vector<Situacao> situacoes;                 // Situação de cada handle
+    std::int64_t passos_nivel = 0;                   // Passos de espera por nível de prioridade (0 sem envelhecimento)
+    std::int64_t passo_atual = 0;                    // Passos avançados com pacientes presentes
+    std::size_t ocupadas = 0;                        // Estações com paciente em tratamento
+    std::array<std::size_t, 8> espera_por_sintoma{}; // Pacientes que esperam, por flag de sintoma
+    std::vector<int> concluidos_no_passo;            // Pacientes que concluíram o tratamento no último passo
+};
+
+#endif // ESCALONADOR_H
@@ -0,0 +1,196 @@
+#include "filaprioridade.h"
+
+#include <algorithm>
+
+#include "ordenacao.h"
+
+bool FilaPrioridade::precede(const Entrada& a, const Entrada& b)
+{
+    if (a.prioridade != b.prioridade) {
+        return a.prioridade > b.prioridade;
+    }
+    return a.ordem < b.ordem;
+}
+
+// Grava a entrada na posição i do heap e atualiza o índice de posições
+void FilaPrioridade::colocar(std::size_t i, const Entrada& entrada)
+{
+    heap[i] = entrada;
+    posicao[entrada.handle] = static_cast<int>(i);
+}
+
+// Move a entrada da posição i em direção à raiz enquanto ela preceder o pai
+void FilaPrioridade::subir(std::size_t i)
+{
+    Entrada entrada = heap[i];
+    while (i > 0) {
+        std::size_t pai = (i - 1) / GRAU;
+        if (!precede(entrada, heap[pai])) {
+            break;
+        }
+        colocar(i, heap[pai]); // Desce o pai para a posição atual
+        i = pai;
+    }
+    colocar(i, entrada);
+}
+
+// Move a entrada da posição i em direção às folhas enquanto algum filho a preceder
+void FilaPrioridade::descer(std::size_t i)
+{
+    Entrada entrada = heap[i];
+    const std::size_t n = heap.size();
+    while (true) {
+        std::size_t primeiro_filho = i * GRAU + 1;
+        if (primeiro_filho >= n) {
+            break;
+        }
+
+        // Procura o filho de maior prioridade
+        std::size_t ultimo_filho = std::min(primeiro_filho + GRAU, n);
+        std::size_t melhor = primeiro_filho;
+        for (std::size_t f = primeiro_filho + 1; f < ultimo_filho; ++f) {
+            if (precede(heap[f], heap[melhor])) {
+                melhor = f;
+            }
+        }
+
+        if (!precede(heap[melhor], entrada)) {
+            break;
+        }
+        colocar(i, heap[melhor]); // Sobe o filho para a posição atual
+        i = melhor;
+    }
+    colocar(i, entrada);
+}
+
+void FilaPrioridade::inserir(int handle, std::int64_t prioridade, int ordem)
+{
+    if (handle >= static_cast<int>(posicao.size())) {
+        posicao.resize(handle + 1, -1); // Aumenta o índice de posições se necessário
+    }
+    heap.push_back(Entrada{prioridade, ordem, handle});
+    subir(heap.size() - 1);
+}
+
+void FilaPrioridade::construir(std::vector<Entrada> novas)
+{
+    heap = std::move(novas);
+    posicao.clear();
+    for (std::size_t i = 0; i < heap.size(); ++i) {
+        if (heap[i].handle >= static_cast<int>(posicao.size())) {
+            posicao.resize(heap[i].handle + 1, -1);
+        }
+        posicao[heap[i].handle] = static_cast<int>(i);
+    }
+
+    // Desce cada nó interno, do último ao primeiro
+    if (heap.size() > 1) {
+        for (std::size_t i = (heap.size() - 2) / GRAU + 1; i-- > 0;) {
+            descer(i);
+        }
+    }
+}
+
+void FilaPrioridade::alterar_prioridade(int handle, std::int64_t prioridade)
+{
+    if (!contem(handle)) {
+        return;
+    }
+    std::size_t i = posicao[handle];
+    std::int64_t anterior = heap[i].prioridade;
+    heap[i].prioridade = prioridade;
+
+    // Reposiciona apenas o paciente alterado
+    if (prioridade > anterior) {
+        subir(i);
+    } else if (prioridade < anterior) {
+        descer(i);
+    }
+}
+
+bool FilaPrioridade::remover(int handle)
+{
+    if (!contem(handle)) {
+        return false;
+    }
+    std::size_t i = posicao[handle];
+    posicao[handle] = -1;
+
+    // Substitui a entrada removida pela última do heap e a reposiciona
+    Entrada ultima = heap.back();
+    heap.pop_back();
+    if (i < heap.size()) {
+        colocar(i, ultima);
+        if (i > 0 && precede(ultima, heap[(i - 1) / GRAU])) {
+            subir(i);
+        } else {
+            descer(i);
+        }
+    }
+    return true;
+}
+
+int FilaPrioridade::remover_topo()
+{
+    if (heap.empty()) {
+        return -1;
+    }
+    int handle = heap.front().handle;
+    remover(handle);
+    return handle;
+}
+
+int FilaPrioridade::topo() const
+{
+    return heap.empty() ? -1 : heap.front().handle;
+}
+
+bool FilaPrioridade::contem(int handle) const
+{
+    return handle >= 0 && handle < static_cast<int>(posicao.size()) && posicao[handle] != -1;
+}
+
+std::vector<int> FilaPrioridade::primeiros(std::size_t k) const
+{
+    std::vector<int> resultado;
+    k = std::min(k, heap.size());
+    resultado.reserve(k);
+
+    // Fronteira de posições candidatas, organizada como heap auxiliar
+    std::vector<std::size_t> fronteira;
+    auto compara = [this](std::size_t a, std::size_t b) { return precede(heap[b], heap[a]); };
+    if (k > 0) {
+        fronteira.push_back(0);
+    }
+
+    while (resultado.size() < k) {
+        std::pop_heap(fronteira.begin(), fronteira.end(), compara);
+        std::size_t i = fronteira.back();
+        fronteira.pop_back();
+        resultado.push_back(heap[i].handle);
+
+        // Os filhos do nó retirado passam a ser candidatos
+        std::size_t primeiro_filho = i * GRAU + 1;
+        std::size_t ultimo_filho = std::min(primeiro_filho + GRAU, heap.size());
+        for (std::size_t f = primeiro_filho; f < ultimo_filho; ++f) {
+            fronteira.push_back(f);
+            std::push_heap(fronteira.begin(), fronteira.end(), compara);
+        }
+    }
+    return resultado;
+}
+
+std::vector<int> FilaPrioridade::ordenados() const
+{
+    std::vector<std::size_t> ordem = ordem_por_prioridade(
+        heap.size(),
+        [this](std::size_t i) { return heap[i].prioridade; },
+        [this](std::size_t i) { return heap[i].ordem; });
+
+    std::vector<int> resultado;
+    resultado.reserve(ordem.size());
+    for (std::size_t i : ordem) {
+        resultado.push_back(heap[i].handle);
+    }
+    return resultado;
+}
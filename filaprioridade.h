@@ -0,0 +1,157 @@
+#ifndef FILAPRIORIDADE_H
+#define FILAPRIORIDADE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Fila de prioridade indexada (heap 4-ário) usada na triagem.
+ *
+ * Cada paciente é identificado por um handle inteiro (posição estável no
+ * armazenamento de pacientes). A fila guarda apenas a prioridade, a ordem de
+ * chegada e o handle, e mantém a posição de cada handle dentro do heap, o que
+ * permite alterar a prioridade ou remover um paciente em O(log n) sem
+ * reordenar a fila inteira.
+ *
+ * Ordem de atendimento: maior prioridade primeiro; em caso de empate, quem
+ * chegou antes (menor ordem de chegada) é atendido primeiro. A prioridade é um
+ * inteiro de 64 bits qualquer: as flags de sintomas ou a chave que já inclui o
+ * envelhecimento da espera (ver Escalonador::envelhecer).
+ */
+class FilaPrioridade
+{
+public:
+    // Entrada armazenada no heap
+    struct Entrada {
+        std::int64_t prioridade; // Prioridade do paciente (maior primeiro)
+        int ordem;               // Ordem de chegada (ID do paciente)
+        int handle;              // Handle do paciente no armazenamento
+    };
+
+    /**
+     * @brief Insere um paciente na fila.
+     * @param handle Handle do paciente (não negativo e ainda não presente na fila).
+     * @param prioridade Prioridade do paciente.
+     * @param ordem Ordem de chegada usada como critério de desempate.
+     */
+    void inserir(int handle, std::int64_t prioridade, int ordem);
+
+    /**
+     * @brief Substitui o conteúdo da fila pelas entradas informadas.
+     * Organiza o heap de baixo para cima em O(n), mais rápido que n inserções.
+     * @param novas Entradas com handles distintos e não negativos.
+     */
+    void construir(std::vector<Entrada> novas);
+
+    /**
+     * @brief Altera a prioridade de um paciente já presente na fila.
+     * @param handle Handle do paciente.
+     * @param prioridade Nova prioridade.
+     */
+    void alterar_prioridade(int handle, std::int64_t prioridade);
+
+    /**
+     * @brief Remove um paciente qualquer da fila.
+     * @param handle Handle do paciente.
+     * @return true se o paciente estava na fila.
+     */
+    bool remover(int handle);
+
+    /**
+     * @brief Remove e retorna o paciente de maior prioridade.
+     * @return Handle do paciente removido ou -1 se a fila estiver vazia.
+     */
+    int remover_topo();
+
+    /**
+     * @brief Retorna o paciente de maior prioridade sem removê-lo.
+     * @return Handle do paciente ou -1 se a fila estiver vazia.
+     */
+    int topo() const;
+
+    /**
+     * @brief Retorna os k primeiros pacientes na ordem de atendimento.
+     * Percorre apenas a parte do heap necessária (O(k log k)).
+     * @param k Quantidade de pacientes desejada.
+     * @return Handles dos pacientes em ordem de atendimento.
+     */
+    std::vector<int> primeiros(std::size_t k) const;
+
+    /**
+     * @brief Retorna o primeiro paciente, na ordem de atendimento, aceito por um critério.
+     * Percorre o heap do topo para baixo como primeiros(), parando no primeiro
+     * aceito; o custo depende de quantos pacientes à frente dele são recusados.
+     * @param aceita Função que recebe uma Entrada e retorna true se o paciente serve.
+     * @return Handle do paciente ou -1 se nenhum for aceito.
+     */
+    template <typename Criterio>
+    int primeiro_aceito(Criterio aceita) const;
+
+    /**
+     * @brief Retorna todos os pacientes na ordem de atendimento.
+     * Usa a ordenação estável em tempo linear de ordenacao.h.
+     * @return Handles dos pacientes em ordem de atendimento.
+     */
+    std::vector<int> ordenados() const;
+
+    bool contem(int handle) const;
+
+    /**
+     * @brief Entrada de um paciente presente na fila.
+     */
+    const Entrada& entrada(int handle) const { return heap[posicao[handle]]; }
+
+    /**
+     * @brief Verifica se a entrada a deve ser atendida antes da entrada b.
+     * @return true se a tem prioridade maior, ou prioridade igual e chegou antes.
+     */
+    static bool precede(const Entrada& a, const Entrada& b);
+
+    std::size_t tamanho() const { return heap.size(); }
+    bool vazia() const { return heap.empty(); }
+
+    // Entradas do heap, sem ordem definida (para varreduras completas)
+    const std::vector<Entrada>& entradas() const { return heap; }
+
+private:
+    static const std::size_t GRAU = 4; // Número de filhos de cada nó
+
+    void subir(std::size_t i);
+    void descer(std::size_t i);
+    void colocar(std::size_t i, const Entrada& entrada);
+
+    std::vector<Entrada> heap;  // Heap armazenado em vetor
+    std::vector<int> posicao;   // Posição de cada handle no heap (-1 se ausente)
+};
+
+template <typename Criterio>
+int FilaPrioridade::primeiro_aceito(Criterio aceita) const
+{
+    // Fronteira de posições candidatas, organizada como heap auxiliar (ver primeiros())
+    std::vector<std::size_t> fronteira;
+    auto compara = [this](std::size_t a, std::size_t b) { return precede(heap[b], heap[a]); };
+    if (!heap.empty()) {
+        fronteira.push_back(0);
+    }
+
+    while (!fronteira.empty()) {
+        std::pop_heap(fronteira.begin(), fronteira.end(), compara);
+        std::size_t i = fronteira.back();
+        fronteira.pop_back();
+        if (aceita(heap[i])) {
+            return heap[i].handle;
+        }
+
+        std::size_t primeiro_filho = i * GRAU + 1;
+        std::size_t ultimo_filho = std::min(primeiro_filho + GRAU, heap.size());
+        for (std::size_t f = primeiro_filho; f < ultimo_filho; ++f) {
+            fronteira.push_back(f);
+            std::push_heap(fronteira.begin(), fronteira.end(), compara);
+        }
+    }
+    return -1;
+}
+
+#endif // FILAPRIORIDADE_H
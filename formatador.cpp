@@ -0,0 +1,264 @@
+#include "formatador.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "armazem.h"
+#include "cpf.h"
+#include "data.h"
+
+namespace {
+
+// Nome de cada sintoma, na ordem dos bits de SINTOMAS (paciente.h)
+constexpr const char* NOMES_SINTOMAS[8] = {
+    "TOSSE", "NÁUSEA", "FEBRE", "DISENTERIA", "INFECÇÃO", "COVID", "AVC", "ACIDENTE",
+};
+
+// Espaço de cada rótulo; o maior, com os oito sintomas, tem 60 bytes em UTF-8
+constexpr std::size_t TAMANHO_ROTULO = 64;
+
+struct RotulosSintomas {
+    char textos[256][TAMANHO_ROTULO];
+    unsigned char tamanhos[256];
+};
+
+constexpr RotulosSintomas montar_rotulos()
+{
+    RotulosSintomas rotulos{};
+    for (unsigned mascara = 0; mascara < 256; ++mascara) {
+        std::size_t tamanho = 0;
+        for (unsigned s = 0; s < 8; ++s) {
+            if ((mascara & (1u << s)) == 0) {
+                continue;
+            }
+            if (tamanho > 0) {
+                rotulos.textos[mascara][tamanho++] = ' ';
+            }
+            for (const char* c = NOMES_SINTOMAS[s]; *c != '\0'; ++c) {
+                rotulos.textos[mascara][tamanho++] = *c;
+            }
+        }
+        rotulos.tamanhos[mascara] = static_cast<unsigned char>(tamanho);
+    }
+    return rotulos;
+}
+
+// Rótulo de cada máscara de sintomas
+constexpr RotulosSintomas ROTULOS = montar_rotulos();
+static_assert(ROTULOS.tamanhos[255] < TAMANHO_ROTULO, "TAMANHO_ROTULO não comporta todos os sintomas");
+
+const char SEPARADOR_TEXTO[] = "-----------------------------\n";
+
+} // namespace
+
+std::string_view rotulo_sintomas(unsigned sintomas)
+{
+    sintomas &= 0xFF;
+    return std::string_view(ROTULOS.textos[sintomas], ROTULOS.tamanhos[sintomas]);
+}
+
+Formatador::Formatador(Formato formato, long long hoje)
+    : formato(formato)
+    , hoje(hoje)
+{
+}
+
+// Garante espaço para mais tamanho bytes e devolve onde escrevê-los
+char* Formatador::reservar(std::size_t tamanho)
+{
+    if (usado + tamanho > buffer.size()) {
+        buffer.resize(std::max<std::size_t>(usado + tamanho, buffer.size() * 2));
+    }
+    char* destino = buffer.data() + usado;
+    usado += tamanho;
+    return destino;
+}
+
+void Formatador::acrescentar(std::string_view texto)
+{
+    if (!texto.empty()) {
+        std::memcpy(reservar(texto.size()), texto.data(), texto.size());
+    }
+}
+
+void Formatador::acrescentar_inteiro(long long valor)
+{
+    char digitos[20];
+    int n = 0;
+    unsigned long long resto = valor < 0 ? 0ULL - static_cast<unsigned long long>(valor)
+                                         : static_cast<unsigned long long>(valor);
+    do {
+        digitos[n++] = static_cast<char>('0' + resto % 10);
+        resto /= 10;
+    } while (resto != 0);
+
+    char* destino = reservar(n + (valor < 0));
+    if (valor < 0) {
+        *destino++ = '-';
+    }
+    while (n > 0) {
+        *destino++ = digitos[--n];
+    }
+}
+
+// DD/MM/AAAA, como a interface exibe e a importação aceita
+void Formatador::acrescentar_data(long long dia)
+{
+    int ano, mes, dia_do_mes;
+    data_do_dia_juliano(dia, ano, mes, dia_do_mes);
+    if (ano < 0 || ano > 9999) {
+        acrescentar_inteiro(dia); // Fora do formato de quatro dígitos: mantém o dia juliano
+        return;
+    }
+    char* destino = reservar(10);
+    destino[0] = static_cast<char>('0' + dia_do_mes / 10);
+    destino[1] = static_cast<char>('0' + dia_do_mes % 10);
+    destino[2] = '/';
+    destino[3] = static_cast<char>('0' + mes / 10);
+    destino[4] = static_cast<char>('0' + mes % 10);
+    destino[5] = '/';
+    destino[6] = static_cast<char>('0' + ano / 1000);
+    destino[7] = static_cast<char>('0' + ano / 100 % 10);
+    destino[8] = static_cast<char>('0' + ano / 10 % 10);
+    destino[9] = static_cast<char>('0' + ano % 10);
+}
+
+// Campo CSV entre aspas, com as aspas duplicadas, apenas se contiver separador ou aspas
+void Formatador::acrescentar_csv(std::string_view texto)
+{
+    bool simples = true;
+    for (char c : texto) {
+        simples = simples && c != ',' && c != ';' && c != '"';
+    }
+    if (simples) {
+        acrescentar(texto);
+        return;
+    }
+    acrescentar("\"");
+    for (std::size_t inicio = 0;;) {
+        std::size_t aspas = texto.find('"', inicio);
+        acrescentar(texto.substr(inicio, aspas == std::string_view::npos ? aspas : aspas + 1 - inicio));
+        if (aspas == std::string_view::npos) {
+            break;
+        }
+        acrescentar("\"");
+        inicio = aspas + 1;
+    }
+    acrescentar("\"");
+}
+
+// Texto JSON entre aspas, escapando aspas, barras invertidas e caracteres de controle
+void Formatador::acrescentar_json(std::string_view texto)
+{
+    static const char HEXADECIMAL[] = "0123456789abcdef";
+    acrescentar("\"");
+    std::size_t inicio = 0;
+    for (std::size_t i = 0; i < texto.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(texto[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        acrescentar(texto.substr(inicio, i - inicio));
+        if (c == '"' || c == '\\') {
+            char* destino = reservar(2);
+            destino[0] = '\\';
+            destino[1] = static_cast<char>(c);
+        } else {
+            char* destino = reservar(6);
+            std::memcpy(destino, "\\u00", 4);
+            destino[4] = HEXADECIMAL[c >> 4];
+            destino[5] = HEXADECIMAL[c & 0xF];
+        }
+        inicio = i + 1;
+    }
+    acrescentar(texto.substr(inicio));
+    acrescentar("\"");
+}
+
+void Formatador::comecar()
+{
+    primeiro = true;
+    if (formato == CSV) {
+        acrescentar("id,nome,cpf,email,nascimento,idade,sintomas\n");
+    } else if (formato == JSON) {
+        acrescentar("[");
+    }
+}
+
+void Formatador::escrever(const Campos& paciente)
+{
+    switch (formato) {
+    case TEXTO:
+        acrescentar("ID: ");
+        acrescentar_inteiro(paciente.id);
+        acrescentar("\nNome: ");
+        acrescentar(paciente.nome);
+        acrescentar("\nCPF: ");
+        escrever_cpf(paciente.cpf, reservar(TAMANHO_CPF_FORMATADO));
+        acrescentar("\nEmail: ");
+        acrescentar(paciente.email);
+        acrescentar("\nData de Nascimento: ");
+        acrescentar_data(paciente.nascimento);
+        acrescentar("\nIdade: ");
+        acrescentar_inteiro(calcular_idade(paciente.nascimento, hoje));
+        acrescentar("\nSintomas: ");
+        acrescentar(rotulo_sintomas(paciente.sintomas));
+        acrescentar("\n");
+        acrescentar(SEPARADOR_TEXTO);
+        break;
+    case CSV:
+        acrescentar_inteiro(paciente.id);
+        acrescentar(",");
+        acrescentar_csv(paciente.nome);
+        acrescentar(",");
+        escrever_cpf(paciente.cpf, reservar(TAMANHO_CPF_FORMATADO));
+        acrescentar(",");
+        acrescentar_csv(paciente.email);
+        acrescentar(",");
+        acrescentar_data(paciente.nascimento);
+        acrescentar(",");
+        acrescentar_inteiro(calcular_idade(paciente.nascimento, hoje));
+        acrescentar(",");
+        acrescentar(rotulo_sintomas(paciente.sintomas));
+        acrescentar("\n");
+        break;
+    case JSON:
+        acrescentar(primeiro ? "\n  {\"id\": " : ",\n  {\"id\": ");
+        acrescentar_inteiro(paciente.id);
+        acrescentar(", \"nome\": ");
+        acrescentar_json(paciente.nome);
+        acrescentar(", \"cpf\": \"");
+        escrever_cpf(paciente.cpf, reservar(TAMANHO_CPF_FORMATADO));
+        acrescentar("\", \"email\": ");
+        acrescentar_json(paciente.email);
+        acrescentar(", \"nascimento\": \"");
+        acrescentar_data(paciente.nascimento);
+        acrescentar("\", \"idade\": ");
+        acrescentar_inteiro(calcular_idade(paciente.nascimento, hoje));
+        acrescentar(", \"sintomas\": \"");
+        acrescentar(rotulo_sintomas(paciente.sintomas));
+        acrescentar("\"}");
+        break;
+    }
+    primeiro = false;
+}
+
+void Formatador::escrever(const ArmazemPacientes& pacientes, int id)
+{
+    escrever(Campos{id, pacientes.cpf(id), pacientes.nome(id), pacientes.email(id), pacientes.nascimento(id),
+                    pacientes.sintomas(id)});
+}
+
+void Formatador::terminar()
+{
+    if (formato == JSON) {
+        acrescentar(primeiro ? "]\n" : "\n]\n");
+    }
+}
+
+bool Formatador::descarregar(std::FILE* arquivo)
+{
+    bool gravado = std::fwrite(buffer.data(), 1, usado, arquivo) == usado;
+    usado = 0;
+    return gravado;
+}
@@ -0,0 +1,100 @@
+#ifndef FORMATADOR_H
+#define FORMATADOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+class ArmazemPacientes;
+
+/**
+ * @brief Nomes dos sintomas de uma máscara, separados por espaço (por exemplo "TOSSE FEBRE").
+ * Lidos de uma tabela com as 256 máscaras montada na compilação; o texto é estático.
+ */
+std::string_view rotulo_sintomas(unsigned sintomas);
+
+/**
+ * @brief Formata pacientes em texto, CSV ou JSON em um buffer reaproveitado.
+ *
+ * Os campos são escritos diretamente no buffer, sem textos intermediários: o
+ * CPF a partir da chave, a data a partir do dia juliano e os sintomas pela
+ * tabela de rótulos. O buffer só cresce, de modo que formatar muitos pacientes
+ * com o mesmo formatador (ou descarregá-lo em um arquivo de tempos em tempos)
+ * não aloca memória depois dos primeiros pacientes.
+ *
+ * TEXTO segue o bloco exibido pela interface (um campo por linha e um
+ * separador). CSV e JSON usam os nomes de campos da importação (ver
+ * importacao.h), acrescidos de id e idade, e podem ser importados de volta.
+ */
+class Formatador
+{
+public:
+    enum Formato { TEXTO, CSV, JSON };
+
+    // Campos exibidos de um paciente; os textos só precisam valer durante a chamada
+    struct Campos {
+        int id;
+        std::uint64_t cpf;      // Chave do CPF (ver cpf.h)
+        std::string_view nome;
+        std::string_view email;
+        long long nascimento;   // Dia juliano
+        unsigned sintomas;
+    };
+
+    /**
+     * @param formato Formato da saída.
+     * @param hoje Dia juliano de referência para a idade.
+     */
+    Formatador(Formato formato, long long hoje);
+
+    /**
+     * @brief Escreve o início da saída: o cabeçalho do CSV ou a abertura do vetor JSON.
+     */
+    void comecar();
+
+    void escrever(const Campos& paciente);
+
+    /**
+     * @brief Escreve o paciente com o ID informado, lendo os campos do armazenamento.
+     */
+    void escrever(const ArmazemPacientes& pacientes, int id);
+
+    /**
+     * @brief Escreve o fim da saída: o fechamento do vetor JSON.
+     */
+    void terminar();
+
+    /**
+     * @brief Texto formatado desde a última limpeza; válido até a próxima escrita.
+     */
+    std::string_view texto() const { return std::string_view(buffer.data(), usado); }
+
+    /**
+     * @brief Esvazia o buffer, mantendo a memória reservada.
+     */
+    void limpar() { usado = 0; }
+
+    /**
+     * @brief Grava o texto formatado no arquivo e esvazia o buffer.
+     * @return false se a gravação falhou.
+     */
+    bool descarregar(std::FILE* arquivo);
+
+private:
+    char* reservar(std::size_t tamanho);
+    void acrescentar(std::string_view texto);
+    void acrescentar_inteiro(long long valor);
+    void acrescentar_data(long long dia);
+    void acrescentar_csv(std::string_view texto);
+    void acrescentar_json(std::string_view texto);
+
+    Formato formato;
+    long long hoje;
+    std::vector<char> buffer;
+    std::size_t usado = 0;  // Bytes formatados no início do buffer
+    bool primeiro = true;   // Nenhum paciente escrito desde comecar() (separador do JSON)
+};
+
+#endif // FORMATADOR_H
@@ -0,0 +1,167 @@
+#include "histograma.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Bits de precisão dentro de cada potência de dois: 2^5 = 32 baldes por potência
+static const int PRECISAO = 5;
+static const std::int64_t SUBBALDES = std::int64_t(1) << PRECISAO;
+// Baldes necessários para cobrir até INT64_MAX (potência 62)
+static const std::size_t BALDES = static_cast<std::size_t>((62 - PRECISAO) * SUBBALDES + 2 * SUBBALDES);
+
+// Leitura e escrita relaxadas: basta que cada contador seja lido inteiro
+template <typename T>
+static T ler(const std::atomic<T>& valor)
+{
+    return valor.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+static void escrever(std::atomic<T>& valor, T novo)
+{
+    valor.store(novo, std::memory_order_relaxed);
+}
+
+// Soma feita pelo único escritor: leitura e escrita separadas, sem instrução atômica de soma
+template <typename T>
+static void acrescentar(std::atomic<T>& valor, T parcela)
+{
+    escrever(valor, ler(valor) + parcela);
+}
+
+Histograma::Histograma() : contagens(new std::atomic<std::uint64_t>[BALDES])
+{
+    limpar();
+}
+
+Histograma::Histograma(const Histograma& outro) : Histograma()
+{
+    *this = outro;
+}
+
+Histograma& Histograma::operator=(const Histograma& outro)
+{
+    if (this != &outro) {
+        for (std::size_t b = 0; b < BALDES; ++b) {
+            escrever(contagens[b], ler(outro.contagens[b]));
+        }
+        escrever(total, ler(outro.total));
+        escrever(menor, ler(outro.menor));
+        escrever(maior, ler(outro.maior));
+        escrever(soma, ler(outro.soma));
+    }
+    return *this;
+}
+
+// Posição do bit mais significativo de um valor positivo
+static int maior_bit(std::uint64_t valor)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(valor);
+#else
+    int bit = 0;
+    while (valor >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Abaixo de 2 * SUBBALDES, um balde por valor; acima, o valor é deslocado até sobrarem PRECISAO + 1 bits
+std::size_t Histograma::balde(std::int64_t valor)
+{
+    if (valor < 2 * SUBBALDES) {
+        return static_cast<std::size_t>(valor);
+    }
+    int deslocamento = maior_bit(static_cast<std::uint64_t>(valor)) - PRECISAO;
+    return static_cast<std::size_t>(deslocamento * SUBBALDES + (valor >> deslocamento));
+}
+
+// Maior valor que cai no balde b
+std::int64_t Histograma::maior_do_balde(std::size_t b)
+{
+    if (b < static_cast<std::size_t>(2 * SUBBALDES)) {
+        return static_cast<std::int64_t>(b);
+    }
+    int deslocamento = static_cast<int>(b / SUBBALDES) - 1;
+    std::uint64_t sub = b - static_cast<std::size_t>(deslocamento) * SUBBALDES;
+    return static_cast<std::int64_t>(((sub + 1) << deslocamento) - 1);
+}
+
+void Histograma::registrar(std::int64_t valor, std::uint64_t vezes)
+{
+    if (vezes == 0) {
+        return;
+    }
+    valor = std::max<std::int64_t>(valor, 0);
+    acrescentar(contagens[balde(valor)], vezes);
+    bool vazio = ler(total) == 0;
+    if (vazio || valor < ler(menor)) {
+        escrever(menor, valor);
+    }
+    if (vazio || valor > ler(maior)) {
+        escrever(maior, valor);
+    }
+    acrescentar(soma, static_cast<double>(valor) * static_cast<double>(vezes));
+    acrescentar(total, vezes);
+}
+
+void Histograma::somar(const Histograma& outro)
+{
+    Histograma retrato(outro);
+    std::uint64_t quantidade_outro = ler(retrato.total);
+    if (quantidade_outro == 0) {
+        return;
+    }
+    for (std::size_t b = 0; b < BALDES; ++b) {
+        acrescentar(contagens[b], ler(retrato.contagens[b]));
+    }
+    bool vazio = ler(total) == 0;
+    escrever(menor, vazio ? ler(retrato.menor) : std::min(ler(menor), ler(retrato.menor)));
+    escrever(maior, vazio ? ler(retrato.maior) : std::max(ler(maior), ler(retrato.maior)));
+    acrescentar(soma, ler(retrato.soma));
+    acrescentar(total, quantidade_outro);
+}
+
+void Histograma::limpar()
+{
+    for (std::size_t b = 0; b < BALDES; ++b) {
+        escrever<std::uint64_t>(contagens[b], 0);
+    }
+    escrever<std::uint64_t>(total, 0);
+    escrever<std::int64_t>(menor, 0);
+    escrever<std::int64_t>(maior, 0);
+    escrever(soma, 0.0);
+}
+
+double Histograma::media() const
+{
+    std::uint64_t quantidade = ler(total);
+    return quantidade ? ler(soma) / static_cast<double>(quantidade) : 0.0;
+}
+
+std::int64_t Histograma::percentil(double p) const
+{
+    // A quantidade é recontada nos baldes, para não depender da ordem em que um escritor concorrente os atualiza
+    std::unique_ptr<std::uint64_t[]> retrato(new std::uint64_t[BALDES]);
+    std::uint64_t quantidade = 0;
+    for (std::size_t b = 0; b < BALDES; ++b) {
+        retrato[b] = ler(contagens[b]);
+        quantidade += retrato[b];
+    }
+    if (quantidade == 0) {
+        return 0;
+    }
+    std::int64_t menor_valor = ler(menor);
+    std::int64_t maior_valor = ler(maior);
+    p = std::min(std::max(p, 0.0), 100.0);
+    std::uint64_t alvo = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(p / 100.0 * quantidade)));
+    std::uint64_t acumulado = 0;
+    for (std::size_t b = 0; b < BALDES; ++b) {
+        acumulado += retrato[b];
+        if (acumulado >= alvo) {
+            return std::min(std::max(maior_do_balde(b), menor_valor), std::max(maior_valor, menor_valor));
+        }
+    }
+    return maior_valor;
+}
@@ -0,0 +1,69 @@
+#ifndef HISTOGRAMA_H
+#define HISTOGRAMA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Histograma de valores inteiros não negativos com precisão relativa fixa.
+ *
+ * Os valores de 0 a 63 têm um balde cada; acima disso, cada potência de dois
+ * é dividida em 32 baldes, de modo que o erro dos percentis fica abaixo de
+ * 1/32 do valor em toda a faixa de int64. Registrar custa O(1) e não aloca, e
+ * o histograma ocupa sempre o mesmo espaço (cerca de 15 KB), qualquer que seja
+ * a quantidade de valores.
+ *
+ * Um único thread pode registrar valores (registrar, somar, limpar), enquanto
+ * outros threads consultam o histograma sem travas: os contadores são atômicos
+ * e o escritor não usa instruções de leitura-modificação-escrita, de modo que
+ * registrar custa o mesmo que em um histograma comum. Uma consulta concorrente
+ * pode não ver os registros mais recentes, ou vê-los apenas em parte (na
+ * contagem e ainda não na média, por exemplo). Copiar o histograma tira um
+ * retrato dos valores, que pode então ser consultado com calma.
+ */
+class Histograma
+{
+public:
+    Histograma();
+    Histograma(const Histograma& outro);
+    Histograma& operator=(const Histograma& outro);
+
+    /**
+     * @brief Registra um valor; valores negativos são registrados como 0.
+     * @param vezes Quantidade de ocorrências do valor.
+     */
+    void registrar(std::int64_t valor, std::uint64_t vezes = 1);
+
+    /**
+     * @brief Acrescenta os valores registrados em outro histograma.
+     */
+    void somar(const Histograma& outro);
+
+    void limpar();
+
+    std::uint64_t quantidade() const { return total.load(std::memory_order_relaxed); }
+    std::int64_t minimo() const { return quantidade() ? menor.load(std::memory_order_relaxed) : 0; }
+    std::int64_t maximo() const { return quantidade() ? maior.load(std::memory_order_relaxed) : 0; }
+    double media() const;
+
+    /**
+     * @brief Valor abaixo do qual (ou igual ao qual) está a fração p dos valores registrados.
+     * @param p Percentil entre 0 e 100.
+     * @return Valor aproximado (ver a precisão na descrição da classe), ou 0 se o histograma estiver vazio.
+     */
+    std::int64_t percentil(double p) const;
+
+private:
+    static std::size_t balde(std::int64_t valor);
+    static std::int64_t maior_do_balde(std::size_t b);
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> contagens; // Ocorrências por balde
+    std::atomic<std::uint64_t> total{0};                     // Quantidade de valores registrados
+    std::atomic<std::int64_t> menor{0};                      // Menor valor registrado
+    std::atomic<std::int64_t> maior{0};                      // Maior valor registrado
+    std::atomic<double> soma{0};                             // Soma dos valores registrados, para a média
+};
+
+#endif // HISTOGRAMA_H
@@ -0,0 +1,628 @@
+#include "historico.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "arquivomapeado.h"
+#include "binario.h"
+#include "diario.h"
+#include "triagem.h"
+
+namespace {
+
+const char ASSINATURA_SEGMENTO[8] = {'B', '1', 'H', 'I', 'S', 'T', '0', '1'};
+const char* const EXTENSAO_SEGMENTO = ".b1h";
+const int QUANTIDADE_SINTOMAS = 8;
+const std::size_t LINHAS_POR_SALTO = 1024; // Linhas entre dois pontos de entrada nas colunas de tamanho variável
+
+// Colunas de um segmento, na ordem em que aparecem no arquivo
+enum Coluna {
+    COLUNA_NASCIMENTOS, // Diferença para o anterior, em zigue-zague e tamanho variável
+    COLUNA_CPFS,        // Chave do CPF em tamanho variável
+    COLUNA_SINTOMAS,    // Um mapa de bits por sintoma, 64 pacientes por palavra
+    COLUNA_DICIONARIO,  // Nomes distintos na ordem da primeira ocorrência: posições (u32) e textos
+    COLUNA_CODIGOS,     // Posição do nome no dicionário, com largura fixa em bits
+    COLUNA_SALTOS,      // Posição de cada bloco de linhas nas colunas de tamanho variável (Salto)
+    COLUNA_EMAILS,      // Tamanho variável seguido do texto
+    COLUNA_FIM,
+    COLUNAS = COLUNA_FIM + 1
+};
+
+// Cabeçalho gravado no início de cada segmento
+struct Cabecalho {
+    std::uint32_t primeiro_id;
+    std::uint32_t quantidade;
+    std::int32_t nascimento_minimo;
+    std::int32_t nascimento_maximo;
+    std::uint8_t uniao;
+    std::uint8_t intersecao;
+    std::uint8_t largura;        // Bits de cada código de nome
+    std::uint32_t nomes;         // Nomes no dicionário
+    std::uint64_t inicio[COLUNAS]; // Posição de cada coluna no arquivo; inicio[COLUNA_FIM] é o tamanho
+};
+
+// Início de um bloco de LINHAS_POR_SALTO linhas: permite ler uma faixa sem decodificar as anteriores
+struct Salto {
+    std::uint32_t nascimento;          // Posições relativas ao início de cada coluna
+    std::uint32_t cpf;
+    std::uint32_t email;
+    std::int32_t nascimento_anterior;  // Base da diferença da primeira linha do bloco
+};
+
+// Inteiro sem sinal em grupos de 7 bits, do menos para o mais significativo
+void escrever_variavel(std::vector<char>& destino, std::uint64_t valor)
+{
+    while (valor >= 0x80) {
+        destino.push_back(static_cast<char>((valor & 0x7F) | 0x80));
+        valor >>= 7;
+    }
+    destino.push_back(static_cast<char>(valor));
+}
+
+bool ler_variavel(const char*& atual, const char* fim, std::uint64_t& valor)
+{
+    valor = 0;
+    for (int deslocamento = 0; atual < fim && deslocamento < 64; deslocamento += 7) {
+        std::uint8_t byte = static_cast<std::uint8_t>(*atual++);
+        valor |= static_cast<std::uint64_t>(byte & 0x7F) << deslocamento;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Zigue-zague: diferenças pequenas, positivas ou negativas, viram inteiros pequenos
+std::uint64_t zigue(std::int64_t valor)
+{
+    return (static_cast<std::uint64_t>(valor) << 1) ^ static_cast<std::uint64_t>(valor >> 63);
+}
+
+std::int64_t zague(std::uint64_t valor)
+{
+    return static_cast<std::int64_t>(valor >> 1) ^ -static_cast<std::int64_t>(valor & 1);
+}
+
+// Bits necessários para representar os valores de 0 a maximo (pelo menos 1)
+std::uint8_t largura_de(std::uint32_t maximo)
+{
+    std::uint8_t largura = 1;
+    while (largura < 32 && (maximo >> largura) != 0) {
+        largura++;
+    }
+    return largura;
+}
+
+// Lê o código da linha na coluna de códigos; a coluna tem 8 bytes de folga no fim
+std::uint32_t ler_codigo(const char* codigos, std::size_t linha, std::uint8_t largura)
+{
+    std::size_t bit = linha * largura;
+    std::uint64_t palavra;
+    std::memcpy(&palavra, codigos + bit / 8, sizeof(palavra));
+    return static_cast<std::uint32_t>((palavra >> (bit % 8)) & ((std::uint64_t(1) << largura) - 1));
+}
+
+bool ler_cabecalho(const char* dados, std::size_t tamanho, Cabecalho& cabecalho)
+{
+    Leitor leitor(dados, tamanho);
+    char assinatura[sizeof(ASSINATURA_SEGMENTO)];
+    std::int32_t minimo, maximo;
+    if (!leitor.bytes(assinatura, sizeof(assinatura)) ||
+        std::memcmp(assinatura, ASSINATURA_SEGMENTO, sizeof(assinatura)) != 0 ||
+        !leitor.u32(cabecalho.primeiro_id) || !leitor.u32(cabecalho.quantidade) || !leitor.i32(minimo) ||
+        !leitor.i32(maximo) || !leitor.u8(cabecalho.uniao) || !leitor.u8(cabecalho.intersecao) ||
+        !leitor.u8(cabecalho.largura) || !leitor.u32(cabecalho.nomes)) {
+        return false;
+    }
+    cabecalho.nascimento_minimo = minimo;
+    cabecalho.nascimento_maximo = maximo;
+    for (std::uint64_t& inicio : cabecalho.inicio) {
+        if (!leitor.u64(inicio)) {
+            return false;
+        }
+    }
+    // As colunas aparecem em ordem e a última termina no fim do arquivo
+    for (int c = 1; c < COLUNAS; ++c) {
+        if (cabecalho.inicio[c] < cabecalho.inicio[c - 1]) {
+            return false;
+        }
+    }
+    // As colunas de tamanho fixo têm o tamanho que a quantidade de linhas determina
+    const std::uint64_t quantidade = cabecalho.quantidade;
+    const std::uint64_t* inicio = cabecalho.inicio;
+    return inicio[COLUNA_FIM] == tamanho && cabecalho.largura >= 1 && cabecalho.largura <= 32 &&
+           inicio[COLUNA_DICIONARIO] - inicio[COLUNA_SINTOMAS] ==
+               (quantidade + 63) / 64 * sizeof(std::uint64_t) * QUANTIDADE_SINTOMAS &&
+           inicio[COLUNA_CODIGOS] - inicio[COLUNA_DICIONARIO] >= (cabecalho.nomes + 1ULL) * sizeof(std::uint32_t) &&
+           inicio[COLUNA_SALTOS] - inicio[COLUNA_CODIGOS] == (quantidade * cabecalho.largura + 7) / 8 + 8 &&
+           inicio[COLUNA_EMAILS] - inicio[COLUNA_SALTOS] ==
+               (quantidade + LINHAS_POR_SALTO - 1) / LINHAS_POR_SALTO * sizeof(Salto);
+}
+
+// Lê um valor de tamanho fixo de uma posição possivelmente desalinhada do arquivo mapeado
+template <typename T>
+T ler_fixo(const char* dados)
+{
+    T valor;
+    std::memcpy(&valor, dados, sizeof(valor));
+    return valor;
+}
+
+std::string nome_do_segmento(int primeiro_id)
+{
+    char nome[32];
+    std::snprintf(nome, sizeof(nome), "segmento-%010d%s", primeiro_id, EXTENSAO_SEGMENTO);
+    return nome;
+}
+
+// Sincroniza com o disco um arquivo gravado pela biblioteca padrão
+#ifdef _WIN32
+bool sincronizar_arquivo(std::FILE* arquivo) { return std::fflush(arquivo) == 0 && _commit(_fileno(arquivo)) == 0; }
+bool sincronizar_diretorio(const std::string&) { return true; }
+#else
+bool sincronizar_arquivo(std::FILE* arquivo) { return std::fflush(arquivo) == 0 && fsync(fileno(arquivo)) == 0; }
+
+// Garante que a criação ou a remoção de um segmento também chegue ao disco
+bool sincronizar_diretorio(const std::string& diretorio)
+{
+    int d = open(diretorio.c_str(), O_RDONLY | O_CLOEXEC);
+    if (d == -1) {
+        return false;
+    }
+    bool ok = fsync(d) == 0;
+    close(d);
+    return ok;
+}
+#endif
+
+// O paciente atende ao filtro de sintomas da consulta
+bool sintomas_atendem(unsigned sintomas, const Historico::Consulta& consulta)
+{
+    return (sintomas & consulta.todos) == consulta.todos && (consulta.algum == 0 || (sintomas & consulta.algum)) &&
+           (sintomas & consulta.nenhum) == 0;
+}
+
+} // namespace
+
+Historico::Historico(std::string diretorio, std::size_t pacientes_por_segmento)
+    : diretorio(std::move(diretorio))
+    , pacientes_por_segmento(std::max<std::size_t>(pacientes_por_segmento, 1))
+{
+}
+
+bool Historico::abrir()
+{
+    std::error_code erro_diretorio;
+    std::filesystem::create_directories(diretorio, erro_diretorio);
+    if (erro_diretorio) {
+        return false;
+    }
+
+    indice.clear();
+    std::error_code erro_listagem;
+    for (const std::filesystem::directory_entry& entrada :
+         std::filesystem::directory_iterator(diretorio, erro_listagem)) {
+        if (entrada.path().extension() != EXTENSAO_SEGMENTO) {
+            continue; // Inclui os temporários de um selamento interrompido
+        }
+        ArquivoMapeado arquivo(entrada.path().string());
+        Cabecalho cabecalho;
+        if (!arquivo.existe() || !ler_cabecalho(arquivo.dados(), arquivo.tamanho(), cabecalho)) {
+            return false;
+        }
+        indice.push_back(Segmento{entrada.path().string(), arquivo.tamanho(),
+                                  static_cast<int>(cabecalho.primeiro_id), cabecalho.quantidade,
+                                  cabecalho.nascimento_minimo, cabecalho.nascimento_maximo, cabecalho.uniao,
+                                  cabecalho.intersecao});
+    }
+    if (erro_listagem) {
+        return false;
+    }
+
+    // Os segmentos precisam cobrir os IDs a partir de 0, sem lacunas nem sobreposições
+    std::sort(indice.begin(), indice.end(),
+              [](const Segmento& a, const Segmento& b) { return a.primeiro_id < b.primeiro_id; });
+    proximo_id = 0;
+    for (const Segmento& segmento : indice) {
+        if (segmento.primeiro_id != proximo_id) {
+            indice.clear();
+            proximo_id = 0;
+            return false;
+        }
+        proximo_id += static_cast<int>(segmento.quantidade);
+    }
+    marca = liberado = proximo_id;
+    barreiras.clear();
+    erro = false;
+    return true;
+}
+
+bool Historico::conferir(const Triagem& triagem)
+{
+    // O primeiro segmento com um ID que a triagem não admitiu ou que ainda está na fila, e todos os seguintes
+    const long long admitidos = static_cast<long long>(triagem.admitidos());
+    std::size_t confirmados = 0;
+    int fim = 0;
+    for (; confirmados < indice.size(); ++confirmados) {
+        const Segmento& segmento = indice[confirmados];
+        int ultimo = segmento.primeiro_id + static_cast<int>(segmento.quantidade);
+        if (ultimo > admitidos) {
+            break;
+        }
+        int id = segmento.primeiro_id;
+        while (id < ultimo && !triagem.na_fila(id)) {
+            id++;
+        }
+        if (id < ultimo) {
+            break;
+        }
+        fim = ultimo;
+    }
+
+    // Os nomes e emails dos pacientes já selados só existem nos segmentos; sem eles, selar de novo a
+    // partir da memória gravaria esses pacientes sem nome e email
+    if (static_cast<std::size_t>(fim) < triagem.pacientes().sem_textos()) {
+        erro = true;
+        return false;
+    }
+    if (confirmados == indice.size()) {
+        return !erro;
+    }
+
+    // Apaga do último para o primeiro: uma queda no meio deixa os segmentos cobrindo os IDs sem lacunas
+    while (indice.size() > confirmados) {
+        std::error_code erro_remover;
+        std::filesystem::remove(indice.back().caminho, erro_remover);
+        if (erro_remover) {
+            erro = true;
+        }
+        indice.pop_back();
+    }
+    erro = !sincronizar_diretorio(diretorio) || erro;
+    proximo_id = marca = liberado = fim;
+    barreiras.clear();
+    return !erro;
+}
+
+bool Historico::acompanhar(const Triagem& triagem, const Diario* diario)
+{
+    if (erro) {
+        return false;
+    }
+    const int admitidos = static_cast<int>(triagem.admitidos());
+    while (marca < admitidos && !triagem.na_fila(marca)) {
+        marca++;
+    }
+
+    // Selada antes de o diário sincronizar as saídas, uma faixa poderia ter pacientes que a
+    // reaplicação do diário devolve à fila depois de uma queda; a faixa espera o número do
+    // último registro anexado quando ela ficou completa
+    if (diario == nullptr) {
+        liberado = marca;
+        barreiras.clear();
+    } else {
+        int aguardado = barreiras.empty() ? liberado : barreiras.back().id;
+        if (static_cast<std::size_t>(marca - proximo_id) / pacientes_por_segmento >
+            static_cast<std::size_t>(aguardado - proximo_id) / pacientes_por_segmento) {
+            barreiras.push_back(Barreira{marca, diario->ultimo_numero()});
+        }
+        if (!barreiras.empty()) {
+            std::uint64_t duravel = diario->numero_duravel();
+            while (!barreiras.empty() && barreiras.front().numero <= duravel) {
+                liberado = barreiras.front().id;
+                barreiras.pop_front();
+            }
+        }
+    }
+
+    while (static_cast<std::size_t>(liberado - proximo_id) >= pacientes_por_segmento) {
+        if (!selar(triagem, proximo_id, pacientes_por_segmento)) {
+            erro = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Codifica os pacientes de IDs [primeiro_id, primeiro_id + quantidade) e grava o segmento
+bool Historico::selar(const Triagem& triagem, int primeiro_id, std::size_t quantidade)
+{
+    const ArmazemPacientes& pacientes = triagem.pacientes();
+    const std::size_t palavras = (quantidade + 63) / 64;
+
+    Cabecalho cabecalho{};
+    cabecalho.primeiro_id = static_cast<std::uint32_t>(primeiro_id);
+    cabecalho.quantidade = static_cast<std::uint32_t>(quantidade);
+    cabecalho.nascimento_minimo = std::numeric_limits<std::int32_t>::max();
+    cabecalho.nascimento_maximo = std::numeric_limits<std::int32_t>::min();
+    cabecalho.intersecao = 0xFF;
+
+    std::vector<char> colunas[COLUNA_FIM];
+    std::vector<std::uint64_t> mapas(palavras * QUANTIDADE_SINTOMAS, 0);
+    std::unordered_map<std::string_view, std::uint32_t> dicionario;
+    std::vector<std::string_view> nomes; // Nomes do dicionário, em ordem de código
+    std::vector<std::uint32_t> codigos(quantidade);
+    std::int64_t nascimento_anterior = 0;
+
+    for (std::size_t linha = 0; linha < quantidade; ++linha) {
+        int id = primeiro_id + static_cast<int>(linha);
+        if (linha % LINHAS_POR_SALTO == 0) {
+            Salto salto{static_cast<std::uint32_t>(colunas[COLUNA_NASCIMENTOS].size()),
+                        static_cast<std::uint32_t>(colunas[COLUNA_CPFS].size()),
+                        static_cast<std::uint32_t>(colunas[COLUNA_EMAILS].size()),
+                        static_cast<std::int32_t>(nascimento_anterior)};
+            Escritor(colunas[COLUNA_SALTOS]).bytes(&salto, sizeof(salto));
+        }
+        std::int32_t nascimento = static_cast<std::int32_t>(pacientes.nascimento(id));
+        unsigned sintomas = pacientes.sintomas(id);
+
+        cabecalho.nascimento_minimo = std::min(cabecalho.nascimento_minimo, nascimento);
+        cabecalho.nascimento_maximo = std::max(cabecalho.nascimento_maximo, nascimento);
+        cabecalho.uniao |= static_cast<std::uint8_t>(sintomas);
+        cabecalho.intersecao &= static_cast<std::uint8_t>(sintomas);
+
+        escrever_variavel(colunas[COLUNA_NASCIMENTOS], zigue(nascimento - nascimento_anterior));
+        nascimento_anterior = nascimento;
+        escrever_variavel(colunas[COLUNA_CPFS], pacientes.cpf(id));
+        for (int s = 0; s < QUANTIDADE_SINTOMAS; ++s) {
+            if (sintomas & (1u << s)) {
+                mapas[s * palavras + linha / 64] |= std::uint64_t(1) << (linha % 64);
+            }
+        }
+
+        // Os textos do armazenamento não mudam enquanto o segmento é montado
+        std::string_view nome = pacientes.nome(id);
+        auto inserido = dicionario.emplace(nome, static_cast<std::uint32_t>(nomes.size()));
+        if (inserido.second) {
+            nomes.push_back(nome);
+        }
+        codigos[linha] = inserido.first->second;
+
+        std::string_view email = pacientes.email(id);
+        escrever_variavel(colunas[COLUNA_EMAILS], email.size());
+        colunas[COLUNA_EMAILS].insert(colunas[COLUNA_EMAILS].end(), email.begin(), email.end());
+    }
+    Escritor(colunas[COLUNA_SINTOMAS]).bytes(mapas.data(), mapas.size() * sizeof(std::uint64_t));
+
+    // Dicionário: a posição de cada nome (e a do fim) seguida dos textos
+    Escritor escritor_dicionario(colunas[COLUNA_DICIONARIO]);
+    std::uint32_t posicao_nome = 0;
+    for (std::string_view nome : nomes) {
+        escritor_dicionario.u32(posicao_nome);
+        posicao_nome += static_cast<std::uint32_t>(nome.size());
+    }
+    escritor_dicionario.u32(posicao_nome);
+    for (std::string_view nome : nomes) {
+        escritor_dicionario.bytes(nome.data(), nome.size());
+    }
+
+    // Códigos dos nomes com a menor largura que comporta o dicionário, mais a folga de leitura
+    cabecalho.nomes = static_cast<std::uint32_t>(nomes.size());
+    cabecalho.largura = largura_de(cabecalho.nomes > 0 ? cabecalho.nomes - 1 : 0);
+    colunas[COLUNA_CODIGOS].assign((quantidade * cabecalho.largura + 7) / 8 + 8, 0);
+    for (std::size_t linha = 0; linha < quantidade; ++linha) {
+        std::size_t bit = linha * cabecalho.largura;
+        std::uint64_t palavra;
+        std::memcpy(&palavra, colunas[COLUNA_CODIGOS].data() + bit / 8, sizeof(palavra));
+        palavra |= static_cast<std::uint64_t>(codigos[linha]) << (bit % 8);
+        std::memcpy(colunas[COLUNA_CODIGOS].data() + bit / 8, &palavra, sizeof(palavra));
+    }
+
+    // Cabeçalho de tamanho fixo seguido das colunas
+    std::vector<char> cabecalho_gravado;
+    Escritor escritor(cabecalho_gravado);
+    escritor.bytes(ASSINATURA_SEGMENTO, sizeof(ASSINATURA_SEGMENTO));
+    escritor.u32(cabecalho.primeiro_id);
+    escritor.u32(cabecalho.quantidade);
+    escritor.i32(cabecalho.nascimento_minimo);
+    escritor.i32(cabecalho.nascimento_maximo);
+    escritor.u8(cabecalho.uniao);
+    escritor.u8(cabecalho.intersecao);
+    escritor.u8(cabecalho.largura);
+    escritor.u32(cabecalho.nomes);
+    std::uint64_t posicao = cabecalho_gravado.size() + sizeof(cabecalho.inicio);
+    for (int c = 0; c < COLUNA_FIM; ++c) {
+        escritor.u64(posicao);
+        posicao += colunas[c].size();
+    }
+    escritor.u64(posicao);
+
+    // Grava e sincroniza um temporário e o renomeia: um segmento existe completo ou não existe
+    std::string caminho = (std::filesystem::path(diretorio) / nome_do_segmento(primeiro_id)).string();
+    std::string temporario = caminho + ".tmp";
+    std::FILE* arquivo = std::fopen(temporario.c_str(), "wb");
+    if (arquivo == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(cabecalho_gravado.data(), 1, cabecalho_gravado.size(), arquivo) == cabecalho_gravado.size();
+    for (int c = 0; c < COLUNA_FIM && ok; ++c) {
+        ok = std::fwrite(colunas[c].data(), 1, colunas[c].size(), arquivo) == colunas[c].size();
+    }
+    ok = ok && sincronizar_arquivo(arquivo);
+    if (std::fclose(arquivo) != 0 || !ok) {
+        return false;
+    }
+    std::error_code erro_renomear;
+    std::filesystem::rename(temporario, caminho, erro_renomear);
+    if (erro_renomear || !sincronizar_diretorio(diretorio)) {
+        return false;
+    }
+
+    indice.push_back(Segmento{caminho, static_cast<std::size_t>(posicao), primeiro_id, cabecalho.quantidade,
+                              cabecalho.nascimento_minimo, cabecalho.nascimento_maximo, cabecalho.uniao,
+                              cabecalho.intersecao});
+    proximo_id += static_cast<int>(quantidade);
+    return true;
+}
+
+// O cabeçalho não exclui que o segmento tenha pacientes que atendem à consulta
+bool Historico::pode_atender(const Segmento& segmento, const Consulta& consulta) const
+{
+    long long ultimo_id = static_cast<long long>(segmento.primeiro_id) + segmento.quantidade - 1;
+    return consulta.primeiro_id <= ultimo_id && consulta.ultimo_id >= segmento.primeiro_id &&
+           consulta.nascimento_minimo <= segmento.nascimento_maximo &&
+           consulta.nascimento_maximo >= segmento.nascimento_minimo &&
+           (consulta.todos & ~segmento.uniao) == 0 && (consulta.algum == 0 || (consulta.algum & segmento.uniao)) &&
+           (consulta.nenhum & segmento.intersecao) == 0;
+}
+
+/**
+ * @brief Mapeia um segmento e entrega os pacientes que atendem à consulta.
+ * Os sintomas são filtrados palavra a palavra nos mapas de bits; as colunas de
+ * tamanho variável só são decodificadas nos blocos de linhas com algum candidato,
+ * a partir do salto do bloco.
+ */
+std::size_t Historico::percorrer(const Segmento& segmento, const Consulta& consulta,
+                                 const std::function<void(const Registro&)>& entregar) const
+{
+    ArquivoMapeado arquivo(segmento.caminho);
+    Cabecalho cabecalho;
+    if (!arquivo.existe() || !ler_cabecalho(arquivo.dados(), arquivo.tamanho(), cabecalho)) {
+        return 0;
+    }
+    const char* dados = arquivo.dados();
+    const std::uint64_t* inicio = cabecalho.inicio;
+    const std::size_t palavras = (static_cast<std::size_t>(cabecalho.quantidade) + 63) / 64;
+    auto palavra_do_mapa = [&](int sintoma, std::size_t k) {
+        return ler_fixo<std::uint64_t>(dados + inicio[COLUNA_SINTOMAS] +
+                                       (sintoma * palavras + k) * sizeof(std::uint64_t));
+    };
+
+    // Linhas da faixa de IDs pedida
+    const long long primeira =
+        std::max<long long>(0, static_cast<long long>(consulta.primeiro_id) - segmento.primeiro_id);
+    const long long ultima = std::min<long long>(static_cast<long long>(cabecalho.quantidade) - 1,
+                                                 static_cast<long long>(consulta.ultimo_id) - segmento.primeiro_id);
+
+    const char* nomes = dados + inicio[COLUNA_DICIONARIO];
+    const char* textos_nomes = nomes + (cabecalho.nomes + 1ULL) * sizeof(std::uint32_t);
+    const std::size_t tamanho_textos = static_cast<std::size_t>(dados + inicio[COLUNA_CODIGOS] - textos_nomes);
+    std::size_t entregues = 0;
+
+    for (std::size_t bloco = static_cast<std::size_t>(primeira) / LINHAS_POR_SALTO;
+         static_cast<long long>(bloco * LINHAS_POR_SALTO) <= ultima; ++bloco) {
+        const std::size_t primeira_do_bloco = bloco * LINHAS_POR_SALTO;
+        const std::size_t fim_do_bloco = std::min<std::size_t>(primeira_do_bloco + LINHAS_POR_SALTO,
+                                                               static_cast<std::size_t>(ultima) + 1);
+
+        // Candidatos do bloco pelos sintomas, 64 linhas por palavra
+        std::uint64_t candidatos[LINHAS_POR_SALTO / 64];
+        bool algum_candidato = false;
+        for (std::size_t k = primeira_do_bloco / 64; k * 64 < fim_do_bloco; ++k) {
+            std::uint64_t palavra = ~std::uint64_t(0), qualquer = consulta.algum != 0 ? 0 : ~std::uint64_t(0);
+            for (int s = 0; s < QUANTIDADE_SINTOMAS; ++s) {
+                unsigned bit = 1u << s;
+                if ((consulta.todos | consulta.algum | consulta.nenhum) & bit) {
+                    std::uint64_t mapa = palavra_do_mapa(s, k);
+                    palavra &= (consulta.todos & bit) ? mapa : ~std::uint64_t(0);
+                    palavra &= (consulta.nenhum & bit) ? ~mapa : ~std::uint64_t(0);
+                    qualquer |= (consulta.algum & bit) ? mapa : 0;
+                }
+            }
+            candidatos[k - primeira_do_bloco / 64] = palavra & qualquer;
+            algum_candidato = algum_candidato || (palavra & qualquer) != 0;
+        }
+        if (!algum_candidato) {
+            continue;
+        }
+
+        // Decodifica o bloco a partir do seu salto até a última linha pedida
+        Salto salto = ler_fixo<Salto>(dados + inicio[COLUNA_SALTOS] + bloco * sizeof(Salto));
+        const char* nascimento_atual = dados + inicio[COLUNA_NASCIMENTOS] + salto.nascimento;
+        const char* cpf_atual = dados + inicio[COLUNA_CPFS] + salto.cpf;
+        const char* email_atual = dados + inicio[COLUNA_EMAILS] + salto.email;
+        if (nascimento_atual > dados + inicio[COLUNA_CPFS] || cpf_atual > dados + inicio[COLUNA_SINTOMAS] ||
+            email_atual > dados + inicio[COLUNA_FIM]) {
+            break; // Segmento corrompido
+        }
+        std::int64_t nascimento = salto.nascimento_anterior;
+        for (std::size_t linha = primeira_do_bloco; linha < fim_do_bloco; ++linha) {
+            std::uint64_t diferenca, cpf, tamanho_email;
+            if (!ler_variavel(nascimento_atual, dados + inicio[COLUNA_CPFS], diferenca) ||
+                !ler_variavel(cpf_atual, dados + inicio[COLUNA_SINTOMAS], cpf) ||
+                !ler_variavel(email_atual, dados + inicio[COLUNA_FIM], tamanho_email) ||
+                tamanho_email > static_cast<std::uint64_t>(dados + inicio[COLUNA_FIM] - email_atual)) {
+                return entregues; // Segmento corrompido: fica o que já foi entregue
+            }
+            nascimento += zague(diferenca);
+            std::string_view email(email_atual, tamanho_email);
+            email_atual += tamanho_email;
+
+            bool candidato = (candidatos[(linha / 64) - primeira_do_bloco / 64] >> (linha % 64)) & 1;
+            if (static_cast<long long>(linha) < primeira || !candidato || nascimento < consulta.nascimento_minimo ||
+                nascimento > consulta.nascimento_maximo) {
+                continue;
+            }
+
+            std::uint32_t codigo = ler_codigo(dados + inicio[COLUNA_CODIGOS], linha, cabecalho.largura);
+            if (codigo >= cabecalho.nomes) {
+                return entregues;
+            }
+            std::uint32_t de = ler_fixo<std::uint32_t>(nomes + codigo * sizeof(std::uint32_t));
+            std::uint32_t ate = ler_fixo<std::uint32_t>(nomes + (codigo + 1) * sizeof(std::uint32_t));
+            if (de > ate || ate > tamanho_textos) {
+                return entregues;
+            }
+            unsigned sintomas = 0;
+            for (int s = 0; s < QUANTIDADE_SINTOMAS; ++s) {
+                sintomas |= static_cast<unsigned>((palavra_do_mapa(s, linha / 64) >> (linha % 64)) & 1) << s;
+            }
+            entregar(Registro{segmento.primeiro_id + static_cast<int>(linha), cpf,
+                              std::string_view(textos_nomes + de, ate - de), email, nascimento, sintomas});
+            entregues++;
+        }
+    }
+    return entregues;
+}
+
+Historico::Resultado Historico::consultar(const Triagem& triagem, const Consulta& consulta,
+                                          const std::function<void(const Registro&)>& entregar) const
+{
+    Resultado resultado;
+    for (const Segmento& segmento : indice) {
+        if (!pode_atender(segmento, consulta)) {
+            resultado.segmentos_pulados++;
+            continue;
+        }
+        resultado.segmentos_lidos++;
+        resultado.registros += percorrer(segmento, consulta, entregar);
+    }
+
+    // Pacientes recentes, ainda só na memória da triagem
+    const ArmazemPacientes& pacientes = triagem.pacientes();
+    long long ultimo = std::min<long long>(static_cast<long long>(triagem.admitidos()) - 1, consulta.ultimo_id);
+    for (long long id = std::max(proximo_id, consulta.primeiro_id); id <= ultimo; ++id) {
+        int i = static_cast<int>(id);
+        long long nascimento = pacientes.nascimento(i);
+        if (triagem.na_fila(i) || !sintomas_atendem(pacientes.sintomas(i), consulta) ||
+            nascimento < consulta.nascimento_minimo || nascimento > consulta.nascimento_maximo) {
+            continue;
+        }
+        entregar(Registro{i, pacientes.cpf(i), pacientes.nome(i), pacientes.email(i), nascimento,
+                          pacientes.sintomas(i)});
+        resultado.registros++;
+    }
+    return resultado;
+}
+
+std::size_t Historico::bytes_em_disco() const
+{
+    std::size_t total = 0;
+    for (const Segmento& segmento : indice) {
+        total += segmento.bytes;
+    }
+    return total;
+}
@@ -0,0 +1,172 @@
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Diario;
+class Triagem;
+
+/**
+ * @brief Histórico dos pacientes que saíram da fila, em segmentos colunares imutáveis em disco.
+ *
+ * Os pacientes recentes ficam apenas na memória da triagem. Quando todos os
+ * pacientes de uma faixa de pacientes_por_segmento IDs consecutivos já saíram
+ * da fila (tratados ou removidos), a faixa é selada em um arquivo de segmento,
+ * que nunca mais muda, e a triagem descarta da memória os nomes e emails
+ * dela: o relatório e as consultas do histórico passam a lê-los daqui. Cada coluna é codificada à parte: os IDs são
+ * consecutivos e ficam só no cabeçalho, os nomes vão para um dicionário do
+ * segmento com códigos de largura mínima em bits, as datas de nascimento são
+ * gravadas como diferenças para a anterior e os CPFs como chaves, ambos em
+ * inteiros de tamanho variável, e os sintomas como um mapa de bits por sintoma.
+ *
+ * O cabeçalho de cada segmento guarda a faixa de IDs (a ordem de chegada), o
+ * menor e o maior nascimento e a união e a interseção dos sintomas; uma
+ * consulta descarta pelo cabeçalho os segmentos que não podem ter resultados e
+ * lê os demais um de cada vez, mapeados em memória, entregando os registros
+ * sem carregar o histórico inteiro. Dentro do segmento, os mapas de sintomas
+ * filtram as linhas antes de qualquer decodificação, e pontos de entrada a
+ * cada bloco de linhas evitam decodificar os blocos sem candidatos.
+ *
+ * A triagem não tem o instante da admissão no armazenamento; a faixa de
+ * tempo das consultas é a de chegada, pelos IDs. Uma faixa completa só é
+ * selada depois que o diário sincronizou os registros das saídas que a
+ * completaram (ver Diario::numero_duravel), e o segmento e o diretório são
+ * sincronizados com o disco antes de contar como selados. Ao reabrir,
+ * conferir() descarta os segmentos que a triagem recuperada não confirma,
+ * que são selados de novo a partir da memória; assim, reaplicar o diário ou
+ * reabrir o histórico não duplica nem perde pacientes. Os pacientes cujos nomes
+ * e emails a triagem já descartou não podem ser selados de novo: se os
+ * segmentos deles faltarem, conferir() falha.
+ */
+class Historico
+{
+public:
+    /**
+     * @brief Filtro de uma consulta; os campos não informados aceitam todos os pacientes.
+     * Os sintomas seguem IndiceSintomas::Consulta: todos os de todos, pelo
+     * menos um dos de algum (se algum não for 0) e nenhum dos de nenhum.
+     */
+    struct Consulta {
+        int primeiro_id = 0;
+        int ultimo_id = std::numeric_limits<int>::max();
+        long long nascimento_minimo = std::numeric_limits<long long>::min();
+        long long nascimento_maximo = std::numeric_limits<long long>::max();
+        unsigned todos = 0;
+        unsigned algum = 0;
+        unsigned nenhum = 0;
+    };
+
+    // Paciente encontrado; os textos só valem durante a chamada que o recebe
+    struct Registro {
+        int id;
+        std::uint64_t cpf;      // Chave do CPF (ver cpf.h)
+        std::string_view nome;
+        std::string_view email;
+        long long nascimento;   // Dia juliano
+        unsigned sintomas;
+    };
+
+    // Resumo de uma consulta
+    struct Resultado {
+        std::size_t registros = 0;          // Pacientes entregues
+        std::size_t segmentos_lidos = 0;    // Segmentos mapeados e percorridos
+        std::size_t segmentos_pulados = 0;  // Segmentos descartados pelo cabeçalho
+    };
+
+    /**
+     * @param diretorio Diretório dos arquivos de segmento.
+     * @param pacientes_por_segmento Pacientes selados em cada segmento.
+     */
+    explicit Historico(std::string diretorio, std::size_t pacientes_por_segmento = 65536);
+
+    /**
+     * @brief Cria o diretório, se preciso, e lê os cabeçalhos dos segmentos já selados.
+     * @return false se o diretório não puder ser usado ou se os segmentos não cobrirem os IDs
+     *         a partir de 0 sem lacunas.
+     */
+    bool abrir();
+
+    /**
+     * @brief Descarta os segmentos que a triagem recuperada não confirma: os que têm IDs ainda
+     * não admitidos ou ainda na fila (selados antes de uma queda que perdeu o fim do diário).
+     * Chamado ao passar a arquivar a triagem (ver Triagem::arquivar_em).
+     * @return false se um segmento não pôde ser apagado ou se os segmentos confirmados não cobrem
+     *         os pacientes que a triagem já tirou da memória (ArmazemPacientes::sem_textos), como
+     *         quando o diretório foi apagado; o histórico deixa de selar.
+     */
+    bool conferir(const Triagem& triagem);
+
+    /**
+     * @brief Sela as faixas de IDs cujos pacientes já saíram todos da fila.
+     * Chamado pela triagem a cada saída da fila e a cada passo (ver
+     * Triagem::arquivar_em); custa O(1) amortizado quando não há faixa completa.
+     * @param diario Diário da triagem: só são seladas as saídas que ele já
+     *        sincronizou. nullptr se a triagem não é persistida.
+     * @return false se a gravação de um segmento falhou; o histórico deixa de selar.
+     */
+    bool acompanhar(const Triagem& triagem, const Diario* diario = nullptr);
+
+    /**
+     * @brief Entrega, em ordem de ID, os pacientes fora da fila que atendem à consulta.
+     * Percorre os segmentos selados e, depois deles, os pacientes recentes na triagem.
+     * @param entregar Recebe cada paciente encontrado.
+     */
+    Resultado consultar(const Triagem& triagem, const Consulta& consulta,
+                        const std::function<void(const Registro&)>& entregar) const;
+
+    /**
+     * @brief Pacientes nos segmentos: os IDs de 0 a selados() - 1.
+     */
+    std::size_t selados() const { return proximo_id; }
+
+    std::size_t segmentos() const { return indice.size(); }
+
+    /**
+     * @brief Tamanho dos arquivos de segmento, em bytes.
+     */
+    std::size_t bytes_em_disco() const;
+
+    bool falhou() const { return erro; }
+
+private:
+    // Cabeçalho de um segmento, mantido em memória
+    struct Segmento {
+        std::string caminho;
+        std::size_t bytes;              // Tamanho do arquivo
+        int primeiro_id;
+        std::uint32_t quantidade;
+        std::int32_t nascimento_minimo;
+        std::int32_t nascimento_maximo;
+        unsigned uniao;                 // Sintomas de algum paciente do segmento
+        unsigned intersecao;            // Sintomas de todos os pacientes do segmento
+    };
+
+    bool selar(const Triagem& triagem, int primeiro_id, std::size_t quantidade);
+    bool pode_atender(const Segmento& segmento, const Consulta& consulta) const;
+    std::size_t percorrer(const Segmento& segmento, const Consulta& consulta,
+                          const std::function<void(const Registro&)>& entregar) const;
+
+    // Faixa completa esperando que o diário sincronize as saídas que a completaram
+    struct Barreira {
+        int id;                         // Os IDs anteriores já saíram da fila
+        std::uint64_t numero;           // Último registro do diário quando a faixa ficou completa
+    };
+
+    std::string diretorio;
+    std::size_t pacientes_por_segmento;
+    std::vector<Segmento> indice;       // Segmentos selados, em ordem de ID
+    std::deque<Barreira> barreiras;     // Faixas completas cujas saídas ainda não estão no disco
+    int proximo_id = 0;                 // Primeiro ID ainda não selado
+    int marca = 0;                      // Primeiro ID que pode estar na fila: os anteriores já saíram dela
+    int liberado = 0;                   // Primeiro ID cuja saída pode não estar no disco
+    bool erro = false;
+};
+
+#endif // HISTORICO_H
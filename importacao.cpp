@@ -0,0 +1,977 @@
+#include "importacao.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+#include "arquivomapeado.h"
+#include "cpf.h"
+#include "data.h"
+#include "paciente.h"
+#include "texto.h"
+#include "triagem.h"
+
+// Quantidade mínima de bytes por thread de leitura; abaixo disso não compensa dividir
+static const std::size_t TAMANHO_MINIMO_PEDACO = 1 << 20;
+
+// Erro de estrutura do JSON; a leitura não consegue continuar dentro do objeto
+static const char* const JSON_MAL_FORMADO = "JSON mal formado";
+
+// Campos de um cadastro, na ordem das colunas de um CSV sem cabeçalho
+enum Campo { CAMPO_NOME, CAMPO_CPF, CAMPO_EMAIL, CAMPO_NASCIMENTO, CAMPO_SINTOMAS, TOTAL_CAMPOS };
+
+// Nome de cada campo no cabeçalho CSV e nas chaves JSON
+static const char* const NOMES_CAMPOS[TOTAL_CAMPOS] = {"nome", "cpf", "email", "nascimento", "sintomas"};
+
+// Nomes aceitos para cada sintoma
+struct NomeSintoma {
+    const char* nome;
+    unsigned flag;
+};
+static const NomeSintoma NOMES_SINTOMAS[] = {
+    {"tosse", TOSSE},           {"nausea", NAUSEA},     {"náusea", NAUSEA},
+    {"febre", FEBRE},           {"disenteria", DISENTERIA},
+    {"infeccao", INFECCAO},     {"infecção", INFECCAO}, {"covid", COVID},
+    {"avc", AVC},               {"acidente", ACIDENTE}
+};
+
+// Registros lidos de um pedaço do conteúdo por uma thread
+struct Pedaco {
+    std::vector<Triagem::Cadastro> cadastros;
+    std::vector<std::string_view> cpfs;   // CPF de cada cadastro, conferido em lote no fim do pedaço
+    std::vector<std::size_t> posicoes;    // Deslocamento em bytes de cada cadastro
+    std::vector<ErroImportacao> erros;    // Até o fim da leitura, linha guarda o deslocamento em bytes do registro
+    std::deque<std::string> textos;       // Campos decodificados (aspas duplicadas ou escapes JSON)
+};
+
+static bool espaco(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool espaco_json(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool digito(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Remove espaços do início e do fim
+static std::string_view aparar(std::string_view texto)
+{
+    std::size_t inicio = 0;
+    std::size_t fim = texto.size();
+    while (inicio < fim && espaco(texto[inicio])) {
+        inicio++;
+    }
+    while (fim > inicio && espaco(texto[fim - 1])) {
+        fim--;
+    }
+    return texto.substr(inicio, fim - inicio);
+}
+
+// Lê exatamente n dígitos a partir da posição informada
+static bool ler_digitos(std::string_view texto, std::size_t inicio, std::size_t n, int& valor)
+{
+    valor = 0;
+    for (std::size_t i = inicio; i < inicio + n; ++i) {
+        if (!digito(texto[i])) {
+            return false;
+        }
+        valor = valor * 10 + (texto[i] - '0');
+    }
+    return true;
+}
+
+/**
+ * @brief Lê uma data de nascimento no formato DD/MM/AAAA ou AAAA-MM-DD.
+ * @param texto Data sem espaços.
+ * @param hoje Dia juliano de hoje; datas posteriores são rejeitadas.
+ * @param nascimento Recebe o dia juliano da data.
+ * @return Mensagem de erro ou nullptr se a data for válida.
+ */
+static const char* ler_nascimento(std::string_view texto, long long hoje, long long& nascimento)
+{
+    int ano, mes, dia;
+    if (texto.size() == 10 && texto[2] == '/' && texto[5] == '/' &&
+        ler_digitos(texto, 0, 2, dia) && ler_digitos(texto, 3, 2, mes) && ler_digitos(texto, 6, 4, ano)) {
+    }
+    else if (texto.size() == 10 && texto[4] == '-' && texto[7] == '-' &&
+             ler_digitos(texto, 0, 4, ano) && ler_digitos(texto, 5, 2, mes) && ler_digitos(texto, 8, 2, dia)) {
+    }
+    else {
+        return "data de nascimento fora do formato DD/MM/AAAA ou AAAA-MM-DD";
+    }
+
+    // A data existe se a conversão de volta devolve o mesmo dia, mês e ano (rejeita 31/02 etc.)
+    int a, m, d;
+    nascimento = dia_juliano(ano, mes, dia);
+    data_do_dia_juliano(nascimento, a, m, d);
+    if (ano < 1 || mes < 1 || mes > 12 || a != ano || m != mes || d != dia) {
+        return "data de nascimento inexistente";
+    }
+    if (nascimento > hoje) {
+        return "data de nascimento no futuro";
+    }
+    return nullptr;
+}
+
+static bool separador_sintomas(char c)
+{
+    return c == '|' || c == '+' || c == ',' || c == ';' || c == ' ' || c == '\t';
+}
+
+/**
+ * @brief Acrescenta às flags os sintomas de um texto.
+ * O texto é a máscara numérica (1 a 255) ou uma lista de nomes de sintomas.
+ * @return Mensagem de erro ou nullptr.
+ */
+static const char* ler_sintomas(std::string_view texto, unsigned& sintomas)
+{
+    texto = aparar(texto);
+    if (!texto.empty() && std::all_of(texto.begin(), texto.end(), digito)) {
+        int mascara = 0;
+        if (texto.size() > 3 || !ler_digitos(texto, 0, texto.size(), mascara) || mascara < 1 || mascara > 255) {
+            return "sintomas fora do intervalo de 1 a 255";
+        }
+        sintomas |= static_cast<unsigned>(mascara);
+        return nullptr;
+    }
+
+    std::size_t i = 0;
+    while (i < texto.size()) {
+        if (separador_sintomas(texto[i])) {
+            i++;
+            continue;
+        }
+        std::size_t fim = i;
+        while (fim < texto.size() && !separador_sintomas(texto[fim])) {
+            fim++;
+        }
+        std::string_view nome = texto.substr(i, fim - i);
+        const NomeSintoma* encontrado = std::find_if(std::begin(NOMES_SINTOMAS), std::end(NOMES_SINTOMAS),
+                                                     [&](const NomeSintoma& s) { return iguais_sem_caixa(nome, s.nome); });
+        if (encontrado == std::end(NOMES_SINTOMAS)) {
+            return "sintoma desconhecido";
+        }
+        sintomas |= encontrado->flag;
+        i = fim;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Valida os campos de um registro e monta o cadastro.
+ * O CPF não é conferido aqui: fica em cpf para a conferência em lote de conferir_cpfs.
+ * @return Mensagem de erro ou nullptr se o registro for válido.
+ */
+static const char* preencher(const std::string_view (&valores)[TOTAL_CAMPOS], unsigned sintomas, long long hoje,
+                             Triagem::Cadastro& cadastro, std::string_view& cpf)
+{
+    cadastro.nome = aparar(valores[CAMPO_NOME]);
+    if (cadastro.nome.empty()) {
+        return "nome vazio";
+    }
+    cpf = aparar(valores[CAMPO_CPF]);
+    const char* erro = ler_nascimento(aparar(valores[CAMPO_NASCIMENTO]), hoje, cadastro.nascimento);
+    if (erro != nullptr) {
+        return erro;
+    }
+    if (sintomas == 0) {
+        return "nenhum sintoma informado";
+    }
+    cadastro.email = aparar(valores[CAMPO_EMAIL]);
+    cadastro.sintomas = sintomas;
+    return nullptr;
+}
+
+// Guarda um cadastro lido, com o CPF ainda por conferir
+static void acrescentar(Pedaco& pedaco, const Triagem::Cadastro& cadastro, std::string_view cpf, std::size_t posicao)
+{
+    pedaco.cadastros.push_back(cadastro);
+    pedaco.cpfs.push_back(cpf);
+    pedaco.posicoes.push_back(posicao);
+}
+
+// Converte os CPFs do pedaço em chaves de uma vez e descarta os cadastros com CPF inválido
+static void conferir_cpfs(Pedaco& pedaco)
+{
+    std::vector<std::uint64_t> chaves = cpfs_para_chaves(pedaco.cpfs);
+    std::size_t validos = 0;
+    for (std::size_t i = 0; i < chaves.size(); ++i) {
+        if (chaves[i] == CPF_INVALIDO) {
+            pedaco.erros.push_back(ErroImportacao{pedaco.posicoes[i], "CPF inválido"});
+            continue;
+        }
+        pedaco.cadastros[validos] = pedaco.cadastros[i];
+        pedaco.cadastros[validos].cpf = chaves[i];
+        validos++;
+    }
+    pedaco.cadastros.resize(validos);
+    pedaco.cpfs = std::vector<std::string_view>();
+    pedaco.posicoes = std::vector<std::size_t>();
+}
+
+// Executa f(i) para i de 0 a n - 1, cada chamada em uma thread (a última na thread atual)
+template <typename F>
+static void em_paralelo(std::size_t n, F f)
+{
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        threads.emplace_back(f, i);
+    }
+    if (n > 0) {
+        f(n - 1);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
+
+// Quantidade de pedaços em que o conteúdo é dividido
+static std::size_t quantidade_de_pedacos(std::size_t tamanho, unsigned threads)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return std::max<std::size_t>(1, std::min<std::size_t>(threads, tamanho / TAMANHO_MINIMO_PEDACO));
+}
+
+// ---------------------------------------------------------------------------------------------
+// CSV
+
+/**
+ * @brief Divide uma linha CSV em campos.
+ * Campos entre aspas podem conter o separador e aspas duplicadas ("");
+ * os campos com aspas duplicadas são decodificados em textos.
+ * @return Mensagem de erro ou nullptr.
+ */
+static const char* dividir_csv(std::string_view linha, char separador, std::vector<std::string_view>& campos,
+                               std::deque<std::string>& textos)
+{
+    campos.clear();
+    std::size_t i = 0;
+    while (true) {
+        while (i < linha.size() && espaco(linha[i])) {
+            i++;
+        }
+        if (i < linha.size() && linha[i] == '"') {
+            std::size_t inicio = ++i;
+            bool duplicadas = false;
+            while (true) {
+                if (i >= linha.size()) {
+                    return "aspas não fechadas";
+                }
+                if (linha[i] == '"') {
+                    if (i + 1 < linha.size() && linha[i + 1] == '"') {
+                        duplicadas = true;
+                        i += 2;
+                        continue;
+                    }
+                    break;
+                }
+                i++;
+            }
+            std::string_view campo = linha.substr(inicio, i - inicio);
+            i++; // Aspas de fechamento
+            if (duplicadas) {
+                std::string& texto = textos.emplace_back();
+                texto.reserve(campo.size());
+                for (std::size_t k = 0; k < campo.size(); ++k) {
+                    texto.push_back(campo[k]);
+                    if (campo[k] == '"') {
+                        k++; // Pula a segunda aspa do par
+                    }
+                }
+                campo = texto;
+            }
+            while (i < linha.size() && espaco(linha[i])) {
+                i++;
+            }
+            if (i < linha.size() && linha[i] != separador) {
+                return "texto depois das aspas de fechamento";
+            }
+            campos.push_back(campo);
+        }
+        else {
+            std::size_t inicio = i;
+            while (i < linha.size() && linha[i] != separador) {
+                i++;
+            }
+            campos.push_back(aparar(linha.substr(inicio, i - inicio)));
+        }
+        if (i >= linha.size()) {
+            return nullptr;
+        }
+        i++; // Separador
+    }
+}
+
+// Disposição das colunas de um CSV, definida pela primeira linha
+struct FormatoCsv {
+    char separador;
+    std::vector<int> campo_da_coluna; // Campo de cada coluna (-1 para colunas ignoradas)
+};
+
+// Lê as linhas entre inicio e fim (início de linha ou fim do conteúdo)
+static void ler_pedaco_csv(std::string_view conteudo, std::size_t inicio, std::size_t fim, const FormatoCsv& formato,
+                           long long hoje, Pedaco& pedaco)
+{
+    std::vector<std::string_view> campos;
+    std::size_t pos = inicio;
+    while (pos < fim) {
+        const void* quebra = std::memchr(conteudo.data() + pos, '\n', fim - pos);
+        std::size_t fim_linha = quebra != nullptr ? static_cast<const char*>(quebra) - conteudo.data() : fim;
+        std::string_view linha = conteudo.substr(pos, fim_linha - pos);
+        std::size_t inicio_linha = pos;
+        pos = fim_linha + 1;
+        if (aparar(linha).empty()) {
+            continue;
+        }
+
+        const char* erro = dividir_csv(linha, formato.separador, campos, pedaco.textos);
+        if (erro == nullptr) {
+            std::string_view valores[TOTAL_CAMPOS];
+            for (std::size_t c = 0; c < campos.size() && c < formato.campo_da_coluna.size(); ++c) {
+                if (formato.campo_da_coluna[c] >= 0) {
+                    valores[formato.campo_da_coluna[c]] = campos[c];
+                }
+            }
+            unsigned sintomas = 0;
+            Triagem::Cadastro cadastro;
+            std::string_view cpf;
+            erro = ler_sintomas(valores[CAMPO_SINTOMAS], sintomas);
+            if (erro == nullptr) {
+                erro = preencher(valores, sintomas, hoje, cadastro, cpf);
+            }
+            if (erro == nullptr) {
+                acrescentar(pedaco, cadastro, cpf, inicio_linha);
+            }
+        }
+        if (erro != nullptr) {
+            pedaco.erros.push_back(ErroImportacao{inicio_linha, erro});
+        }
+    }
+}
+
+// Lê um conteúdo CSV a partir de inicio, dividido em até n pedaços
+static void ler_csv(std::string_view conteudo, std::size_t inicio, std::size_t n, long long hoje,
+                    std::vector<Pedaco>& pedacos, std::vector<ErroImportacao>& erros)
+{
+    // A primeira linha define o separador e, se for um cabeçalho, a ordem das colunas
+    std::size_t fim_primeira = conteudo.find('\n', inicio);
+    if (fim_primeira == std::string_view::npos) {
+        fim_primeira = conteudo.size();
+    }
+    std::string_view primeira = conteudo.substr(inicio, fim_primeira - inicio);
+
+    FormatoCsv formato;
+    formato.separador = std::count(primeira.begin(), primeira.end(), ';') >
+                        std::count(primeira.begin(), primeira.end(), ',') ? ';' : ',';
+
+    std::deque<std::string> textos;
+    std::vector<std::string_view> colunas;
+    bool cabecalho = false;
+    if (dividir_csv(primeira, formato.separador, colunas, textos) == nullptr) {
+        for (std::string_view coluna : colunas) {
+            int campo = -1;
+            for (int c = 0; c < TOTAL_CAMPOS; ++c) {
+                if (iguais_sem_caixa(coluna, NOMES_CAMPOS[c])) {
+                    campo = c;
+                    cabecalho = true;
+                }
+            }
+            formato.campo_da_coluna.push_back(campo);
+        }
+    }
+    if (cabecalho) {
+        bool colunas_presentes[TOTAL_CAMPOS] = {};
+        for (int campo : formato.campo_da_coluna) {
+            if (campo >= 0) {
+                colunas_presentes[campo] = true;
+            }
+        }
+        if (!colunas_presentes[CAMPO_NOME] || !colunas_presentes[CAMPO_CPF] ||
+            !colunas_presentes[CAMPO_NASCIMENTO] || !colunas_presentes[CAMPO_SINTOMAS]) {
+            erros.push_back(ErroImportacao{inicio, "cabeçalho sem as colunas nome, cpf, nascimento e sintomas"});
+            return;
+        }
+        inicio = std::min(fim_primeira + 1, conteudo.size());
+    }
+    else {
+        formato.campo_da_coluna = {CAMPO_NOME, CAMPO_CPF, CAMPO_EMAIL, CAMPO_NASCIMENTO, CAMPO_SINTOMAS};
+    }
+
+    // Divide o restante em pedaços de tamanho parecido, cada um começando no início de uma linha
+    std::vector<std::size_t> limites = {inicio};
+    const std::size_t passo = (conteudo.size() - inicio) / n;
+    for (std::size_t p = 1; p < n; ++p) {
+        std::size_t limite = std::max(limites.back(), inicio + p * passo);
+        std::size_t quebra = conteudo.find('\n', limite);
+        limites.push_back(quebra == std::string_view::npos ? conteudo.size() : quebra + 1);
+    }
+    limites.push_back(conteudo.size());
+
+    pedacos.resize(n);
+    em_paralelo(n, [&](std::size_t p) {
+        ler_pedaco_csv(conteudo, limites[p], limites[p + 1], formato, hoje, pedacos[p]);
+        conferir_cpfs(pedacos[p]);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------
+// JSON
+
+static void pular_espacos_json(std::string_view t, std::size_t& i)
+{
+    while (i < t.size() && espaco_json(t[i])) {
+        i++;
+    }
+}
+
+// Acrescenta um ponto de código em UTF-8
+static void acrescentar_utf8(std::string& texto, unsigned cp)
+{
+    if (cp < 0x80) {
+        texto.push_back(static_cast<char>(cp));
+    }
+    else if (cp < 0x800) {
+        texto.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        texto.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else if (cp < 0x10000) {
+        texto.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        texto.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        texto.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else {
+        texto.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        texto.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        texto.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        texto.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+// Lê os 4 dígitos hexadecimais de um escape \u
+static bool ler_hex4(std::string_view t, std::size_t& i, unsigned& valor)
+{
+    if (i + 4 > t.size()) {
+        return false;
+    }
+    valor = 0;
+    for (std::size_t fim = i + 4; i < fim; ++i) {
+        char c = t[i];
+        unsigned d;
+        if (c >= '0' && c <= '9') {
+            d = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            d = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            d = c - 'A' + 10;
+        } else {
+            return false;
+        }
+        valor = valor * 16 + d;
+    }
+    return true;
+}
+
+/**
+ * @brief Lê um texto JSON começando nas aspas iniciais.
+ * Sem escapes, o valor aponta para o próprio conteúdo; com escapes, é decodificado em textos.
+ * @return false se o texto estiver mal formado.
+ */
+static bool ler_texto_json(std::string_view t, std::size_t& i, std::string_view& valor, std::deque<std::string>& textos)
+{
+    std::size_t inicio = ++i;
+    while (i < t.size() && t[i] != '"' && t[i] != '\\') {
+        if (static_cast<unsigned char>(t[i]) < 0x20) {
+            return false;
+        }
+        i++;
+    }
+    if (i >= t.size()) {
+        return false;
+    }
+    if (t[i] == '"') {
+        valor = t.substr(inicio, i - inicio);
+        i++;
+        return true;
+    }
+
+    std::string& texto = textos.emplace_back(t.substr(inicio, i - inicio));
+    while (true) {
+        if (i >= t.size() || static_cast<unsigned char>(t[i]) < 0x20) {
+            return false;
+        }
+        char c = t[i++];
+        if (c == '"') {
+            valor = texto;
+            return true;
+        }
+        if (c != '\\') {
+            texto.push_back(c);
+            continue;
+        }
+        if (i >= t.size()) {
+            return false;
+        }
+        switch (t[i++]) {
+        case '"': texto.push_back('"'); break;
+        case '\\': texto.push_back('\\'); break;
+        case '/': texto.push_back('/'); break;
+        case 'b': texto.push_back('\b'); break;
+        case 'f': texto.push_back('\f'); break;
+        case 'n': texto.push_back('\n'); break;
+        case 'r': texto.push_back('\r'); break;
+        case 't': texto.push_back('\t'); break;
+        case 'u': {
+            unsigned cp;
+            if (!ler_hex4(t, i, cp) || (cp >= 0xDC00 && cp <= 0xDFFF)) {
+                return false;
+            }
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                // Par substituto: o segundo escape completa o ponto de código
+                unsigned baixo;
+                if (i + 2 > t.size() || t[i] != '\\' || t[i + 1] != 'u') {
+                    return false;
+                }
+                i += 2;
+                if (!ler_hex4(t, i, baixo) || baixo < 0xDC00 || baixo > 0xDFFF) {
+                    return false;
+                }
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (baixo - 0xDC00);
+            }
+            acrescentar_utf8(texto, cp);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Pula um valor JSON qualquer (texto, número, literal, objeto ou vetor).
+ * @return false se o valor estiver mal formado ou incompleto.
+ */
+static bool pular_valor_json(std::string_view t, std::size_t& i)
+{
+    int profundidade = 0;
+    do {
+        pular_espacos_json(t, i);
+        if (i >= t.size()) {
+            return false;
+        }
+        char c = t[i];
+        if (c == '"') {
+            for (i++; i < t.size() && t[i] != '"'; ++i) {
+                if (t[i] == '\\') {
+                    i++;
+                }
+            }
+            if (i >= t.size()) {
+                return false;
+            }
+            i++;
+        }
+        else if (c == '{' || c == '[') {
+            profundidade++;
+            i++;
+        }
+        else if (c == '}' || c == ']') {
+            if (--profundidade < 0) {
+                return false;
+            }
+            i++;
+        }
+        else if (c == ',' || c == ':') {
+            if (profundidade == 0) {
+                return false;
+            }
+            i++;
+        }
+        else {
+            std::size_t inicio = i;
+            while (i < t.size() && (std::isalnum(static_cast<unsigned char>(t[i])) || t[i] == '-' ||
+                                    t[i] == '+' || t[i] == '.')) {
+                i++;
+            }
+            if (i == inicio) {
+                return false;
+            }
+        }
+    } while (profundidade > 0);
+    return true;
+}
+
+// Verifica se o valor na posição i é o literal null
+static bool nulo_json(std::string_view t, std::size_t i)
+{
+    return t.compare(i, 4, "null") == 0;
+}
+
+/**
+ * @brief Lê o valor do campo sintomas: número, texto ou vetor de números e textos.
+ * @param erro Recebe a mensagem de erro se o valor for inválido, sem interromper a leitura.
+ * @return false se o JSON estiver mal formado.
+ */
+static bool ler_sintomas_json(std::string_view t, std::size_t& i, unsigned& sintomas, const char*& erro,
+                              std::deque<std::string>& textos)
+{
+    // Lê um elemento; retorna false apenas em erro de estrutura
+    auto ler_elemento = [&]() {
+        std::string_view valor;
+        if (t[i] == '"') {
+            if (!ler_texto_json(t, i, valor, textos)) {
+                return false;
+            }
+        }
+        else if (digito(t[i])) {
+            std::size_t inicio = i;
+            if (!pular_valor_json(t, i)) {
+                return false;
+            }
+            valor = t.substr(inicio, i - inicio);
+        }
+        else {
+            if (erro == nullptr && !nulo_json(t, i)) {
+                erro = "sintomas com tipo inválido";
+            }
+            return pular_valor_json(t, i);
+        }
+        const char* erro_valor = ler_sintomas(valor, sintomas);
+        if (erro == nullptr) {
+            erro = erro_valor;
+        }
+        return true;
+    };
+
+    if (t[i] != '[') {
+        return ler_elemento();
+    }
+    i++;
+    pular_espacos_json(t, i);
+    if (i < t.size() && t[i] == ']') {
+        i++;
+        return true;
+    }
+    while (true) {
+        pular_espacos_json(t, i);
+        if (i >= t.size() || !ler_elemento()) {
+            return false;
+        }
+        pular_espacos_json(t, i);
+        if (i >= t.size()) {
+            return false;
+        }
+        if (t[i++] == ']') {
+            return true;
+        }
+        if (t[i - 1] != ',') {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Lê um objeto JSON de paciente começando na chave de abertura.
+ * Campos desconhecidos são ignorados e null equivale a um campo ausente.
+ * @return Mensagem de erro, JSON_MAL_FORMADO se a estrutura estiver quebrada, ou nullptr.
+ */
+static const char* ler_objeto_json(std::string_view t, std::size_t& i, long long hoje, std::deque<std::string>& textos,
+                                   Triagem::Cadastro& cadastro, std::string_view& cpf)
+{
+    std::string_view valores[TOTAL_CAMPOS];
+    unsigned sintomas = 0;
+    const char* erro = nullptr;
+
+    i++; // Chave de abertura
+    pular_espacos_json(t, i);
+    if (i < t.size() && t[i] == '}') {
+        i++;
+        return preencher(valores, sintomas, hoje, cadastro, cpf);
+    }
+    while (true) {
+        std::string_view chave;
+        pular_espacos_json(t, i);
+        if (i >= t.size() || t[i] != '"' || !ler_texto_json(t, i, chave, textos)) {
+            return JSON_MAL_FORMADO;
+        }
+        pular_espacos_json(t, i);
+        if (i >= t.size() || t[i] != ':') {
+            return JSON_MAL_FORMADO;
+        }
+        i++;
+        pular_espacos_json(t, i);
+        if (i >= t.size()) {
+            return JSON_MAL_FORMADO;
+        }
+
+        int campo = -1;
+        for (int c = 0; c < TOTAL_CAMPOS; ++c) {
+            if (chave == NOMES_CAMPOS[c]) {
+                campo = c;
+            }
+        }
+
+        if (campo == CAMPO_SINTOMAS) {
+            if (!ler_sintomas_json(t, i, sintomas, erro, textos)) {
+                return JSON_MAL_FORMADO;
+            }
+        }
+        else if (campo >= 0 && t[i] == '"') {
+            if (!ler_texto_json(t, i, valores[campo], textos)) {
+                return JSON_MAL_FORMADO;
+            }
+        }
+        else {
+            if (campo >= 0 && erro == nullptr && !nulo_json(t, i)) {
+                erro = "campo com tipo inválido (esperado texto)";
+            }
+            if (!pular_valor_json(t, i)) {
+                return JSON_MAL_FORMADO;
+            }
+        }
+
+        pular_espacos_json(t, i);
+        if (i >= t.size()) {
+            return JSON_MAL_FORMADO;
+        }
+        if (t[i] == '}') {
+            i++;
+            break;
+        }
+        if (t[i] != ',') {
+            return JSON_MAL_FORMADO;
+        }
+        i++;
+    }
+    return erro != nullptr ? erro : preencher(valores, sintomas, hoje, cadastro, cpf);
+}
+
+// Lê os objetos entre inicio e fim, separados por vírgulas ou espaços
+static void ler_pedaco_json(std::string_view conteudo, std::size_t inicio, std::size_t fim, long long hoje,
+                            Pedaco& pedaco)
+{
+    std::string_view t = conteudo.substr(0, fim);
+    std::size_t i = inicio;
+    while (true) {
+        while (i < fim && (espaco_json(t[i]) || t[i] == ',')) {
+            i++;
+        }
+        if (i >= fim) {
+            return;
+        }
+        std::size_t inicio_objeto = i;
+        if (t[i] != '{') {
+            pedaco.erros.push_back(ErroImportacao{inicio_objeto, "esperado um objeto JSON"});
+            if (!pular_valor_json(t, i)) {
+                return;
+            }
+            continue;
+        }
+
+        Triagem::Cadastro cadastro;
+        std::string_view cpf;
+        const char* erro = ler_objeto_json(t, i, hoje, pedaco.textos, cadastro, cpf);
+        if (erro == nullptr) {
+            acrescentar(pedaco, cadastro, cpf, inicio_objeto);
+            continue;
+        }
+        pedaco.erros.push_back(ErroImportacao{inicio_objeto, erro});
+        if (erro == JSON_MAL_FORMADO) {
+            // Retoma a leitura depois do objeto, cujos limites já foram conferidos por dividir_json
+            i = inicio_objeto;
+            if (!pular_valor_json(t, i)) {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Localiza os objetos de primeiro nível de um JSON e escolhe os limites dos pedaços.
+ * Percorre o conteúdo uma vez acompanhando apenas textos e aninhamento, o que
+ * permite dividir a leitura completa entre threads sem cortar objetos.
+ * @param limites Recebe o início de cada pedaço, seguido do fim dos objetos.
+ * @return Mensagem de erro de estrutura, ou nullptr; em caso de erro os limites
+ *         cobrem apenas os objetos completos anteriores a ele.
+ */
+static const char* dividir_json(std::string_view t, std::size_t inicio, std::size_t n, std::vector<std::size_t>& limites,
+                                std::size_t& posicao_erro)
+{
+    std::size_t i = inicio;
+    bool vetor = t[i] == '[';
+    if (vetor) {
+        i++;
+    }
+    limites = {i};
+    const std::size_t passo = (t.size() - i) / n;
+    std::size_t proximo = i + passo;
+
+    int profundidade = 0;
+    bool texto_aberto = false;
+    std::size_t inicio_valor = i; // Início do último valor de primeiro nível
+    std::size_t fim_completo = i; // Fim do último valor de primeiro nível completo
+    for (; i < t.size(); ++i) {
+        char c = t[i];
+        if (c == '"') {
+            for (i++; i < t.size() && t[i] != '"'; ++i) {
+                if (t[i] == '\\') {
+                    i++;
+                }
+            }
+            if (i >= t.size()) {
+                texto_aberto = true;
+                break;
+            }
+        }
+        else if (c == '{' || c == '[') {
+            if (profundidade++ == 0) {
+                inicio_valor = i;
+                if (i >= proximo && limites.size() < n) {
+                    limites.push_back(i);
+                    proximo = i + passo;
+                }
+            }
+        }
+        else if (c == '}' || c == ']') {
+            if (profundidade == 0 && c == ']' && vetor) {
+                // Fim do vetor: depois dele só pode haver espaços
+                limites.push_back(i);
+                std::size_t fim = i + 1;
+                pular_espacos_json(t, fim);
+                if (fim < t.size()) {
+                    posicao_erro = fim;
+                    return "conteúdo depois do fim do vetor JSON";
+                }
+                return nullptr;
+            }
+            if (--profundidade < 0) {
+                limites.push_back(i);
+                posicao_erro = i;
+                return JSON_MAL_FORMADO;
+            }
+            if (profundidade == 0) {
+                fim_completo = i + 1;
+            }
+        }
+    }
+
+    if (texto_aberto || profundidade > 0) {
+        // Último valor incompleto: lê apenas os objetos anteriores a ele
+        while (limites.size() > 1 && limites.back() >= fim_completo) {
+            limites.pop_back();
+        }
+        limites.push_back(std::max(limites.back(), fim_completo));
+        posicao_erro = std::max(inicio_valor, fim_completo);
+        return "objeto JSON incompleto";
+    }
+    limites.push_back(t.size());
+    if (vetor) {
+        posicao_erro = t.size();
+        return "vetor JSON sem ] final";
+    }
+    return nullptr;
+}
+
+// Lê um conteúdo JSON a partir de inicio, dividido em até n pedaços
+static void ler_json(std::string_view conteudo, std::size_t inicio, std::size_t n, long long hoje,
+                     std::vector<Pedaco>& pedacos, std::vector<ErroImportacao>& erros)
+{
+    std::vector<std::size_t> limites;
+    std::size_t posicao_erro = 0;
+    const char* erro = dividir_json(conteudo, inicio, n, limites, posicao_erro);
+    if (erro != nullptr) {
+        erros.push_back(ErroImportacao{posicao_erro, erro});
+    }
+
+    n = limites.size() - 1;
+    pedacos.resize(n);
+    em_paralelo(n, [&](std::size_t p) {
+        ler_pedaco_json(conteudo, limites[p], limites[p + 1], hoje, pedacos[p]);
+        conferir_cpfs(pedacos[p]);
+    });
+}
+
+// Troca o deslocamento em bytes guardado em cada erro (em ordem crescente) pelo número da linha
+static void numerar_linhas(std::string_view conteudo, std::vector<ErroImportacao>& erros)
+{
+    std::size_t linha = 1;
+    std::size_t pos = 0;
+    for (ErroImportacao& erro : erros) {
+        std::size_t alvo = std::min(erro.linha, conteudo.size());
+        while (pos < alvo) {
+            const void* quebra = std::memchr(conteudo.data() + pos, '\n', alvo - pos);
+            if (quebra == nullptr) {
+                break;
+            }
+            pos = static_cast<const char*>(quebra) - conteudo.data() + 1;
+            linha++;
+        }
+        pos = std::max(pos, alvo);
+        erro.linha = linha;
+    }
+}
+
+ResultadoImportacao importar(Triagem& triagem, std::string_view conteudo, unsigned threads)
+{
+    ResultadoImportacao resultado;
+
+    // Ignora a marca de ordem de bytes UTF-8 e os espaços iniciais
+    std::size_t inicio = conteudo.substr(0, 3) == "\xEF\xBB\xBF" ? 3 : 0;
+    while (inicio < conteudo.size() && espaco_json(conteudo[inicio])) {
+        inicio++;
+    }
+    if (inicio == conteudo.size()) {
+        return resultado;
+    }
+
+    const std::size_t n = quantidade_de_pedacos(conteudo.size() - inicio, threads);
+    const long long hoje = dia_juliano_hoje();
+    std::vector<Pedaco> pedacos;
+    std::vector<ErroImportacao> erros;
+    if (conteudo[inicio] == '[' || conteudo[inicio] == '{') {
+        ler_json(conteudo, inicio, n, hoje, pedacos, erros);
+    }
+    else {
+        ler_csv(conteudo, inicio, n, hoje, pedacos, erros);
+    }
+
+    // Junta os pedaços na ordem do arquivo
+    std::size_t total = 0;
+    for (const Pedaco& pedaco : pedacos) {
+        total += pedaco.cadastros.size();
+    }
+    std::vector<Triagem::Cadastro> cadastros;
+    cadastros.reserve(total);
+    for (const Pedaco& pedaco : pedacos) {
+        cadastros.insert(cadastros.end(), pedaco.cadastros.begin(), pedaco.cadastros.end());
+        erros.insert(erros.end(), pedaco.erros.begin(), pedaco.erros.end());
+    }
+    std::stable_sort(erros.begin(), erros.end(),
+                     [](const ErroImportacao& a, const ErroImportacao& b) { return a.linha < b.linha; });
+    numerar_linhas(conteudo, erros);
+
+    // Os textos dos cadastros apontam para o conteúdo e para os pedaços, que continuam vivos aqui
+    resultado.admitidos = triagem.admitir_lote(cadastros);
+    resultado.atualizados = cadastros.size() - resultado.admitidos;
+    resultado.erros = std::move(erros);
+    return resultado;
+}
+
+bool importar_arquivo(Triagem& triagem, const std::string& caminho, ResultadoImportacao& resultado, unsigned threads)
+{
+    ArquivoMapeado arquivo(caminho);
+    if (!arquivo.existe()) {
+        return false;
+    }
+    resultado = importar(triagem, std::string_view(arquivo.dados(), arquivo.tamanho()), threads);
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef IMPORTACAO_H
+#define IMPORTACAO_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Triagem;
+
+// Registro rejeitado na importação
+struct ErroImportacao {
+    std::size_t linha;  // Linha do arquivo onde o registro começa (a partir de 1)
+    const char* motivo; // Descrição do problema
+};
+
+// Resumo de uma importação
+struct ResultadoImportacao {
+    std::size_t admitidos = 0;         // Pacientes novos inseridos na fila
+    std::size_t atualizados = 0;       // Registros que atualizaram pacientes já na fila
+    std::vector<ErroImportacao> erros; // Registros rejeitados, em ordem de linha
+};
+
+/**
+ * @brief Importa pacientes de um conteúdo CSV ou JSON para a triagem.
+ *
+ * O formato é detectado pelo primeiro caractere: '[' ou '{' indicam JSON (um
+ * vetor de objetos ou um objeto por linha); qualquer outro, CSV.
+ *
+ * CSV: uma linha por paciente, separada por vírgula ou ponto e vírgula
+ * (escolhido pela primeira linha). Se a primeira linha for um cabeçalho com os
+ * nomes nome, cpf, email, nascimento e sintomas, as colunas seguem o cabeçalho
+ * e colunas desconhecidas são ignoradas; sem cabeçalho, as colunas são lidas
+ * nessa ordem. Campos entre aspas aceitam o separador e aspas duplicadas, mas
+ * não quebras de linha.
+ *
+ * JSON: objetos com as mesmas chaves; sintomas pode ser um número, um texto ou
+ * um vetor de nomes.
+ *
+ * O CPF aceita os formatos de cpf_para_chave, a data de nascimento DD/MM/AAAA
+ * ou AAAA-MM-DD (existente e não futura) e os sintomas a máscara de flags (1 a
+ * 255) ou os nomes de SINTOMAS separados por |, +, espaço, vírgula ou ponto e
+ * vírgula, sem diferenciar maiúsculas de minúsculas.
+ *
+ * Conteúdos grandes são divididos em pedaços lidos em paralelo; os registros
+ * válidos são então admitidos de uma só vez, na ordem do arquivo, por
+ * Triagem::admitir_lote. Registros inválidos são rejeitados individualmente
+ * sem interromper a importação.
+ *
+ * @param triagem Triagem que recebe os pacientes.
+ * @param conteudo Conteúdo do arquivo (UTF-8).
+ * @param threads Quantidade máxima de threads de leitura (0 usa a quantidade de núcleos).
+ * @return Quantidades importadas e registros rejeitados.
+ */
+ResultadoImportacao importar(Triagem& triagem, std::string_view conteudo, unsigned threads = 0);
+
+/**
+ * @brief Importa pacientes de um arquivo CSV ou JSON, mapeado em memória.
+ * @param triagem Triagem que recebe os pacientes.
+ * @param caminho Caminho do arquivo.
+ * @param resultado Recebe o resumo da importação.
+ * @param threads Quantidade máxima de threads de leitura (0 usa a quantidade de núcleos).
+ * @return false se o arquivo não puder ser aberto.
+ */
+bool importar_arquivo(Triagem& triagem, const std::string& caminho, ResultadoImportacao& resultado,
+                      unsigned threads = 0);
+
+#endif // IMPORTACAO_H
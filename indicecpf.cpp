@@ -0,0 +1,110 @@
+#include "indicecpf.h"
+
+// Capacidade inicial da tabela (potência de 2)
+static const unsigned BITS_INICIAIS = 6;
+
+IndiceCpf::IndiceCpf()
+    : mascara(0), bits(0), quantidade(0)
+{
+    redimensionar(std::size_t(1) << BITS_INICIAIS);
+}
+
+// Hash multiplicativo de Fibonacci: usa os bits mais altos do produto
+std::size_t IndiceCpf::posicao_ideal(std::uint64_t chave) const
+{
+    return static_cast<std::size_t>((chave * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+}
+
+void IndiceCpf::redimensionar(std::size_t capacidade)
+{
+    std::vector<Slot> antigos;
+    antigos.swap(tabela);
+    tabela.assign(capacidade, Slot{0, -1});
+    mascara = capacidade - 1;
+    bits = 0;
+    while ((std::size_t(1) << bits) < capacidade) {
+        bits++;
+    }
+
+    // Reinsere as entradas da tabela antiga
+    quantidade = 0;
+    for (const Slot& slot : antigos) {
+        if (slot.handle != -1) {
+            inserir(slot.chave, slot.handle);
+        }
+    }
+}
+
+void IndiceCpf::reservar(std::size_t total)
+{
+    std::size_t capacidade = tabela.size();
+    while (total * 2 > capacidade) {
+        capacidade *= 2;
+    }
+    if (capacidade != tabela.size()) {
+        redimensionar(capacidade);
+    }
+}
+
+int IndiceCpf::buscar(std::uint64_t chave) const
+{
+    for (std::size_t i = posicao_ideal(chave); ; i = (i + 1) & mascara) {
+        const Slot& slot = tabela[i];
+        if (slot.handle == -1) {
+            return -1; // Slot vazio: o CPF não está na tabela
+        }
+        if (slot.chave == chave) {
+            return slot.handle;
+        }
+    }
+}
+
+void IndiceCpf::inserir(std::uint64_t chave, int handle)
+{
+    // Mantém a carga da tabela abaixo de 50%
+    if ((quantidade + 1) * 2 > tabela.size()) {
+        redimensionar(tabela.size() * 2);
+    }
+
+    for (std::size_t i = posicao_ideal(chave); ; i = (i + 1) & mascara) {
+        Slot& slot = tabela[i];
+        if (slot.handle == -1) {
+            slot.chave = chave;
+            slot.handle = handle;
+            quantidade++;
+            return;
+        }
+        if (slot.chave == chave) {
+            slot.handle = handle; // CPF já presente: substitui o handle
+            return;
+        }
+    }
+}
+
+bool IndiceCpf::remover(std::uint64_t chave)
+{
+    std::size_t i = posicao_ideal(chave);
+    while (true) {
+        if (tabela[i].handle == -1) {
+            return false;
+        }
+        if (tabela[i].chave == chave) {
+            break;
+        }
+        i = (i + 1) & mascara;
+    }
+
+    // Desloca para trás as entradas seguintes que ficariam inalcançáveis
+    std::size_t vazio = i;
+    for (std::size_t j = (i + 1) & mascara; tabela[j].handle != -1; j = (j + 1) & mascara) {
+        std::size_t ideal = posicao_ideal(tabela[j].chave);
+        // A entrada em j pode ocupar o vazio se o vazio estiver entre sua posição ideal e j
+        if (((j - ideal) & mascara) >= ((j - vazio) & mascara)) {
+            tabela[vazio] = tabela[j];
+            vazio = j;
+        }
+    }
+    tabela[vazio].handle = -1;
+    quantidade--;
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef INDICECPF_H
+#define INDICECPF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Índice de pacientes por CPF em tabela hash de endereçamento aberto.
+ *
+ * Associa a chave compacta do CPF (ver cpf.h) ao handle do paciente. Usa
+ * sondagem linear com capacidade potência de 2 e carga máxima de 50%, e a
+ * remoção desloca as entradas seguintes para trás em vez de deixar marcas de
+ * remoção, de modo que busca, inserção e remoção são O(1) em média.
+ */
+class IndiceCpf
+{
+public:
+    IndiceCpf();
+
+    /**
+     * @brief Busca o handle do paciente com o CPF informado.
+     * @param chave Chave do CPF.
+     * @return Handle do paciente ou -1 se o CPF não estiver no índice.
+     */
+    int buscar(std::uint64_t chave) const;
+
+    /**
+     * @brief Associa um CPF a um handle, substituindo a associação anterior.
+     * @param chave Chave do CPF.
+     * @param handle Handle do paciente.
+     */
+    void inserir(std::uint64_t chave, int handle);
+
+    /**
+     * @brief Remove um CPF do índice.
+     * @param chave Chave do CPF.
+     * @return true se o CPF estava no índice.
+     */
+    bool remover(std::uint64_t chave);
+
+    /**
+     * @brief Prepara a tabela para receber a quantidade informada de CPFs sem redimensionar.
+     * @param total Quantidade esperada de CPFs no índice.
+     */
+    void reservar(std::size_t total);
+
+    std::size_t tamanho() const { return quantidade; }
+
+private:
+    struct Slot {
+        std::uint64_t chave; // Chave do CPF
+        int handle;          // Handle do paciente (-1 indica slot vazio)
+    };
+
+    std::size_t posicao_ideal(std::uint64_t chave) const;
+    void redimensionar(std::size_t capacidade);
+
+    std::vector<Slot> tabela;  // Slots da tabela hash
+    std::size_t mascara;       // Capacidade - 1
+    unsigned bits;             // log2 da capacidade
+    std::size_t quantidade;    // Quantidade de CPFs no índice
+};
+
+#endif // INDICECPF_H
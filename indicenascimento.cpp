@@ -0,0 +1,283 @@
+#include "indicenascimento.h"
+
+#include <algorithm>
+
+#include "data.h"
+
+// Dias livres deixados antes e depois dos nascimentos ao dimensionar as árvores (cerca de 45 anos)
+static const long long MARGEM = 1 << 14;
+
+// Datas indexadas: de 1/1/1 a 31/12/9999, os anos aceitos pela importação e pela exibição
+static const long long PRIMEIRO_DIA = dia_juliano(1, 1, 1);
+static const long long ULTIMO_DIA = dia_juliano(9999, 12, 31);
+
+// Limita um dia ao intervalo das chaves dos índices ordenados
+static std::int32_t chave_do_dia(long long dia)
+{
+    return static_cast<std::int32_t>(std::min<long long>(std::max<long long>(dia, INT32_MIN), INT32_MAX));
+}
+
+// Leva uma data de nascimento fora das datas indexadas para o limite mais próximo
+static long long limitar_dia(long long dia)
+{
+    return std::min(std::max(dia, PRIMEIRO_DIA), ULTIMO_DIA);
+}
+
+void IndiceNascimento::adicionar(int id, long long nascimento, bool na_fila)
+{
+    nascimento = limitar_dia(nascimento);
+    if (static_cast<std::size_t>(id) / 64 == fila.size()) {
+        fila.push_back(0);
+    }
+    quantidade = static_cast<std::size_t>(id) + 1;
+    cobrir(nascimento);
+    somar(arvore_todos, nascimento, 1);
+    ordem_todos.inserir(chave_do_dia(nascimento), id);
+    if (na_fila) {
+        fila[static_cast<std::size_t>(id) / 64] |= std::uint64_t(1) << (id % 64);
+        somar(arvore_fila, nascimento, 1);
+        ordem_fila.inserir(chave_do_dia(nascimento), id);
+    } else {
+        ordem_historico.inserir(chave_do_dia(nascimento), id);
+    }
+}
+
+void IndiceNascimento::atualizar(int id, long long anterior, long long nascimento)
+{
+    anterior = limitar_dia(anterior);
+    nascimento = limitar_dia(nascimento);
+    if (anterior == nascimento) {
+        return;
+    }
+    bool na_fila = esta_na_fila(id);
+    IndiceOrdenado<std::int32_t>& parte = na_fila ? ordem_fila : ordem_historico;
+    if (na_fila) {
+        subtrair(arvore_fila, anterior);
+    }
+    parte.remover(chave_do_dia(anterior), id);
+    subtrair(arvore_todos, anterior);
+    ordem_todos.remover(chave_do_dia(anterior), id);
+    cobrir(nascimento);
+    somar(arvore_todos, nascimento, 1);
+    ordem_todos.inserir(chave_do_dia(nascimento), id);
+    parte.inserir(chave_do_dia(nascimento), id);
+    if (na_fila) {
+        somar(arvore_fila, nascimento, 1);
+    }
+}
+
+void IndiceNascimento::marcar_fila(int id, long long nascimento, bool na_fila)
+{
+    if (esta_na_fila(id) == na_fila) {
+        return;
+    }
+    nascimento = limitar_dia(nascimento);
+    std::uint64_t bit = std::uint64_t(1) << (id % 64);
+    if (na_fila) {
+        fila[static_cast<std::size_t>(id) / 64] |= bit;
+        somar(arvore_fila, nascimento, 1);
+        ordem_historico.remover(chave_do_dia(nascimento), id);
+        ordem_fila.inserir(chave_do_dia(nascimento), id);
+    } else {
+        fila[static_cast<std::size_t>(id) / 64] &= ~bit;
+        subtrair(arvore_fila, nascimento);
+        ordem_fila.remover(chave_do_dia(nascimento), id);
+        ordem_historico.inserir(chave_do_dia(nascimento), id);
+    }
+}
+
+void IndiceNascimento::construir(const std::vector<long long>& nascimentos, const std::vector<int>& ids_na_fila)
+{
+    limpar();
+    quantidade = nascimentos.size();
+    fila.assign((quantidade + 63) / 64, 0);
+    if (quantidade == 0) {
+        return;
+    }
+
+    long long primeiro = ULTIMO_DIA, ultimo = PRIMEIRO_DIA;
+    for (int id : ids_na_fila) {
+        fila[static_cast<std::size_t>(id) / 64] |= std::uint64_t(1) << (id % 64);
+    }
+    for (long long nascimento : nascimentos) {
+        long long dia = limitar_dia(nascimento);
+        primeiro = std::min(primeiro, dia);
+        ultimo = std::max(ultimo, dia);
+    }
+    dimensionar(primeiro - MARGEM, ultimo + MARGEM);
+
+    // Ordena pelo dia por contagem, em O(n + D): percorridos em ordem de ID, os pacientes de
+    // um mesmo dia já saem na ordem de IndiceOrdenado, que não precisa ordenar de novo
+    std::vector<std::uint32_t> posicao(arvore_todos.size(), 0);
+    for (long long nascimento : nascimentos) {
+        posicao[static_cast<std::size_t>(limitar_dia(nascimento) - base) + 1]++;
+    }
+    for (std::size_t p = 1; p < posicao.size(); ++p) {
+        posicao[p] += posicao[p - 1];
+    }
+    std::vector<IndiceOrdenado<std::int32_t>::Entrada> todos(quantidade), na_fila, fora_da_fila;
+    for (std::size_t id = 0; id < quantidade; ++id) {
+        long long dia = limitar_dia(nascimentos[id]);
+        todos[posicao[static_cast<std::size_t>(dia - base)]++] = {chave_do_dia(dia), static_cast<int>(id)};
+    }
+    na_fila.reserve(ids_na_fila.size());
+    fora_da_fila.reserve(quantidade - ids_na_fila.size());
+    for (const IndiceOrdenado<std::int32_t>::Entrada& entrada : todos) {
+        (esta_na_fila(entrada.handle) ? na_fila : fora_da_fila).push_back(entrada);
+    }
+    ordem_todos.construir(std::move(todos));
+    ordem_fila.construir(std::move(na_fila));
+    ordem_historico.construir(std::move(fora_da_fila));
+    reconstruir_arvores();
+}
+
+void IndiceNascimento::limpar()
+{
+    quantidade = 0;
+    base = 0;
+    arvore_todos.clear();
+    arvore_fila.clear();
+    ordem_todos.construir({});
+    ordem_fila.construir({});
+    ordem_historico.construir({});
+    fila.clear();
+}
+
+// Soma valor à contagem do dia; o dia está coberto pela árvore (ver cobrir)
+void IndiceNascimento::somar(Arvore& arvore, long long dia, std::uint32_t valor)
+{
+    for (std::size_t p = static_cast<std::size_t>(dia - base) + 1; p < arvore.size(); p += p & (~p + 1)) {
+        arvore[p] += valor;
+    }
+}
+
+void IndiceNascimento::subtrair(Arvore& arvore, long long dia)
+{
+    somar(arvore, dia, ~std::uint32_t(0)); // Soma -1 em aritmética modular
+}
+
+// Quantidade de nascimentos até o dia, inclusive
+std::uint32_t IndiceNascimento::ate(const Arvore& arvore, long long dia) const
+{
+    if (arvore.empty() || dia < base) {
+        return 0;
+    }
+    std::uint32_t total = 0;
+    const long long dias = static_cast<long long>(arvore.size()) - 1;
+    std::size_t p = static_cast<std::size_t>(dia >= base + dias ? dias : dia - base + 1);
+    for (; p > 0; p -= p & (~p + 1)) {
+        total += arvore[p];
+    }
+    return total;
+}
+
+/**
+ * @brief Garante que as árvores cobrem o dia, dobrando o intervalo de dias se preciso.
+ * Crescer custa O(n + D), mas acontece só quando aparece um nascimento fora do intervalo.
+ */
+void IndiceNascimento::cobrir(long long dia)
+{
+    long long dias = static_cast<long long>(arvore_todos.size()) - 1;
+    if (dias > 0 && dia >= base && dia - base < dias) {
+        return;
+    }
+    if (dias <= 0) {
+        dimensionar(dia - MARGEM, dia + MARGEM);
+        arvore_fila.assign(arvore_todos.size(), 0);
+        return;
+    }
+    long long inicio = std::min(base, dia - MARGEM);
+    long long fim = std::max(base + dias, dia + MARGEM + 1);
+    long long novos_dias = std::max(2 * dias, fim - inicio);
+    long long novo_inicio = inicio - (novos_dias - (fim - inicio)) / 2;
+    dimensionar(novo_inicio, novo_inicio + novos_dias);
+    reconstruir_arvores();
+}
+
+/**
+ * @brief Dimensiona arvore_todos, zerada, para os dias de inicio a fim (exclusivo), cortados às datas
+ * indexadas: as árvores nunca passam de cerca de 3,65 milhões de dias, quaisquer que sejam as datas.
+ */
+void IndiceNascimento::dimensionar(long long inicio, long long fim)
+{
+    inicio = std::max(inicio, PRIMEIRO_DIA);
+    fim = std::min(fim, ULTIMO_DIA + 1);
+    base = inicio;
+    arvore_todos.assign(static_cast<std::size_t>(fim - inicio) + 1, 0);
+}
+
+// Recalcula as árvores, já dimensionadas em arvore_todos, a partir dos índices ordenados, em O(n + D)
+void IndiceNascimento::reconstruir_arvores()
+{
+    arvore_todos.assign(arvore_todos.size(), 0);
+    arvore_fila.assign(arvore_todos.size(), 0);
+    ordem_todos.percorrer([&](const IndiceOrdenado<std::int32_t>::Entrada& entrada) {
+        arvore_todos[static_cast<std::size_t>(entrada.chave - base) + 1]++;
+    });
+    ordem_fila.percorrer([&](const IndiceOrdenado<std::int32_t>::Entrada& entrada) {
+        arvore_fila[static_cast<std::size_t>(entrada.chave - base) + 1]++;
+    });
+    // Cada posição acumula as contagens das posições que ela cobre
+    for (Arvore* arvore : {&arvore_todos, &arvore_fila}) {
+        for (std::size_t p = 1; p < arvore->size(); ++p) {
+            std::size_t pai = p + (p & (~p + 1));
+            if (pai < arvore->size()) {
+                (*arvore)[pai] += (*arvore)[p];
+            }
+        }
+    }
+}
+
+std::size_t IndiceNascimento::contar(long long primeiro, long long ultimo, Escopo escopo) const
+{
+    if (primeiro > ultimo) {
+        return 0;
+    }
+    auto na_faixa = [&](const Arvore& arvore) {
+        return static_cast<std::size_t>(ate(arvore, ultimo) - (primeiro > base ? ate(arvore, primeiro - 1) : 0));
+    };
+    switch (escopo) {
+    case IndiceSintomas::FILA:
+        return na_faixa(arvore_fila);
+    case IndiceSintomas::HISTORICO:
+        return na_faixa(arvore_todos) - na_faixa(arvore_fila);
+    default:
+        return na_faixa(arvore_todos);
+    }
+}
+
+std::vector<int> IndiceNascimento::buscar(long long primeiro, long long ultimo, Escopo escopo,
+                                          std::size_t limite) const
+{
+    std::vector<int> ids;
+    if (primeiro > ultimo || limite == 0 || ultimo < INT32_MIN || primeiro > INT32_MAX) {
+        return ids;
+    }
+    const std::int32_t fim = chave_do_dia(ultimo);
+    const IndiceOrdenado<std::int32_t>& ordem = escopo == IndiceSintomas::FILA        ? ordem_fila
+                                                : escopo == IndiceSintomas::HISTORICO ? ordem_historico
+                                                                                      : ordem_todos;
+    ordem.percorrer_a_partir(chave_do_dia(primeiro), [&](const IndiceOrdenado<std::int32_t>::Entrada& entrada) {
+        if (entrada.chave > fim) {
+            return false;
+        }
+        ids.push_back(entrada.handle);
+        return ids.size() < limite;
+    });
+    return ids;
+}
+
+std::size_t IndiceNascimento::contar_idade(int idade_minima, int idade_maxima, long long hoje, Escopo escopo) const
+{
+    long long primeiro, ultimo;
+    faixa_de_nascimento(idade_minima, idade_maxima, hoje, primeiro, ultimo);
+    return contar(primeiro, ultimo, escopo);
+}
+
+std::vector<int> IndiceNascimento::buscar_idade(int idade_minima, int idade_maxima, long long hoje, Escopo escopo,
+                                                std::size_t limite) const
+{
+    long long primeiro, ultimo;
+    faixa_de_nascimento(idade_minima, idade_maxima, hoje, primeiro, ultimo);
+    return buscar(primeiro, ultimo, escopo, limite);
+}
@@ -0,0 +1,112 @@
+#ifndef INDICENASCIMENTO_H
+#define INDICENASCIMENTO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "indicesintomas.h"
+#include "indiceordenado.h"
+
+/**
+ * @brief Índice das datas de nascimento, para contar e listar faixas de idade sem percorrer os pacientes.
+ *
+ * As contagens vêm de duas árvores de Fenwick indexadas pelo dia de
+ * nascimento, uma com todos os pacientes admitidos e outra com os da fila, e
+ * custam O(log D), onde D é a quantidade de dias entre o nascimento mais
+ * antigo e o mais recente. As listagens vêm de índices ordenados pelo dia
+ * (ver IndiceOrdenado), um com todos os pacientes, um com os da fila e um com
+ * os do histórico, e custam O(log n + k) para k pacientes encontrados. As idades não são
+ * guardadas: a faixa de idade é convertida em uma faixa de datas na data de
+ * referência (ver faixa_de_nascimento), de modo que o resultado nunca fica
+ * desatualizado por causa de aniversários.
+ *
+ * Os pacientes são identificados pelo ID, atribuído em ordem, como no
+ * armazenamento (ver ArmazemPacientes). As datas são dias julianos; uma data
+ * fora dos anos 1 a 9999 é indexada como o limite mais próximo, de modo que
+ * D nunca passa de cerca de 3,65 milhões de dias, qualquer que seja a entrada.
+ */
+class IndiceNascimento
+{
+public:
+    using Escopo = IndiceSintomas::Escopo;
+
+    /**
+     * @brief Acrescenta o próximo paciente.
+     * @param id ID do paciente, igual a tamanho().
+     * @param nascimento Data de nascimento (dia juliano).
+     * @param na_fila O paciente entra na fila.
+     */
+    void adicionar(int id, long long nascimento, bool na_fila = true);
+
+    /**
+     * @brief Troca a data de nascimento de um paciente.
+     * @param anterior Data de nascimento indexada até agora.
+     */
+    void atualizar(int id, long long anterior, long long nascimento);
+
+    /**
+     * @brief Marca que o paciente saiu da fila (ou voltou a ela).
+     * @param nascimento Data de nascimento indexada do paciente.
+     */
+    void marcar_fila(int id, long long nascimento, bool na_fila);
+
+    /**
+     * @brief Substitui o conteúdo do índice, ordenando por contagem dos dias em O(n + D).
+     * @param nascimentos Data de nascimento de cada paciente, em ordem de ID.
+     * @param fila IDs dos pacientes na fila.
+     */
+    void construir(const std::vector<long long>& nascimentos, const std::vector<int>& fila);
+
+    void limpar();
+
+    /**
+     * @brief Quantidade de pacientes do escopo nascidos entre primeiro e ultimo (dias julianos, inclusive).
+     */
+    std::size_t contar(long long primeiro, long long ultimo, Escopo escopo) const;
+
+    /**
+     * @brief IDs dos pacientes do escopo nascidos entre primeiro e ultimo, do nascimento mais antigo
+     * ao mais recente; os nascidos no mesmo dia ficam em ordem de ID (de chegada).
+     * @param limite Quantidade máxima de IDs.
+     */
+    std::vector<int> buscar(long long primeiro, long long ultimo, Escopo escopo,
+                            std::size_t limite = std::numeric_limits<std::size_t>::max()) const;
+
+    /**
+     * @brief Quantidade de pacientes do escopo com idade entre idade_minima e idade_maxima anos na data hoje.
+     */
+    std::size_t contar_idade(int idade_minima, int idade_maxima, long long hoje, Escopo escopo) const;
+
+    /**
+     * @brief IDs dos pacientes do escopo com idade entre idade_minima e idade_maxima anos na data hoje,
+     * do mais velho para o mais novo (ver buscar).
+     */
+    std::vector<int> buscar_idade(int idade_minima, int idade_maxima, long long hoje, Escopo escopo,
+                                  std::size_t limite = std::numeric_limits<std::size_t>::max()) const;
+
+    std::size_t tamanho() const { return quantidade; }
+
+private:
+    using Arvore = std::vector<std::uint32_t>;
+
+    void somar(Arvore& arvore, long long dia, std::uint32_t valor);
+    void subtrair(Arvore& arvore, long long dia);
+    std::uint32_t ate(const Arvore& arvore, long long dia) const;
+    void cobrir(long long dia);
+    void dimensionar(long long inicio, long long fim);
+    void reconstruir_arvores();
+    bool esta_na_fila(int id) const { return (fila[static_cast<std::size_t>(id) / 64] >> (id % 64)) & 1; }
+
+    std::size_t quantidade = 0;                     // Pacientes indexados
+    long long base = 0;                             // Dia correspondente à posição 1 das árvores
+    Arvore arvore_todos;                            // Fenwick dos nascimentos de todos os pacientes (posição 0 sem uso)
+    Arvore arvore_fila;                             // Fenwick dos nascimentos dos pacientes na fila
+    IndiceOrdenado<std::int32_t> ordem_todos;       // Todos os pacientes por dia de nascimento
+    IndiceOrdenado<std::int32_t> ordem_fila;        // Pacientes na fila por dia de nascimento
+    IndiceOrdenado<std::int32_t> ordem_historico;   // Pacientes fora da fila por dia de nascimento
+    std::vector<std::uint64_t> fila;                // Mapa dos pacientes na fila, 64 IDs por palavra
+};
+
+#endif // INDICENASCIMENTO_H
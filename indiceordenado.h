@@ -0,0 +1,205 @@
+#ifndef INDICEORDENADO_H
+#define INDICEORDENADO_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+/**
+ * @brief Índice ordenado de chaves com handles de pacientes.
+ *
+ * As entradas (chave, handle) ficam ordenadas em blocos de vetores contíguos
+ * de até TAMANHO_BLOCO elementos, formando uma árvore B de dois níveis: o
+ * bloco é localizado por busca binária sobre a última chave de cada bloco e a
+ * entrada por busca binária dentro do bloco. Inserções e remoções deslocam
+ * apenas os elementos de um bloco, sem copiar o índice inteiro. Chaves
+ * repetidas são permitidas e ficam ordenadas por handle.
+ *
+ * @tparam Chave Tipo da chave; precisa do operador <.
+ */
+template <typename Chave>
+class IndiceOrdenado
+{
+public:
+    struct Entrada {
+        Chave chave; // Chave de ordenação
+        int handle;  // Handle do paciente
+    };
+
+    /**
+     * @brief Insere uma entrada no índice.
+     * @param chave Chave da entrada.
+     * @param handle Handle do paciente.
+     */
+    void inserir(const Chave& chave, int handle)
+    {
+        Entrada entrada{chave, handle};
+        quantidade++;
+        if (blocos.empty()) {
+            blocos.push_back(std::vector<Entrada>{entrada});
+            return;
+        }
+
+        std::size_t b = bloco_de(entrada);
+        std::vector<Entrada>& bloco = blocos[b];
+        bloco.insert(std::upper_bound(bloco.begin(), bloco.end(), entrada, menor), entrada);
+
+        // Divide o bloco ao meio quando ele fica cheio
+        if (bloco.size() >= TAMANHO_BLOCO) {
+            std::vector<Entrada> metade(std::make_move_iterator(bloco.begin() + bloco.size() / 2),
+                                        std::make_move_iterator(bloco.end()));
+            bloco.resize(bloco.size() / 2);
+            blocos.insert(blocos.begin() + b + 1, std::move(metade));
+        }
+    }
+
+    /**
+     * @brief Substitui o conteúdo do índice pelas entradas informadas.
+     * Ordena as entradas uma única vez, se ainda não estiverem ordenadas, e
+     * as divide em blocos pela metade cheios, mais rápido que inseri-las uma a uma.
+     * @param entradas Entradas em qualquer ordem.
+     */
+    void construir(std::vector<Entrada> entradas)
+    {
+        if (!std::is_sorted(entradas.begin(), entradas.end(), menor)) {
+            std::sort(entradas.begin(), entradas.end(), menor);
+        }
+        blocos.clear();
+        quantidade = entradas.size();
+        for (std::size_t i = 0; i < entradas.size(); i += TAMANHO_BLOCO / 2) {
+            std::size_t fim = std::min(i + TAMANHO_BLOCO / 2, entradas.size());
+            blocos.emplace_back(std::make_move_iterator(entradas.begin() + i),
+                                std::make_move_iterator(entradas.begin() + fim));
+        }
+    }
+
+    /**
+     * @brief Remove uma entrada do índice.
+     * @param chave Chave da entrada.
+     * @param handle Handle do paciente.
+     * @return true se a entrada estava no índice.
+     */
+    bool remover(const Chave& chave, int handle)
+    {
+        if (blocos.empty()) {
+            return false;
+        }
+        Entrada entrada{chave, handle};
+        std::size_t b = bloco_de(entrada);
+        std::vector<Entrada>& bloco = blocos[b];
+        auto it = std::lower_bound(bloco.begin(), bloco.end(), entrada, menor);
+        if (it == bloco.end() || menor(entrada, *it)) {
+            return false;
+        }
+        bloco.erase(it);
+        quantidade--;
+
+        // Blocos vazios são descartados
+        if (bloco.empty()) {
+            blocos.erase(blocos.begin() + b);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Busca todas as entradas com a chave informada.
+     * @param chave Chave procurada.
+     * @return Handles das entradas encontradas (vazio se nenhuma).
+     */
+    std::vector<int> buscar(const Chave& chave) const
+    {
+        std::vector<int> handles;
+
+        // Primeiro bloco cuja última chave não é menor que a chave procurada
+        auto b = std::lower_bound(blocos.begin(), blocos.end(), chave,
+                                  [](const std::vector<Entrada>& bloco, const Chave& c) {
+                                      return bloco.back().chave < c;
+                                  });
+
+        // Percorre as entradas iguais, que podem continuar nos blocos seguintes
+        for (; b != blocos.end(); ++b) {
+            auto it = std::lower_bound(b->begin(), b->end(), chave,
+                                       [](const Entrada& e, const Chave& c) { return e.chave < c; });
+            for (; it != b->end(); ++it) {
+                if (chave < it->chave) {
+                    return handles;
+                }
+                handles.push_back(it->handle);
+            }
+        }
+        return handles;
+    }
+
+    /**
+     * @brief Chama f(entrada) para cada entrada, em ordem.
+     */
+    template <typename F>
+    void percorrer(F f) const
+    {
+        for (const std::vector<Entrada>& bloco : blocos) {
+            for (const Entrada& entrada : bloco) {
+                f(entrada);
+            }
+        }
+    }
+
+    /**
+     * @brief Chama f(entrada), em ordem, para as entradas a partir da primeira com chave não menor que a informada.
+     * Para quando f retorna false; serve para percorrer uma faixa de chaves sem percorrer o índice inteiro.
+     */
+    template <typename F>
+    void percorrer_a_partir(const Chave& chave, F f) const
+    {
+        auto b = std::lower_bound(blocos.begin(), blocos.end(), chave,
+                                  [](const std::vector<Entrada>& bloco, const Chave& c) {
+                                      return bloco.back().chave < c;
+                                  });
+        if (b == blocos.end()) {
+            return;
+        }
+        auto it = std::lower_bound(b->begin(), b->end(), chave,
+                                   [](const Entrada& e, const Chave& c) { return e.chave < c; });
+        for (;;) {
+            for (; it != b->end(); ++it) {
+                if (!f(*it)) {
+                    return;
+                }
+            }
+            if (++b == blocos.end()) {
+                return;
+            }
+            it = b->begin();
+        }
+    }
+
+    std::size_t tamanho() const { return quantidade; }
+
+private:
+    static const std::size_t TAMANHO_BLOCO = 512; // Quantidade de entradas que provoca a divisão de um bloco
+
+    static bool menor(const Entrada& a, const Entrada& b)
+    {
+        if (a.chave < b.chave) return true;
+        if (b.chave < a.chave) return false;
+        return a.handle < b.handle;
+    }
+
+    // Índice do bloco onde a entrada está ou deveria ser inserida
+    std::size_t bloco_de(const Entrada& entrada) const
+    {
+        auto b = std::lower_bound(blocos.begin(), blocos.end(), entrada,
+                                  [](const std::vector<Entrada>& bloco, const Entrada& e) {
+                                      return menor(bloco.back(), e);
+                                  });
+        if (b == blocos.end()) {
+            return blocos.size() - 1; // Maior que todas as entradas: vai para o último bloco
+        }
+        return static_cast<std::size_t>(b - blocos.begin());
+    }
+
+    std::vector<std::vector<Entrada>> blocos; // Blocos ordenados e não vazios
+    std::size_t quantidade = 0;               // Quantidade total de entradas
+};
+
+#endif // INDICEORDENADO_H
@@ -0,0 +1,260 @@
+#include "indicesintomas.h"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SINTOMAS_AVX2
+#endif
+
+// Bits ligados em uma palavra; sem a instrução POPCNT, por somas paralelas, que o compilador vetoriza
+static inline std::uint64_t bits_ligados(std::uint64_t x)
+{
+#if defined(__POPCNT__)
+    return static_cast<std::uint64_t>(__builtin_popcountll(x));
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (x * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+// Posição do bit menos significativo de uma palavra diferente de zero
+static inline int menor_bit(std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int bit = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Palavras combinadas de cada vez: os mapas intermediários de um bloco cabem no cache L1
+static const std::size_t BLOCO = 256;
+
+/**
+ * @brief Conta os bits ligados em n palavras.
+ * Com AVX2, conta 256 bits por iteração: cada nibble consulta a tabela de 16
+ * contagens com uma permutação de bytes e as somas por byte são acumuladas em 64 bits.
+ */
+static std::uint64_t contar_bits(const std::uint64_t* a, std::size_t n)
+{
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+#ifdef SINTOMAS_AVX2
+    const __m256i tabela = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i soma = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i baixo = _mm256_shuffle_epi8(tabela, _mm256_and_si256(v, nibble));
+        __m256i alto = _mm256_shuffle_epi8(tabela, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        soma = _mm256_add_epi64(soma, _mm256_sad_epu8(_mm256_add_epi8(baixo, alto), _mm256_setzero_si256()));
+    }
+    alignas(32) std::uint64_t parciais[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(parciais), soma);
+    total = parciais[0] + parciais[1] + parciais[2] + parciais[3];
+#endif
+    for (; i < n; ++i) {
+        total += bits_ligados(a[i]);
+    }
+    return total;
+}
+
+void IndiceSintomas::adicionar(int id, unsigned sintomas, bool na_fila)
+{
+    std::size_t palavra = static_cast<std::size_t>(id) / 64;
+    if (palavra == fila.size()) {
+        fila.push_back(0);
+        for (std::vector<std::uint64_t>& mapa : por_sintoma) {
+            mapa.push_back(0);
+        }
+    }
+    quantidade = static_cast<std::size_t>(id) + 1;
+    sintomas &= 0xFF;
+    gravar_sintomas(id, sintomas);
+    combinacoes_todos[sintomas]++;
+    marcar_fila(id, na_fila);
+}
+
+void IndiceSintomas::atualizar(int id, unsigned sintomas)
+{
+    sintomas &= 0xFF;
+    unsigned anterior = sintomas_de(id);
+    if (anterior == sintomas) {
+        return;
+    }
+    combinacoes_todos[anterior]--;
+    combinacoes_todos[sintomas]++;
+    if ((fila[static_cast<std::size_t>(id) / 64] >> (id % 64)) & 1) {
+        combinacoes_fila[anterior]--;
+        combinacoes_fila[sintomas]++;
+    }
+    gravar_sintomas(id, sintomas);
+}
+
+void IndiceSintomas::marcar_fila(int id, bool na_fila)
+{
+    std::uint64_t& palavra = fila[static_cast<std::size_t>(id) / 64];
+    std::uint64_t bit = std::uint64_t(1) << (id % 64);
+    if (((palavra & bit) != 0) == na_fila) {
+        return;
+    }
+    if (na_fila) {
+        palavra |= bit;
+        combinacoes_fila[sintomas_de(id)]++;
+    } else {
+        palavra &= ~bit;
+        combinacoes_fila[sintomas_de(id)]--;
+    }
+}
+
+// Sintomas do paciente, lidos dos mapas
+unsigned IndiceSintomas::sintomas_de(int id) const
+{
+    std::size_t palavra = static_cast<std::size_t>(id) / 64;
+    unsigned sintomas = 0;
+    for (int s = 0; s < QUANTIDADE_SINTOMAS; ++s) {
+        sintomas |= static_cast<unsigned>((por_sintoma[s][palavra] >> (id % 64)) & 1) << s;
+    }
+    return sintomas;
+}
+
+void IndiceSintomas::gravar_sintomas(int id, unsigned sintomas)
+{
+    std::size_t palavra = static_cast<std::size_t>(id) / 64;
+    std::uint64_t bit = std::uint64_t(1) << (id % 64);
+    for (int s = 0; s < QUANTIDADE_SINTOMAS; ++s) {
+        if (sintomas & (1u << s)) {
+            por_sintoma[s][palavra] |= bit;
+        } else {
+            por_sintoma[s][palavra] &= ~bit;
+        }
+    }
+}
+
+void IndiceSintomas::reservar(std::size_t total)
+{
+    fila.reserve((total + 63) / 64);
+    for (std::vector<std::uint64_t>& mapa : por_sintoma) {
+        mapa.reserve((total + 63) / 64);
+    }
+}
+
+void IndiceSintomas::limpar()
+{
+    quantidade = 0;
+    combinacoes_todos.fill(0);
+    combinacoes_fila.fill(0);
+    fila.clear();
+    for (std::vector<std::uint64_t>& mapa : por_sintoma) {
+        mapa.clear();
+    }
+}
+
+std::size_t IndiceSintomas::bytes() const
+{
+    return fila.capacity() * sizeof(std::uint64_t) * (1 + QUANTIDADE_SINTOMAS);
+}
+
+// Escreve em saida o mapa dos pacientes do escopo nas palavras [inicio, inicio + palavras)
+void IndiceSintomas::escopo(Escopo escopo, std::size_t inicio, std::size_t palavras, std::uint64_t* saida) const
+{
+    const std::uint64_t* na_fila = fila.data() + inicio;
+    for (std::size_t k = 0; k < palavras; ++k) {
+        saida[k] = escopo == FILA ? na_fila[k] : escopo == HISTORICO ? ~na_fila[k] : ~std::uint64_t(0);
+    }
+    // Os bits depois do último paciente ficam desligados
+    if (escopo != FILA && inicio + palavras == fila.size() && quantidade % 64 != 0) {
+        saida[palavras - 1] &= (std::uint64_t(1) << (quantidade % 64)) - 1;
+    }
+}
+
+// Escreve em saida o mapa dos pacientes que atendem à consulta, nas palavras [inicio, inicio + palavras)
+void IndiceSintomas::combinar(const Consulta& consulta, std::size_t inicio, std::size_t palavras,
+                              std::uint64_t* saida) const
+{
+    escopo(consulta.escopo, inicio, palavras, saida);
+    std::uint64_t qualquer[BLOCO];
+    if (consulta.algum != 0) {
+        std::fill(qualquer, qualquer + palavras, 0);
+    }
+    for (int s = 0; s < QUANTIDADE_SINTOMAS; ++s) {
+        const std::uint64_t* mapa = por_sintoma[s].data() + inicio;
+        if (consulta.todos & (1u << s)) {
+            for (std::size_t k = 0; k < palavras; ++k) {
+                saida[k] &= mapa[k];
+            }
+        }
+        if (consulta.algum & (1u << s)) {
+            for (std::size_t k = 0; k < palavras; ++k) {
+                qualquer[k] |= mapa[k];
+            }
+        }
+        if (consulta.nenhum & (1u << s)) {
+            for (std::size_t k = 0; k < palavras; ++k) {
+                saida[k] &= ~mapa[k];
+            }
+        }
+    }
+    if (consulta.algum != 0) {
+        for (std::size_t k = 0; k < palavras; ++k) {
+            saida[k] &= qualquer[k];
+        }
+    }
+}
+
+std::size_t IndiceSintomas::contar(const Consulta& consulta) const
+{
+    std::uint64_t resultado[BLOCO];
+    std::uint64_t total = 0;
+    for (std::size_t inicio = 0; inicio < fila.size(); inicio += BLOCO) {
+        std::size_t palavras = std::min(BLOCO, fila.size() - inicio);
+        combinar(consulta, inicio, palavras, resultado);
+        total += contar_bits(resultado, palavras);
+    }
+    return static_cast<std::size_t>(total);
+}
+
+std::vector<int> IndiceSintomas::buscar(const Consulta& consulta, std::size_t limite) const
+{
+    std::vector<int> ids;
+    std::uint64_t resultado[BLOCO];
+    for (std::size_t inicio = 0; inicio < fila.size() && ids.size() < limite; inicio += BLOCO) {
+        std::size_t palavras = std::min(BLOCO, fila.size() - inicio);
+        combinar(consulta, inicio, palavras, resultado);
+        for (std::size_t k = 0; k < palavras && ids.size() < limite; ++k) {
+            // Percorre só os bits ligados, do menor para o maior
+            for (std::uint64_t w = resultado[k]; w != 0 && ids.size() < limite; w &= w - 1) {
+                ids.push_back(static_cast<int>((inicio + k) * 64 + menor_bit(w)));
+            }
+        }
+    }
+    return ids;
+}
+
+IndiceSintomas::Matriz IndiceSintomas::coocorrencia(Escopo escopo) const
+{
+    Matriz matriz{};
+    for (unsigned combinacao = 1; combinacao < 256; ++combinacao) {
+        std::uint64_t pacientes = escopo == FILA     ? combinacoes_fila[combinacao]
+                                  : escopo == TODOS  ? combinacoes_todos[combinacao]
+                                                     : combinacoes_todos[combinacao] - combinacoes_fila[combinacao];
+        if (pacientes == 0) {
+            continue;
+        }
+        for (unsigned a = combinacao; a != 0; a &= a - 1) {
+            for (unsigned b = combinacao; b != 0; b &= b - 1) {
+                matriz[menor_bit(a)][menor_bit(b)] += pacientes;
+            }
+        }
+    }
+    return matriz;
+}
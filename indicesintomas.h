@@ -0,0 +1,117 @@
+#ifndef INDICESINTOMAS_H
+#define INDICESINTOMAS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Índice de sintomas em mapas de bits, para consultas e contagens sem percorrer os pacientes.
+ *
+ * Guarda um mapa de bits por sintoma (bit id ligado se o paciente id tem o
+ * sintoma) e um mapa dos pacientes que estão na fila, sobre todos os pacientes
+ * admitidos. Uma consulta combina os mapas palavra a palavra (E, OU e E-NÃO
+ * sobre 64 pacientes por vez) e conta os bits ligados do resultado, em blocos
+ * que cabem no cache L1; com o núcleo compilado com AVX2 (opção B1_AVX2), a
+ * contagem usa a contagem de bits vetorial por tabela de nibbles. Cada mapa
+ * ocupa um bit por paciente: 10 milhões de pacientes ocupam cerca de 11 MB e
+ * uma consulta sobre todos eles lê alguns megabytes.
+ *
+ * Além dos mapas, o índice mantém a quantidade de pacientes com cada uma das
+ * 256 combinações de sintomas, entre todos e entre os da fila, atualizada a
+ * cada mudança; a coocorrência é calculada dessas contagens, em tempo que não
+ * depende da quantidade de pacientes.
+ *
+ * Os pacientes são identificados pelo ID, atribuído em ordem, como no
+ * armazenamento (ver ArmazemPacientes).
+ */
+class IndiceSintomas
+{
+public:
+    static const int QUANTIDADE_SINTOMAS = 8;
+
+    // Pacientes considerados por uma consulta
+    enum Escopo {
+        FILA,      // Pacientes na fila, esperando ou em tratamento
+        HISTORICO, // Pacientes que já saíram da fila (tratados ou removidos)
+        TODOS      // Todos os pacientes admitidos
+    };
+
+    /**
+     * @brief Consulta booleana sobre os sintomas (flags de SINTOMAS).
+     * Seleciona os pacientes do escopo com todos os sintomas de todos, pelo
+     * menos um dos sintomas de algum (se algum não for 0) e nenhum dos sintomas
+     * de nenhum. "COVID e FEBRE, sem AVC" é {COVID | FEBRE, 0, AVC}.
+     */
+    struct Consulta {
+        unsigned todos = 0;
+        unsigned algum = 0;
+        unsigned nenhum = 0;
+        Escopo escopo = FILA;
+    };
+
+    // Coocorrência dos sintomas: [i][j] pacientes com os sintomas de bit i e j; [i][i] pacientes com o sintoma i
+    using Matriz = std::array<std::array<std::uint64_t, QUANTIDADE_SINTOMAS>, QUANTIDADE_SINTOMAS>;
+
+    /**
+     * @brief Acrescenta o próximo paciente.
+     * @param id ID do paciente, igual a tamanho().
+     * @param sintomas Sintomas do paciente.
+     * @param na_fila O paciente entra na fila.
+     */
+    void adicionar(int id, unsigned sintomas, bool na_fila = true);
+
+    /**
+     * @brief Troca os sintomas de um paciente.
+     */
+    void atualizar(int id, unsigned sintomas);
+
+    /**
+     * @brief Marca que o paciente saiu da fila (ou voltou a ela).
+     */
+    void marcar_fila(int id, bool na_fila);
+
+    void reservar(std::size_t total);
+    void limpar();
+
+    /**
+     * @brief Quantidade de pacientes que atendem à consulta.
+     */
+    std::size_t contar(const Consulta& consulta) const;
+
+    /**
+     * @brief IDs dos pacientes que atendem à consulta, em ordem crescente (de chegada).
+     * @param limite Quantidade máxima de IDs.
+     */
+    std::vector<int> buscar(const Consulta& consulta,
+                            std::size_t limite = std::numeric_limits<std::size_t>::max()) const;
+
+    /**
+     * @brief Contagem de cada sintoma e de cada par de sintomas entre os pacientes do escopo.
+     * Calculada das contagens por combinação de sintomas, sem ler os mapas.
+     */
+    Matriz coocorrencia(Escopo escopo) const;
+
+    std::size_t tamanho() const { return quantidade; }
+
+    /**
+     * @brief Memória ocupada pelos mapas de bits.
+     */
+    std::size_t bytes() const;
+
+private:
+    void combinar(const Consulta& consulta, std::size_t inicio, std::size_t palavras, std::uint64_t* saida) const;
+    void escopo(Escopo escopo, std::size_t inicio, std::size_t palavras, std::uint64_t* saida) const;
+    unsigned sintomas_de(int id) const;
+    void gravar_sintomas(int id, unsigned sintomas);
+
+    std::size_t quantidade = 0;                                  // Pacientes indexados
+    std::array<std::vector<std::uint64_t>, QUANTIDADE_SINTOMAS> por_sintoma; // Mapa de cada sintoma, 64 IDs por palavra
+    std::vector<std::uint64_t> fila;                             // Mapa dos pacientes na fila
+    std::array<std::uint64_t, 256> combinacoes_todos{};          // Pacientes com cada combinação de sintomas
+    std::array<std::uint64_t, 256> combinacoes_fila{};           // Pacientes da fila com cada combinação
+};
+
+#endif // INDICESINTOMAS_H
@@ -0,0 +1,357 @@
+// Gerador de carga sintética e repetição de rastros de operações da triagem.
+//
+// Gera pacientes válidos (CPFs com dígitos verificadores, nomes sorteados com
+// a frequência dos nomes reais e sintomas por gravidade) e as operações que a
+// interface faz com eles (admitir, atualizar, remover e consultar), chegando
+// com a taxa e as rajadas informadas (ver carga.h). O rastro gerado pode ser
+// gravado e repetido depois, sempre com as mesmas operações na mesma ordem.
+//
+// As operações são aplicadas a uma triagem no próprio processo, pelas mesmas
+// funções que a interface chama (--alvo local), ou ao serviço b1d pelo socket,
+// com até --janela pedidos em trânsito (--alvo servico). Sem --velocidade as
+// operações são feitas o mais rápido possível; com ela, no instante do rastro
+// dividido pela velocidade, e a latência passa a contar do instante agendado,
+// de modo que a espera por operações atrasadas entra nos percentis. Com
+// --avancar, a triagem local avança um passo (um segundo na interface) a cada
+// P operações. No fim são informados, por tipo de operação, a quantidade, as
+// respostas e os percentis da latência em microssegundos.
+//
+// Uso: b1_loadgen [--operacoes N] [--taxa X] [--rajadas X] [--tamanho-rajada N]
+//                 [--mistura admitir,atualizar,remover,consultar] [--ausentes F] [--semente S]
+//                 [--gravar arquivo] [--repetir arquivo] [--alvo local|servico|nenhum]
+//                 [--socket caminho] [--janela N] [--velocidade X] [--avancar P]
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "carga.h"
+#include "cliente.h"
+#include "cpf.h"
+#include "data.h"
+#include "formatador.h"
+#include "histograma.h"
+#include "protocolo.h"
+#include "triagem.h"
+
+namespace {
+
+using Relogio = std::chrono::steady_clock;
+
+// Linhas do relatório: as quatro operações do rastro e os passos da triagem local
+enum Linha { ADMITIR, ATUALIZAR, REMOVER, CONSULTAR, AVANCAR, LINHAS };
+
+const char* const NOMES_LINHAS[LINHAS] = {"admitir", "atualizar", "remover", "consultar", "avancar"};
+
+struct Medicao {
+    Histograma latencia;            // Nanossegundos
+    std::size_t ok = 0;
+    std::size_t nao_encontrado = 0;
+    std::size_t falhas = 0;         // Outros status
+};
+
+using Medicoes = std::array<Medicao, LINHAS>;
+
+Linha linha_da_operacao(std::uint8_t operacao)
+{
+    return static_cast<Linha>(operacao - Protocolo::ADMITIR);
+}
+
+void contar(Medicao& medicao, Protocolo::Status status)
+{
+    if (status == Protocolo::OK) {
+        medicao.ok++;
+    } else if (status == Protocolo::NAO_ENCONTRADO) {
+        medicao.nao_encontrado++;
+    } else {
+        medicao.falhas++;
+    }
+}
+
+// Ritmo da repetição: o instante agendado de cada operação, ou o início dela se não há ritmo
+class Ritmo
+{
+public:
+    Ritmo(double velocidade, Relogio::time_point inicio) : velocidade(velocidade), inicio(inicio) {}
+
+    bool ativo() const { return velocidade > 0; }
+
+    Relogio::time_point agendado(const OperacaoCarga& operacao) const
+    {
+        return inicio + std::chrono::nanoseconds(static_cast<std::int64_t>(operacao.instante / velocidade));
+    }
+
+    // Espera até o instante agendado (sem dormir: os intervalos são de microssegundos)
+    void esperar(const OperacaoCarga& operacao) const
+    {
+        if (!ativo()) {
+            return;
+        }
+        Relogio::time_point alvo = agendado(operacao);
+        while (Relogio::now() < alvo) {
+        }
+    }
+
+private:
+    double velocidade;
+    Relogio::time_point inicio;
+};
+
+/**
+ * @brief Aplica o rastro a uma triagem no próprio processo, pelas funções chamadas pela interface.
+ * Os textos de cada operação são preparados antes de medir, em buffers reaproveitados.
+ */
+void repetir_local(const RastroCarga& rastro, const Ritmo& ritmo, std::size_t passos_avancar, Medicoes& medicoes)
+{
+    Triagem triagem;
+    Formatador formatador(Formatador::TEXTO, dia_juliano_hoje());
+    std::string nome, email, cpf(TAMANHO_CPF_FORMATADO, ' ');
+
+    for (std::size_t i = 0; i < rastro.operacoes.size(); ++i) {
+        const OperacaoCarga& operacao = rastro.operacoes[i];
+        const PacienteCarga& paciente = rastro.pacientes[operacao.paciente];
+        escrever_cpf(paciente.cpf, &cpf[0]);
+        if (operacao.operacao == Protocolo::ADMITIR || operacao.operacao == Protocolo::ATUALIZAR) {
+            nome.assign(rastro.textos.texto(paciente.nome));
+            email.assign(rastro.textos.texto(paciente.email));
+        }
+        ritmo.esperar(operacao);
+
+        Relogio::time_point comeco = Relogio::now();
+        Protocolo::Status status = Protocolo::OK;
+        switch (operacao.operacao) {
+        case Protocolo::ADMITIR:
+            triagem.admitir(nome, cpf, email, paciente.nascimento, operacao.sintomas);
+            break;
+        case Protocolo::ATUALIZAR:
+            if (triagem.buscar_cpf(cpf) == -1) {
+                status = Protocolo::NAO_ENCONTRADO;
+            } else {
+                triagem.admitir(nome, cpf, email, paciente.nascimento, operacao.sintomas);
+            }
+            break;
+        case Protocolo::REMOVER:
+            status = triagem.remover(cpf) ? Protocolo::OK : Protocolo::NAO_ENCONTRADO;
+            break;
+        default: {
+            // Como a consulta da interface: busca pelo CPF e formata o paciente encontrado
+            int id = triagem.buscar_cpf(cpf);
+            if (id == -1) {
+                status = Protocolo::NAO_ENCONTRADO;
+            } else {
+                formatador.limpar();
+                formatador.escrever(triagem.pacientes(), id);
+            }
+            break;
+        }
+        }
+        Relogio::time_point fim = Relogio::now();
+
+        Medicao& medicao = medicoes[linha_da_operacao(operacao.operacao)];
+        medicao.latencia.registrar((fim - (ritmo.ativo() ? ritmo.agendado(operacao) : comeco)).count());
+        contar(medicao, status);
+
+        if (passos_avancar > 0 && (i + 1) % passos_avancar == 0) {
+            comeco = Relogio::now();
+            triagem.avancar();
+            medicoes[AVANCAR].latencia.registrar((Relogio::now() - comeco).count());
+            medicoes[AVANCAR].ok++;
+        }
+    }
+}
+
+/**
+ * @brief Envia o rastro ao serviço, com até janela pedidos em trânsito.
+ * Os pedidos prontos são enviados juntos em uma só escrita, como em b1_cliente bench.
+ * @return false se a conexão foi perdida.
+ */
+bool repetir_servico(const RastroCarga& rastro, const Ritmo& ritmo, Cliente& cliente, std::size_t janela,
+                     Medicoes& medicoes)
+{
+    const std::size_t n = rastro.operacoes.size();
+    std::vector<Relogio::time_point> envio(janela); // Início de cada pedido em trânsito, por posição na janela
+    Cliente::Resposta resposta;
+    char cpf[TAMANHO_CPF_FORMATADO];
+    std::size_t enviados = 0, recebidos = 0;
+
+    while (recebidos < n) {
+        Relogio::time_point agora = Relogio::now();
+        while (enviados < n && enviados - recebidos < janela &&
+               (!ritmo.ativo() || ritmo.agendado(rastro.operacoes[enviados]) <= agora)) {
+            const OperacaoCarga& operacao = rastro.operacoes[enviados];
+            const PacienteCarga& paciente = rastro.pacientes[operacao.paciente];
+            escrever_cpf(paciente.cpf, cpf);
+            std::string_view texto_cpf(cpf, sizeof(cpf));
+            switch (operacao.operacao) {
+            case Protocolo::ADMITIR:
+            case Protocolo::ATUALIZAR:
+                cliente.pedir_admissao(rastro.textos.texto(paciente.nome), texto_cpf,
+                                       rastro.textos.texto(paciente.email), paciente.nascimento, operacao.sintomas,
+                                       operacao.operacao == Protocolo::ATUALIZAR);
+                break;
+            case Protocolo::REMOVER:
+                cliente.pedir_remocao(texto_cpf);
+                break;
+            default:
+                cliente.pedir_consulta(texto_cpf);
+                break;
+            }
+            envio[enviados % janela] = ritmo.ativo() ? ritmo.agendado(operacao) : agora;
+            enviados++;
+        }
+        if (enviados == recebidos) {
+            ritmo.esperar(rastro.operacoes[enviados]); // Nada em trânsito: aguarda a próxima operação
+            continue;
+        }
+        if (!cliente.descarregar() || !cliente.receber(resposta)) {
+            return false;
+        }
+        Medicao& medicao = medicoes[linha_da_operacao(rastro.operacoes[recebidos].operacao)];
+        medicao.latencia.registrar((Relogio::now() - envio[recebidos % janela]).count());
+        contar(medicao, resposta.status);
+        recebidos++;
+    }
+    return true;
+}
+
+void imprimir(const Medicoes& medicoes, double segundos)
+{
+    std::printf("%-10s %10s %10s %10s %7s %9s %9s %9s %9s %9s\n", "operacao", "quantidade", "ok", "ausentes",
+                "falhas", "p50_us", "p90_us", "p99_us", "p999_us", "max_us");
+    std::uint64_t total = 0;
+    for (int l = 0; l < LINHAS; ++l) {
+        const Medicao& m = medicoes[l];
+        if (m.latencia.quantidade() == 0) {
+            continue;
+        }
+        total += m.latencia.quantidade();
+        std::printf("%-10s %10llu %10zu %10zu %7zu %9.2f %9.2f %9.2f %9.2f %9.2f\n", NOMES_LINHAS[l],
+                    static_cast<unsigned long long>(m.latencia.quantidade()), m.ok, m.nao_encontrado, m.falhas,
+                    m.latencia.percentil(50) / 1e3, m.latencia.percentil(90) / 1e3, m.latencia.percentil(99) / 1e3,
+                    m.latencia.percentil(99.9) / 1e3, m.latencia.maximo() / 1e3);
+    }
+    std::printf("%llu operações em %.3f s (%.0f operações/s)\n", static_cast<unsigned long long>(total), segundos,
+                segundos > 0 ? total / segundos : 0.0);
+}
+
+// Lê os pesos separados por vírgula
+bool ler_mistura(const char* texto, std::array<double, 4>& mistura)
+{
+    const char* p = texto;
+    for (std::size_t i = 0; i < mistura.size(); ++i) {
+        char* fim;
+        mistura[i] = std::strtod(p, &fim);
+        if (fim == p || mistura[i] < 0 || *fim != (i + 1 < mistura.size() ? ',' : '\0')) {
+            return false;
+        }
+        p = fim + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t quantidade = 1000000;   // Operações geradas
+    ModeloCarga modelo;
+    modelo.hoje = dia_juliano_hoje();
+    std::uint64_t semente = 42;
+    const char* gravar = nullptr;       // Arquivo onde gravar o rastro gerado
+    const char* repetir = nullptr;      // Rastro gravado (substitui o gerado)
+    std::string alvo = "local";
+    std::string caminho = Protocolo::caminho_padrao();
+    std::size_t janela = 64;
+    double velocidade = 0;              // 0: o mais rápido possível
+    std::size_t passos_avancar = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--operacoes") == 0 && i + 1 < argc) {
+            quantidade = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--taxa") == 0 && i + 1 < argc) {
+            modelo.taxa = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--rajadas") == 0 && i + 1 < argc) {
+            modelo.rajadas = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--tamanho-rajada") == 0 && i + 1 < argc) {
+            modelo.tamanho_rajada = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--mistura") == 0 && i + 1 < argc) {
+            if (!ler_mistura(argv[++i], modelo.mistura)) {
+                std::fprintf(stderr, "mistura inválida: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--ausentes") == 0 && i + 1 < argc) {
+            modelo.ausentes = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--gravar") == 0 && i + 1 < argc) {
+            gravar = argv[++i];
+        } else if (std::strcmp(argv[i], "--repetir") == 0 && i + 1 < argc) {
+            repetir = argv[++i];
+        } else if (std::strcmp(argv[i], "--alvo") == 0 && i + 1 < argc) {
+            alvo = argv[++i];
+        } else if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            caminho = argv[++i];
+        } else if (std::strcmp(argv[i], "--janela") == 0 && i + 1 < argc) {
+            janela = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--velocidade") == 0 && i + 1 < argc) {
+            velocidade = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--avancar") == 0 && i + 1 < argc) {
+            passos_avancar = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr, "opção desconhecida: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (alvo != "local" && alvo != "servico" && alvo != "nenhum") {
+        std::fprintf(stderr, "alvo desconhecido: %s\n", alvo.c_str());
+        return 2;
+    }
+    if (janela == 0) {
+        janela = 1;
+    }
+
+    RastroCarga rastro;
+    Relogio::time_point inicio = Relogio::now();
+    if (repetir != nullptr) {
+        if (const char* erro = ler_rastro(repetir, rastro)) {
+            std::fprintf(stderr, "%s: %s\n", repetir, erro);
+            return 1;
+        }
+    } else {
+        rastro = gerar_carga(modelo, quantidade, semente);
+    }
+    std::printf("%zu operações sobre %zu pacientes %s em %.3f s\n", rastro.operacoes.size(), rastro.pacientes.size(),
+                repetir != nullptr ? "lidas" : "geradas",
+                std::chrono::duration<double>(Relogio::now() - inicio).count());
+    if (gravar != nullptr) {
+        if (!gravar_rastro(gravar, rastro)) {
+            std::fprintf(stderr, "%s: falha ao gravar o rastro\n", gravar);
+            return 1;
+        }
+        std::printf("rastro gravado em %s\n", gravar);
+    }
+    if (alvo == "nenhum" || rastro.operacoes.empty()) {
+        return 0;
+    }
+
+    Medicoes medicoes;
+    Cliente cliente;
+    if (alvo == "servico" && !cliente.conectar(caminho)) {
+        std::fprintf(stderr, "não foi possível conectar a %s\n", caminho.c_str());
+        return 1;
+    }
+    inicio = Relogio::now();
+    Ritmo ritmo(velocidade, inicio);
+    if (alvo == "local") {
+        repetir_local(rastro, ritmo, passos_avancar, medicoes);
+    } else if (!repetir_servico(rastro, ritmo, cliente, janela, medicoes)) {
+        std::fprintf(stderr, "conexão perdida\n");
+        return 1;
+    }
+    imprimir(medicoes, std::chrono::duration<double>(Relogio::now() - inicio).count());
+    return 0;
+}
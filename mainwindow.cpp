@@ -3,246 +3,394 @@
 #include "./ui_mainwindow.h"
 #include <QTimer>
 #include <QDate>
+#include <algorithm>
+#include <chrono>
 #include <vector>
 #include <QMessageBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QVBoxLayout>
+#include <QFileDialog>
+#include <QStandardPaths>
+#include <QHeaderView>
+#include <QSignalBlocker>
+#include "triagem.h"
+#include "cpf.h"
+#include "data.h"
+#include "formatador.h"
+#include "importacao.h"
+#include "modelopacientes.h"
+
+// Quantidade máxima de resultados exibidos pela busca aproximada
+const std::size_t LIMITE_APROXIMADOS = 20;
+
+// Quantidade máxima de registros rejeitados listados depois de uma importação
+const std::size_t LIMITE_ERROS_IMPORTACAO = 100;
+
+// Estação de tratamento exibida na interface
+struct ConfiguracaoEstacao {
+    const char* nome;   // Nome exibido
+    unsigned afinidade; // Sintomas atendidos com preferência (ver Triagem::Estacao)
+};
 
-// Variável estática para gerar IDs únicos para cada paciente
-static int id_autoincremental = 0;
-
-// Enumeração para representar os diferentes sintomas usando flags binárias
-typedef enum{
-    TOSSE = 1,
-    NAUSEA = 2,
-    FEBRE = 4,
-    DISENTERIA = 8,
-    INFECCAO = 16,
-    COVID = 32,
-    AVC = 64,
-    ACIDENTE = 128
-} SINTOMAS;
-
-// Classe Patient para representar os pacientes
-class Patient
-{
-public:
-    /**
-     * @brief Construtor da classe Patient.
-     * @param name Nome do paciente.
-     * @param cpf CPF do paciente.
-     * @param email Email do paciente.
-     * @param bday Data de nascimento do paciente.
-     * @param sintomas Sintomas do paciente representados por flags binárias.
-     */
-    Patient(QString name, QString cpf, QString email, QDate bday, unsigned sintomas);
-
-    int id;             // Identificador único do paciente
-    QString name;       // Nome do paciente
-    QString cpf;        // CPF do paciente
-    QString email;      // Email do paciente
-    QDate bday;         // Data de nascimento do paciente
-    int idade;          // Idade do paciente
-    unsigned sintomas;  // Sintomas do paciente representados por flags binárias
+// Dois consultórios gerais e uma sala de trauma, que chama primeiro os casos de AVC e acidente
+const ConfiguracaoEstacao ESTACOES[] = {
+    {"Consultório 1", 0},
+    {"Consultório 2", 0},
+    {"Trauma", AVC | ACIDENTE},
 };
 
-// Implementação do construtor da classe Patient
-Patient::Patient(QString name, QString cpf, QString email, QDate bday, unsigned sintomas ){
-    QDate current_date = QDate::currentDate();          // Obtém a data atual
-    this->id = id_autoincremental++;                    // Atribui um ID único e incrementa o contador
-    this->name = name;                                  // Define o nome do paciente
-    this->cpf = cpf;                                    // Define o CPF do paciente
-    this->email = email;                                // Define o email do paciente
-    this->bday = bday;                                  // Define a data de nascimento
-    this->sintomas = sintomas;                          // Define os sintomas usando flags binárias
-    this->idade = current_date.year() - bday.year();    // Calcula a idade básica
-
-    // Ajusta a idade se o aniversário ainda não ocorreu no ano atual
-    if (current_date.month() < bday.month() ||
-        (current_date.month() == bday.month() && current_date.day() < bday.day())) {
-        this->idade--;
-    }
+// Segundos de espera para a prioridade subir um nível (ver Triagem::configurar_envelhecimento):
+// um paciente só com tosse (1) passa à frente de um acidente recém-chegado (128) depois de cerca de uma hora
+const std::int64_t PASSOS_POR_NIVEL = 30;
+
+// Intervalo entre as gravações do arquivo de métricas
+const std::chrono::seconds INTERVALO_METRICAS(10);
+
+// Intervalo mínimo entre duas atualizações da tabela de pacientes: as mudanças da fila nesse
+// intervalo (uma importação ou uma rajada de admissões, por exemplo) são aplicadas de uma só vez
+const std::chrono::milliseconds INTERVALO_TABELA(200);
+
+// Arquivo de métricas, gravado na pasta de dados do aplicativo ao lado do diário
+const char* const ARQUIVO_METRICAS = "metricas.json";
+
+// Aviso exibido quando o CPF digitado não é válido
+const char* const MENSAGEM_CPF_INVALIDO =
+    "CPF inválido. Use o formato XXX.XXX.XXX-XX ou os 11 dígitos, com os dígitos verificadores corretos.";
+
+/**
+ * @brief Formata o CPF de um paciente a partir da chave guardada no armazenamento.
+ * @param triagem Triagem onde o paciente foi admitido.
+ * @param id ID do paciente.
+ * @return CPF no formato XXX.XXX.XXX-XX.
+ */
+static QString cpf_de(const Triagem& triagem, int id) {
+    return QString::fromStdString(chave_para_cpf(triagem.pacientes().cpf(id)));
 }
 
-// Vetores para gerenciar a fila de pacientes, fila ordenada por nome e relatório de pacientes tratados
-std::vector<Patient> fila;
-std::vector<Patient> sorted_name_fila;
-std::vector<Patient> relatorio;
+/**
+ * @brief Pasta onde ficam o diário, os instantâneos e as métricas.
+ */
+static std::string pasta_dados() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation).toStdString();
+}
 
-// Variável para controlar o tempo de tratamento do paciente atual (-1 indica que nenhum tratamento está em andamento)
-int tempo_tratamento = -1;
+/**
+ * @brief Formata uma duração em nanossegundos como segundos com uma casa decimal.
+ */
+static QString segundos(std::int64_t ns) {
+    return QString::number(ns / 1e9, 'f', 1) + " s";
+}
 
 /**
  * @brief Construtor da classe MainWindow.
- * Configura a interface do usuário e inicializa os temporizadores.
+ * Configura a interface do usuário, recupera a triagem gravada e inicia o relógio e as medidas.
  * @param parent Widget pai.
  */
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , diario(pasta_dados())
+    , historico(pasta_dados() + "/historico")
 {
-    ui->setupUi(this);            // Configura a interface do usuário
-    ui->progressBar->setValue(0); // Inicializa a barra de progresso com valor 0
-
-    // Cria um temporizador para atualizar a interface do usuário a cada intervalo padrão
-    QTimer *timer = new QTimer(this);
-    connect(timer, SIGNAL(timeout()), this, SLOT(update_ui()));
-    timer->start(); // Inicia o temporizador
-
-    // Cria um segundo temporizador para atualizar a fila a cada 1 segundo (1000 milissegundos)
-    QTimer *timer1sec = new QTimer(this);
-    connect(timer1sec, SIGNAL(timeout()), this, SLOT(update_fila()));
-    timer1sec->start(1000); // Inicia o temporizador com intervalo de 1 segundo
+    ui->setupUi(this); // Configura a interface do usuário
+
+    // Recupera a fila e o histórico gravados e passa a registrar as novas operações
+    if (!diario.abrir(triagem)) {
+        QMessageBox::warning(this, "Aviso", "Não foi possível recuperar os dados gravados. "
+                                            "As operações desta sessão não serão salvas.");
+    }
+
+    // Sela em disco as faixas de pacientes que já saíram da fila, inclusive as recuperadas
+    if (!historico.abrir()) {
+        QMessageBox::warning(this, "Aviso", "Não foi possível abrir o histórico em disco. "
+                                            "Os pacientes desta sessão ficarão apenas na memória.");
+    } else if (!triagem.arquivar_em(&historico)) {
+        QMessageBox::warning(this, "Aviso", "O histórico em disco não tem os pacientes já atendidos. "
+                                            "Os nomes e emails deles não podem ser exibidos e os "
+                                            "pacientes desta sessão ficarão apenas na memória.");
+    }
+
+    // Configura as estações de tratamento e cria um rótulo e uma barra de progresso para cada uma
+    std::vector<unsigned> afinidades;
+    for (const ConfiguracaoEstacao& estacao : ESTACOES) {
+        afinidades.push_back(estacao.afinidade);
+    }
+    triagem.configurar_estacoes(afinidades);
+    triagem.configurar_envelhecimento(PASSOS_POR_NIVEL);
+    for (std::size_t e = 0; e < triagem.estacoes().size(); ++e) {
+        QLabel* rotulo = new QLabel(this);
+        rotulo->setAlignment(Qt::AlignCenter);
+        QProgressBar* barra = new QProgressBar(this);
+        ui->chamadoLayout->addWidget(rotulo);
+        ui->chamadoLayout->addWidget(barra);
+        rotulos_estacoes.push_back(rotulo);
+        barras_estacoes.push_back(barra);
+    }
+
+    // Tabela da fila e do relatório: a vista pede ao modelo apenas as linhas visíveis,
+    // todas da mesma altura, para que a rolagem não dependa da quantidade de pacientes
+    modelo_pacientes = new ModeloPacientes(triagem, telemetria, this);
+    ui->tabelaPacientes->setModel(modelo_pacientes);
+    ui->tabelaPacientes->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->tabelaPacientes->verticalHeader()->hide();
+    ui->tabelaPacientes->horizontalHeader()->setStretchLastSection(true);
+    ui->tabelaPacientes->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    ui->tabelaPacientes->setSortingEnabled(true);
+    exibir_tabela(false);
+
+    // Mede o atendimento a partir de agora e grava as métricas periodicamente
+    triagem.medir_em(&telemetria);
+    agenda.agendar(Agenda::Relogio::now() + INTERVALO_METRICAS,
+                   [this](Agenda::Instante prazo) { gravar_metricas(prazo); });
+
+    // Um único temporizador acorda a janela no próximo prazo da agenda: a virada do
+    // segundo exibido no relógio e, enquanto houver pacientes, o passo do tratamento
+    despertador = new QTimer(this);
+    despertador->setSingleShot(true);
+    despertador->setTimerType(Qt::PreciseTimer);
+    connect(despertador, SIGNAL(timeout()), this, SLOT(acordar()));
+    mostrar_relogio();
+    fila_mudou();
+}
+
+/**
+ * @brief Instante, no relógio da agenda, em que o segundo exibido muda.
+ */
+static Agenda::Instante proximo_segundo()
+{
+    return Agenda::Relogio::now() + std::chrono::milliseconds(1000 - QTime::currentTime().msec());
 }
 
 /**
- * @brief Atualiza a interface com a hora e data atuais.
+ * @brief Executa os prazos vencidos da agenda e volta a dormir até o próximo.
  * Não possui parâmetros de entrada ou retorno.
  */
-void MainWindow::update_ui()
+void MainWindow::acordar()
 {
-    QTime time = QTime::currentTime();                // Obtém a hora atual
-    QString time_to_text = time.toString("hh:mm:ss");  // Formata a hora como string
-    QDate date = QDate::currentDate();                // Obtém a data atual
-    QString date_to_text = date.toString();            // Converte a data para string
-    ui->clock->setText(time_to_text);                 // Atualiza o label do relógio na interface
-    ui->date->setText(date_to_text);                  // Atualiza o label da data na interface
+    agenda.executar_vencidos(Agenda::Relogio::now());
+    rearmar();
 }
 
 /**
- * @brief Atualiza a fila de pacientes na interface e gerencia o tratamento atual.
+ * @brief Programa o temporizador para o prazo mais próximo da agenda.
  * Não possui parâmetros de entrada ou retorno.
  */
-void MainWindow::update_fila()
+void MainWindow::rearmar()
 {
-    const QString default_value = "Aguardando paciente"; // Valor padrão quando não há pacientes na fila
+    Agenda::Instante prazo = agenda.proximo_prazo();
+    if (prazo == Agenda::Instante::max()) {
+        despertador->stop();
+        return;
+    }
+    // Arredonda para cima para não acordar antes do prazo
+    auto espera = std::chrono::ceil<std::chrono::milliseconds>(prazo - Agenda::Relogio::now());
+    despertador->start(static_cast<int>(std::max<long long>(espera.count(), 0)));
+}
 
-    // Verifica se a fila está vazia
-    if(fila.empty()){
-        // Define todos os campos de pacientes na interface com o valor padrão
-        ui->primeiro->setText(default_value);
-        ui->segundo->setText(default_value);
-        ui->terceiro->setText(default_value);
-        ui->quarto->setText(default_value);
-        ui->ultimo->setText(default_value);
-        return; // Sai da função se não há pacientes
-    }
-
-    // Atualiza os campos de pacientes na interface com os CPFs dos pacientes na fila
-    ui->primeiro->setText(fila.size() > 0 ? fila.at(0).cpf : default_value);
-    ui->segundo->setText(fila.size() > 1 ? fila.at(1).cpf : default_value);
-    ui->terceiro->setText(fila.size() > 2 ? fila.at(2).cpf : default_value);
-    ui->quarto->setText(fila.size() > 3 ? fila.at(3).cpf : default_value);
-    ui->ultimo->setText(fila.size() > 4 ? fila.at(4).cpf : default_value);
-
-    // Gerencia o tratamento do paciente atual
-    if(tempo_tratamento == -1){
-        // Se nenhum tratamento está em andamento, inicia o tratamento do primeiro paciente da fila
-        QString chamado = QString(fila.at(0).cpf + " " + QString::number(fila.at(0).id));
-        ui->numero_chamado->setText(chamado);          // Atualiza o campo de chamado com CPF e ID do paciente
-        tempo_tratamento = fila.at(0).sintomas + 1;    // Define o tempo de tratamento baseado nos sintomas
-        ui->progressBar->setValue(0);                  // Reseta a barra de progresso
-    }
-    else if(tempo_tratamento > 0){
-        // Se o tratamento está em andamento, decrementa o tempo restante
-        tempo_tratamento--;
-        int porcentagem = (fila.at(0).sintomas - tempo_tratamento) * 100 / fila.at(0).sintomas; // Calcula a porcentagem de conclusão
-        ui->progressBar->setValue(porcentagem); // Atualiza a barra de progresso
-
-        // Verifica se o tratamento foi concluído
-        if(tempo_tratamento == 0){
-            tempo_tratamento = -1;           // Reseta o tempo de tratamento
-            ui->progressBar->setValue(0);    // Reseta a barra de progresso
-            fila.erase(fila.begin());         // Remove o paciente tratado da fila
+/**
+ * @brief Atualiza o relógio e, quando o dia muda, a data; agenda a próxima virada de segundo.
+ * Não possui parâmetros de entrada ou retorno.
+ */
+void MainWindow::mostrar_relogio()
+{
+    ui->clock->setText(QTime::currentTime().toString("hh:mm:ss")); // Atualiza o label do relógio na interface
+    QDate hoje = QDate::currentDate();
+    if (hoje != data_exibida) {
+        data_exibida = hoje;
+        ui->date->setText(hoje.toString()); // Atualiza o label da data na interface
+    }
+    agenda.agendar(proximo_segundo(), [this](Agenda::Instante) { mostrar_relogio(); });
+}
+
+/**
+ * @brief Avança o tratamento em um passo e agenda o próximo enquanto houver pacientes.
+ * Os passos são agendados a partir do prazo anterior, não do instante atual,
+ * para que um atraso do laço de eventos seja compensado em vez de acumulado.
+ * @param prazo Prazo deste passo.
+ */
+void MainWindow::passo_tratamento(Agenda::Instante prazo)
+{
+    prazo_tratamento = -1;
+    if (triagem.avancar()) {
+        bool fila_alterada = false;
+        for (std::size_t e = 0; e < triagem.estacoes().size(); ++e) {
+            const Triagem::Estacao& estacao = triagem.estacoes()[e];
+            if (estacao.evento == Escalonador::CHAMADO) {
+                // Um novo paciente foi chamado: exibe CPF, ID e a estação
+                ui->numero_chamado->setText("Último chamado: " + cpf_de(triagem, estacao.paciente) + " " +
+                                            QString::number(estacao.paciente) + " - " +
+                                            QString::fromUtf8(ESTACOES[e].nome));
+            }
+            fila_alterada = fila_alterada || estacao.evento == Escalonador::CHAMADO ||
+                            estacao.evento == Escalonador::CONCLUIDO;
         }
+        mostrar_estacoes(false);
+        if (fila_alterada) {
+            mostrar_fila();
+            mostrar_estatisticas();
+            tabela_mudou();
+        }
+    }
+    if (!triagem.vazia()) {
+        prazo_tratamento = agenda.agendar(prazo + std::chrono::seconds(1),
+                                          [this](Agenda::Instante proximo) { passo_tratamento(proximo); });
     }
 }
 
 /**
- * @brief Gera um relatório dos pacientes tratados e exibe no TextBrowser.
+ * @brief Atualiza a interface depois de uma admissão, remoção ou importação.
+ * Volta a agendar o tratamento se ele estava parado por falta de pacientes.
  * Não possui parâmetros de entrada ou retorno.
  */
-void MainWindow::gerar_relatorio() {
-    for (const Patient& patient : relatorio) {
-        QString info;
-        info += "ID: " + QString::number(patient.id) + "\n";                        // Adiciona o ID do paciente
-        info += "Nome: " + patient.name + "\n";                                      // Adiciona o nome do paciente
-        info += "CPF: " + patient.cpf + "\n";                                        // Adiciona o CPF do paciente
-        info += "Email: " + patient.email + "\n";                                    // Adiciona o email do paciente
-        info += "Data de Nascimento: " + patient.bday.toString("dd/MM/yyyy") + "\n"; // Adiciona a data de nascimento
-        info += "Idade: " + QString::number(patient.idade) + "\n";                   // Adiciona a idade do paciente
-        info += "Sintomas: ";                                                        // Início da lista de sintomas
-
-        // Verifica e adiciona os sintomas do paciente
-        if (patient.sintomas & TOSSE)       info += "TOSSE ";
-        if (patient.sintomas & NAUSEA)      info += "NÁUSEA ";
-        if (patient.sintomas & FEBRE)       info += "FEBRE ";
-        if (patient.sintomas & DISENTERIA)  info += "DISENTERIA ";
-        if (patient.sintomas & INFECCAO)    info += "INFECÇÃO ";
-        if (patient.sintomas & COVID)       info += "COVID ";
-        if (patient.sintomas & AVC)         info += "AVC ";
-        if (patient.sintomas & ACIDENTE)    info += "ACIDENTE ";
-
-        info += "\n-----------------------------\n"; // Adiciona uma linha separadora
+void MainWindow::fila_mudou()
+{
+    mostrar_fila();
+    mostrar_estacoes(true);
+    mostrar_estatisticas();
+    tabela_mudou();
+    if (prazo_tratamento == -1 && !triagem.vazia()) {
+        // Alinha o tratamento à virada do segundo, para acordar uma só vez por segundo
+        prazo_tratamento = agenda.agendar(proximo_segundo(),
+                                          [this](Agenda::Instante prazo) { passo_tratamento(prazo); });
+    }
+    rearmar();
+}
 
-        // Adiciona as informações ao TextBrowser na interface
-        ui->textBrowser->append(info);
+/**
+ * @brief Agenda a atualização da tabela de pacientes, se ainda não houver uma agendada.
+ * A tabela é reordenada no máximo uma vez a cada INTERVALO_TABELA, qualquer que
+ * seja a quantidade de mudanças da fila nesse intervalo.
+ * Não possui parâmetros de entrada ou retorno.
+ */
+void MainWindow::tabela_mudou()
+{
+    if (prazo_tabela != -1) {
+        return;
     }
+    prazo_tabela = agenda.agendar(Agenda::Relogio::now() + INTERVALO_TABELA, [this](Agenda::Instante) {
+        prazo_tabela = -1;
+        modelo_pacientes->atualizar();
+    });
 }
 
 /**
- * @brief Ordena a fila de pacientes com base nos sintomas usando o algoritmo de seleção.
+ * @brief Exibe os CPFs dos próximos pacientes que esperam, sem os que já estão em tratamento.
  * Não possui parâmetros de entrada ou retorno.
  */
-void ordenar_paciente_sintoma(){
-    int n = fila.size(); // Obtém o tamanho da fila
-
-    // Loop externo para cada posição na fila
-    for (int i = 0; i < n - 1; ++i) {
-        int max_idx = i;                     // Assume que o primeiro elemento é o de maior prioridade
-        int max_priority = fila[i].sintomas; // Obtém a prioridade atual
-
-        // Loop interno para encontrar o paciente com a maior prioridade na parte não ordenada
-        for (int j = i + 1; j < n; ++j) {
-            int current_priority = fila[j].sintomas; // Obtém a prioridade do paciente atual
-
-            // Se o paciente atual tem uma prioridade maior, atualiza o índice máximo
-            if (current_priority > max_priority) {
-                max_idx = j;
-                max_priority = current_priority;
-            }
-        }
+void MainWindow::mostrar_fila()
+{
+    const QString default_value = "Aguardando paciente"; // Valor padrão quando não há pacientes na fila
 
-        // Se o índice máximo mudou, troca os pacientes para ordenar
-        if (max_idx != i) {
-            std::swap(fila[i], fila[max_idx]);
+    std::vector<int> proximos;
+    for (int id : triagem.primeiros(5 + triagem.estacoes().size())) {
+        if (triagem.estacao_de(id) == -1 && proximos.size() < 5) {
+            proximos.push_back(id);
         }
     }
+    ui->primeiro->setText(proximos.size() > 0 ? cpf_de(triagem, proximos[0]) : default_value);
+    ui->segundo->setText(proximos.size() > 1 ? cpf_de(triagem, proximos[1]) : default_value);
+    ui->terceiro->setText(proximos.size() > 2 ? cpf_de(triagem, proximos[2]) : default_value);
+    ui->quarto->setText(proximos.size() > 3 ? cpf_de(triagem, proximos[3]) : default_value);
+    ui->ultimo->setText(proximos.size() > 4 ? cpf_de(triagem, proximos[4]) : default_value);
 }
 
 /**
- * @brief Ordena a fila de pacientes com base no nome usando o algoritmo de seleção.
- * Não possui parâmetros de entrada ou retorno.
+ * @brief Exibe o paciente em tratamento e o progresso de cada estação.
+ * @param tudo true para refazer todas as estações; false para apenas as que tiveram evento no último passo.
  */
-void ordenar_paciente_nome() {
-    sorted_name_fila = fila;               // Cria uma cópia da fila original para ordenar
-    int n = sorted_name_fila.size();      // Obtém o tamanho da fila ordenada
-
-    // Loop externo para cada posição na fila ordenada
-    for (int i = 0; i < n - 1; ++i) {
-        int min_idx = i; // Assume que o primeiro elemento é o mínimo
-
-        // Loop interno para encontrar o paciente com o menor nome na parte não ordenada
-        for (int j = i + 1; j < n; ++j) {
-            // Compara os nomes lexicograficamente de forma insensível a maiúsculas/minúsculas
-            if (sorted_name_fila[j].name.compare(sorted_name_fila[min_idx].name, Qt::CaseInsensitive) < 0) {
-                min_idx = j; // Atualiza o índice mínimo se um nome menor for encontrado
+void MainWindow::mostrar_estacoes(bool tudo)
+{
+    for (std::size_t e = 0; e < rotulos_estacoes.size(); ++e) {
+        const Triagem::Estacao& estacao = triagem.estacoes()[e];
+        if (tudo || estacao.evento == Escalonador::CHAMADO || estacao.evento == Escalonador::CONCLUIDO) {
+            QString nome = QString::fromUtf8(ESTACOES[e].nome) + ": ";
+            if (estacao.paciente == -1) {
+                rotulos_estacoes[e]->setText(nome + "livre");
+            } else {
+                rotulos_estacoes[e]->setText(nome + cpf_de(triagem, estacao.paciente) + " " +
+                                             QString::number(estacao.paciente));
             }
         }
+        if (tudo || estacao.evento != Escalonador::NENHUM) {
+            barras_estacoes[e]->setValue(estacao.progresso);
+        }
+    }
+}
 
-        // Se o índice mínimo mudou, troca os pacientes para ordenar
-        if (min_idx != i) {
-            std::swap(sorted_name_fila[i], sorted_name_fila[min_idx]);
+/**
+ * @brief Exibe no painel de estatísticas o tamanho da fila, os contadores e as esperas medidas.
+ * Não possui parâmetros de entrada ou retorno.
+ */
+void MainWindow::mostrar_estatisticas()
+{
+    QString texto = "Esperando: " + QString::number(telemetria.esperando()) +
+                    " | Em tratamento: " + QString::number(telemetria.em_tratamento()) +
+                    " | Fila máxima: " + QString::number(telemetria.fila_maxima()) +
+                    " | Admissões: " + QString::number(telemetria.admissoes()) +
+                    " | Altas: " + QString::number(telemetria.altas()) +
+                    " | Remoções: " + QString::number(telemetria.remocoes()) + "\n";
+
+    Histograma espera = telemetria.espera_total();
+    if (espera.quantidade() == 0) {
+        texto += "Espera: nenhum chamado medido";
+    } else {
+        texto += "Espera (mediana / p90 / máxima): " + segundos(espera.percentil(50)) + " / " +
+                 segundos(espera.percentil(90)) + " / " + segundos(espera.maximo());
+    }
+
+    // Mediana da espera e do tratamento de cada classe com chamados medidos, da mais grave para a menos
+    QString classes;
+    for (std::size_t c = Telemetria::CLASSES; c-- > 0;) {
+        const Histograma& espera_classe = telemetria.espera(c);
+        if (espera_classe.quantidade() == 0) {
+            continue;
         }
+        classes += (classes.isEmpty() ? "" : " | ") + QString::fromUtf8(Telemetria::nome_classe(c)) + ": " +
+                   segundos(espera_classe.percentil(50)) + " / " + segundos(telemetria.tratamento(c).percentil(50));
     }
+    if (!classes.isEmpty()) {
+        texto += "\nPor classe (espera / tratamento): " + classes;
+    }
+    ui->estatisticas->setText(texto);
+}
+
+/**
+ * @brief Grava o arquivo de métricas e agenda a próxima gravação.
+ * @param prazo Prazo desta gravação.
+ */
+void MainWindow::gravar_metricas(Agenda::Instante prazo)
+{
+    // Uma falha aqui não afeta o atendimento; a próxima gravação tenta de novo
+    telemetria.gravar(pasta_dados() + "/" + ARQUIVO_METRICAS);
+    agenda.agendar(prazo + INTERVALO_METRICAS, [this](Agenda::Instante proximo) { gravar_metricas(proximo); });
+}
+
+/**
+ * @brief Exibe na tabela o relatório de todos os pacientes admitidos, na ordem de chegada.
+ * Os nomes e emails dos pacientes já selados vêm do histórico em disco (ver ModeloPacientes).
+ * Não possui parâmetros de entrada ou retorno.
+ */
+void MainWindow::gerar_relatorio() {
+    exibir_tabela(true);
+    modelo_pacientes->exibir(ModeloPacientes::RELATORIO);
+}
+
+/**
+ * @brief Alterna a área de resultados entre a tabela de pacientes e o texto das consultas.
+ * A tabela escondida deixa de exibir pacientes, liberando a ordem que guardava.
+ * @param tabela true para exibir a tabela; false para o texto.
+ */
+void MainWindow::exibir_tabela(bool tabela)
+{
+    if (!tabela) {
+        modelo_pacientes->exibir(ModeloPacientes::NENHUM);
+    }
+    // Cada listagem começa na ordem natural, sem a coluna ordenada da anterior
+    QSignalBlocker bloqueio(ui->tabelaPacientes->horizontalHeader());
+    ui->tabelaPacientes->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    ui->tabelaPacientes->setVisible(tabela);
+    ui->textBrowser->setVisible(!tabela);
 }
 
 // Destrutor da classe MainWindow
@@ -258,11 +406,9 @@ MainWindow::~MainWindow()
  */
 void MainWindow::on_patientButton_clicked()
 {
-    bool paciente_cadastrado = false;       // Flag para verificar se o paciente já está cadastrado
-    Patient * paciente_existente = nullptr;  // Ponteiro para o paciente existente
     unsigned int sintomas = 0;               // Variável para armazenar os sintomas selecionados
     QString name = ui->nameLineEdit->text(); // Obtém o nome inserido no campo de texto
-    QString cpf = ui->cpfLineEdit->text();   // Obtém o CPF inserido no campo de texto
+    QString cpf = ui->cpfLineEdit->text().trimmed(); // Obtém o CPF inserido no campo de texto
     QString email = ui->emailLineEdit->text(); // Obtém o email inserido no campo de texto
     QDate bday = ui->birthdayDateEdit->date();  // Obtém a data de nascimento inserida
 
@@ -278,10 +424,10 @@ void MainWindow::on_patientButton_clicked()
         return;
     }
 
-    // Valida o formato do CPF (XXX.XXX.XXX-XX)
-    if(cpf[3] != '.' || cpf[7] != '.' || cpf[11] != '-'){
+    // Valida o formato do CPF (XXX.XXX.XXX-XX ou 11 dígitos) e os dígitos verificadores
+    if(!cpf_valido(cpf.toStdString())){
         ui->cpfLineEdit->setText(""); // Limpa o campo CPF
-        QMessageBox::warning(this, "Erro de Entrada", "O CPF deve seguir o formato XXX.XXX.XXX-XX");
+        QMessageBox::warning(this, "Erro de Entrada", MENSAGEM_CPF_INVALIDO);
         return;
     }
 
@@ -317,37 +463,15 @@ void MainWindow::on_patientButton_clicked()
         return;
     }
 
-    // Percorre a fila para verificar se o paciente já está cadastrado
-    for (Patient& paciente : fila) {
-        if(paciente.cpf.compare(cpf) == 0){
-            paciente_cadastrado = true;     // Marca que o paciente está cadastrado
-            paciente_existente = &paciente; // Aponta para o paciente existente
-            break;                           // Sai do loop após encontrar o paciente
-        }
-    }
-
-    if(paciente_cadastrado){
-        // Atualiza os dados do paciente existente
-        QDate current_date = QDate::currentDate(); // Obtém a data atual
-        paciente_existente->name = name;              // Atualiza o nome
-        paciente_existente->email = email;            // Atualiza o email
-        paciente_existente->bday = bday;              // Atualiza a data de nascimento
-        paciente_existente->sintomas = sintomas;      // Atualiza os sintomas
-        paciente_existente->idade = current_date.year() - bday.year(); // Recalcula a idade
-
-        // Ajusta a idade se o aniversário ainda não ocorreu no ano atual
-        if (current_date.month() < bday.month() ||
-            (current_date.month() == bday.month() && current_date.day() < bday.day())) {
-            paciente_existente->idade--;
-        }
-    }
-    else{
-        // Cria um novo paciente e adiciona à fila e ao relatório
-        Patient new_patient = Patient(name, cpf, email, bday, sintomas);
-        fila.push_back(new_patient);           // Adiciona o paciente à fila
-        ordenar_paciente_sintoma();           // Ordena a fila por sintomas
-        relatorio.push_back(new_patient);      // Adiciona o paciente ao relatório de tratados
+    // Adiciona o paciente à fila ou atualiza o paciente com o mesmo CPF
+    Triagem::Admissao admissao = triagem.admitir(name.toStdString(), cpf.toStdString(), email.toStdString(),
+                                                 bday.toJulianDay(), sintomas);
+    if (admissao == Triagem::CPF_MAL_FORMADO) {
+        ui->cpfLineEdit->setText(""); // Limpa o campo CPF
+        QMessageBox::warning(this, "Erro de Entrada", MENSAGEM_CPF_INVALIDO);
+        return;
     }
+    fila_mudou();
 
     // Limpa os campos de entrada na interface após adicionar/atualizar o paciente
     ui->nameLineEdit->setText("");
@@ -365,34 +489,6 @@ void MainWindow::on_patientButton_clicked()
     ui->sintoma_disenteriaCheckBox->setCheckState(Qt::CheckState::Unchecked);
 }
 
-/**
- * @brief Realiza uma busca binária pelo nome do paciente.
- * @param name Nome do paciente a ser buscado.
- * @return Índice do paciente encontrado ou -1 se não encontrado.
- */
-int binary_search(const QString& name) {
-    int left = 0;                             // Início do intervalo de busca
-    int right = sorted_name_fila.size() - 1; // Fim do intervalo de busca
-
-    // Enquanto o intervalo de busca for válido
-    while (left <= right) {
-        int mid = left + (right - left) / 2; // Calcula o índice do meio
-        // Compara o nome alvo com o nome do paciente no índice do meio
-        int cmp = sorted_name_fila[mid].name.compare(name, Qt::CaseInsensitive);
-
-        if (cmp == 0) {
-            return mid; // Paciente encontrado, retorna o índice
-        }
-        else if (cmp < 0) {
-            left = mid + 1; // O nome alvo está na metade direita
-        }
-        else {
-            right = mid - 1; // O nome alvo está na metade esquerda
-        }
-    }
-    return -1; // Paciente não encontrado
-}
-
 /**
  * @brief Função chamada quando o botão de consultar paciente é clicado.
  * Realiza a busca do paciente pelo CPF ou nome e exibe as informações.
@@ -400,6 +496,7 @@ int binary_search(const QString& name) {
  */
 void MainWindow::on_consultarPatient_clicked()
 {
+    exibir_tabela(false);
     ui->textBrowser->clear();
     ui->textBrowser->append("Início de listagem");
     QString cpf = ui->cpfLineEdit->text();   // Obtém o CPF inserido
@@ -407,93 +504,102 @@ void MainWindow::on_consultarPatient_clicked()
 
     // Verifica se a busca binária está selecionada
     if(ui->buscaBinariaCheckbox->isChecked()){
-        ordenar_paciente_nome(); // Ordena os registros da fila em sorted_name_fila
-        int idx = binary_search(name); // Realiza a busca binária pelo nome
-
-        // Verifica se o paciente foi encontrado
-        if(idx != -1){
-            Patient patient = sorted_name_fila.at(idx); // Obtém o paciente encontrado
-            QString info;
-            info += "ID: " + QString::number(patient.id) + "\n";                        // Adiciona o ID
-            info += "Nome: " + patient.name + "\n";                                      // Adiciona o nome
-            info += "CPF: " + patient.cpf + "\n";                                        // Adiciona o CPF
-            info += "Email: " + patient.email + "\n";                                    // Adiciona o email
-            info += "Data de Nascimento: " + patient.bday.toString("dd/MM/yyyy") + "\n"; // Adiciona a data de nascimento
-            info += "Idade: " + QString::number(patient.idade) + "\n";                   // Adiciona a idade
-            info += "Sintomas: ";                                                        // Início da lista de sintomas
-
-            // Verifica e adiciona os sintomas do paciente
-            if (patient.sintomas & TOSSE)       info += "TOSSE ";
-            if (patient.sintomas & NAUSEA)      info += "NÁUSEA ";
-            if (patient.sintomas & FEBRE)       info += "FEBRE ";
-            if (patient.sintomas & DISENTERIA)  info += "DISENTERIA ";
-            if (patient.sintomas & INFECCAO)    info += "INFECÇÃO ";
-            if (patient.sintomas & COVID)       info += "COVID ";
-            if (patient.sintomas & AVC)         info += "AVC ";
-            if (patient.sintomas & ACIDENTE)    info += "ACIDENTE ";
-
-            info += "\n-----------------------------\n"; // Adiciona uma linha separadora
-
-            // Adiciona as informações ao TextBrowser na interface
-            ui->textBrowser->append(info);
+        // Busca no índice ordenado todos os pacientes com o nome informado
+        std::vector<int> encontrados = triagem.buscar_nome(name.toStdString());
+
+        // Formata todos os pacientes encontrados de uma vez e adiciona ao TextBrowser na interface
+        if (!encontrados.empty()) {
+            Formatador formatador(Formatador::TEXTO, dia_juliano_hoje());
+            for (int id : encontrados) {
+                formatador.escrever(triagem.pacientes(), id);
+            }
+            std::string_view info = formatador.texto();
+            ui->textBrowser->append(QString::fromUtf8(info.data(), static_cast<qsizetype>(info.size())));
             return; // Sai da função após exibir as informações
         }
 
+        // Se o nome exato não foi encontrado, mostra os nomes parecidos
+        if (listar_aproximados(name)) {
+            return;
+        }
+
         // Se o paciente não foi encontrado, exibe uma mensagem de aviso
         QMessageBox::warning(this, "Não Encontrado", "Nenhum paciente com o nome \"" + name + "\" foi encontrado.");
         return;
     }
 
-    // Se a busca binária não estiver selecionada, realiza uma busca sequencial
-    for (Patient& patient : fila) {
-        // Verifica se o CPF ou o nome do paciente correspondem aos critérios de busca
-        if( (!cpf.isEmpty() && patient.cpf.compare(cpf) == 0) ||
-            (!name.isEmpty() && patient.name.toLower().compare(name.toLower()) == 0)
-            ){
-            QString info;
-            info += "ID: " + QString::number(patient.id) + "\n";                        // Adiciona o ID
-            info += "Nome: " + patient.name + "\n";                                      // Adiciona o nome
-            info += "CPF: " + patient.cpf + "\n";                                        // Adiciona o CPF
-            info += "Email: " + patient.email + "\n";                                    // Adiciona o email
-            info += "Data de Nascimento: " + patient.bday.toString("dd/MM/yyyy") + "\n"; // Adiciona a data de nascimento
-            info += "Idade: " + QString::number(patient.idade) + "\n";                   // Adiciona a idade
-            info += "Sintomas: ";                                                        // Início da lista de sintomas
-
-            // Verifica e adiciona os sintomas do paciente
-            if (patient.sintomas & TOSSE)       info += "TOSSE ";
-            if (patient.sintomas & NAUSEA)      info += "NÁUSEA ";
-            if (patient.sintomas & FEBRE)       info += "FEBRE ";
-            if (patient.sintomas & DISENTERIA)  info += "DISENTERIA ";
-            if (patient.sintomas & INFECCAO)    info += "INFECÇÃO ";
-            if (patient.sintomas & COVID)       info += "COVID ";
-            if (patient.sintomas & AVC)         info += "AVC ";
-            if (patient.sintomas & ACIDENTE)    info += "ACIDENTE ";
-
-            info += "\n-----------------------------\n"; // Adiciona uma linha separadora
-
-            // Adiciona as informações ao TextBrowser na interface
-            ui->textBrowser->append(info);
-            return; // Sai da função após encontrar e exibir o paciente
-        }
+    // Se a busca binária não estiver selecionada, consulta o índice de CPF
+    int encontrado = -1;
+    if (!cpf.isEmpty()) {
+        encontrado = triagem.buscar_cpf(cpf.toStdString());
+    }
+
+    // Se o CPF não foi encontrado, realiza uma busca sequencial pelo nome
+    if (encontrado == -1 && !name.isEmpty()) {
+        encontrado = triagem.buscar_nome_sequencial(name.toStdString());
+    }
+
+    if (encontrado != -1) {
+        Formatador formatador(Formatador::TEXTO, dia_juliano_hoje());
+        formatador.escrever(triagem.pacientes(), encontrado);
+        std::string_view info = formatador.texto();
+
+        // Adiciona as informações ao TextBrowser na interface
+        ui->textBrowser->append(QString::fromUtf8(info.data(), static_cast<qsizetype>(info.size())));
+        return; // Sai da função após encontrar e exibir o paciente
+    }
+
+    // Se o nome exato não foi encontrado, mostra os nomes parecidos
+    if (!name.isEmpty() && listar_aproximados(name)) {
+        return;
     }
 
     // Se o paciente não foi encontrado, exibe uma mensagem de aviso
     QMessageBox::warning(this, "Não Encontrado", "Paciente não encontrado.");
 }
 
+/**
+ * @brief Lista os pacientes da fila e do relatório com nome parecido com o informado.
+ * Aceita nomes parciais, sem acentos e com pequenos erros de digitação.
+ * @param name Nome ou parte do nome a ser buscado.
+ * @return true se algum paciente foi listado.
+ */
+bool MainWindow::listar_aproximados(const QString& name)
+{
+    std::vector<Triagem::Aproximado> resultados = triagem.buscar_aproximado(name.toStdString(), LIMITE_APROXIMADOS);
+    if (resultados.empty()) {
+        return false;
+    }
+
+    ui->textBrowser->append("Nenhum nome exato encontrado. Pacientes com nome parecido:");
+    for (const Triagem::Aproximado& resultado : resultados) {
+        Patient patient = triagem.paciente(resultado.id);
+        ui->textBrowser->append("ID: " + QString::number(patient.id) +
+                                " | Nome: " + QString::fromStdString(patient.name) +
+                                " | CPF: " + QString::fromStdString(patient.cpf) +
+                                (resultado.na_fila ? " | Na fila" : " | Fora da fila"));
+    }
+    return true;
+}
+
 /**
  * @brief Função chamada quando a edição do campo CPF é finalizada para validar o formato.
  * Não possui parâmetros de entrada ou retorno.
  */
 void MainWindow::on_cpfLineEdit_editingFinished()
 {
-    QString cpf = ui->cpfLineEdit->text(); // Obtém o CPF inserido
-    // Verifica se o CPF segue o formato XXX.XXX.XXX-XX
-    if(cpf[3] != '.' || cpf[7] != '.' || cpf[11] != '-'){
+    QString cpf = ui->cpfLineEdit->text().trimmed(); // Obtém o CPF inserido
+    if(cpf.isEmpty()){
+        return; // Campo ainda não preenchido; a admissão avisa se continuar vazio
+    }
+    // Verifica o formato e os dígitos verificadores do CPF
+    std::uint64_t chave = cpf_para_chave(cpf.toStdString());
+    if(chave == CPF_INVALIDO){
         ui->cpfLineEdit->setText(""); // Limpa o campo CPF
-        QMessageBox::warning(this, "Erro de Entrada", "O CPF deve seguir o formato XXX.XXX.XXX-XX"); // Exibe mensagem de erro
+        QMessageBox::warning(this, "Erro de Entrada", MENSAGEM_CPF_INVALIDO); // Exibe mensagem de erro
         return;
     }
+    ui->cpfLineEdit->setText(QString::fromStdString(chave_para_cpf(chave))); // Exibe o CPF no formato XXX.XXX.XXX-XX
 }
 
 /**
@@ -502,7 +608,6 @@ void MainWindow::on_cpfLineEdit_editingFinished()
  */
 void MainWindow::on_pushButton_clicked()
 {
-    ui->textBrowser->clear();
     gerar_relatorio(); // Chama a função para gerar o relatório dos pacientes tratados
 }
 
@@ -521,13 +626,11 @@ void MainWindow::on_removePatient_clicked()
         return;
     }
 
-    // Percorre a fila para encontrar o paciente com o CPF correspondente
-    for (int i = 0; i < fila.size(); ++i) {
-        if(fila[i].cpf.compare(cpf) == 0){
-            fila.erase(fila.begin()+i); // Remove o paciente da fila
-            QMessageBox::information(this, "Paciente Removido", "Paciente removido com sucesso.");
-            return; // Sai do loop após remover o paciente
-        }
+    // Remove o paciente da fila; se ele estava em tratamento, o tratamento é encerrado
+    if(triagem.remover(cpf.toStdString())){
+        fila_mudou();
+        QMessageBox::information(this, "Paciente Removido", "Paciente removido com sucesso.");
+        return;
     }
 
     // Se o paciente não foi encontrado, exibe uma mensagem de aviso
@@ -536,36 +639,44 @@ void MainWindow::on_removePatient_clicked()
 
 /**
  * @brief Função chamada quando o botão para listar pacientes na fila é clicado.
- * Exibe todos os pacientes atualmente na fila.
+ * Exibe na tabela todos os pacientes atualmente na fila, na ordem de atendimento.
  * Não possui parâmetros de entrada ou retorno.
  */
 void MainWindow::on_pushButton_2_clicked()
 {
-    ui->textBrowser->clear();
-    ui->textBrowser->append("Início de listagem");
-    for (Patient& patient : fila) {
-        QString info;
-        info += "ID: " + QString::number(patient.id) + "\n";                        // Adiciona o ID
-        info += "Nome: " + patient.name + "\n";                                      // Adiciona o nome
-        info += "CPF: " + patient.cpf + "\n";                                        // Adiciona o CPF
-        info += "Email: " + patient.email + "\n";                                    // Adiciona o email
-        info += "Data de Nascimento: " + patient.bday.toString("dd/MM/yyyy") + "\n"; // Adiciona a data de nascimento
-        info += "Idade: " + QString::number(patient.idade) + "\n";                   // Adiciona a idade
-        info += "Sintomas: ";                                                        // Início da lista de sintomas
-
-        // Verifica e adiciona os sintomas do paciente
-        if (patient.sintomas & TOSSE)       info += "TOSSE ";
-        if (patient.sintomas & NAUSEA)      info += "NÁUSEA ";
-        if (patient.sintomas & FEBRE)       info += "FEBRE ";
-        if (patient.sintomas & DISENTERIA)  info += "DISENTERIA ";
-        if (patient.sintomas & INFECCAO)    info += "INFECÇÃO ";
-        if (patient.sintomas & COVID)       info += "COVID ";
-        if (patient.sintomas & AVC)         info += "AVC ";
-        if (patient.sintomas & ACIDENTE)    info += "ACIDENTE ";
-
-        info += "\n-----------------------------\n"; // Adiciona uma linha separadora
+    exibir_tabela(true);
+    modelo_pacientes->exibir(ModeloPacientes::FILA);
+}
 
-        // Adiciona as informações ao TextBrowser na interface
-        ui->textBrowser->append(info);
+/**
+ * @brief Importa pacientes de um arquivo CSV ou JSON escolhido pelo usuário.
+ * Mostra a quantidade de pacientes admitidos e atualizados e as linhas rejeitadas.
+ */
+void MainWindow::on_importarPacientes_clicked()
+{
+    QString caminho = QFileDialog::getOpenFileName(this, "Importar pacientes", QString(),
+                                                   "CSV ou JSON (*.csv *.json *.jsonl);;Todos os arquivos (*)");
+    if (caminho.isEmpty()) {
+        return; // Usuário cancelou
+    }
+
+    ResultadoImportacao resultado;
+    if (!importar_arquivo(triagem, caminho.toStdString(), resultado)) {
+        QMessageBox::warning(this, "Erro de Importação", "Não foi possível abrir o arquivo " + caminho);
+        return;
+    }
+
+    fila_mudou();
+    exibir_tabela(false);
+    ui->textBrowser->clear();
+    ui->textBrowser->append("Importação concluída: " + QString::number(resultado.admitidos) + " admitidos, " +
+                            QString::number(resultado.atualizados) + " atualizados, " +
+                            QString::number(resultado.erros.size()) + " rejeitados");
+    for (std::size_t i = 0; i < resultado.erros.size() && i < LIMITE_ERROS_IMPORTACAO; ++i) {
+        ui->textBrowser->append("Linha " + QString::number(resultado.erros[i].linha) + ": " +
+                                QString::fromUtf8(resultado.erros[i].motivo));
+    }
+    if (resultado.erros.size() > LIMITE_ERROS_IMPORTACAO) {
+        ui->textBrowser->append("...");
     }
 }
@@ -1,9 +1,21 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QDate>
 #include <QMainWindow>
+#include <vector>
+
+#include "agenda.h"
+#include "diario.h"
+#include "historico.h"
+#include "telemetria.h"
+#include "triagem.h"
 
 QT_BEGIN_NAMESPACE
+class QLabel;
+class QProgressBar;
+class QTimer;
+class ModeloPacientes;
 namespace Ui {
 class MainWindow;
 }
@@ -17,8 +29,7 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 private slots:
-    void update_ui();
-    void update_fila();
+    void acordar();
     void on_patientButton_clicked();
     void gerar_relatorio();
 
@@ -32,8 +43,34 @@ private slots:
 
     void on_pushButton_2_clicked();
 
+    void on_importarPacientes_clicked();
+
 private:
+    bool listar_aproximados(const QString& name);
+    void exibir_tabela(bool tabela);
+    void rearmar();
+    void mostrar_relogio();
+    void passo_tratamento(Agenda::Instante prazo);
+    void fila_mudou();
+    void tabela_mudou();
+    void mostrar_fila();
+    void mostrar_estacoes(bool tudo);
+    void mostrar_estatisticas();
+    void gravar_metricas(Agenda::Instante prazo);
+
     Ui::MainWindow *ui;
+    Telemetria telemetria; // Esperas, tratamentos e tamanho da fila medidos nesta sessão
+    Triagem triagem;       // Fila, cadastro e tratamento dos pacientes
+    Diario diario;         // Persistência da triagem; destruído antes dela, gravando o que estiver pendente
+    Historico historico;   // Segmentos em disco com os pacientes que já saíram da fila
+    std::vector<QLabel*> rotulos_estacoes;      // Paciente em tratamento em cada estação
+    std::vector<QProgressBar*> barras_estacoes; // Progresso do tratamento em cada estação
+    Agenda agenda;                  // Prazos do relógio, do tratamento e da tabela de pacientes
+    QTimer* despertador = nullptr;  // Acorda a janela no prazo mais próximo da agenda
+    int prazo_tratamento = -1;      // Prazo do próximo passo do tratamento na agenda (-1 se parado)
+    int prazo_tabela = -1;          // Prazo da próxima atualização da tabela de pacientes (-1 se nenhuma)
+    QDate data_exibida;             // Data exibida no rótulo de data
+    ModeloPacientes* modelo_pacientes = nullptr; // Fila ou relatório exibido na tabela de pacientes
 
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,377 @@
+#include "modelopacientes.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <utility>
+
+#include "cpf.h"
+#include "data.h"
+#include "formatador.h"
+#include "historico.h"
+#include "telemetria.h"
+#include "texto.h"
+#include "triagem.h"
+
+// IDs consecutivos lidos do histórico de uma vez para exibir nomes e emails de pacientes selados
+static const int PAGINA_HISTORICO = 1024;
+
+// Títulos das colunas, na ordem de ModeloPacientes::Coluna
+static const char* const TITULOS[ModeloPacientes::COLUNAS] = {
+    "ID", "Nome", "CPF", "Email", "Nascimento", "Idade", "Sintomas", "Situação", "Admissão", "Chamado", "Alta",
+};
+
+/**
+ * @brief Formata um instante da telemetria como horário, ou "-" se a transição não foi registrada.
+ */
+static QString horario_de(const Telemetria& telemetria, std::int64_t instante)
+{
+    if (instante == 0) {
+        return "-";
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        telemetria.horario(instante).time_since_epoch());
+    return QDateTime::fromMSecsSinceEpoch(ms.count()).toString("hh:mm:ss");
+}
+
+/**
+ * @brief Ordena os IDs de forma estável pela chave; os empates mantêm a ordem recebida.
+ */
+template <typename Chave>
+static void ordenar_por(std::vector<int>& ids, Chave chave)
+{
+    std::stable_sort(ids.begin(), ids.end(), [&](int a, int b) { return chave(a) < chave(b); });
+}
+
+ModeloPacientes::ModeloPacientes(const Triagem& triagem, const Telemetria& telemetria, QObject* parent)
+    : QAbstractTableModel(parent)
+    , triagem(triagem)
+    , telemetria(telemetria)
+    , hoje(dia_juliano_hoje())
+{
+}
+
+void ModeloPacientes::exibir(Conteudo conteudo)
+{
+    beginResetModel();
+    this->conteudo = conteudo;
+    coluna_ordenada = -1;
+    sentido = Qt::AscendingOrder;
+    hoje = dia_juliano_hoje();
+    ordem = ordenar(coluna_ordenada, sentido);
+    std::vector<int>(ordem).swap(ordem); // Devolve a memória de um conteúdo maior exibido antes
+    linhas = linhas_atuais();
+    fim_pagina = 0;
+    std::vector<std::string>().swap(nomes_pagina);
+    std::vector<std::string>().swap(emails_pagina);
+    endResetModel();
+}
+
+void ModeloPacientes::atualizar()
+{
+    acompanhar(false);
+}
+
+// Aplica as mudanças desde a última atualização; reordenar refaz a ordem do relatório pela ordenação atual
+void ModeloPacientes::acompanhar(bool reordenar)
+{
+    if (conteudo == NENHUM) {
+        return;
+    }
+    hoje = dia_juliano_hoje();
+
+    std::vector<int> nova;
+    int novas_linhas = linhas_atuais();
+    if (conteudo == FILA) {
+        nova = ordenar(coluna_ordenada, sentido);
+        novas_linhas = static_cast<int>(nova.size());
+    } else if (reordenar) {
+        nova = ordenar(coluna_ordenada, sentido);
+    } else {
+        // O relatório só cresce; ordenado, os novos pacientes entram no fim até a próxima ordenação
+        nova.swap(ordem);
+        if (!nova.empty()) {
+            for (int id = linhas; id < novas_linhas; ++id) {
+                nova.push_back(id);
+            }
+        }
+    }
+
+    if (novas_linhas > linhas) {
+        beginInsertRows(QModelIndex(), linhas, novas_linhas - 1);
+        ordem.swap(nova);
+        linhas = novas_linhas;
+        endInsertRows();
+    } else if (novas_linhas < linhas) {
+        beginRemoveRows(QModelIndex(), novas_linhas, linhas - 1);
+        ordem.swap(nova);
+        linhas = novas_linhas;
+        endRemoveRows();
+    } else {
+        ordem.swap(nova);
+    }
+    if (linhas > 0) {
+        emit dataChanged(index(0, 0), index(linhas - 1, COLUNAS - 1));
+    }
+}
+
+// Linhas do conteúdo no estado atual da triagem (as exibidas podem ser da atualização anterior)
+int ModeloPacientes::linhas_atuais() const
+{
+    return conteudo == FILA ? static_cast<int>(triagem.tamanho())
+         : conteudo == RELATORIO ? static_cast<int>(triagem.admitidos())
+         : 0;
+}
+
+int ModeloPacientes::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : linhas;
+}
+
+int ModeloPacientes::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : COLUNAS;
+}
+
+QVariant ModeloPacientes::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= linhas) {
+        return QVariant();
+    }
+    if (role == Qt::TextAlignmentRole) {
+        bool numero = index.column() == ID || index.column() == IDADE;
+        return QVariant(int(Qt::AlignVCenter) | int(numero ? Qt::AlignRight : Qt::AlignLeft));
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    // Formata apenas a célula pedida, lendo só o campo dela no armazenamento
+    const ArmazemPacientes& pacientes = triagem.pacientes();
+    int id = id_da_linha(index.row());
+    switch (index.column()) {
+    case ID:
+        return id;
+    case NOME: {
+        std::string_view nome = texto(id, NOME);
+        return QString::fromUtf8(nome.data(), static_cast<qsizetype>(nome.size()));
+    }
+    case CPF:
+        return QString::fromStdString(chave_para_cpf(pacientes.cpf(id)));
+    case EMAIL: {
+        std::string_view email = texto(id, EMAIL);
+        return QString::fromUtf8(email.data(), static_cast<qsizetype>(email.size()));
+    }
+    case NASCIMENTO:
+        return QDate::fromJulianDay(pacientes.nascimento(id)).toString("dd/MM/yyyy");
+    case IDADE:
+        return calcular_idade(pacientes.nascimento(id), hoje);
+    case SINTOMAS: {
+        std::string_view rotulo = rotulo_sintomas(pacientes.sintomas(id));
+        return QString::fromUtf8(rotulo.data(), static_cast<qsizetype>(rotulo.size()));
+    }
+    case SITUACAO: {
+        int estacao = triagem.estacao_de(id);
+        if (estacao != -1) {
+            return "Em tratamento na estação " + QString::number(estacao + 1);
+        }
+        return triagem.na_fila(id) ? "Esperando" : "Fora da fila";
+    }
+    case ADMISSAO:
+        return horario_de(telemetria, telemetria.instantes(id).admissao);
+    case CHAMADO:
+        return horario_de(telemetria, telemetria.instantes(id).chamada);
+    case ALTA:
+        return horario_de(telemetria, telemetria.instantes(id).alta);
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief Nome ou email de um paciente: da memória ou, se ele foi selado, da página do histórico que o contém.
+ * Os pacientes selados nunca mudam, de modo que a página vale até o fim dos IDs que já eram
+ * selados quando ela foi lida.
+ */
+std::string_view ModeloPacientes::texto(int id, int coluna) const
+{
+    const ArmazemPacientes& pacientes = triagem.pacientes();
+    const Historico* historico = triagem.historico_em_uso();
+    if (static_cast<std::size_t>(id) >= pacientes.sem_textos() || historico == nullptr) {
+        return coluna == NOME ? pacientes.nome(id) : pacientes.email(id);
+    }
+    if (id < pagina || id >= fim_pagina) {
+        pagina = id - id % PAGINA_HISTORICO;
+        fim_pagina = std::min(pagina + PAGINA_HISTORICO, static_cast<int>(pacientes.sem_textos()));
+        nomes_pagina.assign(PAGINA_HISTORICO, std::string());
+        emails_pagina.assign(PAGINA_HISTORICO, std::string());
+        Historico::Consulta consulta;
+        consulta.primeiro_id = pagina;
+        consulta.ultimo_id = fim_pagina - 1;
+        historico->consultar(triagem, consulta, [&](const Historico::Registro& registro) {
+            nomes_pagina[registro.id - pagina].assign(registro.nome);
+            emails_pagina[registro.id - pagina].assign(registro.email);
+        });
+    }
+    return coluna == NOME ? nomes_pagina[id - pagina] : emails_pagina[id - pagina];
+}
+
+/**
+ * @brief Nome ou email de todos os pacientes admitidos, em ordem de ID, para ordenar o relatório.
+ * Os dos pacientes selados vêm de uma única leitura do histórico, em ordem.
+ */
+std::vector<std::string> ModeloPacientes::textos_do_relatorio(int coluna) const
+{
+    const ArmazemPacientes& pacientes = triagem.pacientes();
+    const Historico* historico = triagem.historico_em_uso();
+    std::vector<std::string> textos(triagem.admitidos());
+    std::size_t id = 0;
+    if (historico != nullptr && pacientes.sem_textos() > 0) {
+        Historico::Consulta consulta;
+        consulta.ultimo_id = static_cast<int>(pacientes.sem_textos()) - 1;
+        historico->consultar(triagem, consulta, [&](const Historico::Registro& registro) {
+            textos[registro.id].assign(coluna == NOME ? registro.nome : registro.email);
+        });
+        id = pacientes.sem_textos();
+    }
+    for (; id < textos.size(); ++id) {
+        int i = static_cast<int>(id);
+        textos[id].assign(coluna == NOME ? pacientes.nome(i) : pacientes.email(i));
+    }
+    return textos;
+}
+
+QVariant ModeloPacientes::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal || section < 0 || section >= COLUNAS) {
+        return QVariant();
+    }
+    return QString::fromUtf8(TITULOS[section]);
+}
+
+void ModeloPacientes::sort(int column, Qt::SortOrder order)
+{
+    if (conteudo == NENHUM || column >= COLUNAS) {
+        return;
+    }
+    if (linhas != linhas_atuais()) {
+        // O conteúdo mudou e a atualização ainda não foi aplicada: aplica-a já na nova ordem
+        coluna_ordenada = column;
+        sentido = order;
+        acompanhar(true);
+        return;
+    }
+    emit layoutAboutToBeChanged();
+    coluna_ordenada = column;
+    sentido = order;
+    ordem = ordenar(coluna_ordenada, sentido);
+    emit layoutChanged();
+}
+
+/**
+ * @brief IDs do conteúdo atual na ordem da coluna.
+ * @return IDs de todas as linhas, ou vazio para o relatório na ordem de chegada.
+ */
+std::vector<int> ModeloPacientes::ordenar(int coluna, Qt::SortOrder sentido) const
+{
+    if (conteudo == NENHUM) {
+        return {};
+    }
+
+    std::vector<int> ids;
+    if (conteudo == FILA) {
+        // A ordem de atendimento é a natural e desempata as demais colunas; a de nomes vem pronta do índice
+        ids = coluna == NOME ? triagem.listar_por_nome() : triagem.listar();
+    } else {
+        if (coluna < 0 || (coluna == ID && sentido == Qt::AscendingOrder)) {
+            return {};
+        }
+        ids.resize(triagem.admitidos());
+        std::iota(ids.begin(), ids.end(), 0);
+    }
+
+    const ArmazemPacientes& pacientes = triagem.pacientes();
+    switch (coluna) {
+    case ID:
+        std::sort(ids.begin(), ids.end());
+        break;
+    case NOME:
+        if (conteudo == RELATORIO) {
+            // Não há índice de nomes fora da fila: ordena pelas mesmas chaves em minúsculas do índice
+            std::vector<std::string> nomes = textos_do_relatorio(NOME);
+            std::vector<std::pair<std::string, int>> chaves;
+            chaves.reserve(ids.size());
+            for (int id : ids) {
+                chaves.emplace_back(minusculas(nomes[id]), id);
+            }
+            std::sort(chaves.begin(), chaves.end());
+            for (std::size_t i = 0; i < chaves.size(); ++i) {
+                ids[i] = chaves[i].second;
+            }
+        }
+        break;
+    case CPF:
+        ordenar_por(ids, [&](int id) { return pacientes.cpf(id); });
+        break;
+    case EMAIL:
+        if (conteudo == RELATORIO) {
+            std::vector<std::string> emails = textos_do_relatorio(EMAIL);
+            ordenar_por(ids, [&](int id) { return std::string_view(emails[id]); });
+        } else {
+            ordenar_por(ids, [&](int id) { return pacientes.email(id); });
+        }
+        break;
+    case NASCIMENTO:
+    case IDADE:
+        if (conteudo == RELATORIO) {
+            // O índice de nascimentos já tem todos os pacientes nessa ordem, com os empates por ID
+            ids = triagem.nascimentos().buscar(std::numeric_limits<long long>::min(),
+                                               std::numeric_limits<long long>::max(), IndiceSintomas::TODOS);
+            if (coluna == IDADE) {
+                // Do mais novo ao mais velho, mantendo os empates por ID
+                std::reverse(ids.begin(), ids.end());
+                for (auto inicio = ids.begin(); inicio != ids.end();) {
+                    auto fim = std::find_if(inicio, ids.end(), [&](int id) {
+                        return pacientes.nascimento(id) != pacientes.nascimento(*inicio);
+                    });
+                    std::reverse(inicio, fim);
+                    inicio = fim;
+                }
+            }
+        } else if (coluna == NASCIMENTO) {
+            ordenar_por(ids, [&](int id) { return pacientes.nascimento(id); });
+        } else {
+            ordenar_por(ids, [&](int id) { return -pacientes.nascimento(id); });
+        }
+        break;
+    case SINTOMAS:
+        ordenar_por(ids, [&](int id) { return pacientes.sintomas(id); });
+        break;
+    case SITUACAO:
+        // Em tratamento, esperando e fora da fila
+        ordenar_por(ids, [&](int id) {
+            return triagem.estacao_de(id) != -1 ? 0 : triagem.na_fila(id) ? 1 : 2;
+        });
+        break;
+    case ADMISSAO:
+        ordenar_por(ids, [&](int id) { return telemetria.instantes(id).admissao; });
+        break;
+    case CHAMADO:
+        ordenar_por(ids, [&](int id) { return telemetria.instantes(id).chamada; });
+        break;
+    case ALTA:
+        ordenar_por(ids, [&](int id) { return telemetria.instantes(id).alta; });
+        break;
+    default:
+        break;
+    }
+    if (coluna >= 0 && sentido == Qt::DescendingOrder) {
+        std::reverse(ids.begin(), ids.end());
+    }
+    return ids;
+}
@@ -0,0 +1,104 @@
+#ifndef MODELOPACIENTES_H
+#define MODELOPACIENTES_H
+
+#include <QAbstractTableModel>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Telemetria;
+class Triagem;
+
+/**
+ * @brief Tabela de pacientes para a interface, lida diretamente da triagem.
+ *
+ * Não guarda os textos exibidos: cada célula é formatada a partir do
+ * armazenamento quando a vista pede, e a vista só pede as linhas visíveis.
+ * A fila guarda apenas os IDs na ordem exibida; o relatório de todos os
+ * admitidos, na ordem de chegada, não guarda nada, porque a linha é o ID.
+ * Os nomes e emails dos pacientes selados no histórico em disco não estão
+ * mais na memória: o relatório os lê do histórico (ver Historico::consultar),
+ * uma página de IDs consecutivos de cada vez, e só a página da última linha
+ * pedida fica guardada.
+ *
+ * A ordenação por nome na fila percorre o índice de nomes da triagem; a ordem
+ * de atendimento vem da fila de prioridade e a de chegada é a dos IDs. As
+ * demais colunas são ordenadas pelos campos do armazenamento.
+ */
+class ModeloPacientes : public QAbstractTableModel
+{
+public:
+    enum Coluna {
+        ID,
+        NOME,
+        CPF,
+        EMAIL,
+        NASCIMENTO,
+        IDADE,
+        SINTOMAS,
+        SITUACAO,
+        ADMISSAO,
+        CHAMADO,
+        ALTA,
+        COLUNAS
+    };
+
+    // Pacientes exibidos
+    enum Conteudo {
+        NENHUM,    // Tabela vazia
+        FILA,      // Pacientes da fila, na ordem de atendimento
+        RELATORIO  // Todos os pacientes admitidos, na ordem de chegada
+    };
+
+    ModeloPacientes(const Triagem& triagem, const Telemetria& telemetria, QObject* parent = nullptr);
+
+    /**
+     * @brief Passa a exibir o conteúdo informado, na ordem natural dele.
+     */
+    void exibir(Conteudo conteudo);
+
+    /**
+     * @brief Acompanha as mudanças da fila desde a última atualização: admissões, remoções, chamados e altas.
+     * Reconstrói a ordem exibida em O(n log n); a interface acumula as mudanças
+     * e chama atualizar() no máximo uma vez por intervalo (ver
+     * MainWindow::tabela_mudou), e não a cada mudança. As linhas que entraram ou
+     * saíram são inseridas ou retiradas no fim, de modo que a vista mantém a
+     * posição de rolagem, e as linhas existentes são marcadas como alteradas
+     * por um único sinal; só as visíveis são formatadas de novo. Até a próxima
+     * atualização, a tabela exibe os pacientes da atualização anterior.
+     */
+    void atualizar();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Ordena pela coluna; uma coluna negativa volta à ordem natural do conteúdo.
+     */
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+private:
+    int id_da_linha(int linha) const { return ordem.empty() ? linha : ordem[linha]; }
+    void acompanhar(bool reordenar);
+    int linhas_atuais() const;
+    std::vector<int> ordenar(int coluna, Qt::SortOrder sentido) const;
+    std::string_view texto(int id, int coluna) const;
+    std::vector<std::string> textos_do_relatorio(int coluna) const;
+
+    const Triagem& triagem;
+    const Telemetria& telemetria;
+    Conteudo conteudo = NENHUM;
+    int linhas = 0;                   // Linhas exibidas
+    std::vector<int> ordem;           // ID de cada linha (vazio no relatório na ordem de chegada: a linha é o ID)
+    int coluna_ordenada = -1;         // Coluna da ordenação atual (-1 para a ordem natural)
+    Qt::SortOrder sentido = Qt::AscendingOrder;
+    long long hoje;                   // Dia juliano usado no cálculo das idades
+    mutable int pagina = 0;           // Primeiro ID da página de textos lida do histórico
+    mutable int fim_pagina = 0;       // Fim (exclusivo) dos IDs válidos da página; 0 se nenhuma foi lida
+    mutable std::vector<std::string> nomes_pagina;  // Nomes da página, pela posição do ID nela
+    mutable std::vector<std::string> emails_pagina; // Emails da página
+};
+
+#endif // MODELOPACIENTES_H
@@ -0,0 +1,107 @@
+#ifndef ORDENACAO_H
+#define ORDENACAO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Calcula a ordem de atendimento de n itens com radix sort estável.
+ *
+ * A chave de ordenação é (prioridade decrescente, chegada crescente), com a
+ * prioridade em 64 bits com sinal e a chegada em 32 bits, ordenada por
+ * passagens de counting sort de 8 bits (O(n)). Só os dígitos em que algum item
+ * difere do primeiro são ordenados: com as flags de sintomas como prioridade
+ * bastam no máximo 5 passagens, e com as chaves envelhecidas do Escalonador,
+ * algumas a mais. Itens com a mesma prioridade ficam sempre em ordem de chegada.
+ *
+ * @param n Quantidade de itens.
+ * @param prioridade Função que recebe o índice do item e retorna sua prioridade.
+ * @param chegada Função que recebe o índice do item e retorna sua ordem de chegada (não negativa).
+ * @return Índices dos itens na ordem de atendimento.
+ */
+template <typename Prioridade, typename Chegada>
+std::vector<std::size_t> ordem_por_prioridade(std::size_t n, Prioridade prioridade, Chegada chegada)
+{
+    struct Item {
+        std::uint64_t chave;   // Prioridade invertida, para ordem decrescente
+        std::uint32_t chegada; // Ordem de chegada
+        std::size_t indice;    // Índice original do item
+    };
+
+    std::vector<Item> itens(n);
+    std::vector<Item> auxiliar(n);
+    std::uint64_t chaves_diferentes = 0;   // Bits em que alguma chave difere da primeira
+    std::uint32_t chegadas_diferentes = 0; // Idem para as chegadas
+    for (std::size_t i = 0; i < n; ++i) {
+        // Inverter os bits ordena as prioridades de forma decrescente; o bit de sinal vai junto
+        std::uint64_t p = static_cast<std::uint64_t>(static_cast<std::int64_t>(prioridade(i)));
+        itens[i] = Item{~(p ^ (std::uint64_t(1) << 63)), static_cast<std::uint32_t>(chegada(i)), i};
+        chaves_diferentes |= itens[i].chave ^ itens[0].chave;
+        chegadas_diferentes |= itens[i].chegada ^ itens[0].chegada;
+    }
+
+    // Counting sort estável por dígito de 8 bits, do menos para o mais significativo:
+    // primeiro os 4 dígitos da chegada, depois os 8 da prioridade
+    for (unsigned passagem = 0; passagem < 12; ++passagem) {
+        const bool da_chegada = passagem < 4;
+        const unsigned deslocamento = (da_chegada ? passagem : passagem - 4) * 8;
+        const std::uint64_t diferentes = da_chegada ? chegadas_diferentes : chaves_diferentes;
+        if (((diferentes >> deslocamento) & 0xFF) == 0) {
+            continue; // Todos os itens têm o mesmo dígito
+        }
+        auto digito = [&](const Item& item) {
+            return static_cast<std::size_t>(((da_chegada ? item.chegada : item.chave) >> deslocamento) & 0xFF);
+        };
+
+        std::size_t contagem[256] = {0};
+        for (const Item& item : itens) {
+            contagem[digito(item)]++;
+        }
+
+        // Converte as contagens em posições iniciais de cada dígito
+        std::size_t inicio = 0;
+        for (std::size_t& c : contagem) {
+            std::size_t quantidade = c;
+            c = inicio;
+            inicio += quantidade;
+        }
+
+        for (const Item& item : itens) {
+            auxiliar[contagem[digito(item)]++] = item;
+        }
+        itens.swap(auxiliar);
+    }
+
+    std::vector<std::size_t> ordem(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ordem[i] = itens[i].indice;
+    }
+    return ordem;
+}
+
+/**
+ * @brief Ordena um vetor de itens por prioridade decrescente e chegada crescente.
+ * A ordenação é estável e linear; os itens são movidos uma única vez.
+ * @param itens Vetor a ser ordenado.
+ * @param prioridade Função que recebe um item e retorna sua prioridade.
+ * @param chegada Função que recebe um item e retorna sua ordem de chegada.
+ */
+template <typename T, typename Prioridade, typename Chegada>
+void ordenar_por_prioridade(std::vector<T>& itens, Prioridade prioridade, Chegada chegada)
+{
+    std::vector<std::size_t> ordem = ordem_por_prioridade(
+        itens.size(),
+        [&](std::size_t i) { return prioridade(itens[i]); },
+        [&](std::size_t i) { return chegada(itens[i]); });
+
+    std::vector<T> ordenados;
+    ordenados.reserve(itens.size());
+    for (std::size_t i : ordem) {
+        ordenados.push_back(std::move(itens[i]));
+    }
+    itens.swap(ordenados);
+}
+
+#endif // ORDENACAO_H
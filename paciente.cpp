@@ -0,0 +1,17 @@
+#include "paciente.h"
+
+#include <utility>
+
+#include "cpf.h"
+
+// Implementação do construtor da classe Patient
+Patient::Patient(int id, std::string name, std::string cpf, std::string email, long long bday, unsigned sintomas)
+    : id(id)
+    , name(std::move(name))
+    , cpf(std::move(cpf))
+    , email(std::move(email))
+    , bday(bday)
+    , sintomas(sintomas)
+{
+    this->cpf_chave = cpf_para_chave(this->cpf);               // Converte o CPF uma única vez para a chave compacta
+}
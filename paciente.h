@@ -0,0 +1,43 @@
+#ifndef PACIENTE_H
+#define PACIENTE_H
+
+#include <cstdint>
+#include <string>
+
+// Enumeração para representar os diferentes sintomas usando flags binárias
+typedef enum{
+    TOSSE = 1,
+    NAUSEA = 2,
+    FEBRE = 4,
+    DISENTERIA = 8,
+    INFECCAO = 16,
+    COVID = 32,
+    AVC = 64,
+    ACIDENTE = 128
+} SINTOMAS;
+
+// Registro completo de um paciente, montado para exibição a partir do armazenamento (ver ArmazemPacientes)
+class Patient
+{
+public:
+    /**
+     * @brief Construtor da classe Patient.
+     * @param id Identificador único do paciente.
+     * @param name Nome do paciente (UTF-8).
+     * @param cpf CPF do paciente.
+     * @param email Email do paciente.
+     * @param bday Data de nascimento do paciente (dia juliano, ver data.h).
+     * @param sintomas Sintomas do paciente representados por flags binárias.
+     */
+    Patient(int id, std::string name, std::string cpf, std::string email, long long bday, unsigned sintomas);
+
+    int id;                  // Identificador único do paciente
+    std::string name;        // Nome do paciente
+    std::string cpf;         // CPF do paciente
+    std::uint64_t cpf_chave; // CPF compactado em inteiro (ver cpf.h)
+    std::string email;       // Email do paciente
+    long long bday;          // Data de nascimento do paciente (dia juliano)
+    unsigned sintomas;       // Sintomas do paciente representados por flags binárias
+};
+
+#endif // PACIENTE_H
@@ -0,0 +1,94 @@
+#include "protocolo.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "binario.h"
+
+std::string Protocolo::caminho_padrao()
+{
+    const char* diretorio = std::getenv("XDG_RUNTIME_DIR");
+    return std::string(diretorio != nullptr && *diretorio != '\0' ? diretorio : "/tmp") + "/b1.sock";
+}
+
+std::size_t Protocolo::iniciar_quadro(std::vector<char>& buffer)
+{
+    std::size_t inicio = buffer.size();
+    buffer.resize(inicio + sizeof(std::uint32_t));
+    return inicio;
+}
+
+void Protocolo::concluir_quadro(std::vector<char>& buffer, std::size_t inicio)
+{
+    std::uint32_t tamanho = static_cast<std::uint32_t>(buffer.size() - inicio - sizeof(std::uint32_t));
+    std::memcpy(buffer.data() + inicio, &tamanho, sizeof(tamanho));
+}
+
+long long Protocolo::quadro_completo(const char* dados, std::size_t tamanho)
+{
+    std::uint32_t conteudo;
+    if (tamanho < sizeof(conteudo)) {
+        return 0;
+    }
+    std::memcpy(&conteudo, dados, sizeof(conteudo));
+    if (conteudo > MAXIMO_QUADRO) {
+        return -1;
+    }
+    std::size_t total = sizeof(conteudo) + conteudo;
+    return tamanho >= total ? static_cast<long long>(total) : 0;
+}
+
+void Protocolo::escrever_paciente(Escritor& saida, const Paciente& paciente)
+{
+    saida.i32(paciente.id);
+    saida.u64(paciente.cpf);
+    saida.texto(paciente.nome);
+    saida.texto(paciente.email);
+    saida.i32(paciente.nascimento);
+    saida.u8(static_cast<std::uint8_t>(paciente.sintomas));
+    saida.i32(paciente.estacao);
+}
+
+bool Protocolo::ler_paciente(Leitor& entrada, Paciente& paciente)
+{
+    std::string_view nome, email;
+    std::uint8_t sintomas;
+    if (!entrada.i32(paciente.id) || !entrada.u64(paciente.cpf) || !entrada.texto(nome) || !entrada.texto(email) ||
+        !entrada.i32(paciente.nascimento) || !entrada.u8(sintomas) || !entrada.i32(paciente.estacao)) {
+        return false;
+    }
+    paciente.nome.assign(nome);
+    paciente.email.assign(email);
+    paciente.sintomas = sintomas;
+    return true;
+}
+
+void Protocolo::escrever_notificacao(Escritor& saida, const Notificacao& notificacao)
+{
+    saida.u64(notificacao.versao);
+    saida.u32(notificacao.tamanho);
+    saida.u32(static_cast<std::uint32_t>(notificacao.estacoes.size()));
+    for (const Estacao& estacao : notificacao.estacoes) {
+        saida.i32(estacao.paciente);
+        saida.u8(estacao.evento);
+        saida.texto(estacao.nome);
+    }
+}
+
+bool Protocolo::ler_notificacao(Leitor& entrada, Notificacao& notificacao)
+{
+    std::uint32_t quantidade;
+    if (!entrada.u64(notificacao.versao) || !entrada.u32(notificacao.tamanho) || !entrada.u32(quantidade) ||
+        quantidade > entrada.restante() / (sizeof(std::int32_t) + 1 + sizeof(std::uint32_t))) {
+        return false;
+    }
+    notificacao.estacoes.resize(quantidade);
+    for (Estacao& estacao : notificacao.estacoes) {
+        std::string_view nome;
+        if (!entrada.i32(estacao.paciente) || !entrada.u8(estacao.evento) || !entrada.texto(nome)) {
+            return false;
+        }
+        estacao.nome.assign(nome);
+    }
+    return true;
+}
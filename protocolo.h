@@ -0,0 +1,120 @@
+#ifndef PROTOCOLO_H
+#define PROTOCOLO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Escritor;
+class Leitor;
+
+/**
+ * @brief Protocolo binário entre o serviço da triagem (b1d) e os seus clientes.
+ *
+ * As mensagens trafegam em quadros: um u32 com o tamanho do restante do quadro
+ * seguido do conteúdo, codificado com Escritor/Leitor (binario.h), na ordem de
+ * bytes da máquina; o protocolo é local (socket Unix) e os dois lados rodam na
+ * mesma máquina.
+ *
+ * Pedido:   u32 id, u8 operação, argumentos.
+ * Resposta: u32 id do pedido, u8 status, resultado.
+ *
+ * O cliente escolhe os ids (diferentes de NOTIFICACAO_ID) e pode enviar vários
+ * pedidos sem esperar as respostas (pipelining), inclusive em uma única
+ * escrita; o serviço os aplica e responde na ordem em que chegaram. Os
+ * clientes que pedem ASSINAR passam a receber, como respostas com o id
+ * NOTIFICACAO_ID e status OK, uma Notificacao com o estado atual e outra a
+ * cada mudança da fila ou das estações.
+ *
+ * Argumentos e resultados de cada operação:
+ * - ADMITIR e ATUALIZAR: texto nome, texto CPF, texto email, i32 nascimento
+ *   (dia juliano), u8 sintomas; resultado u8 (1 se admitido, 0 se atualizado) e
+ *   i32 ID. ATUALIZAR responde NAO_ENCONTRADO se o CPF não estiver na fila. Nome
+ *   vazio, sintomas 0 ou nascimento fora dos anos 1 a 9999 ou no futuro dão PEDIDO_INVALIDO.
+ * - REMOVER: texto CPF; sem resultado.
+ * - CONSULTAR: texto CPF; resultado Paciente.
+ * - LISTAR: u32 limite; resultado u32 quantidade e os Pacientes em ordem de atendimento.
+ * - PROXIMO: sem argumentos; resultado Paciente (o próximo a ser chamado) ou NAO_ENCONTRADO.
+ * - ASSINAR: sem argumentos nem resultado.
+ */
+class Protocolo
+{
+public:
+    enum Operacao : std::uint8_t {
+        ADMITIR = 1,
+        ATUALIZAR = 2,
+        REMOVER = 3,
+        CONSULTAR = 4,
+        LISTAR = 5,
+        PROXIMO = 6,
+        ASSINAR = 7
+    };
+
+    enum Status : std::uint8_t {
+        OK = 0,
+        NAO_ENCONTRADO = 1,  // Não há paciente com o CPF na fila (ou a fila está vazia)
+        CPF_MAL_FORMADO = 2, // O CPF não tem um formato aceito ou os dígitos verificadores não conferem
+        PEDIDO_INVALIDO = 3, // Operação desconhecida ou argumentos incompletos ou inválidos
+        SEM_CONEXAO = 255    // Nunca enviado pelo serviço: o cliente perdeu a conexão ou recebeu dados inválidos
+    };
+
+    static const std::uint32_t NOTIFICACAO_ID = 0;        // Id das notificações enviadas aos assinantes
+    static const std::size_t MAXIMO_QUADRO = 16u << 20;   // Tamanho máximo do conteúdo de um quadro
+
+    // Paciente da fila, como aparece nas respostas
+    struct Paciente {
+        std::int32_t id = -1;      // ID do paciente
+        std::uint64_t cpf = 0;     // Chave do CPF (ver cpf.h)
+        std::string nome;
+        std::string email;
+        std::int32_t nascimento = 0; // Dia juliano
+        unsigned sintomas = 0;       // Sintomas representados por flags binárias
+        std::int32_t estacao = -1;   // Estação onde está em tratamento (-1 se espera)
+    };
+
+    // Estado de uma estação de tratamento em uma notificação
+    struct Estacao {
+        std::int32_t paciente = -1; // ID do paciente em tratamento (-1 se a estação está livre)
+        std::uint8_t evento = 0;    // Último evento (ver Escalonador::EventoTratamento)
+        std::string nome;           // Nome do paciente em tratamento
+    };
+
+    // Notificação de mudança enviada aos assinantes
+    struct Notificacao {
+        std::uint64_t versao = 0;      // Quantidade de mudanças aplicadas pelo serviço
+        std::uint32_t tamanho = 0;     // Pacientes na fila, incluindo os em tratamento
+        std::vector<Estacao> estacoes; // Estações de tratamento
+    };
+
+    /**
+     * @brief Caminho padrão do socket: b1.sock em $XDG_RUNTIME_DIR, ou em /tmp se ela não estiver definida.
+     */
+    static std::string caminho_padrao();
+
+    /**
+     * @brief Reserva o tamanho de um novo quadro no fim do buffer.
+     * @return Posição do quadro, a ser passada a concluir_quadro().
+     */
+    static std::size_t iniciar_quadro(std::vector<char>& buffer);
+
+    /**
+     * @brief Grava o tamanho do quadro iniciado em inicio, depois que o conteúdo foi escrito.
+     */
+    static void concluir_quadro(std::vector<char>& buffer, std::size_t inicio);
+
+    /**
+     * @brief Verifica se os dados começam com um quadro completo.
+     * @return Tamanho total do quadro (com o tamanho), 0 se faltam dados, ou -1
+     *         se o quadro excede MAXIMO_QUADRO.
+     */
+    static long long quadro_completo(const char* dados, std::size_t tamanho);
+
+    static void escrever_paciente(Escritor& saida, const Paciente& paciente);
+    static bool ler_paciente(Leitor& entrada, Paciente& paciente);
+    static void escrever_notificacao(Escritor& saida, const Notificacao& notificacao);
+    static bool ler_notificacao(Leitor& entrada, Notificacao& notificacao);
+};
+
+#endif // PROTOCOLO_H
@@ -0,0 +1,257 @@
+#include "recepcao.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "cpf.h"
+#include "texto.h"
+
+// Intervalo máximo de sono do dono sem pedidos, como garantia contra um aviso perdido
+static const std::chrono::milliseconds SONO_MAXIMO(100);
+
+void Retrato::indexar() const
+{
+    por_cpf.reserve(fila.size());
+    por_nome.reserve(fila.size());
+    for (std::size_t i = 0; i < fila.size(); ++i) {
+        por_cpf.emplace_back(fila[i].cpf, static_cast<int>(i));
+        por_nome.emplace_back(minusculas(nome(fila[i])), static_cast<int>(i));
+    }
+    std::sort(por_cpf.begin(), por_cpf.end());
+    std::sort(por_nome.begin(), por_nome.end());
+}
+
+int Retrato::buscar_cpf(std::uint64_t cpf_chave) const
+{
+    std::call_once(indexado, [this] { indexar(); });
+    auto it = std::lower_bound(por_cpf.begin(), por_cpf.end(), std::make_pair(cpf_chave, -1));
+    return it != por_cpf.end() && it->first == cpf_chave ? it->second : -1;
+}
+
+std::vector<int> Retrato::buscar_nome(std::string_view nome) const
+{
+    std::call_once(indexado, [this] { indexar(); });
+    std::string chave = minusculas(nome);
+    auto it = std::lower_bound(por_nome.begin(), por_nome.end(), std::make_pair(chave, -1));
+    std::vector<int> posicoes;
+    for (; it != por_nome.end() && it->first == chave; ++it) {
+        posicoes.push_back(it->second);
+    }
+    return posicoes;
+}
+
+Recepcao::Recepcao(Triagem& triagem, std::size_t capacidade, std::chrono::milliseconds intervalo_retrato)
+    : triagem(triagem), pedidos(capacidade), intervalo_retrato(intervalo_retrato),
+      atual(std::make_shared<const Retrato>())
+{
+}
+
+Recepcao::~Recepcao()
+{
+    parar();
+}
+
+void Recepcao::iniciar(std::chrono::milliseconds passo)
+{
+    if (dono.joinable()) {
+        return;
+    }
+    this->passo = passo;
+    encerrar = false;
+    publicar(); // A triagem ainda não é compartilhada: o primeiro retrato sai deste thread
+    dono = std::thread(&Recepcao::executar_dono, this);
+}
+
+void Recepcao::parar()
+{
+    if (!dono.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guarda(trava);
+        encerrar = true;
+    }
+    acordar.notify_one();
+    dono.join();
+}
+
+// Entrega o pedido ao anel e acorda o dono se ele estiver dormindo
+Recepcao::Envio Recepcao::enviar(Pedido&& pedido)
+{
+    if (!pedidos.enviar(std::move(pedido))) {
+        return CHEIA;
+    }
+    // Ou o dono vê o pedido antes de dormir, ou este thread o vê dormindo (ver executar_dono)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (dono_dormindo.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> guarda(trava);
+        acordar.notify_one();
+    }
+    return ENVIADO;
+}
+
+Recepcao::Envio Recepcao::admitir(std::string_view nome, std::string_view cpf, std::string_view email,
+                                  long long nascimento, unsigned sintomas)
+{
+    Pedido pedido;
+    pedido.cpf = cpf_para_chave(cpf.data(), cpf.size());
+    if (pedido.cpf == CPF_INVALIDO) {
+        return CPF_MAL_FORMADO;
+    }
+    pedido.tipo = Pedido::ADMISSAO;
+    pedido.nome.assign(nome);
+    pedido.email.assign(email);
+    pedido.nascimento = nascimento;
+    pedido.sintomas = sintomas;
+    return enviar(std::move(pedido));
+}
+
+Recepcao::Envio Recepcao::remover(std::string_view cpf)
+{
+    Pedido pedido;
+    pedido.cpf = cpf_para_chave(cpf.data(), cpf.size());
+    if (pedido.cpf == CPF_INVALIDO) {
+        return CPF_MAL_FORMADO;
+    }
+    pedido.tipo = Pedido::REMOCAO;
+    return enviar(std::move(pedido));
+}
+
+Recepcao::Envio Recepcao::executar(std::function<void(Triagem&)> tarefa)
+{
+    Pedido pedido;
+    pedido.tipo = Pedido::TAREFA;
+    pedido.tarefa = std::move(tarefa);
+    return enviar(std::move(pedido));
+}
+
+void Recepcao::sincronizar()
+{
+    const std::uint64_t alvo = pedidos.reservados();
+    std::unique_lock<std::mutex> guarda(trava);
+    aguardando.fetch_add(1);
+    acordar.notify_one();
+    publicado.wait(guarda, [&] { return versao_publicada >= alvo || encerrar; });
+    aguardando.fetch_sub(1);
+}
+
+/**
+ * @brief Retira do anel até LOTE pedidos e os aplica na triagem, em ordem.
+ * Admissões seguidas são aplicadas de uma só vez por Triagem::admitir_lote.
+ * @return false se não havia pedidos.
+ */
+bool Recepcao::aplicar_lote()
+{
+    Pedido pedido;
+    while (lote.size() < LOTE && pedidos.receber(pedido)) {
+        lote.push_back(std::move(pedido));
+    }
+    if (lote.empty()) {
+        return false;
+    }
+
+    std::vector<Triagem::Cadastro> cadastros;
+    auto admitir_pendentes = [&] {
+        if (!cadastros.empty()) {
+            triagem.admitir_lote(cadastros);
+            cadastros.clear();
+        }
+    };
+    for (Pedido& p : lote) {
+        if (p.tipo == Pedido::ADMISSAO) {
+            cadastros.push_back(Triagem::Cadastro{p.cpf, p.nome, p.email, p.nascimento, p.sintomas});
+        } else if (p.tipo == Pedido::REMOCAO) {
+            admitir_pendentes();
+            triagem.remover_chave(p.cpf);
+        } else {
+            admitir_pendentes();
+            p.tarefa(triagem);
+        }
+    }
+    admitir_pendentes();
+
+    aplicados += lote.size();
+    lote.clear();
+    return true;
+}
+
+// Monta o retrato da triagem e o publica; só o dono (ou iniciar(), antes dele)
+void Recepcao::publicar()
+{
+    auto retrato = std::make_shared<Retrato>();
+    retrato->versao = aplicados;
+    retrato->admitidos = triagem.admitidos();
+    retrato->estacoes = triagem.estacoes();
+    const ArmazemPacientes& armazem = triagem.pacientes();
+    std::vector<int> ids = triagem.listar();
+    retrato->fila.reserve(ids.size());
+    for (int id : ids) {
+        retrato->fila.push_back(Retrato::Linha{id, retrato->nomes.guardar(armazem.nome(id)), armazem.cpf(id),
+                                               armazem.nascimento(id), armazem.sintomas(id),
+                                               triagem.estacao_de(id)});
+    }
+    std::atomic_store(&atual, std::shared_ptr<const Retrato>(std::move(retrato)));
+
+    {
+        std::lock_guard<std::mutex> guarda(trava);
+        versao_publicada = aplicados;
+    }
+    publicado.notify_all();
+}
+
+// Laço do dono: aplica os pedidos, avança o tratamento e publica os retratos
+void Recepcao::executar_dono()
+{
+    using Relogio = std::chrono::steady_clock;
+    Relogio::time_point proximo_passo = Relogio::now() + passo;
+    Relogio::time_point ultimo_retrato = Relogio::now();
+    bool mudou = false; // Há mudanças ainda fora do retrato
+
+    while (true) {
+        bool aplicou = aplicar_lote();
+        mudou = mudou || aplicou;
+
+        Relogio::time_point agora = Relogio::now();
+        if (passo.count() > 0 && agora >= proximo_passo) {
+            mudou = triagem.avancar() || mudou;
+            proximo_passo += passo;
+            if (proximo_passo <= agora) {
+                proximo_passo = agora + passo; // Atrasado: não tenta recuperar os passos perdidos
+            }
+        }
+
+        // Quem espera em sincronizar() recebe o retrato assim que o anel se esvazia
+        bool pedido_urgente = aguardando.load() > 0 && pedidos.vazio();
+        if (mudou && (pedido_urgente || agora - ultimo_retrato >= intervalo_retrato)) {
+            publicar();
+            mudou = false;
+            ultimo_retrato = agora;
+        }
+        if (aplicou) {
+            continue;
+        }
+
+        // Sem pedidos: dorme até o próximo passo, o próximo retrato ou um novo pedido
+        std::unique_lock<std::mutex> guarda(trava);
+        if (encerrar) {
+            guarda.unlock();
+            while (aplicar_lote()) {
+            }
+            publicar();
+            return;
+        }
+        Relogio::time_point prazo = agora + SONO_MAXIMO;
+        if (passo.count() > 0) {
+            prazo = std::min(prazo, proximo_passo);
+        }
+        if (mudou) {
+            prazo = std::min(prazo, ultimo_retrato + intervalo_retrato);
+        }
+        dono_dormindo.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (pedidos.vazio() && !(mudou && aguardando.load() > 0)) {
+            acordar.wait_until(guarda, prazo);
+        }
+        dono_dormindo.store(false, std::memory_order_relaxed);
+    }
+}
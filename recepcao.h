@@ -0,0 +1,191 @@
+#ifndef RECEPCAO_H
+#define RECEPCAO_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "anel.h"
+#include "tabelatexto.h"
+#include "triagem.h"
+
+/**
+ * @brief Retrato imutável da fila, publicado pela Recepcao para consultas de outros threads.
+ *
+ * Contém os pacientes da fila em ordem de atendimento e as estações no momento
+ * em que foi tirado; todas as consultas de um mesmo retrato enxergam o mesmo
+ * estado, mesmo que a triagem mude enquanto ele é lido. Os índices de CPF e de
+ * nome são montados apenas na primeira busca, pelo thread que a faz, de modo
+ * que o thread da triagem só paga pela cópia da fila.
+ */
+class Retrato
+{
+public:
+    // Paciente da fila no momento do retrato
+    struct Linha {
+        int id;                 // ID do paciente
+        std::uint32_t nome;     // Nome do paciente (ver nome())
+        std::uint64_t cpf;      // Chave do CPF (ver cpf.h)
+        long long nascimento;   // Data de nascimento (dia juliano)
+        unsigned sintomas;      // Sintomas representados por flags binárias
+        int estacao;            // Estação onde está em tratamento (-1 se espera)
+    };
+
+    std::uint64_t versao = 0;                 // Pedidos aplicados pelo dono até o retrato
+    std::size_t admitidos = 0;                // Pacientes admitidos desde o início
+    std::vector<Linha> fila;                  // Pacientes da fila, em ordem de atendimento
+    std::vector<Triagem::Estacao> estacoes;   // Estações de tratamento
+    TabelaTexto nomes;                        // Nomes dos pacientes da fila
+
+    std::string_view nome(const Linha& linha) const { return nomes.texto(linha.nome); }
+
+    /**
+     * @brief Posição em fila do paciente com o CPF informado, ou -1.
+     */
+    int buscar_cpf(std::uint64_t cpf_chave) const;
+
+    /**
+     * @brief Posições em fila dos pacientes com o nome informado, sem diferenciar maiúsculas de minúsculas.
+     */
+    std::vector<int> buscar_nome(std::string_view nome) const;
+
+private:
+    void indexar() const;
+
+    mutable std::once_flag indexado;
+    mutable std::vector<std::pair<std::uint64_t, int>> por_cpf;  // (CPF, posição), ordenado por CPF
+    mutable std::vector<std::pair<std::string, int>> por_nome;   // (nome em minúsculas, posição), ordenado
+};
+
+/**
+ * @brief Entrada concorrente de pacientes: vários guichês, um dono da triagem.
+ *
+ * A Triagem não é segura para vários threads. A recepção dá a ela um único
+ * dono, um thread que aplica em ordem os pedidos enviados por qualquer outro
+ * thread (guichês de cadastro, importações) por uma fila sem travas
+ * (ver AnelMpsc), avança o tratamento no intervalo configurado e publica, depois
+ * das mudanças, um Retrato da fila para as consultas.
+ *
+ * Os pedidos são retirados em lotes: admissões seguidas viram uma única
+ * chamada de Triagem::admitir_lote, com o diário e a telemetria da triagem
+ * registrando tudo como antes. Enviar um pedido custa a validação do CPF, a
+ * cópia dos textos e uma comparação e troca; o guichê nunca espera pelo dono.
+ * As consultas pegam o retrato mais recente com uma troca de ponteiro e nunca
+ * seguram o dono, que monta o retrato seguinte enquanto os anteriores ainda
+ * são lidos. Como montar um retrato custa O(n), eles são publicados no
+ * máximo uma vez por intervalo_retrato, ou imediatamente em sincronizar().
+ */
+class Recepcao
+{
+public:
+    // Resultado de um envio
+    enum Envio {
+        ENVIADO,         // O pedido será aplicado pelo dono, na ordem de chegada
+        CPF_MAL_FORMADO, // O CPF não tem um formato aceito ou os dígitos verificadores não conferem
+        CHEIA            // A fila de pedidos está cheia; o pedido deve ser reenviado
+    };
+
+    /**
+     * @param triagem Triagem, que a partir de iniciar() só pode ser usada pelo dono.
+     * @param capacidade Quantidade máxima de pedidos aguardando o dono.
+     * @param intervalo_retrato Intervalo mínimo entre dois retratos publicados.
+     */
+    explicit Recepcao(Triagem& triagem, std::size_t capacidade = 1 << 14,
+                      std::chrono::milliseconds intervalo_retrato = std::chrono::milliseconds(50));
+
+    // Aplica os pedidos pendentes e encerra o dono
+    ~Recepcao();
+
+    Recepcao(const Recepcao&) = delete;
+    Recepcao& operator=(const Recepcao&) = delete;
+
+    /**
+     * @brief Inicia o dono da triagem.
+     * @param passo Intervalo entre dois Triagem::avancar(), ou zero para não avançar o tratamento.
+     */
+    void iniciar(std::chrono::milliseconds passo);
+
+    /**
+     * @brief Aplica os pedidos pendentes, publica o último retrato e encerra o dono.
+     */
+    void parar();
+
+    // Pedidos, de qualquer thread
+
+    /**
+     * @brief Pede a admissão de um paciente (ver Triagem::admitir).
+     */
+    Envio admitir(std::string_view nome, std::string_view cpf, std::string_view email, long long nascimento,
+                  unsigned sintomas);
+
+    /**
+     * @brief Pede a remoção do paciente com o CPF informado (ver Triagem::remover).
+     */
+    Envio remover(std::string_view cpf);
+
+    /**
+     * @brief Pede que o dono execute uma operação qualquer na triagem (configurar estações, por exemplo).
+     */
+    Envio executar(std::function<void(Triagem&)> tarefa);
+
+    /**
+     * @brief Aguarda até que os pedidos enviados antes da chamada apareçam em um retrato.
+     * Só deve ser chamado com o dono iniciado; retorna também se o dono for parado.
+     */
+    void sincronizar();
+
+    // Consultas, de qualquer thread
+
+    /**
+     * @brief Retrato mais recente da fila; continua válido enquanto for usado.
+     */
+    std::shared_ptr<const Retrato> retrato() const { return std::atomic_load(&atual); }
+
+private:
+    // Pedido enviado ao dono
+    struct Pedido {
+        enum Tipo { ADMISSAO, REMOCAO, TAREFA } tipo = ADMISSAO;
+        std::uint64_t cpf = 0;
+        std::string nome;
+        std::string email;
+        long long nascimento = 0;
+        unsigned sintomas = 0;
+        std::function<void(Triagem&)> tarefa;
+    };
+
+    Envio enviar(Pedido&& pedido);
+    void executar_dono();
+    bool aplicar_lote();
+    void publicar();
+
+    static const std::size_t LOTE = 4096; // Pedidos retirados do anel de cada vez
+
+    Triagem& triagem;
+    AnelMpsc<Pedido> pedidos;
+    std::chrono::milliseconds intervalo_retrato;
+    std::chrono::milliseconds passo{0};
+    std::shared_ptr<const Retrato> atual;              // Último retrato publicado
+    std::vector<Pedido> lote;                          // Pedidos retirados do anel (só o dono)
+    std::uint64_t aplicados = 0;                       // Pedidos aplicados (só o dono)
+
+    std::atomic<bool> dono_dormindo{false};            // O dono espera por pedidos e precisa ser acordado
+    std::atomic<int> aguardando{0};                    // Threads esperando em sincronizar()
+
+    std::mutex trava;
+    std::condition_variable acordar;                   // Acorda o dono
+    std::condition_variable publicado;                 // Avisa quem espera em sincronizar()
+    std::uint64_t versao_publicada = 0;                // Pedidos aplicados no último retrato (protegido pela trava)
+    bool encerrar = false;                             // Encerrar o dono (protegido pela trava)
+    std::thread dono;
+};
+
+#endif // RECEPCAO_H
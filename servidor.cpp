@@ -0,0 +1,433 @@
+#include "servidor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "binario.h"
+#include "cpf.h"
+#include "data.h"
+#include "triagem.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // Sem a flag (macOS), o serviço ignora SIGPIPE (ver daemon.cpp)
+#endif
+
+// Respostas pendentes a partir das quais a conexão deixa de ser lida
+static const std::size_t LIMITE_SAIDA = 1 << 20;
+// Quantidade máxima de bytes lidos de uma conexão antes de atender os pedidos
+static const std::size_t LIMITE_LEITURA = 1 << 20;
+// Espera máxima do poll(), para verificar o pedido de encerramento
+static const std::chrono::milliseconds ESPERA_MAXIMA(100);
+
+// Confere o nascimento como a importação: a data cai entre os anos 1 e 9999 e não está no futuro
+static bool nascimento_valido(long long nascimento)
+{
+    return nascimento >= dia_juliano(1, 1, 1) && nascimento <= dia_juliano(9999, 12, 31) &&
+           nascimento <= dia_juliano_hoje();
+}
+
+static bool sem_bloqueio(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1 && fcntl(fd, F_SETFD, FD_CLOEXEC) != -1;
+}
+
+Servidor::Servidor(Triagem& triagem)
+    : triagem(triagem)
+{
+}
+
+Servidor::~Servidor()
+{
+    for (Conexao& conexao : conexoes) {
+        close(conexao.fd);
+    }
+    if (escuta != -1) {
+        close(escuta);
+        unlink(caminho.c_str());
+    }
+}
+
+bool Servidor::abrir(const std::string& caminho)
+{
+    sockaddr_un endereco{};
+    endereco.sun_family = AF_UNIX;
+    if (escuta != -1 || caminho.empty() || caminho.size() >= sizeof(endereco.sun_path)) {
+        errno = EINVAL;
+        return false;
+    }
+    std::memcpy(endereco.sun_path, caminho.c_str(), caminho.size() + 1);
+
+    // Só remove o que estiver no caminho se for um socket, nunca um arquivo comum
+    struct stat informacoes;
+    if (lstat(caminho.c_str(), &informacoes) == 0 && S_ISSOCK(informacoes.st_mode)) {
+        unlink(caminho.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return false;
+    }
+    if (!sem_bloqueio(fd) || bind(fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) == -1 ||
+        listen(fd, SOMAXCONN) == -1) {
+        int erro = errno;
+        close(fd);
+        errno = erro;
+        return false;
+    }
+    escuta = fd;
+    this->caminho = caminho;
+    return true;
+}
+
+void Servidor::executar(std::chrono::milliseconds passo, const std::atomic<bool>& parar)
+{
+    this->passo = passo;
+    if (passo.count() > 0) {
+        agenda.agendar(Agenda::Relogio::now() + passo, [this](Agenda::Instante prazo) { passo_tratamento(prazo); });
+    }
+
+    std::vector<pollfd> fds;
+    while (!parar.load()) {
+        // Espera até o próximo passo, limitada para verificar o pedido de encerramento
+        Agenda::Instante agora = Agenda::Relogio::now();
+        Agenda::Instante prazo = std::min(agenda.proximo_prazo(), agora + ESPERA_MAXIMA);
+        int espera = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(prazo - agora + std::chrono::microseconds(999))
+                .count());
+
+        fds.clear();
+        fds.push_back(pollfd{escuta, POLLIN, 0});
+        for (const Conexao& conexao : conexoes) {
+            short eventos = 0;
+            if (!conexao.fim && !saida_cheia(conexao)) {
+                eventos |= POLLIN;
+            }
+            if (conexao.enviados < conexao.saida.size()) {
+                eventos |= POLLOUT;
+            }
+            fds.push_back(pollfd{conexao.fd, eventos, 0});
+        }
+        if (poll(fds.data(), fds.size(), std::max(espera, 0)) == -1 && errno != EINTR) {
+            break;
+        }
+
+        agenda.executar_vencidos(Agenda::Relogio::now());
+
+        // Atende as conexões que já existiam quando o poll() começou
+        for (std::size_t i = 0; i + 1 < fds.size(); ++i) {
+            Conexao& conexao = conexoes[i];
+            short eventos = fds[i + 1].revents;
+            if (eventos & (POLLERR | POLLNVAL)) {
+                conexao.erro = true;
+                continue;
+            }
+            if (eventos & POLLOUT) {
+                enviar(conexao);
+            }
+            if (eventos & (POLLIN | POLLHUP)) {
+                ler(conexao);
+            }
+            atender(conexao);
+            enviar(conexao);
+        }
+        notificar();
+
+        conexoes.erase(std::remove_if(conexoes.begin(), conexoes.end(),
+                                      [](const Conexao& conexao) {
+                                          bool fechar = conexao.erro ||
+                                                        (conexao.fim && conexao.enviados == conexao.saida.size());
+                                          if (fechar) {
+                                              close(conexao.fd);
+                                          }
+                                          return fechar;
+                                      }),
+                       conexoes.end());
+        if (fds[0].revents & POLLIN) {
+            aceitar();
+        }
+    }
+}
+
+void Servidor::aceitar()
+{
+    while (true) {
+        int fd = accept(escuta, nullptr, nullptr);
+        if (fd == -1) {
+            return; // EAGAIN: não há mais conexões pendentes
+        }
+        if (!sem_bloqueio(fd)) {
+            close(fd);
+            continue;
+        }
+        Conexao conexao;
+        conexao.fd = fd;
+        conexoes.push_back(std::move(conexao));
+    }
+}
+
+// Lê tudo o que o cliente já enviou, até LIMITE_LEITURA
+void Servidor::ler(Conexao& conexao)
+{
+    if (conexao.lidos > 0) {
+        conexao.entrada.erase(conexao.entrada.begin(), conexao.entrada.begin() + conexao.lidos);
+        conexao.lidos = 0;
+    }
+    while (!conexao.fim && conexao.entrada.size() < LIMITE_LEITURA) {
+        std::size_t tamanho = conexao.entrada.size();
+        conexao.entrada.resize(tamanho + 65536);
+        ssize_t lido = recv(conexao.fd, conexao.entrada.data() + tamanho, 65536, 0);
+        conexao.entrada.resize(tamanho + std::max<ssize_t>(lido, 0));
+        if (lido == 0) {
+            conexao.fim = true;
+        } else if (lido < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                conexao.erro = true;
+            }
+            return;
+        }
+    }
+}
+
+// Atende os quadros completos recebidos, enquanto houver espaço para as respostas
+void Servidor::atender(Conexao& conexao)
+{
+    while (!conexao.erro && !saida_cheia(conexao)) {
+        const char* dados = conexao.entrada.data() + conexao.lidos;
+        long long quadro = Protocolo::quadro_completo(dados, conexao.entrada.size() - conexao.lidos);
+        if (quadro == 0) {
+            break;
+        }
+        std::uint32_t id;
+        std::uint8_t operacao;
+        Leitor argumentos(dados + sizeof(std::uint32_t), quadro < 0 ? 0 : quadro - sizeof(std::uint32_t));
+        if (quadro < 0 || !argumentos.u32(id) || !argumentos.u8(operacao) || id == Protocolo::NOTIFICACAO_ID) {
+            conexao.erro = true; // Sem o cabeçalho não há como responder: o cliente está fora do protocolo
+            break;
+        }
+        conexao.lidos += static_cast<std::size_t>(quadro);
+
+        std::size_t inicio = Protocolo::iniciar_quadro(conexao.saida);
+        Escritor resposta(conexao.saida);
+        resposta.u32(id);
+        resposta.u8(Protocolo::OK);
+        std::size_t posicao_status = conexao.saida.size() - 1;
+        Protocolo::Status status = atender_pedido(conexao, operacao, argumentos, resposta);
+        if (status != Protocolo::OK) {
+            conexao.saida.resize(posicao_status + 1); // Descarta o resultado parcial
+            conexao.saida[posicao_status] = static_cast<char>(status);
+        }
+        Protocolo::concluir_quadro(conexao.saida, inicio);
+        atendidos++;
+
+        if (operacao == Protocolo::ASSINAR && status == Protocolo::OK) {
+            // O novo assinante recebe o estado atual logo depois da resposta
+            montar_notificacao();
+            conexao.saida.insert(conexao.saida.end(), notificacao.begin(), notificacao.end());
+            conexao.versao_enviada = versao;
+        }
+    }
+    if (conexao.lidos == conexao.entrada.size()) {
+        conexao.entrada.clear();
+        conexao.lidos = 0;
+    }
+}
+
+Protocolo::Status Servidor::atender_pedido(Conexao& conexao, std::uint8_t operacao, Leitor& argumentos,
+                                           Escritor& resultado)
+{
+    switch (operacao) {
+    case Protocolo::ADMITIR:
+    case Protocolo::ATUALIZAR: {
+        std::string_view nome, cpf, email;
+        std::int32_t nascimento;
+        std::uint8_t sintomas;
+        if (!argumentos.texto(nome) || !argumentos.texto(cpf) || !argumentos.texto(email) ||
+            !argumentos.i32(nascimento) || !argumentos.u8(sintomas)) {
+            return Protocolo::PEDIDO_INVALIDO;
+        }
+        if (nome.empty() || sintomas == 0 || !nascimento_valido(nascimento)) {
+            return Protocolo::PEDIDO_INVALIDO;
+        }
+        std::uint64_t chave = cpf_para_chave(cpf.data(), cpf.size());
+        if (chave == CPF_INVALIDO) {
+            return Protocolo::CPF_MAL_FORMADO;
+        }
+        if (operacao == Protocolo::ATUALIZAR && triagem.indice_cpf.buscar(chave) == -1) {
+            return Protocolo::NAO_ENCONTRADO;
+        }
+        Triagem::Admissao admissao = triagem.admitir_chave(chave, nome, email, nascimento, sintomas);
+        versao++;
+        resultado.u8(admissao == Triagem::ADMITIDO ? 1 : 0);
+        resultado.i32(triagem.indice_cpf.buscar(chave));
+        return Protocolo::OK;
+    }
+    case Protocolo::REMOVER:
+    case Protocolo::CONSULTAR: {
+        std::string_view cpf;
+        if (!argumentos.texto(cpf)) {
+            return Protocolo::PEDIDO_INVALIDO;
+        }
+        std::uint64_t chave = cpf_para_chave(cpf.data(), cpf.size());
+        if (chave == CPF_INVALIDO) {
+            return Protocolo::CPF_MAL_FORMADO;
+        }
+        if (operacao == Protocolo::REMOVER) {
+            if (!triagem.remover_chave(chave)) {
+                return Protocolo::NAO_ENCONTRADO;
+            }
+            versao++;
+            return Protocolo::OK;
+        }
+        int id = triagem.indice_cpf.buscar(chave);
+        if (id == -1) {
+            return Protocolo::NAO_ENCONTRADO;
+        }
+        escrever_paciente(resultado, id);
+        return Protocolo::OK;
+    }
+    case Protocolo::LISTAR: {
+        std::uint32_t limite;
+        if (!argumentos.u32(limite)) {
+            return Protocolo::PEDIDO_INVALIDO;
+        }
+        std::vector<int> ids = triagem.primeiros(std::min<std::size_t>(limite, triagem.tamanho()));
+        // Uma fila muito grande é cortada para que a resposta caiba em um quadro
+        std::size_t posicao_quantidade = conexao.saida.size();
+        resultado.u32(0);
+        std::uint32_t quantidade = 0;
+        for (int id : ids) {
+            if (conexao.saida.size() - posicao_quantidade > Protocolo::MAXIMO_QUADRO / 2) {
+                break;
+            }
+            escrever_paciente(resultado, id);
+            quantidade++;
+        }
+        std::memcpy(conexao.saida.data() + posicao_quantidade, &quantidade, sizeof(quantidade));
+        return Protocolo::OK;
+    }
+    case Protocolo::PROXIMO: {
+        int id = triagem.proximo();
+        if (id == -1) {
+            return Protocolo::NAO_ENCONTRADO;
+        }
+        escrever_paciente(resultado, id);
+        return Protocolo::OK;
+    }
+    case Protocolo::ASSINAR:
+        conexao.assinante = true;
+        return Protocolo::OK;
+    default:
+        return Protocolo::PEDIDO_INVALIDO;
+    }
+}
+
+void Servidor::escrever_paciente(Escritor& saida, int id)
+{
+    const ArmazemPacientes& armazem = triagem.pacientes();
+    paciente.id = id;
+    paciente.cpf = armazem.cpf(id);
+    paciente.nome.assign(armazem.nome(id));
+    paciente.email.assign(armazem.email(id));
+    paciente.nascimento = static_cast<std::int32_t>(armazem.nascimento(id));
+    paciente.sintomas = armazem.sintomas(id);
+    paciente.estacao = triagem.estacao_de(id);
+    Protocolo::escrever_paciente(saida, paciente);
+}
+
+// Envia o que o socket aceitar sem bloquear
+void Servidor::enviar(Conexao& conexao)
+{
+    while (!conexao.erro && conexao.enviados < conexao.saida.size()) {
+        ssize_t enviado = send(conexao.fd, conexao.saida.data() + conexao.enviados,
+                               conexao.saida.size() - conexao.enviados, MSG_NOSIGNAL);
+        if (enviado < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                conexao.erro = true;
+            }
+            break;
+        }
+        conexao.enviados += static_cast<std::size_t>(enviado);
+    }
+    if (conexao.enviados == conexao.saida.size()) {
+        conexao.saida.clear();
+        conexao.enviados = 0;
+    } else if (conexao.enviados > LIMITE_SAIDA) {
+        conexao.saida.erase(conexao.saida.begin(), conexao.saida.begin() + conexao.enviados);
+        conexao.enviados = 0;
+    }
+}
+
+bool Servidor::saida_cheia(const Conexao& conexao)
+{
+    return conexao.saida.size() - conexao.enviados >= LIMITE_SAIDA;
+}
+
+// Monta o quadro da notificação com o estado atual, se ele ainda não foi montado nesta versão
+void Servidor::montar_notificacao()
+{
+    if (!notificacao.empty() && versao_montada == versao) {
+        return;
+    }
+    versao_montada = versao;
+
+    Protocolo::Notificacao estado;
+    estado.versao = versao;
+    estado.tamanho = static_cast<std::uint32_t>(triagem.tamanho());
+    for (const Triagem::Estacao& estacao : triagem.estacoes()) {
+        Protocolo::Estacao resumo;
+        resumo.paciente = estacao.paciente;
+        resumo.evento = static_cast<std::uint8_t>(estacao.evento);
+        if (estacao.paciente != -1) {
+            resumo.nome.assign(triagem.pacientes().nome(estacao.paciente));
+        }
+        estado.estacoes.push_back(std::move(resumo));
+    }
+    notificacao.clear();
+    std::size_t inicio = Protocolo::iniciar_quadro(notificacao);
+    Escritor saida(notificacao);
+    saida.u32(Protocolo::NOTIFICACAO_ID);
+    saida.u8(Protocolo::OK);
+    Protocolo::escrever_notificacao(saida, estado);
+    Protocolo::concluir_quadro(notificacao, inicio);
+}
+
+/**
+ * @brief Envia o estado atual aos assinantes que ainda não o receberam.
+ * Um assinante com a saída cheia fica para depois: ele recebe o estado do
+ * momento na primeira rodada em que a saída tiver espaço, mesmo que a fila não
+ * mude mais.
+ */
+void Servidor::notificar()
+{
+    for (Conexao& conexao : conexoes) {
+        if (conexao.assinante && conexao.versao_enviada != versao && !conexao.erro && !saida_cheia(conexao)) {
+            montar_notificacao();
+            conexao.saida.insert(conexao.saida.end(), notificacao.begin(), notificacao.end());
+            conexao.versao_enviada = versao;
+            enviar(conexao);
+        }
+    }
+}
+
+// Avança o tratamento e agenda o próximo passo a partir do prazo, para não acumular atrasos
+void Servidor::passo_tratamento(Agenda::Instante prazo)
+{
+    if (triagem.avancar()) {
+        versao++;
+    }
+    Agenda::Instante seguinte = prazo + passo;
+    Agenda::Instante agora = Agenda::Relogio::now();
+    if (seguinte <= agora) {
+        seguinte = agora + passo; // Atrasado: não tenta recuperar os passos perdidos
+    }
+    agenda.agendar(seguinte, [this](Agenda::Instante prazo) { passo_tratamento(prazo); });
+}
@@ -0,0 +1,112 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "agenda.h"
+#include "protocolo.h"
+
+class Leitor;
+class Escritor;
+class Triagem;
+
+/**
+ * @brief Serviço da triagem em um socket Unix, pelo protocolo de protocolo.h (apenas POSIX).
+ *
+ * Um único thread é dono da triagem e atende todas as conexões em um laço de
+ * poll(): não há travas, e os pedidos de todos os clientes são aplicados na
+ * ordem em que são lidos. A cada leitura, todos os quadros completos recebidos
+ * na conexão são atendidos e as respostas são acumuladas e enviadas em uma só
+ * escrita, de modo que um cliente que envia pedidos sem esperar as respostas
+ * paga as chamadas de sistema uma vez por lote, e não por pedido.
+ *
+ * Uma conexão com respostas demais ainda não lidas pelo cliente deixa de ser
+ * lida até que elas sejam enviadas, e os pedidos de uma conexão lenta não
+ * atrasam os das demais. O tratamento avança pela agenda, com o poll()
+ * acordando no próximo passo.
+ *
+ * Depois de cada rodada de pedidos e passos que muda a fila ou as estações, os
+ * assinantes recebem uma única Notificacao com o estado atual. Como cada
+ * notificação traz o estado completo, um assinante que não lê as suas é
+ * simplesmente pulado até esvaziar o buffer, e então recebe o estado daquele
+ * momento: ele perde estados intermediários, nunca o mais recente.
+ */
+class Servidor
+{
+public:
+    /**
+     * @param triagem Triagem servida; só pode ser usada pelo thread que chama executar().
+     */
+    explicit Servidor(Triagem& triagem);
+
+    // Fecha as conexões e remove o socket
+    ~Servidor();
+
+    Servidor(const Servidor&) = delete;
+    Servidor& operator=(const Servidor&) = delete;
+
+    /**
+     * @brief Cria o socket e passa a aceitar conexões.
+     * Um socket deixado no caminho por um serviço anterior é substituído.
+     * @param caminho Caminho do socket.
+     * @return false se o socket não puder ser criado (errno indica o motivo).
+     */
+    bool abrir(const std::string& caminho);
+
+    /**
+     * @brief Atende as conexões até que parar seja verdadeiro.
+     * parar é verificado pelo menos a cada 100 ms (e logo depois de um sinal).
+     * @param passo Intervalo entre dois Triagem::avancar(), ou zero para não avançar o tratamento.
+     * @param parar Pedido de encerramento, em geral ligado por um tratador de sinal.
+     */
+    void executar(std::chrono::milliseconds passo, const std::atomic<bool>& parar);
+
+    std::uint64_t pedidos_atendidos() const { return atendidos; }
+    std::size_t conexoes_abertas() const { return conexoes.size(); }
+
+private:
+    // Conexão de um cliente
+    struct Conexao {
+        int fd = -1;
+        std::vector<char> entrada;   // Dados recebidos e ainda não atendidos a partir de lidos
+        std::size_t lidos = 0;       // Bytes de entrada já atendidos
+        std::vector<char> saida;     // Respostas e notificações a enviar a partir de enviados
+        std::size_t enviados = 0;    // Bytes de saida já enviados
+        bool assinante = false;      // Recebe as notificações de mudança
+        std::uint64_t versao_enviada = 0; // Versão da última notificação posta na saída do assinante
+        bool fim = false;            // O cliente encerrou o envio; fecha depois de enviar as respostas
+        bool erro = false;           // Falha de conexão ou quadro inválido; fecha sem enviar mais nada
+    };
+
+    void aceitar();
+    void ler(Conexao& conexao);
+    void atender(Conexao& conexao);
+    Protocolo::Status atender_pedido(Conexao& conexao, std::uint8_t operacao, Leitor& argumentos,
+                                     Escritor& resultado);
+    void enviar(Conexao& conexao);
+    void montar_notificacao();
+    void notificar();
+    void passo_tratamento(Agenda::Instante prazo);
+    void escrever_paciente(Escritor& saida, int id);
+
+    static bool saida_cheia(const Conexao& conexao);
+
+    Triagem& triagem;
+    std::string caminho;                  // Caminho do socket (vazio se não foi aberto)
+    int escuta = -1;                      // Socket que aceita as conexões
+    std::vector<Conexao> conexoes;
+    Agenda agenda;                        // Passos do tratamento
+    std::chrono::milliseconds passo{0};
+    std::uint64_t versao = 0;             // Mudanças aplicadas na fila ou nas estações
+    std::uint64_t versao_montada = 0;     // Versão do quadro em notificacao
+    std::uint64_t atendidos = 0;          // Pedidos atendidos
+    Protocolo::Paciente paciente;         // Registro reutilizado ao escrever pacientes
+    std::vector<char> notificacao;        // Quadro da última notificação
+};
+
+#endif // SERVIDOR_H
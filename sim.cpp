@@ -0,0 +1,141 @@
+// Simulação da triagem para planejar a quantidade de estações de tratamento.
+//
+// Aplica as mesmas chegadas, geradas por um processo de Poisson ou lidas de um
+// rastro gravado, a vários cenários de estações, simulados em paralelo com as
+// regras da triagem (ver simulacao.h). Para cada cenário são informados os
+// pacientes atendidos, a vazão, o tamanho médio e máximo da fila de espera, a
+// ocupação das estações, os percentis da espera e da permanência e o p99 da
+// espera na classe de sintomas que mais espera, em passos (um passo equivale a
+// um segundo na interface). Com --envelhecimento, a prioridade de quem espera
+// sobe um nível a cada P passos em todos os cenários.
+//
+// Uso: b1_sim [--chegadas N] [--taxa X] [--sintomas p] [--semente S] [--rastro arquivo]
+//             [--cenario nome=afinidade,afinidade,...]... [--envelhecimento P] [--threads N]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "paciente.h"
+#include "simulacao.h"
+
+// Lê as afinidades separadas por vírgula (máscaras de sintomas; 0 atende qualquer paciente)
+static bool ler_cenario(const char* texto, Cenario& cenario)
+{
+    const char* igual = std::strchr(texto, '=');
+    if (igual == nullptr || igual == texto) {
+        return false;
+    }
+    cenario.nome.assign(texto, igual);
+    cenario.afinidades.clear();
+    const char* p = igual + 1;
+    while (true) {
+        char* fim;
+        unsigned long afinidade = std::strtoul(p, &fim, 10);
+        if (fim == p || afinidade > 255) {
+            return false;
+        }
+        cenario.afinidades.push_back(static_cast<unsigned>(afinidade));
+        if (*fim == '\0') {
+            return true;
+        }
+        if (*fim != ',') {
+            return false;
+        }
+        p = fim + 1;
+    }
+}
+
+static void imprimir(const ResultadoSimulacao& r)
+{
+    std::printf("%-22s %10llu %9.4f %10.1f %9zu %7.1f%% %8lld %8lld %8lld %8lld %8lld %8lld %9lld\n",
+                r.cenario.c_str(), static_cast<unsigned long long>(r.atendidos), r.vazao, r.fila_media,
+                r.fila_maxima, r.ocupacao * 100, static_cast<long long>(r.espera.percentil(50)),
+                static_cast<long long>(r.espera.percentil(90)), static_cast<long long>(r.espera.percentil(99)),
+                static_cast<long long>(r.espera.maximo()), static_cast<long long>(r.permanencia.percentil(50)),
+                static_cast<long long>(r.permanencia.percentil(99)), static_cast<long long>(r.pior_classe(99)));
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t quantidade = 1000000; // Chegadas geradas
+    ModeloChegadas modelo;
+    modelo.taxa = 0.05;
+    modelo.sintomas.fill(0.1);
+    std::uint64_t semente = 42;
+    const char* rastro = nullptr;     // Arquivo com as chegadas (substitui as geradas)
+    std::vector<Cenario> cenarios;
+    unsigned threads = 0;
+    std::int64_t passos_por_nivel = 0; // Envelhecimento aplicado a todos os cenários
+
+    for (int i = 1; i < argc; ++i) {
+        Cenario cenario;
+        if (std::strcmp(argv[i], "--chegadas") == 0 && i + 1 < argc) {
+            quantidade = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--taxa") == 0 && i + 1 < argc) {
+            modelo.taxa = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--sintomas") == 0 && i + 1 < argc) {
+            modelo.sintomas.fill(std::strtod(argv[++i], nullptr));
+        } else if (std::strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--rastro") == 0 && i + 1 < argc) {
+            rastro = argv[++i];
+        } else if (std::strcmp(argv[i], "--cenario") == 0 && i + 1 < argc && ler_cenario(argv[i + 1], cenario)) {
+            cenarios.push_back(cenario);
+            i++;
+        } else if (std::strcmp(argv[i], "--envelhecimento") == 0 && i + 1 < argc) {
+            passos_por_nivel = std::strtoll(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::fprintf(stderr,
+                         "uso: %s [--chegadas N] [--taxa X] [--sintomas p] [--semente S] [--rastro arquivo]\n"
+                         "       [--cenario nome=afinidade,afinidade,...]... [--envelhecimento P] [--threads N]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    // Sem cenários informados, compara de uma a três estações gerais e a configuração da interface
+    if (cenarios.empty()) {
+        cenarios = {
+            {"1 geral", {0}},
+            {"2 gerais", {0, 0}},
+            {"3 gerais", {0, 0, 0}},
+            {"2 gerais + trauma", {0, 0, AVC | ACIDENTE}},
+        };
+    }
+    for (Cenario& cenario : cenarios) {
+        cenario.passos_por_nivel = passos_por_nivel;
+    }
+
+    std::vector<Chegada> chegadas;
+    if (rastro != nullptr) {
+        std::size_t linha;
+        if (const char* erro = ler_chegadas(rastro, chegadas, linha)) {
+            std::fprintf(stderr, "%s:%zu: %s\n", rastro, linha, erro);
+            return 1;
+        }
+    } else {
+        chegadas = gerar_chegadas(modelo, quantidade, semente);
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<ResultadoSimulacao> resultados = simular_cenarios(cenarios, chegadas, threads);
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    std::printf("%zu chegadas, %zu cenários, envelhecimento: %s\n", chegadas.size(), cenarios.size(),
+                passos_por_nivel > 0 ? (std::to_string(passos_por_nivel) + " passos por nível").c_str() : "não");
+    std::printf("%-22s %10s %9s %10s %9s %8s %8s %8s %8s %8s %8s %8s %9s\n", "cenario", "atendidos", "vazao",
+                "fila_media", "fila_max", "ocupacao", "esp_p50", "esp_p90", "esp_p99", "esp_max", "perm_p50",
+                "perm_p99", "pior_p99");
+    for (const ResultadoSimulacao& resultado : resultados) {
+        imprimir(resultado);
+    }
+    std::printf("simulação: %.3f s, %.0f chegadas/s\n", segundos,
+                segundos > 0 ? chegadas.size() * cenarios.size() / segundos : 0.0);
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include "simulacao.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <string_view>
+#include <thread>
+
+#include "arquivomapeado.h"
+#include "escalonador.h"
+
+namespace {
+
+// Gerador pseudoaleatório determinístico (xorshift64*), igual em todas as plataformas
+class Gerador
+{
+public:
+    explicit Gerador(std::uint64_t semente) : estado(semente ? semente : 1) {}
+
+    // Número uniforme em [0, 1)
+    double uniforme()
+    {
+        estado ^= estado >> 12;
+        estado ^= estado << 25;
+        estado ^= estado >> 27;
+        return static_cast<double>((estado * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    std::uint64_t estado;
+};
+
+} // namespace
+
+std::vector<Chegada> gerar_chegadas(const ModeloChegadas& modelo, std::size_t quantidade, std::uint64_t semente)
+{
+    std::vector<Chegada> chegadas;
+    if (modelo.taxa <= 0) {
+        return chegadas;
+    }
+    chegadas.reserve(quantidade);
+    Gerador gerador(semente);
+    double tempo = 0;
+    for (std::size_t i = 0; i < quantidade; ++i) {
+        // Intervalos exponenciais entre chegadas; o paciente é atendido a partir do passo em que chegou
+        tempo -= std::log(1.0 - gerador.uniforme()) / modelo.taxa;
+        unsigned sintomas = 0;
+        for (std::size_t bit = 0; bit < modelo.sintomas.size(); ++bit) {
+            if (gerador.uniforme() < modelo.sintomas[bit]) {
+                sintomas |= 1u << bit;
+            }
+        }
+        chegadas.push_back(Chegada{static_cast<std::int64_t>(tempo), sintomas});
+    }
+    return chegadas;
+}
+
+// Lê um inteiro não negativo ocupando todo o texto, ignorando espaços nas pontas
+static bool ler_numero(std::string_view texto, std::int64_t maximo, std::int64_t& valor)
+{
+    while (!texto.empty() && (texto.front() == ' ' || texto.front() == '\t')) {
+        texto.remove_prefix(1);
+    }
+    while (!texto.empty() && (texto.back() == ' ' || texto.back() == '\t' || texto.back() == '\r')) {
+        texto.remove_suffix(1);
+    }
+    if (texto.empty()) {
+        return false;
+    }
+    valor = 0;
+    for (char c : texto) {
+        if (c < '0' || c > '9' || valor > (maximo - (c - '0')) / 10) {
+            return false;
+        }
+        valor = valor * 10 + (c - '0');
+    }
+    return true;
+}
+
+const char* ler_chegadas(const std::string& caminho, std::vector<Chegada>& chegadas, std::size_t& linha_erro)
+{
+    linha_erro = 0;
+    ArquivoMapeado arquivo(caminho);
+    if (!arquivo.existe()) {
+        return "não foi possível abrir o arquivo";
+    }
+
+    std::vector<Chegada> lidas;
+    std::string_view conteudo(arquivo.dados(), arquivo.tamanho());
+    std::size_t numero_linha = 0;
+    while (!conteudo.empty()) {
+        std::size_t fim = conteudo.find('\n');
+        std::string_view linha = conteudo.substr(0, fim);
+        conteudo.remove_prefix(fim == std::string_view::npos ? conteudo.size() : fim + 1);
+        numero_linha++;
+
+        std::size_t inicio = linha.find_first_not_of(" \t\r");
+        if (inicio == std::string_view::npos || linha[inicio] == '#') {
+            continue;
+        }
+        linha_erro = numero_linha;
+        std::size_t virgula = linha.find(',');
+        std::int64_t instante;
+        std::int64_t sintomas;
+        if (virgula == std::string_view::npos || !ler_numero(linha.substr(0, virgula), INT64_MAX / 2, instante)) {
+            return "instante inválido";
+        }
+        if (!ler_numero(linha.substr(virgula + 1), 255, sintomas)) {
+            return "sintomas inválidos";
+        }
+        if (!lidas.empty() && instante < lidas.back().instante) {
+            return "instante anterior ao da chegada anterior";
+        }
+        lidas.push_back(Chegada{instante, static_cast<unsigned>(sintomas)});
+    }
+    linha_erro = 0;
+    chegadas = std::move(lidas);
+    return nullptr;
+}
+
+std::int64_t ResultadoSimulacao::pior_classe(double p) const
+{
+    std::int64_t pior = 0;
+    for (const Histograma& espera : espera_por_classe) {
+        if (espera.quantidade() > 0) {
+            pior = std::max(pior, espera.percentil(p));
+        }
+    }
+    return pior;
+}
+
+ResultadoSimulacao simular(const Cenario& cenario, const std::vector<Chegada>& chegadas)
+{
+    ResultadoSimulacao resultado;
+    resultado.cenario = cenario.nome;
+    if (chegadas.empty()) {
+        return resultado;
+    }
+
+    Escalonador escalonador;
+    escalonador.configurar(cenario.afinidades);
+    escalonador.envelhecer(cenario.passos_por_nivel);
+    const std::size_t estacoes = escalonador.estacoes().size();
+
+    // Os handles dos pacientes atendidos são reaproveitados, para que o escalonador
+    // ocupe memória proporcional aos pacientes presentes e não ao total de chegadas
+    std::vector<std::int64_t> chegada_do_handle;
+    std::vector<int> livres;
+    long double area_fila = 0;      // Soma de pacientes esperando × passos
+    long double area_ocupacao = 0;  // Soma de estações ocupadas × passos
+
+    const std::int64_t primeiro = chegadas.front().instante;
+    std::int64_t agora = primeiro; // Próximo passo a executar
+    std::int64_t ultimo_fim = primeiro;
+    std::size_t proxima = 0;
+    while (true) {
+        // Os pacientes que chegaram até agora entram na espera
+        for (; proxima < chegadas.size() && chegadas[proxima].instante <= agora; ++proxima) {
+            int handle;
+            if (livres.empty()) {
+                handle = static_cast<int>(chegada_do_handle.size());
+                chegada_do_handle.push_back(0);
+            } else {
+                handle = livres.back();
+                livres.pop_back();
+            }
+            chegada_do_handle[handle] = chegadas[proxima].instante;
+            escalonador.inserir(handle, chegadas[proxima].sintomas, static_cast<int>(proxima));
+        }
+        resultado.fila_maxima = std::max(resultado.fila_maxima, escalonador.esperando());
+
+        if (escalonador.vazio()) {
+            if (proxima == chegadas.size()) {
+                break;
+            }
+            agora = chegadas[proxima].instante; // Nada acontece até a próxima chegada
+            continue;
+        }
+
+        // Salta os passos em que só há progresso, sem ultrapassar a próxima chegada
+        std::int64_t passos = escalonador.passos_ate_evento();
+        if (proxima < chegadas.size()) {
+            passos = std::min(passos, chegadas[proxima].instante - agora);
+        }
+        area_fila += static_cast<long double>(escalonador.esperando()) * passos;
+        area_ocupacao += static_cast<long double>(escalonador.estacoes_ocupadas()) * passos;
+        escalonador.avancar(passos);
+        const std::int64_t passo = agora + passos - 1; // Passo em que os eventos ocorreram
+        agora += passos;
+
+        for (int handle : escalonador.concluidos()) {
+            resultado.atendidos++;
+            resultado.permanencia.registrar(passo - chegada_do_handle[handle]);
+            livres.push_back(handle);
+            ultimo_fim = passo;
+        }
+        for (const Escalonador::Estacao& estacao : escalonador.estacoes()) {
+            if (estacao.evento == Escalonador::CHAMADO) {
+                std::int64_t espera = passo - chegada_do_handle[estacao.paciente];
+                resultado.espera.registrar(espera);
+                resultado.espera_por_classe[Telemetria::classe(estacao.prioridade)].registrar(espera);
+            }
+        }
+    }
+
+    resultado.duracao = ultimo_fim - primeiro + 1;
+    resultado.vazao = static_cast<double>(resultado.atendidos) / resultado.duracao;
+    resultado.fila_media = static_cast<double>(area_fila / resultado.duracao);
+    resultado.ocupacao = static_cast<double>(area_ocupacao / (static_cast<long double>(resultado.duracao) * estacoes));
+    return resultado;
+}
+
+std::vector<ResultadoSimulacao> simular_cenarios(const std::vector<Cenario>& cenarios,
+                                                 const std::vector<Chegada>& chegadas, unsigned threads)
+{
+    std::vector<ResultadoSimulacao> resultados(cenarios.size());
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, cenarios.size()));
+
+    // Cada thread pega o próximo cenário ainda não simulado; as chegadas são apenas lidas
+    std::atomic<std::size_t> proximo{0};
+    auto trabalhar = [&]() {
+        for (std::size_t i = proximo++; i < cenarios.size(); i = proximo++) {
+            resultados[i] = simular(cenarios[i], chegadas);
+        }
+    };
+    std::vector<std::thread> trabalhadores;
+    for (unsigned t = 1; t < threads; ++t) {
+        trabalhadores.emplace_back(trabalhar);
+    }
+    trabalhar();
+    for (std::thread& t : trabalhadores) {
+        t.join();
+    }
+    return resultados;
+}
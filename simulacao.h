@@ -0,0 +1,98 @@
+#ifndef SIMULACAO_H
+#define SIMULACAO_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "histograma.h"
+#include "telemetria.h"
+
+/**
+ * Simulação de eventos discretos da triagem, para planejar a capacidade.
+ *
+ * As chegadas de pacientes são aplicadas às mesmas regras de espera e
+ * tratamento da triagem (ver Escalonador), em um relógio virtual medido em
+ * passos (um passo equivale a um avancar() da triagem, um segundo na
+ * interface). O relógio salta direto para o próximo evento, a próxima chegada
+ * ou o próximo fim de tratamento, em vez de simular cada passo, e a simulação
+ * não consulta o relógio do sistema nem guarda os cadastros dos pacientes.
+ */
+
+// Chegada de um paciente
+struct Chegada {
+    std::int64_t instante; // Passo em que o paciente chega (atendido a partir desse passo)
+    unsigned sintomas;     // Sintomas representados por flags binárias (definem a prioridade e a duração)
+};
+
+// Modelo das chegadas geradas por gerar_chegadas()
+struct ModeloChegadas {
+    double taxa = 0.01;               // Chegadas por passo, em média (processo de Poisson)
+    std::array<double, 8> sintomas{}; // Probabilidade de cada flag de sintoma, independentes
+};
+
+// Configuração de estações de tratamento a avaliar
+struct Cenario {
+    std::string nome;                 // Nome exibido no relatório
+    std::vector<unsigned> afinidades; // Afinidade de cada estação (ver Escalonador::configurar)
+    std::int64_t passos_por_nivel = 0; // Envelhecimento da prioridade (ver Escalonador::envelhecer)
+};
+
+// Resultado da simulação de um cenário
+struct ResultadoSimulacao {
+    std::string cenario;           // Nome do cenário
+    std::uint64_t atendidos = 0;   // Pacientes que concluíram o tratamento
+    std::int64_t duracao = 0;      // Passos da primeira chegada até o último fim de tratamento
+    double vazao = 0;              // Atendidos por passo
+    double fila_media = 0;         // Pacientes esperando, em média ao longo do tempo
+    std::size_t fila_maxima = 0;   // Maior quantidade de pacientes esperando
+    double ocupacao = 0;           // Fração das estações ocupadas, em média ao longo do tempo
+    Histograma espera;             // Passos entre a chegada e o chamado
+    Histograma permanencia;        // Passos entre a chegada e o fim do tratamento
+    std::array<Histograma, Telemetria::CLASSES> espera_por_classe; // Espera por classe de sintomas
+
+    /**
+     * @brief Maior percentil p da espera entre as classes de sintomas com pacientes.
+     * Mostra se alguma classe (em geral a de sintomas leves) fica sem atendimento.
+     */
+    std::int64_t pior_classe(double p) const;
+};
+
+/**
+ * @brief Gera chegadas aleatórias segundo o modelo, em ordem de instante a partir do passo 0.
+ * A mesma semente gera sempre as mesmas chegadas.
+ * @param modelo Taxa de chegadas e probabilidades dos sintomas.
+ * @param quantidade Quantidade de chegadas.
+ * @param semente Semente do gerador pseudoaleatório.
+ */
+std::vector<Chegada> gerar_chegadas(const ModeloChegadas& modelo, std::size_t quantidade, std::uint64_t semente);
+
+/**
+ * @brief Lê chegadas gravadas de um arquivo (um rastro de atendimentos reais, por exemplo).
+ * Uma chegada por linha, no formato "instante,sintomas", com os instantes em
+ * ordem não decrescente; linhas vazias e linhas iniciadas por '#' são ignoradas.
+ * @param caminho Caminho do arquivo.
+ * @param chegadas Recebe as chegadas lidas.
+ * @param linha_erro Recebe a linha do primeiro erro (0 se o arquivo não pôde ser aberto).
+ * @return Mensagem de erro ou nullptr.
+ */
+const char* ler_chegadas(const std::string& caminho, std::vector<Chegada>& chegadas, std::size_t& linha_erro);
+
+/**
+ * @brief Simula as chegadas em um cenário até que todos os pacientes sejam atendidos.
+ * @param cenario Estações de tratamento.
+ * @param chegadas Chegadas em ordem de instante.
+ */
+ResultadoSimulacao simular(const Cenario& cenario, const std::vector<Chegada>& chegadas);
+
+/**
+ * @brief Simula as mesmas chegadas em vários cenários, em paralelo.
+ * @param threads Quantidade máxima de threads (0 usa a quantidade de núcleos).
+ * @return Um resultado por cenário, na ordem dos cenários.
+ */
+std::vector<ResultadoSimulacao> simular_cenarios(const std::vector<Cenario>& cenarios,
+                                                 const std::vector<Chegada>& chegadas, unsigned threads = 0);
+
+#endif // SIMULACAO_H
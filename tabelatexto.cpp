@@ -0,0 +1,129 @@
+#include "tabelatexto.h"
+
+#include <algorithm>
+
+#include "binario.h"
+
+namespace {
+const int BITS_INICIAIS = 6; // Capacidade inicial da tabela: 64 posições
+}
+
+TabelaTexto::TabelaTexto()
+    : inicios(1, 0)
+    , tabela(std::size_t(1) << BITS_INICIAIS, 0)
+    , mascara((1u << BITS_INICIAIS) - 1)
+    , bits(BITS_INICIAIS)
+{
+}
+
+// FNV-1a de 64 bits
+std::uint64_t TabelaTexto::hash(std::string_view texto)
+{
+    std::uint64_t h = 0xCBF29CE484222325ULL;
+    for (char c : texto) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+std::uint32_t TabelaTexto::guardar(std::string_view texto)
+{
+    dados.insert(dados.end(), texto.begin(), texto.end());
+    inicios.push_back(static_cast<std::uint32_t>(dados.size()));
+    return static_cast<std::uint32_t>(inicios.size() - 2);
+}
+
+std::uint32_t TabelaTexto::internar(std::string_view texto)
+{
+    // Mantém a carga máxima em 50%
+    if ((internados + 1) * 2 > tabela.size()) {
+        crescer();
+    }
+
+    // Os bits altos do hash multiplicativo escolhem a posição inicial
+    std::size_t i = (hash(texto) * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+    while (tabela[i] != 0) {
+        if (this->texto(tabela[i] - 1) == texto) {
+            return tabela[i] - 1; // Texto já internado
+        }
+        i = (i + 1) & mascara;
+    }
+
+    std::uint32_t id = guardar(texto);
+    tabela[i] = id + 1;
+    internados++;
+    return id;
+}
+
+// Dobra a capacidade da tabela e reinsere os identificadores
+void TabelaTexto::crescer()
+{
+    std::vector<std::uint32_t> antiga;
+    antiga.swap(tabela);
+    bits++;
+    tabela.assign(std::size_t(1) << bits, 0);
+    mascara = static_cast<std::uint32_t>(tabela.size() - 1);
+
+    for (std::uint32_t valor : antiga) {
+        if (valor == 0) {
+            continue;
+        }
+        std::size_t i = (hash(texto(valor - 1)) * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+        while (tabela[i] != 0) {
+            i = (i + 1) & mascara;
+        }
+        tabela[i] = valor;
+    }
+}
+
+std::size_t TabelaTexto::bytes() const
+{
+    return dados.capacity() + inicios.capacity() * sizeof(std::uint32_t) +
+           tabela.capacity() * sizeof(std::uint32_t);
+}
+
+void TabelaTexto::salvar(Escritor& saida, bool com_tabela) const
+{
+    saida.vetor(dados);
+    saida.vetor(inicios);
+    if (com_tabela) {
+        saida.vetor(tabela);
+    }
+}
+
+bool TabelaTexto::carregar(Leitor& entrada, bool com_tabela)
+{
+    // Inícios fora de ordem ou além dos dados dariam textos fora do buffer
+    if (!entrada.vetor(dados) || !entrada.vetor(inicios) || inicios.empty() || inicios.back() != dados.size() ||
+        !std::is_sorted(inicios.begin(), inicios.end())) {
+        return false;
+    }
+    if (!com_tabela) {
+        tabela.assign(std::size_t(1) << BITS_INICIAIS, 0);
+        mascara = static_cast<std::uint32_t>(tabela.size() - 1);
+        bits = BITS_INICIAIS;
+        internados = 0;
+        return true;
+    }
+
+    // A tabela gravada é usada como está: basta conferir a capacidade, os identificadores e a carga,
+    // que mantém uma posição vazia para encerrar as sondagens
+    if (!entrada.vetor(tabela) || tabela.size() < (std::size_t(1) << BITS_INICIAIS) ||
+        tabela.size() > (std::size_t(1) << 31) || (tabela.size() & (tabela.size() - 1)) != 0) {
+        return false;
+    }
+    bits = BITS_INICIAIS;
+    while ((std::size_t(1) << bits) < tabela.size()) {
+        bits++;
+    }
+    mascara = static_cast<std::uint32_t>(tabela.size() - 1);
+    internados = 0;
+    for (std::uint32_t valor : tabela) {
+        if (valor > tamanho()) {
+            return false;
+        }
+        internados += valor != 0;
+    }
+    return internados * 2 <= tabela.size();
+}
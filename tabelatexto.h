@@ -0,0 +1,78 @@
+#ifndef TABELATEXTO_H
+#define TABELATEXTO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class Escritor;
+class Leitor;
+
+/**
+ * @brief Arena de textos identificados por inteiros de 32 bits.
+ *
+ * Os textos ficam em sequência em um único buffer, sem alocação individual,
+ * e são acessados pelo identificador retornado ao guardá-los. Textos guardados
+ * com internar() são deduplicados por uma tabela hash de endereçamento aberto
+ * que guarda apenas os identificadores, de modo que nomes repetidos ocupam
+ * espaço uma única vez. Os textos nunca são removidos.
+ */
+class TabelaTexto
+{
+public:
+    TabelaTexto();
+
+    /**
+     * @brief Guarda um texto, reaproveitando um texto igual já internado.
+     * @return Identificador do texto.
+     */
+    std::uint32_t internar(std::string_view texto);
+
+    /**
+     * @brief Guarda um texto sem procurar repetições.
+     * @return Identificador do texto.
+     */
+    std::uint32_t guardar(std::string_view texto);
+
+    /**
+     * @brief Texto com o identificador informado; válido até a próxima inserção.
+     */
+    std::string_view texto(std::uint32_t id) const
+    {
+        return std::string_view(dados.data() + inicios[id], inicios[id + 1] - inicios[id]);
+    }
+
+    std::size_t tamanho() const { return inicios.size() - 1; }
+
+    /**
+     * @brief Memória reservada pela tabela, em bytes.
+     */
+    std::size_t bytes() const;
+
+    /**
+     * @brief Grava os textos e, se pedido, a tabela de deduplicação, que assim não é reconstruída ao carregar.
+     */
+    void salvar(Escritor& saida, bool com_tabela) const;
+
+    /**
+     * @brief Substitui o conteúdo pelos textos gravados por salvar().
+     * @param com_tabela Lê a tabela de deduplicação gravada; sem ela, internar() não
+     *        reconhece os textos carregados. Deve ser o mesmo valor usado em salvar().
+     * @return false se os dados estiverem incompletos ou inconsistentes.
+     */
+    bool carregar(Leitor& entrada, bool com_tabela);
+
+private:
+    static std::uint64_t hash(std::string_view texto);
+    void crescer();
+
+    std::vector<char> dados;           // Textos em sequência
+    std::vector<std::uint32_t> inicios; // Início de cada texto em dados, mais o fim do último
+    std::vector<std::uint32_t> tabela;  // Identificador + 1 dos textos internados (0 = vazio)
+    std::uint32_t mascara;              // Capacidade da tabela - 1
+    int bits;                           // log2 da capacidade da tabela
+    std::size_t internados = 0;         // Quantidade de textos na tabela
+};
+
+#endif // TABELATEXTO_H
@@ -0,0 +1,165 @@
+#include "telemetria.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+
+// Nome de cada classe de sintomas, pela maior flag do paciente
+static const char* const NOMES_CLASSES[Telemetria::CLASSES] = {
+    "sem_sintomas", "tosse", "nausea", "febre", "disenteria", "infeccao", "covid", "avc", "acidente"
+};
+
+Telemetria::Telemetria()
+{
+    // Os dois relógios são lidos uma única vez; a exibição não precisa de mais precisão
+    auto sistema = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    diferenca_relogios = sistema.count() - agora();
+}
+
+std::int64_t Telemetria::agora()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now().time_since_epoch()).count();
+}
+
+std::size_t Telemetria::classe(unsigned sintomas)
+{
+    std::size_t c = 0;
+    for (sintomas &= 0xFF; sintomas != 0; sintomas >>= 1) {
+        c++;
+    }
+    return c;
+}
+
+const char* Telemetria::nome_classe(std::size_t classe)
+{
+    return classe < CLASSES ? NOMES_CLASSES[classe] : "";
+}
+
+// Leitura e escrita relaxadas dos medidores; só o thread da triagem escreve
+template <typename T>
+static void somar_um(std::atomic<T>& contador)
+{
+    contador.store(contador.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void Telemetria::admitido(int id)
+{
+    if (static_cast<std::size_t>(id) >= pacientes.size()) {
+        pacientes.resize(id + 1);
+    }
+    pacientes[id] = Instantes();
+    pacientes[id].admissao = agora();
+    somar_um(total_admissoes);
+}
+
+void Telemetria::chamado(int id, unsigned sintomas)
+{
+    if (static_cast<std::size_t>(id) >= pacientes.size()) {
+        pacientes.resize(id + 1);
+    }
+    Instantes& paciente = pacientes[id];
+    paciente.chamada = agora();
+    if (paciente.admissao != 0) {
+        esperas[classe(sintomas)].registrar(paciente.chamada - paciente.admissao);
+    }
+}
+
+void Telemetria::concluido(int id, unsigned sintomas)
+{
+    if (static_cast<std::size_t>(id) >= pacientes.size()) {
+        pacientes.resize(id + 1);
+    }
+    Instantes& paciente = pacientes[id];
+    paciente.alta = agora();
+    if (paciente.chamada != 0) {
+        tratamentos[classe(sintomas)].registrar(paciente.alta - paciente.chamada);
+    }
+    somar_um(total_altas);
+}
+
+void Telemetria::removido()
+{
+    somar_um(total_remocoes);
+}
+
+void Telemetria::medir_fila(std::size_t esperando, std::size_t em_tratamento)
+{
+    fila_esperando.store(esperando, std::memory_order_relaxed);
+    fila_em_tratamento.store(em_tratamento, std::memory_order_relaxed);
+    if (esperando > maior_fila.load(std::memory_order_relaxed)) {
+        maior_fila.store(esperando, std::memory_order_relaxed);
+    }
+}
+
+Telemetria::Instantes Telemetria::instantes(int id) const
+{
+    if (id < 0 || static_cast<std::size_t>(id) >= pacientes.size()) {
+        return Instantes();
+    }
+    return pacientes[id];
+}
+
+std::chrono::system_clock::time_point Telemetria::horario(std::int64_t instante) const
+{
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(instante + diferenca_relogios)));
+}
+
+Histograma Telemetria::espera_total() const
+{
+    Histograma total;
+    for (const Histograma& espera : esperas) {
+        total.somar(espera);
+    }
+    return total;
+}
+
+// Grava o resumo de um histograma de nanossegundos, em milissegundos
+static void gravar_histograma(std::FILE* arquivo, const char* nome, const Histograma& valores)
+{
+    Histograma retrato(valores); // Consulta um retrato, para que os campos sejam coerentes entre si
+    const double ms = 1e-6;
+    std::fprintf(arquivo,
+                 "\"%s\": {\"quantidade\": %llu, \"media_ms\": %.3f, \"p50_ms\": %.3f, \"p90_ms\": %.3f, "
+                 "\"p99_ms\": %.3f, \"max_ms\": %.3f}",
+                 nome, static_cast<unsigned long long>(retrato.quantidade()), retrato.media() * ms,
+                 retrato.percentil(50) * ms, retrato.percentil(90) * ms, retrato.percentil(99) * ms,
+                 retrato.maximo() * ms);
+}
+
+bool Telemetria::gravar(const std::string& caminho) const
+{
+    std::string temporario = caminho + ".tmp";
+    std::FILE* arquivo = std::fopen(temporario.c_str(), "w");
+    if (arquivo == nullptr) {
+        return false;
+    }
+
+    long long horario_atual = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::fprintf(arquivo, "{\n  \"horario\": %lld,\n", horario_atual);
+    std::fprintf(arquivo, "  \"fila\": {\"esperando\": %zu, \"em_tratamento\": %zu, \"maxima\": %zu},\n",
+                 esperando(), em_tratamento(), fila_maxima());
+    std::fprintf(arquivo, "  \"contadores\": {\"admissoes\": %llu, \"altas\": %llu, \"remocoes\": %llu},\n",
+                 static_cast<unsigned long long>(admissoes()), static_cast<unsigned long long>(altas()),
+                 static_cast<unsigned long long>(remocoes()));
+    std::fprintf(arquivo, "  ");
+    gravar_histograma(arquivo, "espera_total", espera_total());
+    std::fprintf(arquivo, ",\n  \"classes\": [\n");
+    for (std::size_t c = 0; c < CLASSES; ++c) {
+        std::fprintf(arquivo, "    {\"classe\": \"%s\", ", NOMES_CLASSES[c]);
+        gravar_histograma(arquivo, "espera", esperas[c]);
+        std::fprintf(arquivo, ", ");
+        gravar_histograma(arquivo, "tratamento", tratamentos[c]);
+        std::fprintf(arquivo, "}%s\n", c + 1 < CLASSES ? "," : "");
+    }
+    std::fprintf(arquivo, "  ]\n}\n");
+    if (std::fclose(arquivo) != 0) {
+        return false;
+    }
+
+    std::error_code erro_renomear;
+    std::filesystem::rename(temporario, caminho, erro_renomear);
+    return !erro_renomear;
+}
@@ -0,0 +1,126 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "histograma.h"
+
+/**
+ * @brief Medidas de desempenho do atendimento: esperas, tratamentos e tamanho da fila.
+ *
+ * Registra o instante de cada transição dos pacientes (admissão, chamado para
+ * tratamento e alta) e mantém, por classe de sintomas, histogramas do tempo de
+ * espera (da admissão ao chamado) e do tempo de tratamento (do chamado à alta),
+ * além de medidores do tamanho atual e máximo da fila e contadores de
+ * admissões, altas e remoções. Os tempos são medidos em nanossegundos no
+ * relógio monotônico.
+ *
+ * Um único thread, o da triagem (ver Triagem::medir_em), registra as
+ * transições; cada registro custa uma leitura do relógio e algumas escritas,
+ * sem travas nem alocação (exceto quando o vetor de instantes cresce). As
+ * consultas dos histogramas, medidores e contadores e gravar() podem ser
+ * feitas por outros threads ao mesmo tempo (ver Histograma); instantes(), não.
+ *
+ * Os pacientes admitidos antes de a telemetria começar (recuperados do diário,
+ * por exemplo) não têm o instante de admissão e não entram nos histogramas de
+ * espera.
+ */
+class Telemetria
+{
+public:
+    using Relogio = std::chrono::steady_clock;
+
+    // Classes de sintomas: 0 para pacientes sem sintomas; c > 0 para pacientes
+    // cujo sintoma mais grave (a maior flag) é 1 << (c - 1)
+    static const std::size_t CLASSES = 9;
+
+    // Instantes das transições de um paciente, em nanossegundos no Relogio (0 se não registrada)
+    struct Instantes {
+        std::int64_t admissao = 0; // Entrada na fila
+        std::int64_t chamada = 0;  // Chamado para tratamento
+        std::int64_t alta = 0;     // Fim do tratamento
+    };
+
+    Telemetria();
+
+    /**
+     * @brief Classe de sintomas de um paciente (ver CLASSES).
+     */
+    static std::size_t classe(unsigned sintomas);
+
+    /**
+     * @brief Nome da classe de sintomas, usado em gravar().
+     */
+    static const char* nome_classe(std::size_t classe);
+
+    // Transições, registradas pelo thread da triagem
+
+    void admitido(int id);
+    void chamado(int id, unsigned sintomas);
+    void concluido(int id, unsigned sintomas);
+    void removido();
+
+    /**
+     * @brief Atualiza os medidores da fila depois de uma operação da triagem.
+     * @param esperando Pacientes esperando, sem os que estão em tratamento.
+     * @param em_tratamento Pacientes em tratamento.
+     */
+    void medir_fila(std::size_t esperando, std::size_t em_tratamento);
+
+    /**
+     * @brief Instantes registrados para um paciente; apenas no thread da triagem.
+     */
+    Instantes instantes(int id) const;
+
+    /**
+     * @brief Converte um instante do Relogio para o horário do sistema, para exibição.
+     */
+    std::chrono::system_clock::time_point horario(std::int64_t instante) const;
+
+    // Consultas, de qualquer thread
+
+    const Histograma& espera(std::size_t classe) const { return esperas[classe]; }
+    const Histograma& tratamento(std::size_t classe) const { return tratamentos[classe]; }
+
+    /**
+     * @brief Esperas de todas as classes juntas.
+     */
+    Histograma espera_total() const;
+
+    std::size_t esperando() const { return fila_esperando.load(std::memory_order_relaxed); }
+    std::size_t em_tratamento() const { return fila_em_tratamento.load(std::memory_order_relaxed); }
+    std::size_t fila_maxima() const { return maior_fila.load(std::memory_order_relaxed); }
+    std::uint64_t admissoes() const { return total_admissoes.load(std::memory_order_relaxed); }
+    std::uint64_t altas() const { return total_altas.load(std::memory_order_relaxed); }
+    std::uint64_t remocoes() const { return total_remocoes.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Grava as medidas em JSON, substituindo o arquivo de uma só vez.
+     * O arquivo é escrito ao lado, com a extensão .tmp, e renomeado sobre o
+     * anterior, para que quem o lê nunca encontre um arquivo pela metade.
+     * @return false se o arquivo não pôde ser gravado.
+     */
+    bool gravar(const std::string& caminho) const;
+
+private:
+    static std::int64_t agora();
+
+    std::vector<Instantes> pacientes;               // Instantes por ID de paciente
+    std::array<Histograma, CLASSES> esperas;        // Espera por classe de sintomas (ns)
+    std::array<Histograma, CLASSES> tratamentos;    // Tratamento por classe de sintomas (ns)
+    std::atomic<std::size_t> fila_esperando{0};     // Pacientes esperando
+    std::atomic<std::size_t> fila_em_tratamento{0}; // Pacientes em tratamento
+    std::atomic<std::size_t> maior_fila{0};         // Maior quantidade de pacientes esperando
+    std::atomic<std::uint64_t> total_admissoes{0};  // Pacientes novos admitidos
+    std::atomic<std::uint64_t> total_altas{0};      // Tratamentos concluídos
+    std::atomic<std::uint64_t> total_remocoes{0};   // Pacientes removidos da fila antes da alta
+    std::int64_t diferenca_relogios;                // Horário do sistema menos o Relogio, em ns
+};
+
+#endif // TELEMETRIA_H
@@ -0,0 +1,103 @@
+#include "texto.h"
+
+std::string minusculas(std::string_view texto)
+{
+    std::string resultado(texto);
+    const std::size_t n = resultado.size();
+
+    for (std::size_t i = 0; i < n; ++i) {
+        unsigned char c = static_cast<unsigned char>(resultado[i]);
+        if (c >= 'A' && c <= 'Z') {
+            resultado[i] = static_cast<char>(c + ('a' - 'A'));
+        }
+        else if (c == 0xC3 && i + 1 < n) {
+            // Segundo byte de À..Þ (U+00C0 a U+00DE), exceto o sinal de multiplicação (U+00D7)
+            unsigned char d = static_cast<unsigned char>(resultado[i + 1]);
+            if (d >= 0x80 && d <= 0x9E && d != 0x97) {
+                resultado[i + 1] = static_cast<char>(d + 0x20);
+            }
+            i++;
+        }
+    }
+    return resultado;
+}
+
+// Letra base de cada caractere U+00C0 a U+00FF, indexada pelo segundo byte UTF-8 (0x80 a 0xBF)
+static const char LETRAS_SEM_ACENTO[] = "aaaaaaaceeeeiiiidnooooo ouuuuyts"
+                                        "aaaaaaaceeeeiiiidnooooo ouuuuyty";
+
+std::string normalizar(const std::string& texto)
+{
+    std::string resultado;
+    resultado.reserve(texto.size());
+    bool espaco_pendente = false; // Evita espaços repetidos e no início
+
+    // Acrescenta um caractere, inserindo antes o espaço pendente se houver
+    auto acrescentar = [&](char c) {
+        if (c == ' ') {
+            espaco_pendente = !resultado.empty();
+            return;
+        }
+        if (espaco_pendente) {
+            resultado += ' ';
+            espaco_pendente = false;
+        }
+        resultado += c;
+    };
+
+    const std::size_t n = texto.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        unsigned char c = static_cast<unsigned char>(texto[i]);
+        if (c >= 'A' && c <= 'Z') {
+            acrescentar(static_cast<char>(c + ('a' - 'A')));
+        }
+        else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+            acrescentar(static_cast<char>(c));
+        }
+        else if (c == 0xC3 && i + 1 < n) {
+            unsigned char d = static_cast<unsigned char>(texto[++i]);
+            if (d >= 0x80 && d <= 0xBF) {
+                acrescentar(LETRAS_SEM_ACENTO[d - 0x80]);
+            }
+        }
+        else if (c >= 0x80) {
+            acrescentar(static_cast<char>(c)); // Outros caracteres UTF-8 são mantidos
+        }
+        else {
+            acrescentar(' '); // Pontuação e espaços viram separadores
+        }
+    }
+    return resultado;
+}
+
+bool iguais_sem_caixa(std::string_view a, std::string_view b)
+{
+    // A conversão para minúsculas preserva o tamanho em bytes
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    const std::size_t n = a.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        unsigned char x = static_cast<unsigned char>(a[i]);
+        unsigned char y = static_cast<unsigned char>(b[i]);
+        if (x == 0xC3 && y == 0xC3 && i + 1 < n) {
+            // Letras Latin-1: compara o segundo byte convertido para minúscula
+            unsigned char dx = static_cast<unsigned char>(a[i + 1]);
+            unsigned char dy = static_cast<unsigned char>(b[i + 1]);
+            if (dx >= 0x80 && dx <= 0x9E && dx != 0x97) dx += 0x20;
+            if (dy >= 0x80 && dy <= 0x9E && dy != 0x97) dy += 0x20;
+            if (dx != dy) {
+                return false;
+            }
+            i++;
+            continue;
+        }
+        if (x >= 'A' && x <= 'Z') x += 'a' - 'A';
+        if (y >= 'A' && y <= 'Z') y += 'a' - 'A';
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef TEXTO_H
+#define TEXTO_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Converte um texto UTF-8 para minúsculas.
+ * Trata as letras ASCII e as letras maiúsculas acentuadas do Latin-1
+ * (À a Þ), que cobrem os nomes em português. Os demais caracteres são
+ * mantidos. Usada para gerar chaves de busca insensíveis a maiúsculas.
+ * @param texto Texto em UTF-8.
+ * @return Texto em minúsculas.
+ */
+std::string minusculas(std::string_view texto);
+
+/**
+ * @brief Normaliza um nome para busca aproximada.
+ * Converte para minúsculas, remove acentos das letras Latin-1 (ç vira c,
+ * ã vira a etc.), troca pontuação por espaço e junta espaços repetidos,
+ * sem espaços no início ou no fim.
+ * @param texto Texto em UTF-8.
+ * @return Texto normalizado.
+ */
+std::string normalizar(const std::string& texto);
+
+/**
+ * @brief Compara dois textos UTF-8 sem diferenciar maiúsculas de minúsculas.
+ * Usa as mesmas regras de minusculas(), sem criar cópias dos textos.
+ * @return true se os textos forem iguais.
+ */
+bool iguais_sem_caixa(std::string_view a, std::string_view b);
+
+#endif // TEXTO_H
@@ -0,0 +1,495 @@
+#include "triagem.h"
+
+#include <algorithm>
+
+#include "binario.h"
+#include "cpf.h"
+#include "diario.h"
+#include "historico.h"
+#include "telemetria.h"
+#include "texto.h"
+
+/**
+ * @brief Retira um paciente da fila e dos índices da fila.
+ * Se o paciente estava em tratamento, o tratamento é encerrado e a estação fica livre.
+ * O paciente continua no armazenamento e na busca aproximada.
+ * @param id ID do paciente.
+ */
+void Triagem::retirar(int id)
+{
+    escalonador.remover(id);
+    tirar_dos_indices(id);
+}
+
+// Retira dos índices da fila um paciente que já saiu do escalonador
+void Triagem::tirar_dos_indices(int id)
+{
+    indice_cpf.remover(armazem.cpf(id));
+    indice_nome.remover(minusculas(armazem.nome(id)), id);
+    indice_sintomas.marcar_fila(id, false);
+    indice_nascimento.marcar_fila(id, armazem.nascimento(id), false);
+}
+
+Triagem::Admissao Triagem::admitir(const std::string& name, const std::string& cpf, const std::string& email,
+                                   long long bday, unsigned sintomas)
+{
+    // Converte o CPF para a chave compacta usada pelo índice
+    std::uint64_t cpf_chave = cpf_para_chave(cpf);
+    if (cpf_chave == CPF_INVALIDO) {
+        return CPF_MAL_FORMADO;
+    }
+    return admitir_chave(cpf_chave, name, email, bday, sintomas);
+}
+
+Triagem::Admissao Triagem::admitir_chave(std::uint64_t cpf_chave, std::string_view name, std::string_view email,
+                                         long long bday, unsigned sintomas)
+{
+    // Consulta o índice de CPF para verificar se o paciente já está na fila
+    int id = indice_cpf.buscar(cpf_chave);
+    if (id == -1) {
+        // Guarda o novo paciente e o insere na fila e nos índices
+        id = armazem.adicionar(cpf_chave, name, email, bday, sintomas);
+        escalonador.inserir(id, sintomas, id);    // O ID é também a ordem de chegada
+        indice_cpf.inserir(cpf_chave, id);
+        indice_nome.inserir(minusculas(name), id);
+        indice_sintomas.adicionar(id, sintomas);
+        indice_nascimento.adicionar(id, bday);
+        busca_nome.indexar(id, std::string(name)); // Torna o paciente visível na busca aproximada
+        if (telemetria != nullptr) {
+            telemetria->admitido(id);
+            medir_fila();
+        }
+        if (diario != nullptr) {
+            diario->registrar_admissao(cpf_chave, name, email, bday, sintomas);
+            depois_de_registrar();
+        }
+        return ADMITIDO;
+    }
+
+    // Atualiza os índices de nome se o nome mudou
+    if (armazem.nome(id) != name) {
+        indice_nome.remover(minusculas(armazem.nome(id)), id);
+        indice_nome.inserir(minusculas(name), id);
+        busca_nome.indexar(id, std::string(name));
+    }
+
+    // Atualiza os dados e reposiciona o paciente na fila de acordo com os novos sintomas
+    indice_nascimento.atualizar(id, armazem.nascimento(id), bday);
+    armazem.atualizar(id, name, email, bday, sintomas);
+    escalonador.alterar_prioridade(id, sintomas);
+    indice_sintomas.atualizar(id, sintomas);
+    if (diario != nullptr) {
+        diario->registrar_admissao(cpf_chave, name, email, bday, sintomas);
+        depois_de_registrar();
+    }
+    return ATUALIZADO;
+}
+
+std::size_t Triagem::admitir_lote(const std::vector<Cadastro>& cadastros)
+{
+    std::size_t novos = 0;
+
+    // Lote pequeno em relação à fila: inserir um a um custa menos que reorganizar a fila inteira
+    if (cadastros.size() < escalonador.tamanho()) {
+        for (const Cadastro& cadastro : cadastros) {
+            if (admitir_chave(cadastro.cpf, cadastro.nome, cadastro.email, cadastro.nascimento,
+                              cadastro.sintomas) == ADMITIDO) {
+                novos++;
+            }
+        }
+        return novos;
+    }
+
+    // Guarda os pacientes e atualiza o índice de CPF; a fila e o índice de nomes ficam para o final
+    std::vector<int> ids_novos;
+    ids_novos.reserve(cadastros.size());
+    armazem.reservar(armazem.tamanho() + cadastros.size());
+    indice_sintomas.reservar(armazem.tamanho() + cadastros.size());
+    indice_cpf.reservar(escalonador.tamanho() + cadastros.size());
+    for (const Cadastro& cadastro : cadastros) {
+        int id = indice_cpf.buscar(cadastro.cpf);
+        if (id == -1) {
+            id = armazem.adicionar(cadastro.cpf, cadastro.nome, cadastro.email, cadastro.nascimento, cadastro.sintomas);
+            indice_cpf.inserir(cadastro.cpf, id);
+            indice_sintomas.adicionar(id, cadastro.sintomas);
+            indice_nascimento.adicionar(id, cadastro.nascimento);
+            busca_nome.indexar(id, std::string(cadastro.nome));
+            ids_novos.push_back(id);
+        }
+        else {
+            if (armazem.nome(id) != cadastro.nome) {
+                busca_nome.indexar(id, std::string(cadastro.nome));
+            }
+            indice_nascimento.atualizar(id, armazem.nascimento(id), cadastro.nascimento);
+            armazem.atualizar(id, cadastro.nome, cadastro.email, cadastro.nascimento, cadastro.sintomas);
+            indice_sintomas.atualizar(id, cadastro.sintomas);
+        }
+        if (diario != nullptr) {
+            diario->registrar_admissao(cadastro.cpf, cadastro.nome, cadastro.email, cadastro.nascimento,
+                                       cadastro.sintomas);
+        }
+    }
+    novos = ids_novos.size();
+    if (telemetria != nullptr) {
+        for (int id : ids_novos) {
+            telemetria->admitido(id);
+        }
+    }
+
+    // Reconstrói a fila e o índice de nomes com os pacientes que já estavam na fila e os novos,
+    // usando os dados atualizados do armazenamento; os tratamentos em andamento continuam
+    // Os pacientes novos chegam no passo atual; os demais mantêm a chegada e o envelhecimento
+    std::vector<Escalonador::Paciente> entradas;
+    std::vector<IndiceOrdenado<std::string>::Entrada> nomes;
+    entradas.reserve(escalonador.tamanho() + novos);
+    nomes.reserve(escalonador.tamanho() + novos);
+    for (int id : ids_novos) {
+        entradas.push_back(Escalonador::Paciente{id, armazem.sintomas(id), id, escalonador.passo()});
+    }
+    escalonador.percorrer([&](const Escalonador::Paciente& paciente) {
+        entradas.push_back(Escalonador::Paciente{paciente.handle, armazem.sintomas(paciente.handle), paciente.handle,
+                                                 paciente.chegada});
+    });
+    for (const Escalonador::Paciente& paciente : entradas) {
+        nomes.push_back(IndiceOrdenado<std::string>::Entrada{minusculas(armazem.nome(paciente.handle)),
+                                                             paciente.handle});
+    }
+    escalonador.construir(entradas, escalonador.estacoes(), escalonador.passo());
+    indice_nome.construir(std::move(nomes));
+    medir_fila();
+
+    if (diario != nullptr && !cadastros.empty()) {
+        depois_de_registrar();
+    }
+    return novos;
+}
+
+bool Triagem::remover(const std::string& cpf)
+{
+    return remover_chave(cpf_para_chave(cpf));
+}
+
+bool Triagem::remover_chave(std::uint64_t cpf_chave)
+{
+    int id = indice_cpf.buscar(cpf_chave);
+    if (id == -1) {
+        return false;
+    }
+    retirar(id);
+    if (telemetria != nullptr) {
+        telemetria->removido();
+        medir_fila();
+    }
+    if (diario != nullptr) {
+        diario->registrar_remocao(cpf_chave);
+        depois_de_registrar();
+    }
+    if (historico != nullptr) {
+        arquivar(); // Depois do registro: o histórico espera que ele esteja no disco
+    }
+    return true;
+}
+
+int Triagem::buscar_cpf(const std::string& cpf) const
+{
+    return indice_cpf.buscar(cpf_para_chave(cpf));
+}
+
+std::vector<int> Triagem::buscar_nome(const std::string& name) const
+{
+    return indice_nome.buscar(minusculas(name));
+}
+
+std::vector<int> Triagem::listar_por_nome() const
+{
+    std::vector<int> ids;
+    ids.reserve(indice_nome.tamanho());
+    indice_nome.percorrer([&](const IndiceOrdenado<std::string>::Entrada& entrada) {
+        ids.push_back(entrada.handle);
+    });
+    return ids;
+}
+
+int Triagem::buscar_nome_sequencial(const std::string& name) const
+{
+    int encontrado = -1;
+    escalonador.percorrer([&](const Escalonador::Paciente& paciente) {
+        if (encontrado == -1 && iguais_sem_caixa(armazem.nome(paciente.handle), name)) {
+            encontrado = paciente.handle;
+        }
+    });
+    return encontrado;
+}
+
+std::vector<Triagem::Aproximado> Triagem::buscar_aproximado(const std::string& consulta, std::size_t limite) const
+{
+    std::vector<Aproximado> encontrados;
+    for (const BuscaNome::Resultado& resultado : busca_nome.buscar(consulta, limite)) {
+        encontrados.push_back(Aproximado{resultado.id, escalonador.contem(resultado.id)});
+    }
+    return encontrados;
+}
+
+void Triagem::configurar_estacoes(const std::vector<unsigned>& afinidades)
+{
+    if (!escalonador.configurar(afinidades)) {
+        return;
+    }
+    medir_fila();
+    if (diario != nullptr) {
+        diario->registrar_estacoes(afinidades);
+        depois_de_registrar();
+    }
+}
+
+void Triagem::configurar_envelhecimento(std::int64_t passos_por_nivel)
+{
+    if (!escalonador.envelhecer(passos_por_nivel)) {
+        return;
+    }
+    if (diario != nullptr) {
+        diario->registrar_envelhecimento(escalonador.passos_por_nivel());
+        depois_de_registrar();
+    }
+}
+
+bool Triagem::avancar()
+{
+    bool houve_evento = escalonador.avancar();
+
+    // Os pacientes tratados já saíram do escalonador; falta retirá-los dos índices
+    for (int id : escalonador.concluidos()) {
+        tirar_dos_indices(id);
+    }
+    if (houve_evento && telemetria != nullptr) {
+        for (const Estacao& estacao : escalonador.estacoes()) {
+            if (estacao.evento == Escalonador::CHAMADO) {
+                telemetria->chamado(estacao.paciente, armazem.sintomas(estacao.paciente));
+            }
+        }
+        for (int id : escalonador.concluidos()) {
+            telemetria->concluido(id, armazem.sintomas(id));
+        }
+        medir_fila();
+    }
+
+    // O passo é determinístico: registrar que ele ocorreu basta para reaplicá-lo
+    if (houve_evento && diario != nullptr) {
+        diario->registrar_avanco();
+        depois_de_registrar();
+    }
+
+    // A cada passo, e não só a cada alta, para selar as faixas cujas saídas o diário já gravou
+    if (historico != nullptr) {
+        arquivar();
+    }
+    return houve_evento;
+}
+
+void Triagem::medir_em(Telemetria* telemetria)
+{
+    this->telemetria = telemetria;
+    medir_fila();
+}
+
+bool Triagem::arquivar_em(Historico* historico)
+{
+    if (historico != nullptr && !historico->conferir(*this)) {
+        this->historico = nullptr;
+        return false;
+    }
+    this->historico = historico;
+    if (historico != nullptr) {
+        arquivar();
+    }
+    return true;
+}
+
+// Sela o que o histórico puder e descarta da memória os nomes e emails dos pacientes selados
+void Triagem::arquivar()
+{
+    historico->acompanhar(*this, diario);
+    if (historico->selados() > armazem.sem_textos()) {
+        armazem.descartar_textos(static_cast<int>(historico->selados()));
+    }
+}
+
+Patient Triagem::paciente(int id) const
+{
+    Patient patient = armazem.paciente(id);
+    if (historico != nullptr && static_cast<std::size_t>(id) < armazem.sem_textos()) {
+        Historico::Consulta consulta;
+        consulta.primeiro_id = consulta.ultimo_id = id;
+        historico->consultar(*this, consulta, [&](const Historico::Registro& registro) {
+            patient.name.assign(registro.nome);
+            patient.email.assign(registro.email);
+        });
+    }
+    return patient;
+}
+
+// Atualiza os medidores da fila na telemetria, se houver
+void Triagem::medir_fila()
+{
+    if (telemetria != nullptr) {
+        telemetria->medir_fila(escalonador.esperando(), escalonador.estacoes_ocupadas());
+    }
+}
+
+// Grava um instantâneo quando o diário acumulou eventos suficientes
+void Triagem::depois_de_registrar()
+{
+    if (diario->precisa_instantaneo()) {
+        diario->instantaneo(*this);
+    }
+}
+
+void Triagem::salvar(Escritor& saida) const
+{
+    armazem.salvar(saida);
+
+    // A fila é gravada apenas como os IDs em espera, na ordem do índice de nomes,
+    // e o passo de chegada de cada um; prioridade e ordem vêm do armazenamento.
+    // As chaves do índice vão junto, para que ele seja reconstruído sem ordenar
+    // nem ler os nomes fora de ordem
+    std::vector<std::int64_t> chegada_do_id(armazem.tamanho());
+    escalonador.percorrer([&](const Escalonador::Paciente& paciente) {
+        chegada_do_id[paciente.handle] = paciente.chegada;
+    });
+    std::vector<std::int32_t> ids;
+    std::vector<std::int64_t> chegadas;
+    ids.reserve(escalonador.tamanho());
+    chegadas.reserve(escalonador.tamanho());
+    indice_nome.percorrer([&](const IndiceOrdenado<std::string>::Entrada& entrada) {
+        ids.push_back(entrada.handle);
+        chegadas.push_back(chegada_do_id[entrada.handle]);
+    });
+    saida.vetor(ids);
+    saida.vetor(chegadas);
+    indice_nome.percorrer([&](const IndiceOrdenado<std::string>::Entrada& entrada) { saida.texto(entrada.chave); });
+    busca_nome.salvar(saida);
+
+    saida.u32(static_cast<std::uint32_t>(escalonador.estacoes().size()));
+    for (const Estacao& estacao : escalonador.estacoes()) {
+        saida.u32(estacao.afinidade);
+        saida.i32(estacao.paciente);
+        saida.i32(estacao.tempo);
+        saida.i32(estacao.duracao);
+        saida.i32(estacao.progresso);
+    }
+    saida.u64(static_cast<std::uint64_t>(escalonador.passo()));
+    saida.u64(static_cast<std::uint64_t>(escalonador.passos_por_nivel()));
+}
+
+bool Triagem::carregar(Leitor& entrada)
+{
+    ArmazemPacientes novo;
+    BuscaNome nova_busca;
+    std::vector<std::int32_t> ids;
+    std::vector<std::int64_t> chegadas;
+    std::uint32_t quantidade_estacoes;
+    if (!novo.carregar(entrada) || !entrada.vetor(ids) || !entrada.vetor(chegadas) || chegadas.size() != ids.size()) {
+        return false;
+    }
+    std::vector<std::string_view> chaves(ids.size()); // Apontam para a entrada, que dura até o fim da carga
+    for (std::string_view& chave : chaves) {
+        if (!entrada.texto(chave)) {
+            return false;
+        }
+    }
+    if (!nova_busca.carregar(entrada) || !entrada.u32(quantidade_estacoes) || quantidade_estacoes == 0 ||
+        quantidade_estacoes > entrada.restante() / (5 * sizeof(std::int32_t))) {
+        return false;
+    }
+
+    // Confere se os IDs da fila existem e não se repetem
+    std::vector<bool> na_fila(novo.tamanho(), false);
+    for (std::int32_t id : ids) {
+        if (id < 0 || static_cast<std::size_t>(id) >= novo.tamanho() || na_fila[id]) {
+            return false;
+        }
+        na_fila[id] = true;
+    }
+
+    // Confere as estações: cada paciente em tratamento está na fila e em uma só estação
+    std::vector<Estacao> novas_estacoes(quantidade_estacoes);
+    for (Estacao& estacao : novas_estacoes) {
+        std::uint32_t afinidade;
+        std::int32_t paciente, tempo, duracao, progresso;
+        if (!entrada.u32(afinidade) || !entrada.i32(paciente) || !entrada.i32(tempo) || !entrada.i32(duracao) ||
+            !entrada.i32(progresso)) {
+            return false;
+        }
+        if (paciente != -1) {
+            if (paciente < 0 || static_cast<std::size_t>(paciente) >= novo.tamanho() || !na_fila[paciente] ||
+                duracao < 2 || tempo < 1 || tempo > duracao) {
+                return false;
+            }
+            na_fila[paciente] = false;
+        }
+        estacao.afinidade = afinidade;
+        estacao.paciente = paciente;
+        estacao.tempo = tempo;
+        estacao.duracao = duracao;
+        estacao.progresso = progresso;
+    }
+
+    // Confere o relógio e o envelhecimento: as chegadas não podem estar no futuro
+    std::uint64_t passo, passos_por_nivel;
+    if (!entrada.u64(passo) || !entrada.u64(passos_por_nivel) || passo > static_cast<std::uint64_t>(INT64_MAX) ||
+        passos_por_nivel > static_cast<std::uint64_t>(Escalonador::MAXIMO_PASSOS_POR_NIVEL)) {
+        return false;
+    }
+    for (std::int64_t chegada : chegadas) {
+        if (chegada < 0 || chegada > static_cast<std::int64_t>(passo)) {
+            return false;
+        }
+    }
+
+    armazem = std::move(novo);
+    busca_nome = std::move(nova_busca);
+
+    // Reconstrói a fila e os índices de uma só vez
+    std::vector<Escalonador::Paciente> entradas;
+    std::vector<IndiceOrdenado<std::string>::Entrada> nomes;
+    entradas.reserve(ids.size());
+    nomes.reserve(ids.size());
+    indice_cpf = IndiceCpf();
+    indice_cpf.reservar(ids.size());
+    indice_sintomas.limpar();
+    indice_sintomas.reservar(armazem.tamanho());
+    std::vector<long long> nascimentos(armazem.tamanho());
+    for (std::size_t id = 0; id < armazem.tamanho(); ++id) {
+        indice_sintomas.adicionar(static_cast<int>(id), armazem.sintomas(static_cast<int>(id)), false);
+        nascimentos[id] = armazem.nascimento(static_cast<int>(id));
+    }
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        nomes.push_back(IndiceOrdenado<std::string>::Entrada{std::string(chaves[i]), ids[i]});
+    }
+
+    // Os demais índices são montados em ordem de ID, que lê o armazenamento em sequência
+    std::vector<std::int64_t> chegada_do_id(armazem.tamanho(), -1);
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        chegada_do_id[ids[i]] = chegadas[i];
+    }
+    std::vector<int> fila_por_id;
+    fila_por_id.reserve(ids.size());
+    for (std::size_t id = 0; id < armazem.tamanho(); ++id) {
+        if (chegada_do_id[id] != -1) {
+            fila_por_id.push_back(static_cast<int>(id));
+        }
+    }
+    for (int id : fila_por_id) {
+        entradas.push_back(Escalonador::Paciente{id, armazem.sintomas(id), id, chegada_do_id[id]});
+        indice_sintomas.marcar_fila(id, true);
+    }
+    // Passada à parte: os acessos aleatórios à tabela do CPF tirariam as outras estruturas da cache
+    for (int id : fila_por_id) {
+        indice_cpf.inserir(armazem.cpf(id), id);
+    }
+    escalonador.envelhecer(static_cast<std::int64_t>(passos_por_nivel));
+    escalonador.construir(entradas, std::move(novas_estacoes), static_cast<std::int64_t>(passo));
+    indice_nome.construir(std::move(nomes));
+    indice_nascimento.construir(nascimentos, fila_por_id);
+    return true;
+}
@@ -0,0 +1,302 @@
+#ifndef TRIAGEM_H
+#define TRIAGEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "armazem.h"
+#include "buscanome.h"
+#include "escalonador.h"
+#include "indicecpf.h"
+#include "indicenascimento.h"
+#include "indicesintomas.h"
+#include "indiceordenado.h"
+#include "paciente.h"
+
+class Diario;
+class Escritor;
+class Historico;
+class Leitor;
+class Telemetria;
+
+/**
+ * @brief Motor de triagem: fila de espera, cadastro e tratamento dos pacientes.
+ *
+ * Reúne o armazenamento dos pacientes, a fila de prioridade, os índices de CPF
+ * e de nome e a busca aproximada, sem depender da interface gráfica. Os textos
+ * são UTF-8 e as datas são dias julianos (ver data.h).
+ *
+ * Os pacientes são identificados pelo ID, que é atribuído na admissão em ordem
+ * de chegada. Todos os pacientes admitidos continuam no armazenamento depois de
+ * sair da fila e formam o relatório; as consultas retornam IDs e paciente()
+ * monta o registro completo para exibição.
+ *
+ * O tratamento é feito por uma ou mais estações (salas ou médicos), cada uma
+ * com um paciente por vez, segundo as regras do Escalonador. O paciente
+ * continua na fila enquanto é tratado e só sai dela quando o tratamento termina
+ * ou quando é removido.
+ */
+class Triagem
+{
+public:
+    // Resultado da admissão de um paciente
+    enum Admissao {
+        ADMITIDO,       // Paciente novo inserido na fila
+        ATUALIZADO,     // Paciente com o mesmo CPF já estava na fila e teve os dados atualizados
+        CPF_MAL_FORMADO // O CPF não tem um formato aceito ou os dígitos verificadores não conferem
+    };
+
+    // Estação de tratamento; o paciente em tratamento é identificado pelo ID
+    using Estacao = Escalonador::Estacao;
+
+    // Paciente a ser admitido por admitir_lote(); os textos só precisam existir durante a chamada
+    struct Cadastro {
+        std::uint64_t cpf;      // Chave do CPF (ver cpf.h)
+        std::string_view nome;  // Nome do paciente (UTF-8)
+        std::string_view email; // Email do paciente
+        long long nascimento;   // Data de nascimento (dia juliano)
+        unsigned sintomas;      // Sintomas representados por flags binárias
+    };
+
+    // Paciente encontrado pela busca aproximada
+    struct Aproximado {
+        int id;       // ID do paciente
+        bool na_fila; // O paciente ainda está esperando atendimento
+    };
+
+    /**
+     * @brief Admite um paciente na fila ou atualiza o paciente com o mesmo CPF.
+     * @param name Nome do paciente.
+     * @param cpf CPF no formato XXX.XXX.XXX-XX ou com os 11 dígitos sem separadores.
+     * @param email Email do paciente.
+     * @param bday Data de nascimento (dia juliano).
+     * @param sintomas Sintomas representados por flags binárias.
+     * @return ADMITIDO, ATUALIZADO ou CPF_MAL_FORMADO.
+     */
+    Admissao admitir(const std::string& name, const std::string& cpf, const std::string& email,
+                     long long bday, unsigned sintomas);
+
+    /**
+     * @brief Admite vários pacientes de uma só vez, na ordem informada.
+     * O resultado é o mesmo de chamar admitir() para cada cadastro. Quando o lote
+     * é pelo menos do tamanho da fila, a fila e o índice de nomes são reorganizados
+     * uma única vez no final (heap construído em O(n) e uma só ordenação), em vez
+     * de a cada paciente.
+     * @param cadastros Pacientes com o CPF já convertido para a chave.
+     * @return Quantidade de pacientes novos; os demais atualizaram pacientes que já estavam na fila.
+     */
+    std::size_t admitir_lote(const std::vector<Cadastro>& cadastros);
+
+    /**
+     * @brief Remove da fila o paciente com o CPF informado.
+     * Se o paciente estava em tratamento, o tratamento é encerrado.
+     * @return true se o paciente estava na fila.
+     */
+    bool remover(const std::string& cpf);
+
+    /**
+     * @brief Busca na fila o paciente com o CPF informado.
+     * @return ID do paciente ou -1 se ele não estiver na fila.
+     */
+    int buscar_cpf(const std::string& cpf) const;
+
+    /**
+     * @brief Busca na fila, pelo índice ordenado, os pacientes com o nome informado.
+     * A comparação não diferencia maiúsculas de minúsculas.
+     * @return IDs dos pacientes encontrados (vazio se nenhum).
+     */
+    std::vector<int> buscar_nome(const std::string& name) const;
+
+    /**
+     * @brief Busca na fila, percorrendo-a sequencialmente, o primeiro paciente com o nome informado.
+     * A comparação não diferencia maiúsculas de minúsculas.
+     * @return ID do paciente ou -1 se nenhum paciente da fila tiver o nome.
+     */
+    int buscar_nome_sequencial(const std::string& name) const;
+
+    /**
+     * @brief Busca entre todos os pacientes admitidos os pacientes com nome parecido com o informado.
+     * Aceita nomes parciais, sem acentos e com pequenos erros de digitação (ver BuscaNome).
+     * @param consulta Nome ou parte do nome.
+     * @param limite Quantidade máxima de resultados.
+     * @return Pacientes encontrados, do mais para o menos relevante.
+     */
+    std::vector<Aproximado> buscar_aproximado(const std::string& consulta, std::size_t limite) const;
+
+    /**
+     * @brief Retorna os IDs dos k próximos pacientes a serem atendidos, em ordem.
+     */
+    std::vector<int> primeiros(std::size_t k) const { return escalonador.primeiros(k); }
+
+    /**
+     * @brief Retorna os IDs de todos os pacientes da fila na ordem de atendimento.
+     */
+    std::vector<int> listar() const { return escalonador.ordenados(); }
+
+    /**
+     * @brief Retorna os IDs de todos os pacientes da fila em ordem alfabética do nome.
+     * Percorre o índice de nomes, que já está ordenado, sem ordenar de novo.
+     */
+    std::vector<int> listar_por_nome() const;
+
+    /**
+     * @brief ID do paciente mais prioritário entre os que esperam (sem os que estão em tratamento).
+     * É quem a próxima estação sem afinidade que ficar livre vai chamar.
+     * @return ID do paciente ou -1 se ninguém espera.
+     */
+    int proximo() const { return escalonador.espera().topo(); }
+
+    /**
+     * @brief Monta o registro completo de um paciente admitido.
+     * O nome e o email dos pacientes selados são lidos do histórico em disco.
+     * @param id ID do paciente, entre 0 e admitidos() - 1.
+     */
+    Patient paciente(int id) const;
+
+    /**
+     * @brief Verifica se o paciente ainda está esperando atendimento.
+     */
+    bool na_fila(int id) const { return escalonador.contem(id); }
+
+    /**
+     * @brief Quantidade de pacientes admitidos desde o início, na fila ou não.
+     * Os IDs vão de 0 a admitidos() - 1.
+     */
+    std::size_t admitidos() const { return armazem.tamanho(); }
+
+    /**
+     * @brief Armazenamento dos pacientes, para consultas sem montar o registro completo.
+     * Os pacientes selados no histórico não têm nome e email na memória (ver
+     * ArmazemPacientes::sem_textos); os dos pacientes na fila estão sempre lá.
+     */
+    const ArmazemPacientes& pacientes() const { return armazem; }
+
+    /**
+     * @brief Histórico em que os pacientes são selados (ver arquivar_em), ou nullptr.
+     */
+    const Historico* historico_em_uso() const { return historico; }
+
+    /**
+     * @brief Índice de sintomas de todos os pacientes admitidos, na fila e no histórico.
+     * Responde consultas como "COVID e FEBRE, sem AVC" e conta sintomas e pares
+     * de sintomas sem percorrer os pacientes (ver IndiceSintomas).
+     */
+    const IndiceSintomas& sintomas() const { return indice_sintomas; }
+
+    /**
+     * @brief Índice das datas de nascimento de todos os pacientes admitidos, na fila e no histórico.
+     * Conta e lista faixas de idade, como "esperando com mais de 60 anos", sem
+     * percorrer os pacientes e com a idade calculada na data pedida (ver IndiceNascimento).
+     */
+    const IndiceNascimento& nascimentos() const { return indice_nascimento; }
+
+    std::size_t tamanho() const { return escalonador.tamanho(); }
+    bool vazia() const { return escalonador.vazio(); }
+
+    /**
+     * @brief Define as estações de tratamento.
+     * As estações que continuam existindo mantêm o tratamento em andamento; os
+     * pacientes das estações retiradas voltam a esperar na fila. A triagem
+     * começa com uma única estação sem afinidade.
+     * @param afinidades Afinidade de cada estação (ver Escalonador::Estacao); vazio equivale a {0}.
+     */
+    void configurar_estacoes(const std::vector<unsigned>& afinidades);
+
+    /**
+     * @brief Estações de tratamento, com o estado e o evento do último avancar().
+     */
+    const std::vector<Estacao>& estacoes() const { return escalonador.estacoes(); }
+
+    /**
+     * @brief Define o envelhecimento da prioridade de quem espera (ver Escalonador::envelhecer).
+     * A cada passos_por_nivel chamadas de avancar() com pacientes na fila, quem
+     * espera sobe um nível de prioridade, de modo que pacientes com sintomas leves
+     * não esperam indefinidamente. A triagem começa sem envelhecimento.
+     * @param passos_por_nivel Passos de espera por nível, ou 0 para não envelhecer.
+     */
+    void configurar_envelhecimento(std::int64_t passos_por_nivel);
+
+    std::int64_t passos_por_nivel() const { return escalonador.passos_por_nivel(); }
+
+    /**
+     * @brief Avança o tratamento em uma unidade de tempo em todas as estações.
+     * Cada estação ocupada reduz o tempo restante e, quando ele acaba, retira o
+     * paciente da fila; a estação fica livre até o passo seguinte. Cada estação
+     * que já estava livre chama o próximo paciente que espera: as estações com
+     * afinidade chamam primeiro o paciente mais prioritário com algum dos seus
+     * sintomas e, se não houver, o mais prioritário de todos, como as demais.
+     * O tempo de um tratamento é a prioridade do paciente mais um.
+     * @return true se algo aconteceu em alguma estação (ver Escalonador::Estacao).
+     */
+    bool avancar();
+
+    /**
+     * @brief Estação onde o paciente está sendo tratado, ou -1 se ele não está em tratamento.
+     */
+    int estacao_de(int id) const { return escalonador.estacao_de(id); }
+
+    /**
+     * @brief Passa a registrar as admissões, remoções e passos do tratamento no diário.
+     * @param diario Diário aberto (ver diario.h), ou nullptr para parar de registrar.
+     */
+    void registrar_em(Diario* diario) { this->diario = diario; }
+
+    /**
+     * @brief Passa a registrar as admissões, chamados, altas e o tamanho da fila na telemetria.
+     * @param telemetria Telemetria (ver telemetria.h), ou nullptr para parar de medir.
+     */
+    void medir_em(Telemetria* telemetria);
+
+    /**
+     * @brief Passa a selar no histórico os pacientes que saem da fila (ver Historico).
+     * Descarta os segmentos que o estado atual não confirma (ver Historico::conferir) e
+     * sela as faixas de pacientes que já tinham saído, como as recuperadas do diário.
+     * Com um diário (ver registrar_em), só sela as saídas que ele já gravou em disco.
+     * Os nomes e emails dos pacientes selados saem da memória e passam a ser lidos do histórico.
+     * @param historico Histórico aberto, ou nullptr para parar de selar.
+     * @return false se Historico::conferir falhar, como quando o histórico não tem os pacientes
+     *         já selados; nesse caso a triagem não arquiva.
+     */
+    bool arquivar_em(Historico* historico);
+
+    /**
+     * @brief Grava o estado completo da triagem (ver binario.h).
+     */
+    void salvar(Escritor& saida) const;
+
+    /**
+     * @brief Substitui o estado pelo gravado por salvar() e reconstrói os índices.
+     * @return false se os dados estiverem incompletos ou inconsistentes; nesse caso o estado não muda.
+     */
+    bool carregar(Leitor& entrada);
+
+private:
+    friend class Diario;   // A reaplicação do diário usa as chaves gravadas, sem validar o CPF de novo
+    friend class Recepcao; // Os pedidos chegam com o CPF já validado pelo guichê
+    friend class Servidor; // Idem, pelo serviço, que também procura pacientes pela chave do CPF
+
+    Admissao admitir_chave(std::uint64_t cpf_chave, std::string_view name, std::string_view email,
+                           long long bday, unsigned sintomas);
+    bool remover_chave(std::uint64_t cpf_chave);
+    void retirar(int id);
+    void tirar_dos_indices(int id);
+    void depois_de_registrar();
+    void arquivar();
+    void medir_fila();
+
+    ArmazemPacientes armazem;                 // Todos os pacientes admitidos, em ordem de ID
+    Escalonador escalonador;                  // Fila de prioridade e estações de tratamento, pelos IDs dos pacientes
+    IndiceCpf indice_cpf;                     // Índice hash dos pacientes em espera por CPF
+    IndiceOrdenado<std::string> indice_nome;  // Índice ordenado dos pacientes em espera pelo nome em minúsculas
+    IndiceSintomas indice_sintomas;           // Mapas de bits dos sintomas de todos os pacientes admitidos
+    IndiceNascimento indice_nascimento;       // Datas de nascimento de todos os pacientes admitidos
+    BuscaNome busca_nome;                     // Busca aproximada sobre todos os pacientes admitidos
+    Diario* diario = nullptr;                 // Diário das operações (nullptr se a triagem não é persistida)
+    Telemetria* telemetria = nullptr;         // Medidas do atendimento (nullptr se a triagem não é medida)
+    Historico* historico = nullptr;           // Histórico em disco (nullptr se os pacientes só ficam na memória)
+};
+
+#endif // TRIAGEM_H